@@ -43,4 +43,6 @@
 #define NM_DEBUG				CONF_WINC_DEBUG
 #define NM_BSP_PRINTF			CONF_WINC_PRINTF
 
+void nm_bsp_register_event_cb(void (*pfEventCb)(void));
+
 #endif /* _NM_BSP_SAMD21_H_ */
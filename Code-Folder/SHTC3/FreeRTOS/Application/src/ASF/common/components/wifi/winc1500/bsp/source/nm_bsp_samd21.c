@@ -39,12 +39,16 @@
 #include "conf_winc.h"
 
 static tpfNmBspIsr gpfIsr;
+static tpfNmBspIsr gpfEventCb;
 
 static void chip_isr(void)
 {
 	if (gpfIsr) {
 		gpfIsr();
 	}
+	if (gpfEventCb) {
+		gpfEventCb();
+	}
 }
 
 /*
@@ -164,6 +168,17 @@ void nm_bsp_register_isr(tpfNmBspIsr pfIsr)
 			EXTINT_CALLBACK_TYPE_DETECT);
 }
 
+/*
+ *	@fn		nm_bsp_register_event_cb
+ *	@brief	Register an application callback, called from the WINC interrupt after the HIF handler
+ *	@param[IN]	pfEventCb
+ *				Callback, in interrupt context. Used to wake the task that calls m2m_wifi_handle_events
+ */
+void nm_bsp_register_event_cb(tpfNmBspIsr pfEventCb)
+{
+	gpfEventCb = pfEventCb;
+}
+
 /*
  *	@fn		nm_bsp_interrupt_ctrl
  *	@brief	Enable/Disable interrupts
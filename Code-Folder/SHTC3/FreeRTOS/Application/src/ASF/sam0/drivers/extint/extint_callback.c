@@ -204,6 +204,17 @@ uint8_t extint_get_current_channel(void)
 	return _current_channel;
 }
 
+/** Default enter hook of the channel callbacks, does nothing. */
+WEAK uint32_t extint_callback_hook_enter(void)
+{
+	return 0;
+}
+
+/** Default exit hook of the channel callbacks, does nothing. */
+WEAK void extint_callback_hook_exit(const uint8_t channel, uint32_t context)
+{
+}
+
 /** Handler for the EXTINT hardware module interrupt. */
 void EIC_Handler(void)
 {
@@ -215,7 +226,9 @@ void EIC_Handler(void)
 			/* Find any associated callback entries in the callback table */
 			if (_extint_dev.callbacks[_current_channel] != NULL) {
 				/* Run the registered callback */
+				uint32_t context = extint_callback_hook_enter();
 				_extint_dev.callbacks[_current_channel]();
+				extint_callback_hook_exit(_current_channel, context);
 			}
 		}
 	}
@@ -73,6 +73,16 @@ enum status_code extint_unregister_callback(
 
 uint8_t extint_get_current_channel(void);
 
+/**
+ * \brief Hooks run around every EXTINT channel callback.
+ *
+ * Weak no-ops in the driver, which the application may override, e.g. to
+ * account the time spent in interrupts. The value returned by the enter hook
+ * is passed to the exit hook.
+ */
+uint32_t extint_callback_hook_enter(void);
+void extint_callback_hook_exit(const uint8_t channel, uint32_t context);
+
 /** @} */
 
 /** \name Callback Enabling and Disabling (Channel)
@@ -87,13 +87,26 @@ void _sercom_set_handler(
 #define _SERCOM_INTERRUPT_VECT_NUM(n, unused) \
 		SYSTEM_INTERRUPT_MODULE_SERCOM##n,
 
+/** Default enter hook of the SERCOM handlers, does nothing. */
+WEAK uint32_t sercom_interrupt_hook_enter(void)
+{
+	return 0;
+}
+
+/** Default exit hook of the SERCOM handlers, does nothing. */
+WEAK void sercom_interrupt_hook_exit(const uint8_t instance, uint32_t context)
+{
+}
+
 /** \internal
  * Generates a SERCOM interrupt handler function for a given SERCOM index.
  */
 #define _SERCOM_INTERRUPT_HANDLER(n, unused) \
 		void SERCOM##n##_Handler(void) \
 		{ \
+			uint32_t context = sercom_interrupt_hook_enter(); \
 			_sercom_interrupt_handlers[n](n); \
+			sercom_interrupt_hook_exit(n, context); \
 		}
 
 /**
@@ -55,6 +55,16 @@ void _sercom_set_handler(
 		const uint8_t instance,
 		const sercom_handler_t interrupt_handler);
 
+/**
+ * \brief Hooks run around every SERCOM interrupt handler.
+ *
+ * Weak no-ops in the driver, which the application may override, e.g. to
+ * account the time spent in interrupts. The value returned by the enter hook
+ * is passed to the exit hook.
+ */
+uint32_t sercom_interrupt_hook_enter(void);
+void sercom_interrupt_hook_exit(const uint8_t instance, uint32_t context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,175 @@
+/**************************************************************************/ /**
+ * @file      Acquisition.c
+ * @brief     Sensor acquisition scheduler. Samples every sensor of a descriptor table at its own period, as executor jobs
+ * @details   Each enabled sensor is one job of the executor (Exec/Exec.c), in the high lane, so the sensors share the
+ *            timer service stack instead of a task of their own. A sample is a sequence of steps that only queue their
+ *            I2C transfers: the waits between them (sensor wake-up, conversion) and the retries while a transfer is
+ *            still queued are executor waits, so the job never blocks the timer service. The lid debounce timers and
+ *            the deferred interrupts run in between.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Acquisition/Acquisition.h"
+
+#include "Exec/Exec.h"
+#include "I2cDriver/I2cDriver.h"
+#include "SHTC3/SHTC3.h"
+#include "SHTC3/SHTC3_TASK.h"
+#include "SerialConsole.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define ACQ_SENSOR_COUNT (sizeof(acqSensors) / sizeof(acqSensors[0]))
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+/// Sensors sampled by the scheduler. Adding a sensor is adding a row; it shares the executor and stack of the others.
+static const Acq_Sensor acqSensors[] = {
+    {"SHTC3", 500, 0, SHTC3_Init, 3,
+     {{SHTC3_Wake, SHTC3_GetWakeupTicks}, {SHTC3_Trigger, SHTC3_GetMeasurementTicks}, {SHTC3TaskReadSample, NULL}}},
+};
+
+/// Runtime state of one sensor
+typedef struct Acq_Sensor_State {
+    uint8_t step;         ///< Next step of the sample in progress
+    int32_t job;          ///< Executor job index, negative if the sensor is not sampled
+    Acq_Sensor_Stats stats;
+} Acq_Sensor_State;
+
+static Acq_Sensor_State acqState[ACQ_SENSOR_COUNT];
+static Exec_Job acqJobs[ACQ_SENSOR_COUNT];
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static TickType_t AcqRunJob(void *arg);
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			int32_t AcqInit(void)
+ * @brief       Initializes every sensor of the table and registers a job for each one that answered
+ * @return      Returns 0 on success, or the ExecAdd() error of the last sensor that could not be registered
+ * @note        I2C and the executor must be initialized first. Timer service task only, as ExecAdd()
+ */
+int32_t AcqInit(void)
+{
+    int32_t error = ERROR_NONE;
+
+    for (uint8_t i = 0; i < ACQ_SENSOR_COUNT; i++) {
+        const Acq_Sensor *sensor = &acqSensors[i];
+
+        acqState[i].job = -1;
+        acqState[i].stats.enabled = (sensor->init == NULL) || (sensor->init() == ERROR_NONE);
+        if (!acqState[i].stats.enabled) {
+            SerialConsoleWriteString("ACQ: sensor init failed, sensor disabled\r\n");
+            continue;
+        }
+
+        acqJobs[i].name = sensor->name;
+        acqJobs[i].periodMs = sensor->periodMs;
+        acqJobs[i].phaseMs = sensor->phaseMs;
+        acqJobs[i].deadlineMs = 0;
+        acqJobs[i].lane = EXEC_LANE_HIGH;
+        acqJobs[i].run = AcqRunJob;
+        acqJobs[i].arg = (void *)(uint32_t)i;
+        acqState[i].job = ExecAdd(&acqJobs[i]);
+        if (acqState[i].job < 0) {
+            error = acqState[i].job;
+            acqState[i].stats.enabled = false;
+        }
+    }
+    return error;
+}
+
+/**
+ * @fn			static TickType_t AcqRunJob(void *arg)
+ * @brief       Executor job of a sensor: runs the steps of the sample until one has to wait
+ * @param[in]   arg Index of the sensor in the table
+ * @return      Returns the wait of the step that ran, ACQ_RETRY_TICKS if it was busy, EXEC_DONE once the last step is
+ *              done or a step failed
+ */
+static TickType_t AcqRunJob(void *arg)
+{
+    uint8_t index = (uint8_t)(uint32_t)arg;
+    const Acq_Sensor *sensor = &acqSensors[index];
+    Acq_Sensor_State *state = &acqState[index];
+    int32_t error;
+
+    for (;;) {
+        const Acq_Step *step = &sensor->steps[state->step];
+        error = step->run();
+        if (error == ERROR_BUSY) {
+            return ACQ_RETRY_TICKS;
+        }
+        if (error != ERROR_NONE || ++state->step >= sensor->stepCount) {
+            break;
+        }
+        if (step->waitTicks != NULL) {
+            TickType_t ticks = step->waitTicks();
+            return (ticks > 0) ? ticks : 1;
+        }
+    }
+    state->step = 0;
+
+    taskENTER_CRITICAL();
+    if (error != ERROR_NONE) {
+        state->stats.errors++;
+    } else {
+        state->stats.samples++;
+    }
+    taskEXIT_CRITICAL();
+    return EXEC_DONE;
+}
+
+/**
+ * @fn			uint8_t AcqGetSensorCount(void)
+ * @brief       Returns the number of sensors in the acquisition table
+ */
+uint8_t AcqGetSensorCount(void)
+{
+    return ACQ_SENSOR_COUNT;
+}
+
+/**
+ * @fn			const Acq_Sensor *AcqGetSensor(uint8_t index)
+ * @brief       Returns the descriptor of a sensor of the acquisition table, or NULL if index is out of range
+ */
+const Acq_Sensor *AcqGetSensor(uint8_t index)
+{
+    return (index < ACQ_SENSOR_COUNT) ? &acqSensors[index] : NULL;
+}
+
+/**
+ * @fn			void AcqGetSensorStats(uint8_t index, Acq_Sensor_Stats *stats)
+ * @brief       Copies the counters of a sensor of the acquisition table, with the timing counters of its job
+ * @param[in]   index Index of the sensor, below AcqGetSensorCount()
+ * @param[out]  stats Structure the counters are copied to
+ */
+void AcqGetSensorStats(uint8_t index, Acq_Sensor_Stats *stats)
+{
+    Exec_Job_Stats job = {0};
+
+    if (index >= ACQ_SENSOR_COUNT) {
+        return;
+    }
+    if (acqState[index].job >= 0) {
+        ExecGetJobStats((uint8_t)acqState[index].job, &job);
+    }
+    taskENTER_CRITICAL();
+    *stats = acqState[index].stats;
+    taskEXIT_CRITICAL();
+    stats->overruns = job.overruns;
+    stats->lastJitterTicks = job.lastJitterTicks;
+    stats->maxJitterTicks = job.maxJitterTicks;
+    stats->sumJitterTicks = job.sumJitterTicks;
+    stats->maxRunTicks = job.maxRunTicks;
+}
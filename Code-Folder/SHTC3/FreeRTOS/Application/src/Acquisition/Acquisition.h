@@ -0,0 +1,74 @@
+/**************************************************************************/ /**
+ * @file      Acquisition.h
+ * @brief     Sensor acquisition scheduler. Samples every sensor of a descriptor table at its own period, as executor jobs
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef ACQUISITION_H_
+#define ACQUISITION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define ACQ_MAX_STEPS 3     ///< Steps of one sample
+#define ACQ_RETRY_TICKS 1   ///< Wait before calling a step again that returned ERROR_BUSY
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// One step of a sample. The hooks run on the timer service task, so they queue their I2C transfers and return
+typedef struct Acq_Step {
+    /// Returns ERROR_NONE once done, ERROR_BUSY to be called again after ACQ_RETRY_TICKS (a transfer still queued),
+    /// or an error that ends the sample
+    int32_t (*run)(void);
+    uint32_t (*waitTicks)(void);  ///< Ticks to wait before the next step (wake-up, conversion). NULL to go on at once
+} Acq_Step;
+
+/// Static description of a sensor sampled by the acquisition scheduler
+typedef struct Acq_Sensor {
+    const char *name;              ///< Name printed by the CLI
+    uint32_t periodMs;             ///< Sampling period
+    uint32_t phaseMs;              ///< Offset of the first sample from AcqInit(), to spread sensors on the bus
+    int32_t (*init)(void);         ///< Called once at start, may block. A sensor whose init fails is disabled. May be NULL
+    uint8_t stepCount;             ///< Entries of steps
+    Acq_Step steps[ACQ_MAX_STEPS]; ///< Run in order. The last one reads the sample and hands it on
+} Acq_Sensor;
+
+/// Timing counters of one sensor
+typedef struct Acq_Sensor_Stats {
+    bool enabled;             ///< False if the sensor init failed
+    uint32_t samples;         ///< Samples read without error
+    uint32_t errors;          ///< Samples ended by a failed step
+    uint32_t overruns;        ///< Periods skipped because the executor was still busy at their release time
+    uint32_t lastJitterTicks; ///< Delay between the release time and the start of the last sample
+    uint32_t maxJitterTicks;  ///< Largest release delay seen
+    uint32_t sumJitterTicks;  ///< Accumulated release delay, to compute the average over samples + errors
+    uint32_t maxRunTicks;     ///< Longest time spent in one call of the job: one or more steps
+} Acq_Sensor_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t AcqInit(void);
+uint8_t AcqGetSensorCount(void);
+const Acq_Sensor *AcqGetSensor(uint8_t index);
+void AcqGetSensorStats(uint8_t index, Acq_Sensor_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ACQUISITION_H_ */
@@ -0,0 +1,104 @@
+/**************************************************************************/ /**
+ * @file      AlarmTask.c
+ * @brief     Alarm task. Reacts to lid and SW0 events and evaluates the alarm rules as records are published
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Alarm/AlarmTask.h"
+
+#include <asf.h>
+#include <stdio.h>
+
+#include "Buzzer/Buzzer.h"
+#include "I2cDriver/I2cDriver.h"
+#include "Input/Input.h"
+#include "Rules/Rules.h"
+#include "Schedule/Schedule.h"
+#include "SampleBus/SampleBus.h"
+#include "SerialConsole.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static Sample_Subscriber *alarmSampleSubscriber = NULL;  ///< Lid and rule input records, notified on ALARM_NOTIFY_SAMPLE
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static void AlarmHandleLid(const Sample_Record *record);
+
+/******************************************************************************
+ * Alarm Thread
+ ******************************************************************************/
+
+/**
+ * @fn			void vAlarmTask(void *pvParameters)
+ * @brief       Blocks on the sample bus notification, handles the lid and SW0 records and runs the rule engine on
+ *              the others
+ * @details     The task does not poll: it runs once per lid event, right after the debounce timer publishes it, once
+ *              per SW0 press, once per SHTC3 sample or IMU event, and when the RTC alarm of the medication schedule
+ *              matches. Rules can only watch the sensors subscribed here.
+ * @param[in]   pvParameters Unused
+ */
+void vAlarmTask(void *pvParameters)
+{
+    Sample_Record record;
+
+    alarmSampleSubscriber = SampleBusSubscribe("alarm",
+                                               SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_LID) | SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_SHTC3) |
+                                                   SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_IMU_EVENT) | SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_BUTTON),
+                                               xTaskGetCurrentTaskHandle(), ALARM_NOTIFY_SAMPLE);
+    if (alarmSampleSubscriber == NULL) {
+        SerialConsoleWriteString("ERR: Alarm task could not subscribe to the sample bus!\r\n");
+        vTaskSuspend(NULL);
+    }
+    if (ScheduleInit(xTaskGetCurrentTaskHandle(), ALARM_NOTIFY_SCHEDULE) != ERROR_NONE) {
+        SerialConsoleWriteString("ERR: Medication schedule could not be initialized!\r\n");
+    }
+
+    for (;;) {
+        uint32_t notification = 0;
+        xTaskNotifyWait(0, ALARM_NOTIFY_SAMPLE | ALARM_NOTIFY_SCHEDULE, &notification, portMAX_DELAY);
+
+        if (notification & ALARM_NOTIFY_SCHEDULE) {
+            ScheduleService();
+        }
+
+        while (SampleBusRead(alarmSampleSubscriber, &record)) {
+            if (record.sensor == SAMPLE_SENSOR_LID) {
+                AlarmHandleLid(&record);
+            } else if (record.sensor == SAMPLE_SENSOR_BUTTON) {
+                BuzzerPlay(&buzzerPatternPill);  // SW0 sounds the pill alarm, a lid opening stops it
+            } else {
+                RulesEvaluate(&record);
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void AlarmHandleLid(const Sample_Record *record)
+ * @brief       Opening a compartment acknowledges the pill alarm: the buzzer is stopped
+ * @param[in]   record SAMPLE_SENSOR_LID record
+ */
+static void AlarmHandleLid(const Sample_Record *record)
+{
+    char line[24];
+
+    if (record->channel[SAMPLE_LID_OPEN]) {
+        BuzzerStop(BUZZER_PRIORITY_ALARM);  // buzzer stop buzz
+    }
+    InputEventHandled(record);
+
+    snprintf(line, sizeof(line), "box %d %s\r\n", (int)record->channel[SAMPLE_LID_INDEX] + 1,
+             record->channel[SAMPLE_LID_OPEN] ? "open" : "closed");
+    SerialConsoleWriteString(line);
+}
@@ -0,0 +1,38 @@
+/**************************************************************************/ /**
+ * @file      AlarmTask.h
+ * @brief     Alarm task. Reacts to lid events, evaluates the alarm rules as records are published and signals doses
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef ALARM_TASK_H_
+#define ALARM_TASK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define ALARM_TASK_SIZE 250                        ///< Stack of the alarm task (words). Rule actions run on it
+#define ALARM_NOTIFY_SAMPLE (1UL << 0)             ///< Task notification bit set by the sample bus
+#define ALARM_NOTIFY_SCHEDULE (1UL << 1)           ///< Task notification bit set by the RTC dose alarm
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+void vAlarmTask(void *pvParameters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALARM_TASK_H_ */
@@ -1,7 +1,7 @@
   /******************************************************************************
   * @file	 buzzer.c
   * @author  Jimmy
-  * @brief   Buzzer function, including buzzer FreeRTOS task
+  * @brief   Buzzer pattern engine. Tones are generated by TCC1 PWM, pattern timing by TC3 interrupts
   * @date    2024-04-25
   ******************************************************************************/
   
@@ -10,57 +10,233 @@
  ******************************************************************************/
  #include "Buzzer.h"
 
- 
- /******************************************************************************
- * Functions
+ #include <asf.h>
+ #include <FreeRTOS.h>
+ #include <task.h>
+
+ #include "I2cDriver/I2cDriver.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+const Buzzer_Pattern buzzerPatternFire = {"fire", 3000, 50, 500, 250, 0, BUZZER_PRIORITY_ALARM};
+const Buzzer_Pattern buzzerPatternPill = {"pill", 4000, 50, 200, 800, 0, BUZZER_PRIORITY_REMINDER};
+const Buzzer_Pattern buzzerPatternDamage = {"damage", 2000, 50, 50, 0, 1, BUZZER_PRIORITY_CHIRP};
+
+static struct tcc_module buzzerTcc;
+static struct tc_module buzzerTc;
+static uint32_t buzzerTccHz;    ///< TCC1 counter clock
+static uint32_t buzzerTcHz;     ///< TC3 counter clock
+
+static const Buzzer_Pattern *volatile buzzerPattern = NULL;  ///< Pattern playing, NULL if silent
+static uint32_t buzzerCompare;          ///< TCC1 compare value of the tone playing
+static bool buzzerOn;                   ///< True during the tone of a cycle
+static uint8_t buzzerCyclesLeft;        ///< Cycles left, 0 if the pattern repeats until stopped
+static uint32_t buzzerSegmentLeftMs;    ///< Rest of an on/off time longer than BUZZER_SEGMENT_MAX_MS
+static Buzzer_Stats buzzerStats;
+
+/******************************************************************************
+ * Forward Declarations
  ******************************************************************************/
- void buzzer_init();
- 
- 
+static void BuzzerStartSegment(uint32_t ms);
+static void BuzzerSilence(void);
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
  /**
- * @fn			buzzer init
- * @brief		set up the buzzer pin right here
- * @details 	PB02 is set for buzzer pin
- * @return		void
- * @note
+ * @fn			static void BuzzerTimerCallback(struct tc_module *const module)
+ * @brief		TC3 compare interrupt, at the end of each on or off time of the pattern playing
+ * @details 	Mutes or unmutes the TCC1 PWM and loads the next time in TC3. Stops TC3 once the last cycle is played.
+ * @param[in]	module TC3 instance
  */
-void buzzer_init()
-{	
-	struct port_config pin_conf;
-	/* Set buzzer as output*/
-	pin_conf.direction  = PORT_PIN_DIR_OUTPUT;
-	port_pin_set_config(PIN_PB02, &pin_conf);
-	port_pin_set_output_level(PIN_PB02, LED_0_INACTIVE);	//false (0) is open; true (1) is close 
+static void BuzzerTimerCallback(struct tc_module *const module)
+{
+	const Buzzer_Pattern *pattern = buzzerPattern;
+
+	if (pattern == NULL) {
+		tc_stop_counter(module);
+		return;
+	}
+
+	if (buzzerSegmentLeftMs > 0) {
+		BuzzerStartSegment(buzzerSegmentLeftMs);
+		return;
+	}
+
+	if (buzzerOn && pattern->offMs > 0) {
+		tcc_set_compare_value(&buzzerTcc, BUZZER_TCC_CHANNEL, 0);
+		buzzerOn = false;
+		BuzzerStartSegment(pattern->offMs);
+		return;
+	}
+
+	// End of a cycle
+	if (buzzerCyclesLeft > 0 && --buzzerCyclesLeft == 0) {
+		BuzzerSilence();
+		buzzerStats.completed++;
+		return;
+	}
+
+	tcc_set_compare_value(&buzzerTcc, BUZZER_TCC_CHANNEL, buzzerCompare);
+	buzzerOn = true;
+	BuzzerStartSegment(pattern->onMs);
 }
 
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
  /**
- * @fn			buzzer_case
- * @brief		we can switch different buzzer case right here
- * @details 	use the different buzzer case setting up
- * @return		void
- * @note
+ * @fn			int32_t BuzzerInit(void)
+ * @brief		Sets up TCC1 to drive the buzzer pin in PWM, muted, and TC3 to time the patterns
+ * @return		Returns 0 on success, ERROR_IO if a timer could not be configured
+ * @note		The PWM keeps running while muted, only its compare value changes
  */
+int32_t BuzzerInit(void)
+{
+	struct tcc_config config_tcc;
+	struct tc_config config_tc;
+
+	tcc_get_config_defaults(&config_tcc, BUZZER_TCC);
+	config_tcc.counter.clock_source = GCLK_GENERATOR_0;
+	config_tcc.counter.clock_prescaler = TCC_CLOCK_PRESCALER_DIV8;
+	config_tcc.counter.period = 0xFFFF;
+	config_tcc.compare.wave_generation = TCC_WAVE_GENERATION_SINGLE_SLOPE_PWM;
+	config_tcc.compare.match[BUZZER_TCC_CHANNEL] = 0;
+	config_tcc.pins.enable_wave_out_pin[1] = true;
+	config_tcc.pins.wave_out_pin[1] = BUZZER_PIN;
+	config_tcc.pins.wave_out_pin_mux[1] = BUZZER_PIN_MUX;
+	if (tcc_init(&buzzerTcc, BUZZER_TCC, &config_tcc) != STATUS_OK) {
+		return ERROR_IO;
+	}
+	buzzerTccHz = system_gclk_gen_get_hz(GCLK_GENERATOR_0) / 8;
 
-uint8_t buzzer_case(int buzzer_case)
+	tc_get_config_defaults(&config_tc);
+	config_tc.clock_source = GCLK_GENERATOR_0;
+	config_tc.counter_size = TC_COUNTER_SIZE_16BIT;
+	config_tc.clock_prescaler = TC_CLOCK_PRESCALER_DIV1024;
+	config_tc.wave_generation = TC_WAVE_GENERATION_MATCH_FREQ;
+	config_tc.counter_16_bit.compare_capture_channel[TC_COMPARE_CAPTURE_CHANNEL_0] = 0xFFFF;
+	if (tc_init(&buzzerTc, BUZZER_TC, &config_tc) != STATUS_OK) {
+		return ERROR_IO;
+	}
+	buzzerTcHz = system_gclk_gen_get_hz(GCLK_GENERATOR_0) / 1024;
+
+	tc_register_callback(&buzzerTc, BuzzerTimerCallback, TC_CALLBACK_CC_CHANNEL0);
+	tc_enable_callback(&buzzerTc, TC_CALLBACK_CC_CHANNEL0);
+
+	tcc_enable(&buzzerTcc);
+	tc_enable(&buzzerTc);
+	tc_stop_counter(&buzzerTc);
+	return ERROR_NONE;
+}
+
+ /**
+ * @fn			int32_t BuzzerPlay(const Buzzer_Pattern *pattern)
+ * @brief		Starts a pattern and returns right away
+ * @details 	The pattern replaces the one playing if its priority is the same or higher. Posting the pattern that is
+ *				already playing leaves it running from where it is, so periodic callers do not restart it.
+ * @param[in]	pattern Pattern to play. Must stay valid while it plays
+ * @return		Returns 0 if the pattern plays, ERROR_BUSY if a pattern of higher priority is playing,
+ *				ERROR_INVALID_ARG if the pattern has no tone
+ */
+int32_t BuzzerPlay(const Buzzer_Pattern *pattern)
 {
+	if (pattern == NULL || pattern->toneHz == 0 || pattern->onMs == 0) {
+		return ERROR_INVALID_ARG;
+	}
 
-	switch(buzzer_case)
-	{
-		case(BUZZER_QUIET):
-			port_pin_set_output_level(Buzzer,Buzzer_off);
-		break;
-		
-		case(BUZZER_BUZZING):
-			port_pin_set_output_level(Buzzer,Buzzer_on);
-		break;
-		
+	uint32_t top = (buzzerTccHz / pattern->toneHz) - 1;
+	uint32_t compare = (pattern->dutyPercent >= 100) ? (top + 1) : ((top + 1) * pattern->dutyPercent) / 100;
+
+	taskENTER_CRITICAL();
+	const Buzzer_Pattern *current = buzzerPattern;
+	if (current == pattern) {
+		taskEXIT_CRITICAL();
+		return ERROR_NONE;
+	}
+	if (current != NULL && current->priority > pattern->priority) {
+		buzzerStats.rejected++;
+		taskEXIT_CRITICAL();
+		return ERROR_BUSY;
 	}
-	return 0;
+	if (current != NULL) {
+		buzzerStats.preempted++;
+	} else {
+		sleepmgr_lock_mode(SLEEPMGR_IDLE_2);	// TCC1 and TC3 run on GCLK 0, stopped in standby
+	}
+	buzzerStats.played++;
+
+	buzzerPattern = pattern;
+	buzzerCompare = compare;
+	buzzerOn = true;
+	buzzerCyclesLeft = pattern->repeat;
+	tc_stop_counter(&buzzerTc);
+	tc_clear_status(&buzzerTc, TC_STATUS_CHANNEL_0_MATCH);
+	tcc_set_top_value(&buzzerTcc, top);
+	tcc_set_compare_value(&buzzerTcc, BUZZER_TCC_CHANNEL, compare);
+	BuzzerStartSegment(pattern->onMs);
+	tc_start_counter(&buzzerTc);
+	taskEXIT_CRITICAL();
+
+	return ERROR_NONE;
 }
 
-void buzzer_task()
+ /**
+ * @fn			void BuzzerStop(uint8_t priority)
+ * @brief		Silences the buzzer if the pattern playing has a priority up to the one given
+ * @param[in]	priority Highest BUZZER_PRIORITY_* stopped. BUZZER_PRIORITY_ALARM stops any pattern
+ */
+void BuzzerStop(uint8_t priority)
 {
-	buzzer_init();
-	//SerialConsoleWriteString("Buzzer initialization successful");
+	taskENTER_CRITICAL();
+	if (buzzerPattern != NULL && buzzerPattern->priority <= priority) {
+		BuzzerSilence();
+	}
+	taskEXIT_CRITICAL();
+}
 
-}
\ No newline at end of file
+ /**
+ * @fn			void BuzzerGetStats(Buzzer_Stats *stats)
+ * @brief		Copies the counters of the buzzer engine
+ * @param[out]	stats Structure the counters are copied to
+ */
+void BuzzerGetStats(Buzzer_Stats *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = buzzerStats;
+	stats->playing = (buzzerPattern != NULL) ? buzzerPattern->name : NULL;
+	taskEXIT_CRITICAL();
+}
+
+ /**
+ * @fn			static void BuzzerStartSegment(uint32_t ms)
+ * @brief		Loads an on or off time in TC3, split in BUZZER_SEGMENT_MAX_MS parts to fit the 16-bit counter
+ * @param[in]	ms Time until the next transition
+ */
+static void BuzzerStartSegment(uint32_t ms)
+{
+	uint32_t part = (ms > BUZZER_SEGMENT_MAX_MS) ? BUZZER_SEGMENT_MAX_MS : ms;
+
+	buzzerSegmentLeftMs = ms - part;
+	tc_set_count_value(&buzzerTc, 0);
+	tc_set_compare_value(&buzzerTc, TC_COMPARE_CAPTURE_CHANNEL_0, (part * buzzerTcHz) / 1000);
+}
+
+ /**
+ * @fn			static void BuzzerSilence(void)
+ * @brief		Mutes the PWM and stops the pattern timer. Called with interrupts masked or from the TC3 interrupt
+ */
+static void BuzzerSilence(void)
+{
+	if (buzzerPattern != NULL) {
+		sleepmgr_unlock_mode(SLEEPMGR_IDLE_2);
+	}
+	tcc_set_compare_value(&buzzerTcc, BUZZER_TCC_CHANNEL, 0);
+	tc_stop_counter(&buzzerTc);
+	buzzerPattern = NULL;
+	buzzerOn = false;
+	buzzerSegmentLeftMs = 0;
+}
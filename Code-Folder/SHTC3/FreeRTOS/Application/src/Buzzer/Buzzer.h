@@ -1,31 +1,24 @@
   /******************************************************************************
   * @file	 buzzer.h
   * @author  Jimmy
-  * @brief   Buzzer initialization (active buzzer code)
+  * @brief   Buzzer pattern engine. Tones are generated by TCC1 PWM, pattern timing by TC3 interrupts
   * @date    2024-04-25
   ******************************************************************************/
 
 
 /******************************************************************************
  * Descriptions:
- * This is use to change between different types of the buzzer
- *
- * Passive buzzer (the one we bought)
+ * Passive buzzer (the one we bought) on PA11
  * We will have to toggle the pin by ourselves, but we can set different frequency and volumes
  * usually freq 3000 - 5000 will be great volume and large sound
  *
- * Active buzzer
- * simple GPIO toggle pin 
+ * The pin is driven by TCC1 WO[1] in PWM, so the tone costs no CPU. A pattern is a tone, a duty, an on and off time
+ * and a repeat count; TC3 interrupts only at the on/off transitions to mute or unmute the PWM. Callers post a pattern
+ * and return right away, and a pattern of higher priority replaces the one playing.
  ******************************************************************************/
 
-/******************************************************************************
- * Goals:
- * I hope to use active buzzer and set up the PWM system to toggle the pin to come out with different frequency
- * so that when different situations can have different sounds 
- *
- * Backup plans:
- * use an active buzzer and toggle it simple using GPIO
- ******************************************************************************/
+#ifndef BUZZER_H_
+#define BUZZER_H_
 
 /******************************************************************************
  * Includes
@@ -34,37 +27,57 @@
  #include <board.h>
  #include <conf_board.h>
  #include <port.h>
- 
+
 /******************************************************************************
  * Defines
  ******************************************************************************/
-#define Buzzer PIN_PB02 
-#define Buzzer_on false
-#define Buzzer_off true
+#define BUZZER_PIN PIN_PA11E_TCC1_WO1          ///< Buzzer pin, TCC1 WO[1]
+#define BUZZER_PIN_MUX MUX_PA11E_TCC1_WO1
+#define BUZZER_TCC TCC1
+#define BUZZER_TCC_CHANNEL TCC_MATCH_CAPTURE_CHANNEL_1
+#define BUZZER_TC TC3                          ///< Pattern timing
+#define BUZZER_SEGMENT_MAX_MS 1000             ///< Longest on/off time TC3 counts at once, longer ones are split
 
 /******************************************************************************
  * Structures and Enumerations
  ******************************************************************************/
-
+/// Pattern priorities. A pattern replaces a playing pattern of the same or lower priority
 enum {
-	MEASURE_READY = 0, /* Not ready. */
-	BUZZER_QUIET = 1,  /* When the buzzer is turn off*/
-	BUZZER_BUZZING = 2 /* When the buzzer is open*/
-					   /* Buzzer buzzing 3000 freq*/
-					   /* Buzzer buzzing 4000 freq*/
-					   /* Buzzer buzzing 5000 freq*/
-} buzzer_state;
+	BUZZER_PRIORITY_CHIRP = 0,     ///< Short notifications
+	BUZZER_PRIORITY_REMINDER = 1,  ///< Pill reminder, until a lid is opened
+	BUZZER_PRIORITY_ALARM = 2,     ///< Fire alarm
+};
+
+/// Buzzer pattern: repeat times, the tone for onMs then silence for offMs
+typedef struct Buzzer_Pattern {
+	const char *name;      ///< Name printed by the CLI
+	uint16_t toneHz;       ///< Tone frequency
+	uint8_t dutyPercent;   ///< PWM duty, sets the volume. 100 drives the pin high (active buzzer)
+	uint16_t onMs;         ///< Tone time of a cycle
+	uint16_t offMs;        ///< Silence after the tone, 0 for none
+	uint8_t repeat;        ///< Cycles to play, 0 plays until stopped or replaced
+	uint8_t priority;      ///< BUZZER_PRIORITY_*
+} Buzzer_Pattern;
 
+/// Counters of the buzzer engine
+typedef struct Buzzer_Stats {
+	const char *playing;   ///< Name of the pattern playing, NULL if silent
+	uint32_t played;       ///< Patterns started
+	uint32_t preempted;    ///< Patterns replaced before their end
+	uint32_t rejected;     ///< Patterns refused because one of higher priority was playing
+	uint32_t completed;    ///< Patterns that played all their cycles
+} Buzzer_Stats;
+
+extern const Buzzer_Pattern buzzerPatternFire;
+extern const Buzzer_Pattern buzzerPatternPill;
+extern const Buzzer_Pattern buzzerPatternDamage;
 
 /******************************************************************************
  * Global Function Declaration
  ******************************************************************************/
+int32_t BuzzerInit(void);
+int32_t BuzzerPlay(const Buzzer_Pattern *pattern);
+void BuzzerStop(uint8_t priority);
+void BuzzerGetStats(Buzzer_Stats *stats);
 
-#ifndef BUZZER_H_
-#define BUZZER_H_
-
-void buzzer_init();
-uint8_t buzzer_case();
-void buzzer_task();
-
-#endif /* BUZZER_H_ */
\ No newline at end of file
+#endif /* BUZZER_H_ */
@@ -0,0 +1,233 @@
+/**************************************************************************/ /**
+ * @file      Chart.c
+ * @brief     Sparkline charts of the OLED. One column per interval, drawn incrementally into the framebuffer
+ * @details   Samples are averaged over span / width; when an interval closes its average becomes one column, a line
+ *            from the row of the previous column to its own, and an interval without samples a blank column. Only the
+ *            new column is drawn: the framebuffer holds the rest of the trace, so no history is kept. In scroll mode
+ *            the chart region is shifted one column left in the framebuffer first, which marks dirty only the bytes
+ *            that change. The SSD1306 hardware scroll (26h/27h) is not used: it moves the picture at a rate set in
+ *            frames, not by one column on command, and the RAM has to be rewritten once it is stopped. In sweep mode
+ *            the trace stays and a cursor overwrites the oldest column, with a blank column ahead of it, so a tick
+ *            sends two columns. The scale is fixed, so the trace never has to be redrawn from history. The charts are
+ *            not locked: they are fed and rendered by the display task alone.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Chart/Chart.h"
+
+#include <task.h>
+
+#include "I2cDriver/I2cDriver.h"
+#include "OLED/SSD1306.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define CHART_PENDING 4  ///< Closed columns waiting to be drawn. More are dropped, oldest first
+#define CHART_GAP -1     ///< Row of a column without samples
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Runtime state of one chart
+typedef struct Chart_State {
+    const Chart_Def *def;
+    TickType_t interval;            ///< Ticks per column
+    TickType_t close;               ///< Tick the current interval closes at
+    int32_t sum;                    ///< Samples of the current interval
+    uint16_t count;
+    int8_t lastRow;                 ///< Row of the last column drawn, from the top, CHART_GAP if blank
+    uint8_t cursor;                 ///< Sweep mode: column the next one is drawn in
+    uint8_t pending;                ///< Entries of pendingRow
+    int8_t pendingRow[CHART_PENDING];
+} Chart_State;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static Chart_State chartState[CHART_MAX];
+static uint8_t chartCount;
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static int8_t ChartRow(const Chart_Def *def, int32_t value);
+static void ChartClose(Chart_State *state);
+static void ChartDrawColumn(Chart_State *state, uint8_t column, int8_t row);
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static int8_t ChartRow(const Chart_Def *def, int32_t value)
+ * @brief       Row of a value, from the top of the chart. Values out of the scale are drawn on its edge
+ */
+static int8_t ChartRow(const Chart_Def *def, int32_t value)
+{
+    if (value < def->min) {
+        value = def->min;
+    } else if (value > def->max) {
+        value = def->max;
+    }
+    return (int8_t)(((def->max - value) * (def->height - 1)) / (def->max - def->min));
+}
+
+/**
+ * @fn			static void ChartClose(Chart_State *state)
+ * @brief       Turns the samples of the interval into a column waiting to be drawn, and starts the next interval
+ */
+static void ChartClose(Chart_State *state)
+{
+    int8_t row = (state->count > 0) ? ChartRow(state->def, state->sum / (int32_t)state->count) : CHART_GAP;
+
+    if (state->pending == CHART_PENDING) {
+        for (uint8_t i = 1; i < CHART_PENDING; i++) {
+            state->pendingRow[i - 1] = state->pendingRow[i];
+        }
+        state->pending--;
+    }
+    state->pendingRow[state->pending++] = row;
+    state->sum = 0;
+    state->count = 0;
+}
+
+/**
+ * @fn			static void ChartDrawColumn(Chart_State *state, uint8_t column, int8_t row)
+ * @brief       Draws one column: a line from the row of the previous column to row, or nothing for a gap
+ * @details     The column is built as a bitmap and drawn in one go, so only the bytes that differ from the framebuffer
+ *              are marked dirty
+ */
+static void ChartDrawColumn(Chart_State *state, uint8_t column, int8_t row)
+{
+    const Chart_Def *def = state->def;
+    uint8_t bits[SSD1306_HEIGHT / 8] = {0};
+
+    if (row != CHART_GAP) {
+        int8_t from = (state->lastRow != CHART_GAP) ? state->lastRow : row;
+        int8_t top = (from < row) ? from : row;
+        int8_t bottom = (from < row) ? row : from;
+        for (int8_t r = top; r <= bottom; r++) {
+            bits[r / 8] |= 1 << (r % 8);
+        }
+    }
+    SSD1306_DrawBitmap(def->x + column, def->y, 1, def->height, bits, SSD1306_COLOR_WHITE);
+    state->lastRow = row;
+}
+
+/**
+ * @fn			int32_t ChartAdd(const Chart_Def *def)
+ * @brief       Adds a chart. Its first interval starts now, the region is left as it is until columns are drawn
+ * @param[in]   def Chart description. Must stay valid: it is not copied
+ * @return      Returns the index of the chart, ERROR_NO_RESOURCE if CHART_MAX are added, ERROR_INVALID_ARG if the
+ *              region does not cover whole pages of the screen or the scale or span is empty
+ */
+int32_t ChartAdd(const Chart_Def *def)
+{
+    if (def->mode >= CHART_MODE_MAX || def->width < 2 || def->x + def->width > SSD1306_WIDTH || def->y % 8 != 0 ||
+        def->height == 0 || def->height % 8 != 0 || def->y + def->height > SSD1306_HEIGHT || def->max <= def->min ||
+        def->spanMinutes == 0) {
+        return ERROR_INVALID_ARG;
+    }
+    if (chartCount >= CHART_MAX) {
+        return ERROR_NO_RESOURCE;
+    }
+
+    Chart_State *state = &chartState[chartCount];
+    state->def = def;
+    state->interval = pdMS_TO_TICKS(def->spanMinutes * 60000UL / def->width);
+    state->close = xTaskGetTickCount() + state->interval;
+    state->sum = 0;
+    state->count = 0;
+    state->lastRow = CHART_GAP;
+    state->cursor = 0;
+    state->pending = 0;
+    return chartCount++;
+}
+
+/**
+ * @fn			void ChartSample(uint8_t index, int32_t value)
+ * @brief       Adds a sample to the current interval of a chart
+ */
+void ChartSample(uint8_t index, int32_t value)
+{
+    if (index >= chartCount) {
+        return;
+    }
+    Chart_State *state = &chartState[index];
+    if (state->count < UINT16_MAX) {
+        state->sum += value;
+        state->count++;
+    }
+}
+
+/**
+ * @fn			void ChartUpdate(TickType_t now)
+ * @brief       Closes the intervals that ended by now. Call at least once per interval, and before ChartIsDirty()
+ */
+void ChartUpdate(TickType_t now)
+{
+    for (uint8_t i = 0; i < chartCount; i++) {
+        Chart_State *state = &chartState[i];
+        uint8_t closed = 0;
+        while ((int32_t)(now - state->close) >= 0) {
+            ChartClose(state);
+            state->close += state->interval;
+            // After a long stall, the blank columns would all be dropped anyway: restart from now
+            if (++closed >= CHART_PENDING) {
+                state->close = now + state->interval;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @fn			bool ChartIsDirty(void)
+ * @brief       Tells if a chart has columns to draw
+ */
+bool ChartIsDirty(void)
+{
+    for (uint8_t i = 0; i < chartCount; i++) {
+        if (chartState[i].pending > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @fn			uint8_t ChartRender(void)
+ * @brief       Draws the waiting columns of every chart into the framebuffer. SSD1306_UpdateScreen() sends them
+ * @return      Returns the number of columns drawn
+ */
+uint8_t ChartRender(void)
+{
+    uint8_t drawn = 0;
+
+    for (uint8_t i = 0; i < chartCount; i++) {
+        Chart_State *state = &chartState[i];
+        const Chart_Def *def = state->def;
+
+        for (uint8_t p = 0; p < state->pending; p++) {
+            if (def->mode == CHART_MODE_SCROLL) {
+                SSD1306_ShiftLeft(def->x, def->width, def->y / 8, (def->y + def->height) / 8 - 1);
+                ChartDrawColumn(state, def->width - 1, state->pendingRow[p]);
+            } else {
+                ChartDrawColumn(state, state->cursor, state->pendingRow[p]);
+                state->cursor = (state->cursor + 1) % def->width;
+                // Blank column ahead of the cursor, to show where the trace is written
+                int8_t lastRow = state->lastRow;
+                ChartDrawColumn(state, state->cursor, CHART_GAP);
+                state->lastRow = lastRow;
+            }
+            drawn++;
+        }
+        state->pending = 0;
+    }
+    return drawn;
+}
@@ -0,0 +1,63 @@
+/**************************************************************************/ /**
+ * @file      Chart.h
+ * @brief     Sparkline charts of the OLED. One column per interval, drawn incrementally into the framebuffer
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef CHART_H_
+#define CHART_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define CHART_MAX 2                ///< Charts that can be added
+#define CHART_SPAN_24H (24 * 60)   ///< Span of a 24-hour chart, minutes
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// How a chart makes room for a new column
+typedef enum eChartMode {
+    CHART_MODE_SCROLL = 0,  ///< The trace moves left, the newest column is on the right. Sends the bytes that change
+    CHART_MODE_SWEEP,       ///< The trace stays, a cursor sweeps over it with a blank gap ahead. Sends two columns
+    CHART_MODE_MAX,
+} eChartMode;
+
+/// Constant description of a chart
+typedef struct Chart_Def {
+    uint8_t mode;         ///< eChartMode
+    uint8_t x;            ///< Left column, pixels
+    uint8_t y;            ///< Top row, pixels. Multiple of 8: the chart covers whole pages
+    uint8_t width;        ///< Columns, at least 2
+    uint8_t height;       ///< Rows. Multiple of 8
+    uint16_t spanMinutes; ///< Time the width covers, e.g. CHART_SPAN_24H. A column is the average over span / width
+    int32_t min;          ///< Value at the bottom row. Fixed, so the trace never has to be rescaled and redrawn
+    int32_t max;          ///< Value at the top row
+} Chart_Def;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t ChartAdd(const Chart_Def *def);
+void ChartSample(uint8_t index, int32_t value);
+void ChartUpdate(TickType_t now);
+bool ChartIsDirty(void);
+uint8_t ChartRender(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHART_H_ */
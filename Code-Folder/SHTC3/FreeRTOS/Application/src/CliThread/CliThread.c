@@ -11,7 +11,24 @@
  ******************************************************************************/
 #include "CliThread.h"
 
+#include "Acquisition/Acquisition.h"
+#include "Buzzer/Buzzer.h"
+#include "CpuStats/CpuStats.h"
+#include "Defer/Defer.h"
+#include "Display/DisplayTask.h"
+#include "Exec/Exec.h"
 #include "I2cDriver/I2cDriver.h"
+#include "IMU/ImuTask.h"
+#include "IMU/lsm6dso_reg.h"
+#include "Input/Input.h"
+#include "MemPool/MemPool.h"
+#include "OLED/SSD1306.h"
+#include "Power/Power.h"
+#include "Rules/Rules.h"
+#include "SHTC3/SHTC3.h"
+#include "Schedule/Schedule.h"
+#include "SampleBus/SampleBus.h"
+#include "StackMon/StackMon.h"
 #include "WifiHandlerThread/WifiHandler.h"
 
 /******************************************************************************
@@ -29,10 +46,29 @@ static const CLI_Command_Definition_t xResetCommand = {"reset", "reset: Resets t
 static const CLI_Command_Definition_t xI2cScan = {"i2c", "i2c: Scans I2C bus\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_i2cScan, 0};
 static const CLI_Command_Definition_t xVersion = {"version", "version: print the firmware version\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_version,0};
 static const CLI_Command_Definition_t xTicks = {"ticks", "ticks: print the ticks since scheduler started\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_ticks,0};
+static const CLI_Command_Definition_t xI2cStats = {"i2cstats", "i2cstats: print the I2C transaction engine counters\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_i2cStats, 0};
+static const CLI_Command_Definition_t xShtc3 = {"shtc3", "shtc3 [lpm|nm]: print SHTC3 counters, optionally select low power or normal measurements\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Shtc3, -1};
+static const CLI_Command_Definition_t xI2cDma = {"i2cdma", "i2cdma <bytes>: send I2C writes of at least <bytes> through DMA (0 disables DMA)\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_i2cDma, 1};
+static const CLI_Command_Definition_t xAcq = {"acq", "acq: print the sampling period, counters and jitter of each sensor\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Acq, 0};
+static const CLI_Command_Definition_t xBus = {"bus", "bus: print the sample bus subscribers, their drops and depth high-water marks\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Bus, 0};
+static const CLI_Command_Definition_t xImu = {"imu", "imu: print the IMU FIFO counters, wakeups and I2C transactions per second of data, and the IMU events\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Imu, 0};
+static const CLI_Command_Definition_t xLids = {"lids", "lids: print the state of each lid, its edge, event and glitch counters and the event latency\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Lids, 0};
+static const CLI_Command_Definition_t xBuzzer = {"buzzer", "buzzer: print the buzzer pattern playing and the pattern counters\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Buzzer, 0};
+static const CLI_Command_Definition_t xRules = {"rules", "rules: print the alarm rules, their state and how many times they were raised\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Rules, 0};
+static const CLI_Command_Definition_t xSched = {"sched", "sched: print the RTC time, the next dose alarm and the dose slots of the medication schedule\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Sched, 0};
+static const CLI_Command_Definition_t xPower = {"power", "power: print the time spent active and in each sleep mode, and the sleep counters\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Power, 0};
+static const CLI_Command_Definition_t xTop = {"top", "top [seconds]: print the CPU usage, state, priority and free stack of each task and the interrupt time, since boot or over the last seconds\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Top, -1};
+static const CLI_Command_Definition_t xMem = {"mem", "mem: print the use, high-water mark, spills and failures of each memory pool\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Mem, 0};
+static const CLI_Command_Definition_t xStack = {"stack", "stack [clear]: print the stack size, fewest free words since boot and since the history started, and the recommended size of each task\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Stack, -1};
+static const CLI_Command_Definition_t xExec = {"exec", "exec: print the period, lane, counters, release jitter, run and response time of each executor job\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Exec, 0};
+static const CLI_Command_Definition_t xDefer = {"defer", "defer: print the deferred interrupt events, drops and post-to-handler latency (us)\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Defer, 0};
+static const CLI_Command_Definition_t xWifi = {"wifi", "wifi: print the wake-ups of the Wi-Fi task by source and the sample-to-publish latency (ms)\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Wifi, 0};
+static const CLI_Command_Definition_t xOled = {"oled", "oled: print the dashboard frames, the frames postponed by a busy I2C bus and the bytes sent\r\n", (const pdCOMMAND_LINE_CALLBACK)CLI_Oled, 0};
 		
 const CLI_Command_Definition_t xClearScreen = {CLI_COMMAND_CLEAR_SCREEN, CLI_HELP_CLEAR_SCREEN, CLI_CALLBACK_CLEAR_SCREEN, CLI_PARAMS_CLEAR_SCREEN};
 
 SemaphoreHandle_t cliCharReadySemaphore;  ///< Semaphore to indicate that a character has been received
+static StaticSemaphore_t cliCharReadySemaphoreBuffer;
 
 /******************************************************************************
  * Forward Declarations
@@ -56,6 +92,27 @@ void vCommandConsoleTask(void *pvParameters)
     FreeRTOS_CLIRegisterCommand(&xI2cScan);
 	FreeRTOS_CLIRegisterCommand(&xVersion);
 	FreeRTOS_CLIRegisterCommand(&xTicks);
+    FreeRTOS_CLIRegisterCommand(&xI2cStats);
+    FreeRTOS_CLIRegisterCommand(&xI2cDma);
+    FreeRTOS_CLIRegisterCommand(&xShtc3);
+    FreeRTOS_CLIRegisterCommand(&xAcq);
+    FreeRTOS_CLIRegisterCommand(&xBus);
+    FreeRTOS_CLIRegisterCommand(&xImu);
+    FreeRTOS_CLIRegisterCommand(&xLids);
+    FreeRTOS_CLIRegisterCommand(&xBuzzer);
+    FreeRTOS_CLIRegisterCommand(&xRules);
+    FreeRTOS_CLIRegisterCommand(&xSched);
+    FreeRTOS_CLIRegisterCommand(&xPower);
+    FreeRTOS_CLIRegisterCommand(&xTop);
+    FreeRTOS_CLIRegisterCommand(&xMem);
+    FreeRTOS_CLIRegisterCommand(&xStack);
+    FreeRTOS_CLIRegisterCommand(&xExec);
+    FreeRTOS_CLIRegisterCommand(&xDefer);
+    FreeRTOS_CLIRegisterCommand(&xWifi);
+    FreeRTOS_CLIRegisterCommand(&xOled);
+
+    // The console receives on GCLK 0, stopped in standby: while the CLI runs the box sleeps in IDLE 2 at most
+    sleepmgr_lock_mode(SLEEPMGR_IDLE_2);
 
     char cRxedChar[2];
     unsigned char cInputIndex = 0;
@@ -75,7 +132,7 @@ void vCommandConsoleTask(void *pvParameters)
     SerialConsoleWriteString((char *)pcWelcomeMessage);
 
     // Any semaphores/mutexes/etc you needed to be initialized, you can do them here
-    cliCharReadySemaphore = xSemaphoreCreateBinary();
+    cliCharReadySemaphore = xSemaphoreCreateBinaryStatic(&cliCharReadySemaphoreBuffer);
     if (cliCharReadySemaphore == NULL) {
         LogMessage(LOG_ERROR_LVL, "Could not allocate semaphore\r\n");
         vTaskSuspend(NULL);
@@ -321,3 +378,573 @@ BaseType_t CLI_i2cScan(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8
     SerialConsoleWriteString("\r\n");
     return pdFALSE;
 }
+
+/**
+ * @brief    Prints the I2C transaction engine counters (queueing overhead, bus utilisation, ISR vs DMA cost)
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_i2cStats(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static I2C_Engine_Stats stats;
+    static uint8_t line = 0;
+    char *out = (char *)pcWriteBuffer;
+
+    if (line == 0) {
+        I2cGetEngineStats(&stats);
+    }
+
+    switch (line) {
+        case 0:
+            snprintf(out, xWriteBufferLen, "sub:%lu ok:%lu err:%lu cancel:%lu\r\n", (unsigned long)stats.submitted,
+                     (unsigned long)stats.completed, (unsigned long)stats.errors, (unsigned long)stats.cancelled);
+            break;
+
+        case 1: {
+            uint32_t finished = stats.completed + stats.errors;
+            uint32_t avgWait = (finished > 0) ? (stats.waitTicks / finished) : 0;
+            uint32_t busyPermille = (uint32_t)(((uint64_t)stats.busyTicks * 1000) / (xTaskGetTickCount() + 1));
+            snprintf(out, xWriteBufferLen, "queue:%lu max:%lu wait avg:%lu max:%lu ticks busy:%lu.%lu%%\r\n",
+                     (unsigned long)stats.queueDepth, (unsigned long)stats.maxQueueDepth, (unsigned long)avgWait,
+                     (unsigned long)stats.maxWaitTicks, (unsigned long)(busyPermille / 10), (unsigned long)(busyPermille % 10));
+            break;
+        }
+
+        case 2:
+            snprintf(out, xWriteBufferLen, "isr: %lu xfer %lu B %lu irq %lu us\r\n", (unsigned long)stats.isr.transactions,
+                     (unsigned long)stats.isr.bytes, (unsigned long)stats.isr.interrupts, (unsigned long)stats.isr.busyUs);
+            break;
+
+        default:
+            snprintf(out, xWriteBufferLen, "dma: %lu xfer %lu B %lu irq %lu us (threshold %u)\r\n",
+                     (unsigned long)stats.dma.transactions, (unsigned long)stats.dma.bytes, (unsigned long)stats.dma.interrupts,
+                     (unsigned long)stats.dma.busyUs, I2cGetDmaThreshold());
+            line = 0;
+            return pdFALSE;
+    }
+
+    line++;
+    return pdTRUE;
+}
+
+/**
+ * @brief    Sets the size from which I2C writes go through DMA, to compare both transfer paths with i2cstats
+ ******************************************************************************/
+BaseType_t CLI_i2cDma(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    BaseType_t paramLen;
+    const char *param = FreeRTOS_CLIGetParameter((const char *)pcCommandString, 1, &paramLen);
+
+    I2cSetDmaThreshold((uint16_t)atoi(param));
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "DMA threshold: %u\r\n", I2cGetDmaThreshold());
+    return pdFALSE;
+}
+
+/**
+ * @brief    Prints the SHTC3 driver counters, and switches between low power and normal measurements
+ ******************************************************************************/
+BaseType_t CLI_Shtc3(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    BaseType_t paramLen;
+    const char *param = FreeRTOS_CLIGetParameter((const char *)pcCommandString, 1, &paramLen);
+    SHTC3_Stats stats;
+
+    if (param != NULL) {
+        if (strncmp(param, "lpm", paramLen) == 0) {
+            SHTC3_SetPowerMode(SHTC3_POWER_LOW);
+        } else if (strncmp(param, "nm", paramLen) == 0) {
+            SHTC3_SetPowerMode(SHTC3_POWER_NORMAL);
+        }
+    }
+
+    SHTC3_GetStats(&stats);
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%s ok:%lu crc:%lu i2c:%lu awake:%lu ticks bus:%lu us (last %lu)\r\n",
+             (SHTC3_GetPowerMode() == SHTC3_POWER_LOW) ? "lpm" : "nm", (unsigned long)stats.samples,
+             (unsigned long)stats.crcErrors, (unsigned long)stats.busErrors, (unsigned long)stats.awakeTicks,
+             (unsigned long)stats.busUs, (unsigned long)stats.lastBusUs);
+    return pdFALSE;
+}
+
+/**
+ * @brief    Prints one line per sensor of the acquisition scheduler: period, counters, release jitter and hook run time
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Acq(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t index = 0;
+    const Acq_Sensor *sensor = AcqGetSensor(index);
+    Acq_Sensor_Stats stats;
+
+    AcqGetSensorStats(index, &stats);
+    if (!stats.enabled) {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%s: disabled\r\n", sensor->name);
+    } else {
+        uint32_t released = stats.samples + stats.errors;
+        uint32_t avgJitter = (released > 0) ? (stats.sumJitterTicks / released) : 0;
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%s %lums ok:%lu err:%lu ovr:%lu jit:%lu/%lu/%lu run:%lu\r\n",
+                 sensor->name, (unsigned long)sensor->periodMs, (unsigned long)stats.samples, (unsigned long)stats.errors,
+                 (unsigned long)stats.overruns, (unsigned long)stats.lastJitterTicks, (unsigned long)stats.maxJitterTicks,
+                 (unsigned long)avgJitter, (unsigned long)stats.maxRunTicks);
+    }
+
+    if (++index >= AcqGetSensorCount()) {
+        index = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the number of records published on the sample bus, then one line per subscriber
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Bus(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t line = 0;
+    Sample_Subscriber_Stats stats;
+
+    if (line == 0) {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "published:%lu depth:%u\r\n", (unsigned long)SampleBusGetPublished(),
+                 SAMPLE_BUS_DEPTH);
+    } else {
+        SampleBusGetSubscriberStats(line - 1, &stats);
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%s rx:%lu drop:%lu depth:%lu max:%lu\r\n", stats.name,
+                 (unsigned long)stats.received, (unsigned long)stats.drops, (unsigned long)stats.depth,
+                 (unsigned long)stats.maxDepth);
+    }
+
+    if (++line > SampleBusGetSubscriberCount()) {
+        line = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the IMU FIFO pipeline counters, the wakeups and I2C transactions per second of sampled data, then the
+ *           embedded function event counters
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Imu(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static Imu_Fifo_Stats stats;
+    static uint8_t line = 0;
+
+    if (line == 2) {
+        Imu_Event_Stats events;
+        ImuGetEventStats(&events);
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "evt wake:%lu drop:%lu move:%lu tap:%lu/%lu tilt:%lu still:%lu\r\n",
+                 (unsigned long)events.wakeups, (unsigned long)events.freeFalls, (unsigned long)events.wakeUps,
+                 (unsigned long)events.taps, (unsigned long)events.doubleTaps, (unsigned long)events.orientations,
+                 (unsigned long)events.sleepChanges);
+        line = 0;
+        return pdFALSE;
+    }
+
+    if (line == 0) {
+        ImuGetFifoStats(&stats);
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "wake:%lu smp:%lu batch:%lu drop:%lu ovr:%lu tag:%lu err:%lu\r\n",
+                 (unsigned long)stats.wakeups, (unsigned long)stats.samples, (unsigned long)stats.batches,
+                 (unsigned long)stats.uplinkDrops, (unsigned long)stats.overruns, (unsigned long)stats.otherTags,
+                 (unsigned long)stats.errors);
+        line = 1;
+        return pdTRUE;
+    }
+
+    // Rates in hundredths, per second of data: count * ODR / samples
+    uint32_t i2c = ImuGetBusTransactions();
+    uint32_t wakeRate = (stats.samples > 0) ? (uint32_t)(((uint64_t)stats.wakeups * 100 * IMU_FIFO_ODR_HZ) / stats.samples) : 0;
+    uint32_t i2cRate = (stats.samples > 0) ? (uint32_t)(((uint64_t)i2c * 100 * IMU_FIFO_ODR_HZ) / stats.samples) : 0;
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "i2c:%lu per s of data: wake %lu.%02lu i2c %lu.%02lu\r\n", (unsigned long)i2c,
+             (unsigned long)(wakeRate / 100), (unsigned long)(wakeRate % 100), (unsigned long)(i2cRate / 100),
+             (unsigned long)(i2cRate % 100));
+    line = 2;
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints one line per lid: debounced state, raw edges, published events, glitches and the first edge to handler
+ *           latency (last/max/average, ticks)
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Lids(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t index = 0;
+    Input_Stats stats;
+
+    InputGetStats(index, &stats);
+    uint32_t avgLatency = (stats.handled > 0) ? (stats.sumLatencyTicks / stats.handled) : 0;
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "lid%u %s edge:%lu evt:%lu glitch:%lu lat:%lu/%lu/%lu\r\n",
+             (unsigned)(index + 1), stats.open ? "open" : "closed", (unsigned long)stats.edges, (unsigned long)stats.events,
+             (unsigned long)stats.glitches, (unsigned long)stats.lastLatencyTicks, (unsigned long)stats.maxLatencyTicks,
+             (unsigned long)avgLatency);
+
+    if (++index >= INPUT_MAX) {
+        index = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the buzzer pattern playing and how many patterns were played, pre-empted, refused and completed
+ ******************************************************************************/
+BaseType_t CLI_Buzzer(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    Buzzer_Stats stats;
+
+    BuzzerGetStats(&stats);
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%s played:%lu preempt:%lu busy:%lu done:%lu\r\n",
+             (stats.playing != NULL) ? stats.playing : "silent", (unsigned long)stats.played, (unsigned long)stats.preempted,
+             (unsigned long)stats.rejected, (unsigned long)stats.completed);
+    return pdFALSE;
+}
+
+/**
+ * @brief    Prints one line per alarm rule slot: sensor, channel, condition, dwell time, action and state
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Rules(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t index = 0;
+    Rule rule;
+    Rule_Status status;
+
+    RulesGet(index, &rule, &status);
+    if (rule.action == RULE_ACTION_NONE) {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%u: -\r\n", (unsigned)index);
+    } else {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%u: s%u c%u %c %ld h%ld %lums %s %s raised:%lu last:%ld\r\n",
+                 (unsigned)index, (unsigned)rule.sensor, (unsigned)rule.channel, (rule.comparator == RULE_ABOVE) ? '>' : '<',
+                 (long)rule.threshold, (long)rule.hysteresis, (unsigned long)rule.dwellMs, RulesGetActionName(rule.action),
+                 status.active ? "ON" : (status.pending ? "dwell" : "off"), (unsigned long)status.raised,
+                 (long)status.lastValue);
+    }
+
+    if (++index >= RULES_MAX) {
+        index = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the local time of the RTC, the time zone, the armed dose alarm and the schedule counters, then one
+ *           line per dose slot. "unsaved" means the slots could not be written to flash
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Sched(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t line = 0;
+
+    if (line == 0) {
+        Schedule_Stats stats;
+        uint16_t year;
+        uint8_t month, day, hour, minute;
+        char next[20] = "none";
+
+        ScheduleGetStats(&stats);
+        if (stats.nextMinute != 0) {
+            ScheduleMinuteToDate(stats.nextMinute, &year, &month, &day, &hour, &minute);
+            snprintf(next, sizeof(next), "%02u-%02u %02u:%02u", month, day, hour, minute);
+        }
+        if (!stats.timeValid) {
+            snprintf((char *)pcWriteBuffer, xWriteBufferLen, "time not set, tz:%d%s next:%s\r\n", stats.utcOffsetMin,
+                     stats.stored ? "" : " unsaved", next);
+        } else {
+            ScheduleMinuteToDate(ScheduleGetMinute(), &year, &month, &day, &hour, &minute);
+            snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%04u-%02u-%02u %02u:%02u tz:%d%s next:%s due:%u fired:%lu late:%lu sets:%lu\r\n",
+                     year, month, day, hour, minute, stats.utcOffsetMin, stats.stored ? "" : " unsaved", next,
+                     stats.pending, (unsigned long)stats.fired, (unsigned long)stats.late, (unsigned long)stats.timeSets);
+        }
+    } else {
+        Schedule_Entry entry;
+        ScheduleGet(line - 1, &entry);
+        if (entry.days == 0) {
+            snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%u: -\r\n", (unsigned)(line - 1));
+        } else {
+            snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%u: box %u %02u:%02u days %02x\r\n", (unsigned)(line - 1),
+                     (unsigned)entry.compartment + 1, entry.hour, entry.minute, entry.days);
+        }
+    }
+
+    if (++line > SCHEDULE_MAX_ENTRIES) {
+        line = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the uptime and the time spent active, then the time and sleeps of each sleep mode, then the sleep
+ *           counters
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Power(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static const char *const modeNames[SLEEPMGR_NR_OF_MODES] = {"active", "idle0", "idle1", "idle2", "standby"};
+    static uint8_t line = 0;
+    Power_Stats stats;
+
+    PowerGetStats(&stats);
+    if (line == 0) {
+        uint32_t up = xTaskGetTickCount();
+        uint32_t slept = 0;
+        for (uint8_t mode = SLEEPMGR_IDLE_0; mode < SLEEPMGR_NR_OF_MODES; mode++) {
+            slept += stats.ticks[mode];
+        }
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "up:%lums active:%lums (%lu%%)\r\n",
+                 (unsigned long)(up * portTICK_PERIOD_MS), (unsigned long)((up - slept) * portTICK_PERIOD_MS),
+                 (unsigned long)((up > 0) ? ((uint64_t)(up - slept) * 100) / up : 100));
+    } else if (line < SLEEPMGR_NR_OF_MODES) {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%s: %lums in %lu sleeps\r\n", modeNames[line],
+                 (unsigned long)(stats.ticks[line] * portTICK_PERIOD_MS), (unsigned long)stats.sleeps[line]);
+    } else {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "timer wakeups:%lu aborted:%lu kept awake:%lu\r\n",
+                 (unsigned long)stats.timerWakeups, (unsigned long)stats.aborted,
+                 (unsigned long)stats.sleeps[SLEEPMGR_ACTIVE]);
+    }
+
+    if (++line > SLEEPMGR_NR_OF_MODES) {
+        line = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the CPU usage of each task, busiest first, then of each interrupt source that fired
+ * @details  Without argument the usage since boot is shown, else the usage over the last seconds, up to
+ *           CPU_STATS_WINDOW_MAX. The usage of a task includes the interrupts that preempted it.
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Top(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static const char taskStates[] = {'X', 'R', 'B', 'S', 'D'};
+    static CpuStats_Task tasks[CPU_STATS_MAX_TASKS];
+    static CpuStats_Window window;
+    static uint8_t taskCount = 0;
+    static uint8_t line = 0;
+    static uint8_t isr = 0;
+
+    if (line == 0) {
+        BaseType_t paramLen;
+        const char *param = FreeRTOS_CLIGetParameter((const char *)pcCommandString, 1, &paramLen);
+        int seconds = (param != NULL) ? atoi(param) : 0;
+        if (seconds < 0) {
+            seconds = 0;
+        } else if (seconds > CPU_STATS_WINDOW_MAX) {
+            seconds = CPU_STATS_WINDOW_MAX;
+        }
+
+        taskCount = CpuStatsGetTop((uint8_t)seconds, tasks, CPU_STATS_MAX_TASKS, &window);
+        isr = 0;
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%s %lums, %u tasks\r\n", (seconds == 0) ? "since boot" : "last",
+                 (unsigned long)window.ms, taskCount);
+    } else if (line <= taskCount) {
+        const CpuStats_Task *task = &tasks[line - 1];
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%-8s %c p%u stack:%uB %3u.%u%%\r\n", task->name,
+                 (task->state < sizeof(taskStates)) ? taskStates[task->state] : '?', (unsigned)task->priority,
+                 task->stackFree, task->permille / 10, task->permille % 10);
+    } else {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "isr %-7s %lu irq %3u.%u%%\r\n", CpuStatsGetIsrName(isr),
+                 (unsigned long)window.isrCount[isr], window.isrPermille[isr] / 10, window.isrPermille[isr] % 10);
+        isr++;
+    }
+
+    if (++line <= taskCount) {
+        return pdTRUE;
+    }
+    while (isr < CPU_STATS_ISR_MAX && window.isrCount[isr] == 0) {
+        isr++;
+    }
+    if (isr < CPU_STATS_ISR_MAX) {
+        return pdTRUE;
+    }
+    line = 0;
+    return pdFALSE;
+}
+
+/**
+ * @brief    Prints the free heap, then one line per memory pool: blocks used, high-water mark, allocations, spills to a
+ *           bigger class and failures. The large region is counted in bytes
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Mem(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t line = 0;
+
+    if (line == 0) {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "free:%u min:%u of %u bytes\r\n", (unsigned)xPortGetFreeHeapSize(),
+                 (unsigned)xPortGetMinimumEverFreeHeapSize(), (unsigned)configTOTAL_HEAP_SIZE);
+    } else {
+        MemPool_Stats stats;
+        MemPoolGetStats(line - 1, &stats);
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%-5s %u/%u max:%u allocs:%lu spills:%lu fails:%lu\r\n", stats.name,
+                 stats.used, stats.blocks, stats.highWater, (unsigned long)stats.allocs, (unsigned long)stats.spills,
+                 (unsigned long)stats.failures);
+    }
+
+    if (++line > MEM_POOL_COUNT) {
+        line = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the boots the stack history covers and the last overflow, then one line per task: stack size, fewest
+ *           free words since boot and since the history started, and the recommended size, all in words.
+ *           "stack clear" starts the history afresh
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Stack(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static StackMon_Task tasks[STACK_MON_MAX_TASKS];
+    static uint8_t taskCount = 0;
+    static uint8_t line = 0;
+
+    if (line == 0) {
+        BaseType_t paramLen;
+        const char *param = FreeRTOS_CLIGetParameter((const char *)pcCommandString, 1, &paramLen);
+        StackMon_Info info;
+
+        if (param != NULL && paramLen == 5 && strncmp(param, "clear", 5) == 0) {
+            StackMonClear();
+        }
+        taskCount = StackMonGetTasks(tasks, STACK_MON_MAX_TASKS);
+        StackMonGetInfo(&info);
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%u boots, overflow: %s\r\n", info.boots,
+                 (info.overflow[0] != '\0') ? info.overflow : "none");
+    } else {
+        const StackMon_Task *task = &tasks[line - 1];
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%-8s size:%u free:%u min:%u rec:%u\r\n", task->name, task->words,
+                 task->freeNow, task->freeEver, task->recommended);
+    }
+
+    if (++line > taskCount) {
+        line = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints one line per executor job: period, lane, periods run, overruns, deadline misses, release jitter
+ *           (last/max/average), longest call and longest release to completion time, in ticks
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Exec(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t index = 0;
+    const Exec_Job *job = ExecGetJob(index);
+    Exec_Job_Stats stats;
+
+    if (job == NULL) {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "no jobs\r\n");
+        index = 0;
+        return pdFALSE;
+    }
+
+    ExecGetJobStats(index, &stats);
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%-6s %lums l%u ok:%lu ovr:%lu miss:%lu jit:%lu/%lu/%lu run:%lu rsp:%lu\r\n",
+             job->name, (unsigned long)job->periodMs, job->lane, (unsigned long)stats.runs, (unsigned long)stats.overruns,
+             (unsigned long)stats.deadlineMisses, (unsigned long)stats.lastJitterTicks, (unsigned long)stats.maxJitterTicks,
+             (unsigned long)((stats.runs > 0) ? stats.sumJitterTicks / stats.runs : 0), (unsigned long)stats.maxRunTicks,
+             (unsigned long)stats.maxResponseTicks);
+
+    if (++index >= ExecGetJobCount()) {
+        index = 0;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the ring high-water mark and drain counters, then one line per deferred event type: events posted,
+ *           dropped and handled, latency from the post in the interrupt to the handler call (last/max/average) and
+ *           longest handler call, in microseconds
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Defer(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static uint8_t type = DEFER_EVENT_NONE;
+
+    if (type == DEFER_EVENT_NONE) {
+        Defer_Ring_Stats ring;
+        DeferGetRingStats(&ring);
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "ring %u/%u drains:%lu pend fail:%lu\r\n", ring.highWater,
+                 DEFER_RING_SIZE, (unsigned long)ring.drains, (unsigned long)ring.pendFailures);
+        type++;
+        return pdTRUE;
+    }
+
+    Defer_Stats stats;
+    DeferGetStats(type, &stats);
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "%-6s in:%lu drop:%lu done:%lu lat:%lu/%lu/%luus run:%luus\r\n",
+             DeferGetName(type), (unsigned long)stats.posted, (unsigned long)stats.dropped, (unsigned long)stats.handled,
+             (unsigned long)CpuStatsCountsToUs(stats.lastLatency), (unsigned long)CpuStatsCountsToUs(stats.maxLatency),
+             (unsigned long)CpuStatsCountsToUs((stats.handled > 0) ? stats.sumLatency / stats.handled : 0),
+             (unsigned long)CpuStatsCountsToUs(stats.maxRun));
+
+    if (++type >= DEFER_EVENT_MAX) {
+        type = DEFER_EVENT_NONE;
+        return pdFALSE;
+    }
+    return pdTRUE;
+}
+
+/**
+ * @brief    Prints the wake-ups of the Wi-Fi task by source, then the records published and their latency from the
+ *           sample read to the publish (last/max/average), in milliseconds
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Wifi(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static bool wakeLinePrinted = false;
+    Wifi_Loop_Stats stats;
+
+    WifiGetLoopStats(&stats);
+    if (!wakeLinePrinted) {
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "wake winc:%lu data:%lu imu:%lu state:%lu poll:%lu\r\n",
+                 (unsigned long)stats.wakeUps[WIFI_WAKE_WINC], (unsigned long)stats.wakeUps[WIFI_WAKE_SAMPLE],
+                 (unsigned long)stats.wakeUps[WIFI_WAKE_IMU], (unsigned long)stats.wakeUps[WIFI_WAKE_STATE],
+                 (unsigned long)stats.wakeUps[WIFI_WAKE_POLL]);
+        wakeLinePrinted = true;
+        return pdTRUE;
+    }
+
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "published:%lu latency:%lu/%lu/%lums\r\n", (unsigned long)stats.published,
+             (unsigned long)(stats.lastLatencyTicks * portTICK_PERIOD_MS), (unsigned long)(stats.maxLatencyTicks * portTICK_PERIOD_MS),
+             (unsigned long)((stats.published > 0) ? stats.sumLatencyTicks / stats.published * portTICK_PERIOD_MS : 0));
+    wakeLinePrinted = false;
+    return pdFALSE;
+}
+
+/**
+ * @brief    Prints the frames of the dashboard, the widgets they drew and the frame attempts postponed while the I2C bus
+ *           was busy, then the display updates and the bytes they sent over I2C, control and command bytes included:
+ *           last update and average. An update with nothing changed sends 0 bytes
+ * @note     Prints one line per call, returning pdTRUE until done, so each line fits the CLI output buffer
+ ******************************************************************************/
+BaseType_t CLI_Oled(int8_t *pcWriteBuffer, size_t xWriteBufferLen, const int8_t *pcCommandString)
+{
+    static bool frameLinePrinted = false;
+    SSD1306_Stats stats;
+
+    if (!frameLinePrinted) {
+        Display_Stats display;
+        DisplayGetStats(&display);
+        snprintf((char *)pcWriteBuffer, xWriteBufferLen, "frames:%lu widgets:%lu busy:%lu forced:%lu\r\n",
+                 (unsigned long)display.frames, (unsigned long)display.widgets, (unsigned long)display.busySkips,
+                 (unsigned long)display.forced);
+        frameLinePrinted = true;
+        return pdTRUE;
+    }
+
+    SSD1306_GetStats(&stats);
+    snprintf((char *)pcWriteBuffer, xWriteBufferLen, "updates:%lu bytes last:%u avg:%lu total:%lu\r\n",
+             (unsigned long)stats.updates, (unsigned)stats.lastBytes,
+             (unsigned long)((stats.updates > 0) ? stats.totalBytes / stats.updates : 0), (unsigned long)stats.totalBytes);
+    frameLinePrinted = false;
+    return pdFALSE;
+}
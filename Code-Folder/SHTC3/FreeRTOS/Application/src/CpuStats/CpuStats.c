@@ -0,0 +1,376 @@
+/**************************************************************************/ /**
+ * @file      CpuStats.c
+ * @brief     CPU usage. FreeRTOS run-time statistics on TC5, interrupt time accounting and a sliding usage window
+ * @details   TC5 counts GCLK 0 / 256 and its overflow interrupt extends it to the 32-bit run-time counter of the kernel.
+ *            GCLK 0 stops in standby, so the tickless idle adds the time slept with CpuStatsAdvance(), which the kernel
+ *            credits to the idle task. The SERCOM and EIC handlers are timed by overriding the weak interrupt hooks of
+ *            the ASF drivers with CpuStatsIsrEnter() and CpuStatsIsrExit(). A job of the executor snapshots the
+ *            counters every second, so the usage can be computed over any of the last CPU_STATS_WINDOW_MAX seconds as
+ *            well as since boot.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "CpuStats/CpuStats.h"
+
+#include <asf.h>
+#include <extint_callback.h>
+#include <sercom_interrupt.h>
+
+#include "Exec/Exec.h"
+#include "I2cDriver/I2cDriver.h"
+#include "conf_winc.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define CPU_STATS_PRESCALER 256        ///< TC5 prescaler, 187.5 kHz at 48 MHz: 5.3 us resolution, 6.3 h before wrapping
+#define CPU_STATS_SAMPLE_MS 1000       ///< Snapshot period of the sliding window
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Counters at one point of time
+typedef struct CpuStats_Snapshot {
+    uint32_t time;                              ///< Run-time counter
+    uint8_t count;                              ///< Valid entries of taskNumber and runTime
+    uint8_t taskNumber[CPU_STATS_MAX_TASKS];    ///< xTaskNumber, below 256 as tasks are never deleted
+    uint32_t runTime[CPU_STATS_MAX_TASKS];
+    uint32_t isrTime[CPU_STATS_ISR_MAX];
+    uint32_t isrCount[CPU_STATS_ISR_MAX];
+} CpuStats_Snapshot;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *const cpuStatsIsrNames[CPU_STATS_ISR_MAX] = {"sercom0", "sercom1", "sercom2", "sercom3",
+                                                                "sercom4", "sercom5", "eic",     "winc"};
+
+static struct tc_module cpuStatsTc;
+static bool cpuStatsReady = false;
+static uint32_t cpuStatsHz;
+static volatile uint32_t cpuStatsHigh;    ///< Upper bits of the counter, incremented by the TC5 overflow
+static uint32_t cpuStatsOffset;           ///< Time slept in standby, TC5 stopped
+static volatile uint32_t cpuStatsIsrTime[CPU_STATS_ISR_MAX];
+static volatile uint32_t cpuStatsIsrCount[CPU_STATS_ISR_MAX];
+
+static TaskStatus_t cpuStatsStatus[CPU_STATS_MAX_TASKS];       ///< Shared by the snapshots and CpuStatsGetTop(), scheduler suspended
+#if (CPU_STATS_WINDOW_MAX > 0)
+static CpuStats_Snapshot cpuStatsRing[CPU_STATS_WINDOW_MAX];  ///< One snapshot per second
+static uint8_t cpuStatsHead;                                  ///< Next snapshot to write
+static uint8_t cpuStatsFilled;                                ///< Valid snapshots
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static void CpuStatsTake(CpuStats_Snapshot *snapshot);
+#endif
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void CpuStatsOverflowCallback(struct tc_module *const module)
+ * @brief       TC5 overflow, carries into the upper bits of the run-time counter
+ */
+static void CpuStatsOverflowCallback(struct tc_module *const module)
+{
+    cpuStatsHigh += 0x10000;
+}
+
+#if (CPU_STATS_WINDOW_MAX > 0)
+/**
+ * @fn			static TickType_t CpuStatsSampleJob(void *arg)
+ * @brief       Executor job, stores the snapshot of the current second
+ */
+static TickType_t CpuStatsSampleJob(void *arg)
+{
+    vTaskSuspendAll();
+    CpuStatsTake(&cpuStatsRing[cpuStatsHead]);
+    cpuStatsHead = (cpuStatsHead + 1) % CPU_STATS_WINDOW_MAX;
+    if (cpuStatsFilled < CPU_STATS_WINDOW_MAX) {
+        cpuStatsFilled++;
+    }
+    xTaskResumeAll();
+    return EXEC_DONE;
+}
+#endif
+
+/**
+ * @fn			uint32_t sercom_interrupt_hook_enter(void)
+ * @brief       Enter hook of the ASF SERCOM handlers, overrides the weak one of the driver
+ */
+uint32_t sercom_interrupt_hook_enter(void)
+{
+    return CpuStatsIsrEnter();
+}
+
+/**
+ * @fn			void sercom_interrupt_hook_exit(const uint8_t instance, uint32_t context)
+ * @brief       Exit hook of the ASF SERCOM handlers, charges the handler to its SERCOM
+ */
+void sercom_interrupt_hook_exit(const uint8_t instance, uint32_t context)
+{
+    CpuStatsIsrExit(CPU_STATS_ISR_SERCOM0 + instance, context);
+}
+
+/**
+ * @fn			uint32_t extint_callback_hook_enter(void)
+ * @brief       Enter hook of the ASF EIC channel callbacks, overrides the weak one of the driver
+ */
+uint32_t extint_callback_hook_enter(void)
+{
+    return CpuStatsIsrEnter();
+}
+
+/**
+ * @fn			void extint_callback_hook_exit(const uint8_t channel, uint32_t context)
+ * @brief       Exit hook of the ASF EIC channel callbacks, tells the WINC1500 line apart from the others
+ */
+void extint_callback_hook_exit(const uint8_t channel, uint32_t context)
+{
+    CpuStatsIsrExit((channel == CONF_WINC_SPI_INT_EIC) ? CPU_STATS_ISR_WINC : CPU_STATS_ISR_EIC, context);
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			void CpuStatsConfigureTimer(void)
+ * @brief       portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() of the application. Starts TC5 as the run-time counter
+ * @details     Continuous read synchronization is enabled, so the counter is read without waiting on the TC clock
+ *              domain at every context switch.
+ */
+void CpuStatsConfigureTimer(void)
+{
+    struct tc_config config_tc;
+
+    tc_get_config_defaults(&config_tc);
+    config_tc.clock_source = GCLK_GENERATOR_0;
+    config_tc.clock_prescaler = TC_CLOCK_PRESCALER_DIV256;
+    config_tc.counter_size = TC_COUNTER_SIZE_16BIT;
+    config_tc.wave_generation = TC_WAVE_GENERATION_NORMAL_FREQ;
+    if (tc_init(&cpuStatsTc, TC5, &config_tc) != STATUS_OK) {
+        return;
+    }
+
+    tc_register_callback(&cpuStatsTc, CpuStatsOverflowCallback, TC_CALLBACK_OVERFLOW);
+    tc_enable_callback(&cpuStatsTc, TC_CALLBACK_OVERFLOW);
+    tc_enable(&cpuStatsTc);
+    TC5->COUNT16.READREQ.reg = TC_READREQ_RCONT | TC_READREQ_RREQ | TC_READREQ_ADDR(TC_COUNT16_COUNT_OFFSET);
+    while (tc_is_syncing(&cpuStatsTc)) {
+    }
+
+    cpuStatsHz = system_gclk_gen_get_hz(GCLK_GENERATOR_0) / CPU_STATS_PRESCALER;
+    cpuStatsReady = true;
+}
+
+/**
+ * @fn			uint32_t CpuStatsGetCounter(void)
+ * @brief       portGET_RUN_TIME_COUNTER_VALUE() of the application
+ * @return      Returns the run-time counter, in 1/cpuStatsHz since the scheduler started
+ * @note        Safe from interrupts. An overflow not yet serviced by the TC5 interrupt is accounted here
+ */
+uint32_t CpuStatsGetCounter(void)
+{
+    if (!cpuStatsReady) {
+        return 0;
+    }
+
+    irqflags_t flags = cpu_irq_save();
+    uint32_t high = cpuStatsHigh;
+    uint32_t low = TC5->COUNT16.COUNT.reg;
+    if (TC5->COUNT16.INTFLAG.reg & TC_INTFLAG_OVF) {
+        high += 0x10000;
+        low = TC5->COUNT16.COUNT.reg;
+    }
+    uint32_t counter = high + low + cpuStatsOffset;
+    cpu_irq_restore(flags);
+
+    return counter;
+}
+
+/**
+ * @fn			uint32_t CpuStatsCountsToUs(uint32_t counts)
+ * @brief       Converts a difference of CpuStatsGetCounter() values to microseconds
+ */
+uint32_t CpuStatsCountsToUs(uint32_t counts)
+{
+    return (cpuStatsHz > 0) ? (uint32_t)(((uint64_t)counts * 1000000) / cpuStatsHz) : 0;
+}
+
+/**
+ * @fn			void CpuStatsAdvance(TickType_t ticks)
+ * @brief       Adds time TC5 did not count, called by the tickless idle after a standby sleep
+ * @param[in]   ticks Ticks slept
+ */
+void CpuStatsAdvance(TickType_t ticks)
+{
+    irqflags_t flags = cpu_irq_save();
+    cpuStatsOffset += (uint32_t)(((uint64_t)ticks * cpuStatsHz) / configTICK_RATE_HZ);
+    cpu_irq_restore(flags);
+}
+
+/**
+ * @fn			int32_t CpuStatsInit(void)
+ * @brief       Starts the snapshots of the sliding window
+ * @return      Returns 0 on success, the ExecAdd() error if the job could not be registered
+ * @note        Timer service task only, as ExecAdd()
+ */
+int32_t CpuStatsInit(void)
+{
+#if (CPU_STATS_WINDOW_MAX > 0)
+    static const Exec_Job job = {"cpu", CPU_STATS_SAMPLE_MS, 0, 0, EXEC_LANE_LOW, CpuStatsSampleJob, NULL};
+    int32_t index = ExecAdd(&job);
+
+    return (index < 0) ? index : ERROR_NONE;
+#else
+    return ERROR_NONE;
+#endif
+}
+
+/**
+ * @fn			uint32_t CpuStatsIsrEnter(void)
+ * @brief       Called first thing by an accounted interrupt handler
+ * @return      Returns the start time, to pass to CpuStatsIsrExit()
+ */
+uint32_t CpuStatsIsrEnter(void)
+{
+    return CpuStatsGetCounter();
+}
+
+/**
+ * @fn			void CpuStatsIsrExit(uint8_t source, uint32_t start)
+ * @brief       Called last thing by an accounted interrupt handler
+ * @param[in]   source eCpuStatsIsr of the handler
+ * @param[in]   start Value returned by CpuStatsIsrEnter()
+ * @note        A handler preempted by another accounted one is charged for both
+ */
+void CpuStatsIsrExit(uint8_t source, uint32_t start)
+{
+    if (source >= CPU_STATS_ISR_MAX) {
+        return;
+    }
+    cpuStatsIsrTime[source] += CpuStatsGetCounter() - start;
+    cpuStatsIsrCount[source]++;
+}
+
+#if (CPU_STATS_WINDOW_MAX > 0)
+/**
+ * @fn			static void CpuStatsTake(CpuStats_Snapshot *snapshot)
+ * @brief       Copies the run time of every task and interrupt source
+ * @note        Scheduler suspended, as the task status buffer is shared
+ */
+static void CpuStatsTake(CpuStats_Snapshot *snapshot)
+{
+    UBaseType_t count = uxTaskGetSystemState(cpuStatsStatus, CPU_STATS_MAX_TASKS, NULL);
+
+    snapshot->time = CpuStatsGetCounter();
+    snapshot->count = count;
+    for (UBaseType_t i = 0; i < count; i++) {
+        snapshot->taskNumber[i] = cpuStatsStatus[i].xTaskNumber;
+        snapshot->runTime[i] = cpuStatsStatus[i].ulRunTimeCounter;
+    }
+
+    irqflags_t flags = cpu_irq_save();
+    for (uint8_t i = 0; i < CPU_STATS_ISR_MAX; i++) {
+        snapshot->isrTime[i] = cpuStatsIsrTime[i];
+        snapshot->isrCount[i] = cpuStatsIsrCount[i];
+    }
+    cpu_irq_restore(flags);
+}
+#endif
+
+/**
+ * @fn			uint8_t CpuStatsGetTop(uint8_t seconds, CpuStats_Task *tasks, uint8_t maxTasks, CpuStats_Window *window)
+ * @brief       Computes the CPU usage of each task and interrupt source, busiest task first
+ * @details     The window starts at the snapshot taken seconds ago, so it lasts between seconds - 1 and seconds. Until
+ *              enough snapshots exist the oldest one is used; window->ms gives the actual length.
+ * @param[in]   seconds Length of the window, up to CPU_STATS_WINDOW_MAX. 0 for the usage since boot
+ * @param[out]  tasks Array receiving the usage of each task
+ * @param[in]   maxTasks Entries of tasks
+ * @param[out]  window Length of the window and usage of the interrupts
+ * @return      Returns the number of tasks filled in
+ * @note        The usage since boot is only right until the 32-bit run-time counter wraps, after about 6 hours. The
+ *              sliding window is not affected.
+ */
+uint8_t CpuStatsGetTop(uint8_t seconds, CpuStats_Task *tasks, uint8_t maxTasks, CpuStats_Window *window)
+{
+    const CpuStats_Snapshot *base = NULL;
+    uint32_t isrTime[CPU_STATS_ISR_MAX];
+    uint8_t count = 0;
+
+    vTaskSuspendAll();
+#if (CPU_STATS_WINDOW_MAX > 0)
+    if (seconds > 0 && cpuStatsFilled > 0) {
+        if (seconds > cpuStatsFilled) {
+            seconds = cpuStatsFilled;
+        }
+        base = &cpuStatsRing[(cpuStatsHead + CPU_STATS_WINDOW_MAX - seconds) % CPU_STATS_WINDOW_MAX];
+    }
+#endif
+
+    UBaseType_t total = uxTaskGetSystemState(cpuStatsStatus, CPU_STATS_MAX_TASKS, NULL);
+    uint32_t elapsed = CpuStatsGetCounter() - ((base != NULL) ? base->time : 0);
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+
+    for (UBaseType_t i = 0; i < total && count < maxTasks; i++) {
+        const TaskStatus_t *status = &cpuStatsStatus[i];
+        uint32_t runTime = status->ulRunTimeCounter;
+        if (base != NULL) {
+            for (uint8_t j = 0; j < base->count; j++) {
+                if (base->taskNumber[j] == status->xTaskNumber) {
+                    runTime -= base->runTime[j];
+                    break;
+                }
+            }
+        }
+
+        CpuStats_Task entry = {status->pcTaskName, status->eCurrentState, status->uxCurrentPriority,
+                               (uint16_t)(status->usStackHighWaterMark * sizeof(StackType_t)),
+                               (uint16_t)(((uint64_t)runTime * 1000) / elapsed)};
+
+        uint8_t slot = count++;
+        while (slot > 0 && tasks[slot - 1].permille < entry.permille) {
+            tasks[slot] = tasks[slot - 1];
+            slot--;
+        }
+        tasks[slot] = entry;
+    }
+
+    irqflags_t flags = cpu_irq_save();
+    for (uint8_t i = 0; i < CPU_STATS_ISR_MAX; i++) {
+        isrTime[i] = cpuStatsIsrTime[i];
+        window->isrCount[i] = cpuStatsIsrCount[i];
+    }
+    cpu_irq_restore(flags);
+    for (uint8_t i = 0; i < CPU_STATS_ISR_MAX; i++) {
+        if (base != NULL) {
+            isrTime[i] -= base->isrTime[i];
+            window->isrCount[i] -= base->isrCount[i];
+        }
+        window->isrPermille[i] = (uint16_t)(((uint64_t)isrTime[i] * 1000) / elapsed);
+    }
+    xTaskResumeAll();
+
+    window->ms = (cpuStatsHz > 0) ? (uint32_t)(((uint64_t)elapsed * 1000) / cpuStatsHz) : 0;
+    return count;
+}
+
+/**
+ * @fn			const char *CpuStatsGetIsrName(uint8_t source)
+ * @brief       Returns the name of an interrupt source
+ * @param[in]   source eCpuStatsIsr
+ * @return      Name of the source, or NULL if out of range
+ */
+const char *CpuStatsGetIsrName(uint8_t source)
+{
+    return (source < CPU_STATS_ISR_MAX) ? cpuStatsIsrNames[source] : NULL;
+}
@@ -0,0 +1,78 @@
+/**************************************************************************/ /**
+ * @file      CpuStats.h
+ * @brief     CPU usage. FreeRTOS run-time statistics on TC5, interrupt time accounting and a sliding usage window
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef CPU_STATS_H_
+#define CPU_STATS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define CPU_STATS_MAX_TASKS 8      ///< Tasks tracked: the task table, the idle task and the timer service
+#define CPU_STATS_WINDOW_MAX 5     ///< Longest sliding window, seconds. One snapshot of ~110 B is kept per second, 0
+                                   ///< drops the window and its snapshots, leaving the usage since boot
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Interrupt sources accounted by the handlers
+typedef enum eCpuStatsIsr {
+    CPU_STATS_ISR_SERCOM0 = 0,  ///< Sensor I2C bus
+    CPU_STATS_ISR_SERCOM1,
+    CPU_STATS_ISR_SERCOM2,      ///< WINC1500 SPI
+    CPU_STATS_ISR_SERCOM3,
+    CPU_STATS_ISR_SERCOM4,      ///< Console UART
+    CPU_STATS_ISR_SERCOM5,
+    CPU_STATS_ISR_EIC,          ///< EIC lines other than the WINC one: lids, IMU, button
+    CPU_STATS_ISR_WINC,         ///< WINC1500 interrupt line
+    CPU_STATS_ISR_MAX,
+} eCpuStatsIsr;
+
+/// CPU usage of one task
+typedef struct CpuStats_Task {
+    const char *name;
+    eTaskState state;
+    UBaseType_t priority;
+    uint16_t stackFree;   ///< Stack high-water mark, bytes never used
+    uint16_t permille;    ///< Share of the window the task ran, interrupts it was preempted by included
+} CpuStats_Task;
+
+/// CPU usage of the interrupts over a window
+typedef struct CpuStats_Window {
+    uint32_t ms;                                 ///< Length of the window
+    uint16_t isrPermille[CPU_STATS_ISR_MAX];     ///< Share of the window spent in each interrupt source
+    uint32_t isrCount[CPU_STATS_ISR_MAX];        ///< Interrupts of each source in the window
+} CpuStats_Window;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+void CpuStatsConfigureTimer(void);
+uint32_t CpuStatsGetCounter(void);
+uint32_t CpuStatsCountsToUs(uint32_t counts);
+void CpuStatsAdvance(TickType_t ticks);
+int32_t CpuStatsInit(void);
+uint32_t CpuStatsIsrEnter(void);
+void CpuStatsIsrExit(uint8_t source, uint32_t start);
+uint8_t CpuStatsGetTop(uint8_t seconds, CpuStats_Task *tasks, uint8_t maxTasks, CpuStats_Window *window);
+const char *CpuStatsGetIsrName(uint8_t source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU_STATS_H_ */
@@ -0,0 +1,193 @@
+/**************************************************************************/ /**
+ * @file      Defer.c
+ * @brief     Deferred interrupt handling. Interrupts post typed events to a ring, handled on the timer service task
+ * @details   An interrupt callback only stamps the event with CpuStatsGetCounter(), copies its payload into the next slot
+ *            of a fixed ring and returns. The first event posted to an idle ring queues DeferDrain() to the timer
+ *            service with xTimerPendFunctionCallFromISR(), so one timer command covers a burst of events. DeferDrain()
+ *            calls the handler of each event in order, above every task but the alarm, and measures the latency from
+ *            the post to the handler call. The Cortex-M0 has no exclusive load/store, so a slot is reserved with the
+ *            interrupts masked for a few instructions; the payload is written after, and the type last to publish it.
+ *            The drain is the only consumer: it frees slots without masking anything. A full ring drops the event
+ *            and counts it.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Defer/Defer.h"
+
+#include <asf.h>
+#include <stdbool.h>
+#include <timers.h>
+
+#include "CpuStats/CpuStats.h"
+#include "I2cDriver/I2cDriver.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define DEFER_RING_MASK (DEFER_RING_SIZE - 1)
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *const deferNames[DEFER_EVENT_MAX] = {"none", "button"};
+
+static Defer_Event deferRing[DEFER_RING_SIZE];
+static volatile uint8_t deferHead;  ///< Next slot to reserve, written by the interrupts
+static volatile uint8_t deferTail;  ///< Next slot to handle, written by the drain
+static volatile bool deferDrainPending = false;
+static Defer_Handler deferHandlers[DEFER_EVENT_MAX];
+static Defer_Stats deferStats[DEFER_EVENT_MAX];
+static Defer_Ring_Stats deferRingStats;
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void DeferDrain(void *parameter1, uint32_t parameter2)
+ * @brief       Handles every event of the ring, oldest first. Pended to the timer service by DeferFromISR()
+ */
+static void DeferDrain(void *parameter1, uint32_t parameter2)
+{
+    deferRingStats.drains++;
+    // Cleared before reading the ring: an event posted from now on pends another drain, at worst an empty one
+    deferDrainPending = false;
+
+    while (deferTail != deferHead) {
+        uint8_t tail = deferTail;
+        Defer_Event *event = &deferRing[tail & DEFER_RING_MASK];
+        uint8_t type = event->type;
+        if (type == DEFER_EVENT_NONE) {
+            break;  // Still being written; its interrupt pends a drain if this one is done by then
+        }
+
+        uint32_t start = CpuStatsGetCounter();
+        if (deferHandlers[type] != NULL) {
+            deferHandlers[type](event);
+        }
+        uint32_t end = CpuStatsGetCounter();
+
+        Defer_Stats *stats = &deferStats[type];
+        taskENTER_CRITICAL();
+        stats->handled++;
+        stats->lastLatency = start - event->stamp;
+        stats->sumLatency += stats->lastLatency;
+        if (stats->lastLatency > stats->maxLatency) {
+            stats->maxLatency = stats->lastLatency;
+        }
+        if (end - start > stats->maxRun) {
+            stats->maxRun = end - start;
+        }
+        taskEXIT_CRITICAL();
+
+        event->type = DEFER_EVENT_NONE;
+        deferTail = tail + 1;
+    }
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			int32_t DeferRegister(uint8_t type, Defer_Handler handler)
+ * @brief       Sets the handler of an event type
+ * @return      Returns 0 on success, ERROR_INVALID_ARG if the type is unknown
+ * @note        Call before enabling the interrupt that posts the type
+ */
+int32_t DeferRegister(uint8_t type, Defer_Handler handler)
+{
+    if (type == DEFER_EVENT_NONE || type >= DEFER_EVENT_MAX) {
+        return ERROR_INVALID_ARG;
+    }
+    deferHandlers[type] = handler;
+    return ERROR_NONE;
+}
+
+/**
+ * @fn			int32_t DeferFromISR(uint8_t type, const Defer_Payload *payload, BaseType_t *pxHigherPriorityTaskWoken)
+ * @brief       Queues an event to be handled on the timer service task
+ * @param[in]   type eDeferEvent
+ * @param[in]   payload Payload, copied
+ * @param[out]  pxHigherPriorityTaskWoken Set to pdTRUE if the timer service must run when the interrupt returns
+ * @return      Returns 0 on success, ERROR_NO_RESOURCE if the ring is full (the event is dropped), ERROR_INVALID_ARG
+ *              if the type is unknown
+ * @note        From interrupts, or from a critical section
+ */
+int32_t DeferFromISR(uint8_t type, const Defer_Payload *payload, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (type == DEFER_EVENT_NONE || type >= DEFER_EVENT_MAX) {
+        return ERROR_INVALID_ARG;
+    }
+
+    uint32_t stamp = CpuStatsGetCounter();
+    Defer_Stats *stats = &deferStats[type];
+
+    irqflags_t flags = cpu_irq_save();
+    uint8_t head = deferHead;
+    uint8_t used = (uint8_t)(head - deferTail);
+    if (used >= DEFER_RING_SIZE) {
+        stats->dropped++;
+        cpu_irq_restore(flags);
+        return ERROR_NO_RESOURCE;
+    }
+    deferHead = head + 1;
+    if (used + 1 > deferRingStats.highWater) {
+        deferRingStats.highWater = used + 1;
+    }
+    stats->posted++;
+    bool pend = !deferDrainPending;
+    deferDrainPending = true;
+    cpu_irq_restore(flags);
+
+    Defer_Event *event = &deferRing[head & DEFER_RING_MASK];
+    event->stamp = stamp;
+    event->payload = *payload;
+    __DMB();
+    event->type = type;
+
+    if (pend && xTimerPendFunctionCallFromISR(DeferDrain, NULL, 0, pxHigherPriorityTaskWoken) != pdPASS) {
+        // The event stays queued and is handled by the drain the next post pends
+        deferDrainPending = false;
+        deferRingStats.pendFailures++;
+    }
+    return ERROR_NONE;
+}
+
+/**
+ * @fn			void DeferGetStats(uint8_t type, Defer_Stats *stats)
+ * @brief       Copies the counters of an event type
+ */
+void DeferGetStats(uint8_t type, Defer_Stats *stats)
+{
+    if (type >= DEFER_EVENT_MAX) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    *stats = deferStats[type];
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			void DeferGetRingStats(Defer_Ring_Stats *stats)
+ * @brief       Copies the counters of the ring
+ */
+void DeferGetRingStats(Defer_Ring_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = deferRingStats;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			const char *DeferGetName(uint8_t type)
+ * @brief       Returns the name of an event type, "?" if it is unknown
+ */
+const char *DeferGetName(uint8_t type)
+{
+    return (type < DEFER_EVENT_MAX) ? deferNames[type] : "?";
+}
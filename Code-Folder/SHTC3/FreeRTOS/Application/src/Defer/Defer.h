@@ -0,0 +1,85 @@
+/**************************************************************************/ /**
+ * @file      Defer.h
+ * @brief     Deferred interrupt handling. Interrupts post typed events to a ring, handled on the timer service task
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef DEFER_H_
+#define DEFER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define DEFER_RING_SIZE 16  ///< Events the ring holds. Power of 2
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Event types. Each has one handler
+typedef enum eDeferEvent {
+    DEFER_EVENT_NONE = 0,  ///< Slot reserved but not written yet
+    DEFER_EVENT_BUTTON,    ///< SW0 pressed, Input.c
+    DEFER_EVENT_MAX,
+} eDeferEvent;
+
+/// Payload of an event, by type
+typedef union Defer_Payload {
+    struct {
+        uint8_t line;  ///< EIC line
+    } button;
+    uint32_t word[2];  ///< Size of the union
+} Defer_Payload;
+
+/// Event as queued in the ring
+typedef struct Defer_Event {
+    volatile uint8_t type;  ///< eDeferEvent. Written last: DEFER_EVENT_NONE until the payload is complete
+    uint32_t stamp;         ///< CpuStatsGetCounter() when posted, for the latency
+    Defer_Payload payload;
+} Defer_Event;
+
+/// Handles one event, on the timer service task. Must not block
+typedef void (*Defer_Handler)(const Defer_Event *event);
+
+/// Counters of one event type
+typedef struct Defer_Stats {
+    uint32_t posted;        ///< Events queued
+    uint32_t dropped;       ///< Events lost because the ring was full
+    uint32_t lastLatency;   ///< CpuStatsGetCounter() counts from the post to the handler call, last event
+    uint32_t maxLatency;    ///< Largest latency seen
+    uint32_t sumLatency;    ///< Accumulated latency, to compute the average over handled events
+    uint32_t handled;       ///< Events handled
+    uint32_t maxRun;        ///< Longest handler call, counts
+} Defer_Stats;
+
+/// Counters of the ring
+typedef struct Defer_Ring_Stats {
+    uint8_t highWater;      ///< Most events queued at once
+    uint32_t drains;        ///< Calls of the drain on the timer service
+    uint32_t pendFailures;  ///< Drains that could not be queued to the full timer command queue
+} Defer_Ring_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t DeferRegister(uint8_t type, Defer_Handler handler);
+int32_t DeferFromISR(uint8_t type, const Defer_Payload *payload, BaseType_t *pxHigherPriorityTaskWoken);
+void DeferGetStats(uint8_t type, Defer_Stats *stats);
+void DeferGetRingStats(Defer_Ring_Stats *stats);
+const char *DeferGetName(uint8_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEFER_H_ */
@@ -0,0 +1,222 @@
+/**************************************************************************/ /**
+ * @file      DisplayTask.c
+ * @brief     OLED dashboard: time, temperature, humidity and next dose, redrawn only where a value changed
+ * @details   The task wakes on each SHTC3 sample and every DISPLAY_CLOCK_MS for the clock and the schedule, and sets
+ *            the widgets from them. A widget set to the value it shows stays clean, so steady values cost no frame and
+ *            no bus time. The samples also feed 24-hour sparklines of the temperature and the humidity, which add one
+ *            column per interval. A change waits until DISPLAY_FRAME_MS after the last frame: changes meanwhile go
+ *            into the same frame. While the I2C bus is busy the frame is postponed, so the sensors are read first;
+ *            after DISPLAY_BUSY_MAX_RETRIES it is queued anyway, on the low priority lane of the driver. The task is
+ *            the only user of the SSD1306 framebuffer once SSD1306_Init() has run.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Display/DisplayTask.h"
+
+#include <string.h>
+
+#include "Chart/Chart.h"
+#include "I2cDriver/I2cDriver.h"
+#include "OLED/SSD1306.h"
+#include "SampleBus/SampleBus.h"
+#include "Schedule/Schedule.h"
+#include "SerialConsole.h"
+#include "Widget/Widget.h"
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Widgets of the dashboard, in the order of displayWidgets
+typedef enum eDisplayWidget {
+    DISPLAY_WIDGET_TIME = 0,
+    DISPLAY_WIDGET_TEMPERATURE,
+    DISPLAY_WIDGET_HUMIDITY,
+    DISPLAY_WIDGET_HUMIDITY_BAR,
+    DISPLAY_WIDGET_DOSE_ICON,
+    DISPLAY_WIDGET_DOSE,
+    DISPLAY_WIDGET_MAX,
+} eDisplayWidget;
+
+/// Charts of the dashboard, in the order of displayCharts
+typedef enum eDisplayChart {
+    DISPLAY_CHART_TEMPERATURE = 0,
+    DISPLAY_CHART_HUMIDITY,
+    DISPLAY_CHART_MAX,
+} eDisplayChart;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+/// Pill, 8x8, page-major
+static const uint8_t displayPillIcon[8] = {0x3C, 0x7E, 0x7E, 0x7E, 0x42, 0x42, 0x42, 0x3C};
+
+/// Layout of the 128x64 panel: clock on top, temperature and humidity below, next dose at the bottom
+static const Widget_Def displayWidgets[DISPLAY_WIDGET_MAX] = {
+    {.type = WIDGET_TEXT, .x = 0, .y = 0, .width = 5, .font = &Font_11x18},
+    {.type = WIDGET_NUMBER, .x = 0, .y = 22, .width = 6, .decimals = 1, .font = &Font_7x10, .unit = "C"},
+    {.type = WIDGET_NUMBER, .x = 64, .y = 22, .width = 6, .decimals = 1, .font = &Font_7x10, .unit = "%"},
+    {.type = WIDGET_BAR, .x = 64, .y = 34, .width = 60, .height = 6, .min = 0, .max = 1000},
+    {.type = WIDGET_ICON, .x = 0, .y = 48, .width = 8, .height = 8, .bitmap = displayPillIcon},
+    {.type = WIDGET_TEXT, .x = 12, .y = 48, .width = 10, .font = &Font_7x10},
+};
+
+/// 24-hour sparklines, right of the clock (10 to 40 C) and below the humidity bar. 60 columns: one per 24 minutes
+static const Chart_Def displayCharts[DISPLAY_CHART_MAX] = {
+    {.mode = CHART_MODE_SCROLL, .x = 64, .y = 0, .width = 60, .height = 16, .spanMinutes = CHART_SPAN_24H,
+     .min = 100, .max = 400},
+    {.mode = CHART_MODE_SCROLL, .x = 64, .y = 40, .width = 60, .height = 8, .spanMinutes = CHART_SPAN_24H,
+     .min = 0, .max = 1000},
+};
+
+static Sample_Subscriber *displaySampleSubscriber = NULL;  ///< SHTC3 records, notified on DISPLAY_NOTIFY_SAMPLE
+static Display_Stats displayStats;
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static void DisplayFormatMinute(char *text, uint32_t minute);
+static void DisplayRefresh(void);
+
+/******************************************************************************
+ * Display Thread
+ ******************************************************************************/
+
+/**
+ * @fn			void vDisplayTask(void *pvParameters)
+ * @brief       Sets the widgets from the samples, the clock and the schedule, and sends a frame when one changed
+ * @param[in]   pvParameters Unused
+ */
+void vDisplayTask(void *pvParameters)
+{
+    TickType_t lastFrame = xTaskGetTickCount() - pdMS_TO_TICKS(DISPLAY_FRAME_MS);
+
+    displaySampleSubscriber = SampleBusSubscribe("display", SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_SHTC3),
+                                                 xTaskGetCurrentTaskHandle(), DISPLAY_NOTIFY_SAMPLE);
+    if (displaySampleSubscriber == NULL) {
+        SerialConsoleWriteString("ERR: Display task could not subscribe to the sample bus!\r\n");
+    }
+    for (uint8_t i = 0; i < DISPLAY_WIDGET_MAX; i++) {
+        if (WidgetAdd(&displayWidgets[i]) != i) {
+            SerialConsoleWriteString("ERR: Display widgets could not be added!\r\n");
+            vTaskSuspend(NULL);
+        }
+    }
+    for (uint8_t i = 0; i < DISPLAY_CHART_MAX; i++) {
+        if (ChartAdd(&displayCharts[i]) != i) {
+            SerialConsoleWriteString("ERR: Display charts could not be added!\r\n");
+            vTaskSuspend(NULL);
+        }
+    }
+
+    for (;;) {
+        DisplayRefresh();
+        if (!WidgetIsDirty() && !ChartIsDirty()) {
+            xTaskNotifyWait(0, DISPLAY_NOTIFY_SAMPLE, NULL, pdMS_TO_TICKS(DISPLAY_CLOCK_MS));
+            continue;
+        }
+
+        // Coalesce: what changes until the frame is due goes into the same frame
+        TickType_t elapsed = xTaskGetTickCount() - lastFrame;
+        if (elapsed < pdMS_TO_TICKS(DISPLAY_FRAME_MS)) {
+            vTaskDelay(pdMS_TO_TICKS(DISPLAY_FRAME_MS) - elapsed);
+            DisplayRefresh();
+        }
+
+        uint8_t retries = 0;
+        while (I2cIsBusy() && retries < DISPLAY_BUSY_MAX_RETRIES) {
+            displayStats.busySkips++;
+            retries++;
+            vTaskDelay(pdMS_TO_TICKS(DISPLAY_BUSY_RETRY_MS));
+        }
+        if (retries == DISPLAY_BUSY_MAX_RETRIES && I2cIsBusy()) {
+            displayStats.forced++;
+        }
+
+        uint8_t drawn = WidgetRender();
+        ChartRender();
+        SSD1306_UpdateScreen();
+        lastFrame = xTaskGetTickCount();
+
+        taskENTER_CRITICAL();
+        displayStats.frames++;
+        displayStats.widgets += drawn;
+        taskEXIT_CRITICAL();
+    }
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void DisplayFormatMinute(char *text, uint32_t minute)
+ * @brief       Writes the time of day of a minute since 2000-01-01 as "HH:MM", "--:--" if it is 0
+ * @param[out]  text At least 6 characters
+ */
+static void DisplayFormatMinute(char *text, uint32_t minute)
+{
+    uint16_t year;
+    uint8_t month, day, hour, min;
+
+    if (minute == 0) {
+        strcpy(text, "--:--");
+        return;
+    }
+    ScheduleMinuteToDate(minute, &year, &month, &day, &hour, &min);
+    text[0] = '0' + hour / 10;
+    text[1] = '0' + hour % 10;
+    text[2] = ':';
+    text[3] = '0' + min / 10;
+    text[4] = '0' + min % 10;
+    text[5] = '\0';
+}
+
+/**
+ * @fn			static void DisplayRefresh(void)
+ * @brief       Sets the widgets from the samples waiting on the bus, the clock and the schedule
+ */
+static void DisplayRefresh(void)
+{
+    Sample_Record record;
+    Schedule_Stats schedule;
+    char text[WIDGET_TEXT_LEN];
+
+    while (displaySampleSubscriber != NULL && SampleBusRead(displaySampleSubscriber, &record)) {
+        if (record.status != ERROR_NONE) {
+            WidgetSetInvalid(DISPLAY_WIDGET_TEMPERATURE);
+            WidgetSetInvalid(DISPLAY_WIDGET_HUMIDITY);
+            WidgetSetInvalid(DISPLAY_WIDGET_HUMIDITY_BAR);
+            continue;
+        }
+        WidgetSetValue(DISPLAY_WIDGET_TEMPERATURE, record.channel[SAMPLE_SHTC3_TEMPERATURE]);
+        WidgetSetValue(DISPLAY_WIDGET_HUMIDITY, record.channel[SAMPLE_SHTC3_HUMIDITY]);
+        WidgetSetValue(DISPLAY_WIDGET_HUMIDITY_BAR, record.channel[SAMPLE_SHTC3_HUMIDITY]);
+        ChartSample(DISPLAY_CHART_TEMPERATURE, record.channel[SAMPLE_SHTC3_TEMPERATURE]);
+        ChartSample(DISPLAY_CHART_HUMIDITY, record.channel[SAMPLE_SHTC3_HUMIDITY]);
+    }
+    ChartUpdate(xTaskGetTickCount());
+
+    DisplayFormatMinute(text, ScheduleGetMinute());
+    WidgetSetText(DISPLAY_WIDGET_TIME, text);
+
+    ScheduleGetStats(&schedule);
+    strcpy(text, "Next ");
+    DisplayFormatMinute(&text[5], schedule.nextMinute);
+    WidgetSetText(DISPLAY_WIDGET_DOSE, text);
+    WidgetSetValue(DISPLAY_WIDGET_DOSE_ICON, schedule.nextMinute != 0);
+}
+
+/**
+ * @fn			void DisplayGetStats(Display_Stats *stats)
+ * @brief       Copies the counters of the display task
+ */
+void DisplayGetStats(Display_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = displayStats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,53 @@
+/**************************************************************************/ /**
+ * @file      DisplayTask.h
+ * @brief     OLED dashboard: time, temperature, humidity and next dose, redrawn only where a value changed
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef DISPLAY_TASK_H_
+#define DISPLAY_TASK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define DISPLAY_TASK_SIZE 200                 ///< Stack of the display task (words)
+#define DISPLAY_NOTIFY_SAMPLE (1UL << 0)      ///< Task notification bit set by the sample bus
+#define DISPLAY_FRAME_MS 250                  ///< Shortest time between two frames. Changes meanwhile share a frame
+#define DISPLAY_CLOCK_MS 1000                 ///< Clock and schedule check period, when no sample arrives
+#define DISPLAY_BUSY_RETRY_MS 20              ///< Wait before trying a frame again while the I2C bus is busy
+#define DISPLAY_BUSY_MAX_RETRIES 10           ///< Busy retries before the frame is queued behind the other traffic
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Counters of the display task
+typedef struct Display_Stats {
+    uint32_t frames;      ///< Frames sent
+    uint32_t widgets;     ///< Widgets drawn by those frames
+    uint32_t busySkips;   ///< Frame attempts postponed because the I2C bus was busy
+    uint32_t forced;      ///< Frames queued after DISPLAY_BUSY_MAX_RETRIES with the bus still busy
+} Display_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+void vDisplayTask(void *pvParameters);
+void DisplayGetStats(Display_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DISPLAY_TASK_H_ */
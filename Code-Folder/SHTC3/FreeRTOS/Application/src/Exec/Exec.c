@@ -0,0 +1,249 @@
+/**************************************************************************/ /**
+ * @file      Exec.c
+ * @brief     Periodic job executor. Runs registered jobs to completion on the timer service task, on its stack
+ * @details   One one-shot software timer is armed for the earliest pending call of all jobs. When it fires, every job
+ *            that is due runs, higher lanes first, then the timer is armed again. Releases are absolute (phase + n *
+ *            period), so the periods do not drift with the time the jobs take or with the timer latency. A job that has
+ *            to wait returns the ticks to wait and is called again then, so no job blocks the others meanwhile.
+ *            A job still busy at its next release skips that release, which is counted as an overrun: a slow period
+ *            never causes a burst of catch-up runs. The jobs share the timer service stack, so they replace a task and
+ *            its stack each; they must not block on the timer API, and a long job delays the software timers.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Exec/Exec.h"
+
+#include <stdbool.h>
+#include <timers.h>
+
+#include "I2cDriver/I2cDriver.h"
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Runtime state of one job
+typedef struct Exec_State {
+    const Exec_Job *job;
+    TickType_t release;  ///< Start of the current period, or of the next one when idle
+    TickType_t due;      ///< Tick the job must be called at: the release, or the end of its wait
+    bool active;         ///< True from the first call of a period until the job is done
+    Exec_Job_Stats stats;
+} Exec_State;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static Exec_State execState[EXEC_MAX_JOBS];
+static uint8_t execCount;
+static TimerHandle_t execTimer = NULL;
+static StaticTimer_t execTimerBuffer;
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static Exec_State *ExecNextDue(TickType_t now);
+static void ExecRun(Exec_State *state, TickType_t now);
+static void ExecArm(void);
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void ExecTimerCallback(TimerHandle_t timer)
+ * @brief       Runs every job that is due, then arms the timer for the next one
+ */
+static void ExecTimerCallback(TimerHandle_t timer)
+{
+    for (;;) {
+        TickType_t now = xTaskGetTickCount();
+        Exec_State *state = ExecNextDue(now);
+        if (state == NULL) {
+            break;
+        }
+        ExecRun(state, now);
+    }
+    ExecArm();
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static Exec_State *ExecNextDue(TickType_t now)
+ * @brief       Finds the job to run: of the jobs due, the one of the highest lane, then the one due first
+ * @return      Returns the job, NULL if none is due
+ */
+static Exec_State *ExecNextDue(TickType_t now)
+{
+    Exec_State *next = NULL;
+
+    for (uint8_t i = 0; i < execCount; i++) {
+        Exec_State *state = &execState[i];
+        if ((int32_t)(state->due - now) > 0) {
+            continue;
+        }
+        if (next == NULL || state->job->lane < next->job->lane ||
+            (state->job->lane == next->job->lane && (int32_t)(state->due - next->due) < 0)) {
+            next = state;
+        }
+    }
+    return next;
+}
+
+/**
+ * @fn			static void ExecRun(Exec_State *state, TickType_t now)
+ * @brief       Calls a job and schedules its next call
+ * @param[in]   state Job due
+ * @param[in]   now Tick the job was found due at
+ */
+static void ExecRun(Exec_State *state, TickType_t now)
+{
+    const Exec_Job *job = state->job;
+    TickType_t period = pdMS_TO_TICKS(job->periodMs);
+    TickType_t deadline = pdMS_TO_TICKS(job->deadlineMs ? job->deadlineMs : job->periodMs);
+
+    if (!state->active) {
+        uint32_t jitter = now - state->release;
+        state->stats.lastJitterTicks = jitter;
+        state->stats.sumJitterTicks += jitter;
+        if (jitter > state->stats.maxJitterTicks) {
+            state->stats.maxJitterTicks = jitter;
+        }
+        state->active = true;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t wait = job->run(job->arg);
+    TickType_t end = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    if (end - start > state->stats.maxRunTicks) {
+        state->stats.maxRunTicks = end - start;
+    }
+    if (wait != EXEC_DONE) {
+        state->due = end + wait;
+        taskEXIT_CRITICAL();
+        return;
+    }
+
+    state->active = false;
+    state->stats.runs++;
+    if (end - state->release > state->stats.maxResponseTicks) {
+        state->stats.maxResponseTicks = end - state->release;
+    }
+    if (end - state->release > deadline) {
+        state->stats.deadlineMisses++;
+    }
+    state->release += period;
+    while ((int32_t)(end - state->release) > 0) {
+        state->release += period;
+        state->stats.overruns++;
+    }
+    state->due = state->release;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			static void ExecArm(void)
+ * @brief       Arms the timer for the job due first
+ */
+static void ExecArm(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    int32_t delay = INT32_MAX;
+
+    for (uint8_t i = 0; i < execCount; i++) {
+        int32_t delta = (int32_t)(execState[i].due - now);
+        if (delta < delay) {
+            delay = delta;
+        }
+    }
+    if (delay == INT32_MAX) {
+        return;
+    }
+    xTimerChangePeriod(execTimer, (delay > 0) ? (TickType_t)delay : 1, 0);
+}
+
+/**
+ * @fn			int32_t ExecInit(void)
+ * @brief       Creates the timer of the executor
+ * @return      Returns 0 on success, ERROR_NO_MEMORY if the timer could not be created
+ */
+int32_t ExecInit(void)
+{
+    execTimer = xTimerCreateStatic("exec", 1, pdFALSE, NULL, ExecTimerCallback, &execTimerBuffer);
+    return (execTimer != NULL) ? ERROR_NONE : ERROR_NO_MEMORY;
+}
+
+/**
+ * @fn			int32_t ExecAdd(const Exec_Job *job)
+ * @brief       Registers a job. Its first release is phaseMs from now
+ * @param[in]   job Job description. Must stay valid: it is not copied
+ * @return      Returns the index of the job, ERROR_NO_RESOURCE if EXEC_MAX_JOBS are registered, ERROR_NOT_INITIALIZED
+ *              before ExecInit(), ERROR_INVALID_ARG if the job has no run function or no period
+ * @note        Timer service task only: from vApplicationDaemonTaskStartupHook() or from a job
+ */
+int32_t ExecAdd(const Exec_Job *job)
+{
+    if (execTimer == NULL) {
+        return ERROR_NOT_INITIALIZED;
+    }
+    if (job->run == NULL || pdMS_TO_TICKS(job->periodMs) == 0) {
+        return ERROR_INVALID_ARG;
+    }
+    if (execCount >= EXEC_MAX_JOBS) {
+        return ERROR_NO_RESOURCE;
+    }
+
+    Exec_State *state = &execState[execCount];
+    state->job = job;
+    state->release = xTaskGetTickCount() + pdMS_TO_TICKS(job->phaseMs);
+    state->due = state->release;
+    state->active = false;
+    taskENTER_CRITICAL();
+    execCount++;
+    taskEXIT_CRITICAL();
+
+    ExecArm();
+    return execCount - 1;
+}
+
+/**
+ * @fn			uint8_t ExecGetJobCount(void)
+ * @brief       Returns the number of registered jobs
+ */
+uint8_t ExecGetJobCount(void)
+{
+    return execCount;
+}
+
+/**
+ * @fn			const Exec_Job *ExecGetJob(uint8_t index)
+ * @brief       Returns the description of a registered job, or NULL if index is out of range
+ */
+const Exec_Job *ExecGetJob(uint8_t index)
+{
+    return (index < execCount) ? execState[index].job : NULL;
+}
+
+/**
+ * @fn			void ExecGetJobStats(uint8_t index, Exec_Job_Stats *stats)
+ * @brief       Copies the timing counters of a job
+ * @param[in]   index Index of the job, below ExecGetJobCount()
+ * @param[out]  stats Structure the counters are copied to
+ */
+void ExecGetJobStats(uint8_t index, Exec_Job_Stats *stats)
+{
+    if (index >= execCount) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    *stats = execState[index].stats;
+    taskEXIT_CRITICAL();
+}
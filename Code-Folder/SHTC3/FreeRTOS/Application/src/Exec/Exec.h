@@ -0,0 +1,77 @@
+/**************************************************************************/ /**
+ * @file      Exec.h
+ * @brief     Periodic job executor. Runs registered jobs to completion on the timer service task, on its stack
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef EXEC_H_
+#define EXEC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define EXEC_MAX_JOBS 8  ///< Jobs that can be registered
+#define EXEC_DONE 0      ///< Returned by a job when it is done for this period
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Priority lanes. Of the jobs due at the same time, the ones of the higher lane run first
+typedef enum eExecLane {
+    EXEC_LANE_HIGH = 0,  ///< Sensing
+    EXEC_LANE_NORMAL,    ///< Everything else
+    EXEC_LANE_LOW,       ///< Statistics and housekeeping
+    EXEC_LANE_MAX,
+} eExecLane;
+
+/// Static description of a periodic job
+typedef struct Exec_Job {
+    const char *name;     ///< Name printed by the CLI
+    uint32_t periodMs;    ///< Release period
+    uint32_t phaseMs;     ///< Offset of the first release from ExecAdd(), to spread jobs
+    uint32_t deadlineMs;  ///< Longest time from release to completion. 0 for the period
+    uint8_t lane;         ///< eExecLane
+    /// Runs the job to completion. Returns EXEC_DONE, or the ticks after which it must be called again in the same
+    /// period: a job that has to wait (a sensor conversion) splits there instead of blocking the other jobs
+    TickType_t (*run)(void *arg);
+    void *arg;            ///< Passed to run
+} Exec_Job;
+
+/// Timing counters of one job
+typedef struct Exec_Job_Stats {
+    uint32_t runs;             ///< Periods completed
+    uint32_t overruns;         ///< Releases skipped because the job was still running, or late past its next release
+    uint32_t deadlineMisses;   ///< Periods completed after the deadline
+    uint32_t lastJitterTicks;  ///< Delay between the release and the start of the last period
+    uint32_t maxJitterTicks;   ///< Largest release delay seen
+    uint32_t sumJitterTicks;   ///< Accumulated release delay, to compute the average over runs
+    uint32_t maxRunTicks;      ///< Longest single call of run
+    uint32_t maxResponseTicks; ///< Longest time from release to completion
+} Exec_Job_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t ExecInit(void);
+int32_t ExecAdd(const Exec_Job *job);
+uint8_t ExecGetJobCount(void);
+const Exec_Job *ExecGetJob(uint8_t index);
+void ExecGetJobStats(uint8_t index, Exec_Job_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EXEC_H_ */
@@ -14,22 +14,48 @@
 /******************************************************************************
  * Defines
  ******************************************************************************/
+#define I2C_PHASE_WRITE 0  ///< Transaction is sending its write segment
+#define I2C_PHASE_READ 1   ///< Transaction is receiving its read segment
+
+#define I2C_BUS_STATE_OWNER 2  ///< STATUS.BUSSTATE value while this master owns the bus
 
 /******************************************************************************
  * Variables
  ******************************************************************************/
-SemaphoreHandle_t sensorI2cMutexHandle;                       ///< Mutex to handle the sensor I2C bus thread access.
-SemaphoreHandle_t sensorI2cSemaphoreHandle;                   ///< Binary semaphore to notify task that we have received an I2C interrupt on the Sensor bus
-static volatile TaskHandle_t xTaskToNotifySensorDone = NULL;  ///< Stores the handle of the task that will be notified when the SENSOR transmission is complete. */
-static uint8_t sensorTransmitError = false;                   ///< Flag used to indicate that there was an I2C transmission error on the SENSOR bus.
+SemaphoreHandle_t sensorI2cMutexHandle;      ///< Mutex to handle the sensor I2C bus thread access.
+static StaticSemaphore_t sensorI2cMutexBuffer;
+static uint8_t sensorTransmitError = false;  ///< Flag used to indicate that there was an I2C transmission error on the SENSOR bus.
 
 struct i2c_master_module i2cSensorBusInstance;
 static I2C_Bus_State I2cSensorBusState;  ///< Structure that defines the I2C Bus used for the sensors.
 
 struct i2c_master_packet sensorPacketWrite;
+
+static I2C_Transaction *i2cQueueHead[I2C_PRIORITY_MAX];        ///< First pending transaction of each priority lane
+static I2C_Transaction *i2cQueueTail[I2C_PRIORITY_MAX];        ///< Last pending transaction of each priority lane
+static I2C_Transaction *volatile i2cActiveTransaction = NULL;  ///< Transaction currently on the bus
+static volatile bool i2cEngineBusy = false;                    ///< True while a transfer is on the bus
+static volatile bool i2cEngineRecovering = false;              ///< True while the bus is being reset after a cancelled transfer
+static TickType_t i2cActiveStartTick;                          ///< Tick at which the active transaction reached the bus
+static uint32_t i2cActiveStartUs;                              ///< Timestamp (us) at which the active transaction reached the bus
+static I2C_Engine_Stats i2cEngineStats;                        ///< Engine counters, see I2cGetEngineStats()
+static uint8_t i2cBounceBuffer[I2C_MAX_CHUNK_LEN];             ///< Header + data of a chunked write when it runs without DMA
+
+static struct dma_resource i2cDmaResource;                     ///< DMA channel triggered by the SERCOM0 TX request
+COMPILER_ALIGNED(16)
+static DmacDescriptor i2cDmaDescriptors[2];                    ///< Header and data descriptors of the chunk being written
+static bool i2cDmaReady = false;                               ///< True once the DMA channel is allocated
+static volatile bool i2cDmaActive = false;                     ///< True while a DMA write owns the SERCOM0 interrupt
+static volatile bool i2cDmaWaitEnd = false;                    ///< True while waiting for the SERCOM to shift out the last DMA byte
+static uint16_t i2cDmaThreshold = I2C_DMA_THRESHOLD;           ///< Writes of at least this many bytes use DMA (0 disables DMA)
+
 /******************************************************************************
  * Forward Declarations
  ******************************************************************************/
+static void I2cEngineStartNext(BaseType_t *pxHigherPriorityTaskWoken);
+static void I2cEngineComplete(int32_t status, BaseType_t *pxHigherPriorityTaskWoken);
+static void I2cEngineWriteDone(int32_t status, BaseType_t *pxHigherPriorityTaskWoken);
+
 static int32_t I2cDriverConfigureSensorBus(void)
 {
     int32_t error = STATUS_OK;
@@ -68,63 +94,178 @@ exit:
 /*
   * @fn			void I2cSensorsTxComplete(struct i2c_m_async_desc *const i2c)
   * @brief       Callback function for when the SENSORS I2C bus ends transmissions
-  * @details     This callback sets a flag that tells us that the bus is not busy, and the last transmission is done. With USE_FREERTOS flag, this
-                                 callback notifies the registered thread that the I2C transfer has finished. The registered thread is the thread that initiated the I2C transaction,
-                                 and is currently waiting for a notification that it has finished.
+  * @details     Advances the active queued transaction: the next chunk of the write or the read segment is started right
+                                 away, otherwise the transaction is completed (callback or task notification) and the next queued
+                                 transaction is started from this same interrupt, so back-to-back transactions never wait for a task to run.
   * @param[in]   i2c Pointer to I2C structure used inside the Atmel ASFv3  framework
   * @return      This function is a callback, and it is registered as such when we send an I2C transmission on this I2C bus.
   * @note
   */
 void I2cSensorsTxComplete(struct i2c_master_module *const module)
 {
-    I2cSensorBusState.i2cState = I2C_BUS_READY;
-    I2cSensorBusState.rxDoneFlag = true;
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-    xSemaphoreGiveFromISR(sensorI2cSemaphoreHandle, &xHigherPriorityTaskWoken);
+    I2cSensorBusState.txDoneFlag = true;
     sensorTransmitError = false;
+
+    I2cEngineWriteDone(ERROR_NONE, &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 /**
   * @fn				void I2cSensorRxComplete(struct i2c_m_async_desc *const i2c)
   * @brief			Callback function for when the SENSOR I2C bus ends data reception
-  * @details			This callback sets a flag that tells us that the bus is not busy, and the last reception is done. With USE_FREERTOS flag, this
-                                         callback notifies the registered thread that the I2C transfer has finished. The registered thread is the thread that initiated the I2C transaction,
-                                         and is currently waiting for a notification that it has finished.
+  * @details			Completes the active queued transaction and starts the next one, if any.
   * @param[in]		i2c Pointer to I2C structure used inside the Atmel ASFv3  framework
   * @return			This function is a callback, and it is registered as such when we send an I2C reception on this I2C bus.
   * @note
   */
 void I2cSensorsRxComplete(struct i2c_master_module *const module)
 {
-    I2cSensorBusState.i2cState = I2C_BUS_READY;
-    I2cSensorBusState.rxDoneFlag = true;
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-    xSemaphoreGiveFromISR(sensorI2cSemaphoreHandle, &xHigherPriorityTaskWoken);
+    I2cSensorBusState.rxDoneFlag = true;
     sensorTransmitError = false;
+
+    I2cEngineComplete(ERROR_NONE, &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 /**
   * @fn				void I2cSensorError(struct i2c_m_async_desc *const i2c)
-  * @brief			Callback function for when the LED I2C bus encounters an error while transmitting/receiving
-  * @details			This callback sets a flag that tells us that the bus is not busy, and the last reception is done. With USE_FREERTOS flag, this
-                                         callback notifies the registered thread that the I2C transfer has finished. The registered thread is the thread that initiated the I2C transaction,
-                                         and is currently waiting for a notification that it has finished.
+  * @brief			Callback function for when the SENSOR I2C bus encounters an error while transmitting/receiving
+  * @details			Completes the active queued transaction with ERROR_ABORTED and starts the next one, if any.
   * @param[in]		i2c Pointer to I2C structure used inside the Atmel ASFv3  framework
   * @return			This function is a callback, and it is registered as such when we send an I2C reception on this I2C bus.
   * @note
   */
 void I2cSensorsError(struct i2c_master_module *const module)
 {
-    I2cSensorBusState.i2cState = I2C_BUS_READY;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
     I2cSensorBusState.txDoneFlag = true;
+    sensorTransmitError = true;
+
+    I2cEngineComplete(ERROR_ABORTED, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+  * @fn				static void I2cDmaWriteEnd(int32_t status)
+  * @brief			Ends a DMA write, either once the SERCOM has shifted out its last byte or on a bus error
+  * @details			Mirrors what the ASF interrupt handler does at the end of a write job: sends the STOP condition if
+                                 the bus is still ours, then advances the active transaction.
+  * @param[in]		status ERROR_NONE, or ERROR_IO if the write was NACKed or the bus was lost
+  * @note			Called from the SERCOM0 interrupt
+  */
+static void I2cDmaWriteEnd(int32_t status)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    SercomI2cm *const i2cModule = &(i2cSensorBusInstance.hw->I2CM);
+
+    i2cDmaActive = false;
+    i2cDmaWaitEnd = false;
+    i2cModule->INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB | SERCOM_I2CM_INTENCLR_ERROR;
+    i2cModule->INTFLAG.reg = SERCOM_I2CM_INTFLAG_ERROR;
+
+    if (ERROR_NONE != status) {
+        sensorTransmitError = true;
+    }
+
+    if ((i2cModule->STATUS.reg & SERCOM_I2CM_STATUS_BUSSTATE_Msk) == SERCOM_I2CM_STATUS_BUSSTATE(I2C_BUS_STATE_OWNER)) {
+        while (i2c_master_is_syncing(&i2cSensorBusInstance)) {
+        }
+        i2cModule->CTRLB.reg |= SERCOM_I2CM_CTRLB_CMD(3);
+    } else {
+        i2cModule->INTFLAG.reg = SERCOM_I2CM_INTFLAG_MB;
+    }
+
+    I2cSensorBusState.txDoneFlag = true;
+    I2cEngineWriteDone(status, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+  * @fn				static void I2cDmaWriteInterrupt(void)
+  * @brief			Takes the SERCOM0 interrupts of a DMA write
+  * @details			An address NACK or a lost bus never triggers the DMA, so the write is ended here with ERROR_IO as
+                                 soon as the SERCOM reports it. The first clean master-on-bus interrupt means the address was
+                                 acknowledged and the DMA is feeding the data; it is masked until the DMA hands over the last
+                                 byte, so the data does not cost an interrupt per byte. ERROR stays enabled for the whole write.
+  * @note			Called from the SERCOM0 interrupt
+  */
+static void I2cDmaWriteInterrupt(void)
+{
+    SercomI2cm *const i2cModule = &(i2cSensorBusInstance.hw->I2CM);
+
+    if ((i2cModule->STATUS.reg & (SERCOM_I2CM_STATUS_RXNACK | SERCOM_I2CM_STATUS_BUSERR | SERCOM_I2CM_STATUS_ARBLOST)) ||
+        (i2cModule->INTFLAG.reg & SERCOM_I2CM_INTFLAG_ERROR)) {
+        dma_abort_job(&i2cDmaResource);
+        I2cDmaWriteEnd(ERROR_IO);
+    } else if (!i2cDmaWaitEnd) {
+        i2cModule->INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB;
+    } else if (i2cModule->INTFLAG.reg & SERCOM_I2CM_INTFLAG_MB) {
+        I2cDmaWriteEnd(ERROR_NONE);
+    }
+}
+
+/**
+  * @fn				static void I2cSensorsInterruptHandler(uint8_t instance)
+  * @brief			SERCOM0 interrupt handler installed in front of the ASF I2C master handler
+  * @details			Counts the interrupts taken by the active transaction, and takes the interrupts of DMA writes, which
+                                 the ASF state machine knows nothing about. Everything else goes to ASF.
+  * @param[in]		instance SERCOM instance that triggered the interrupt
+  */
+static void I2cSensorsInterruptHandler(uint8_t instance)
+{
+    I2C_Transaction *transaction = i2cActiveTransaction;
+    if (transaction != NULL) {
+        transaction->interrupts++;
+    }
+
+    if (i2cDmaActive) {
+        I2cDmaWriteInterrupt();
+    } else {
+        _i2c_master_interrupt_handler(instance);
+    }
+}
+
+/**
+  * @fn				static void I2cDmaTransferDone(struct dma_resource *const resource)
+  * @brief			Callback function for when the DMA channel has handed the last byte of a write to the SERCOM
+  * @details			The byte is still being shifted out, so the write is ended on the next SERCOM master-on-bus interrupt.
+  * @param[in]		resource DMA resource of the I2C channel
+  */
+static void I2cDmaTransferDone(struct dma_resource *const resource)
+{
+    I2C_Transaction *transaction = i2cActiveTransaction;
+    if (transaction != NULL) {
+        transaction->interrupts++;
+    }
+
+    i2cDmaWaitEnd = true;
+    i2cSensorBusInstance.hw->I2CM.INTENSET.reg = SERCOM_I2CM_INTENSET_MB;
+}
+
+/**
+  * @fn				static void I2cDmaTransferError(struct dma_resource *const resource)
+  * @brief			Callback function for when the DMA channel fails to feed the SERCOM
+  * @details			Releases the bus and completes the active transaction with ERROR_IO.
+  * @param[in]		resource DMA resource of the I2C channel
+  */
+static void I2cDmaTransferError(struct dma_resource *const resource)
+{
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-    xSemaphoreGiveFromISR(sensorI2cSemaphoreHandle, &xHigherPriorityTaskWoken);
+    i2cDmaActive = false;
+    i2cDmaWaitEnd = false;
+    i2cSensorBusInstance.hw->I2CM.INTENCLR.reg = SERCOM_I2CM_INTENCLR_MB | SERCOM_I2CM_INTENCLR_ERROR;
+    while (i2c_master_is_syncing(&i2cSensorBusInstance)) {
+    }
+    i2cSensorBusInstance.hw->I2CM.CTRLB.reg |= SERCOM_I2CM_CTRLB_CMD(3);
     sensorTransmitError = true;
+
+    I2cEngineComplete(ERROR_IO, &xHigherPriorityTaskWoken);
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
@@ -139,13 +280,41 @@ void I2cDriverRegisterSensorBusCallbacks(void)
 
     i2c_master_register_callback(&i2cSensorBusInstance, I2cSensorsError, I2C_MASTER_CALLBACK_ERROR);
     i2c_master_enable_callback(&i2cSensorBusInstance, I2C_MASTER_CALLBACK_ERROR);
+
+    /* Route SERCOM0 through our handler, which forwards to the ASF one. i2c_master_init() installs the ASF one directly. */
+    _sercom_set_handler(_sercom_get_sercom_inst_index(SERCOM0), I2cSensorsInterruptHandler);
+}
+
+/**
+ * @fn			static void I2cDmaInitialize(void)
+ * @brief       Allocates the DMA channel used for large writes on the sensor bus
+ * @details     The channel moves one byte into the SERCOM DATA register each time the SERCOM requests one (TX trigger).
+ *              If no channel is free the driver keeps working, with every transfer on the SERCOM interrupt path.
+ */
+static void I2cDmaInitialize(void)
+{
+    struct dma_resource_config config;
+
+    dma_get_config_defaults(&config);
+    config.peripheral_trigger = SERCOM0_DMAC_ID_TX;
+    config.trigger_action = DMA_TRIGGER_ACTION_BEAT;
+
+    if (STATUS_OK != dma_allocate(&i2cDmaResource, &config)) {
+        return;
+    }
+
+    dma_register_callback(&i2cDmaResource, I2cDmaTransferDone, DMA_CALLBACK_TRANSFER_DONE);
+    dma_enable_callback(&i2cDmaResource, DMA_CALLBACK_TRANSFER_DONE);
+    dma_register_callback(&i2cDmaResource, I2cDmaTransferError, DMA_CALLBACK_TRANSFER_ERROR);
+    dma_enable_callback(&i2cDmaResource, DMA_CALLBACK_TRANSFER_ERROR);
+    i2cDmaReady = true;
 }
 
 /**
  * @fn			int32_t I2cInitializeDriver(void)
  * @brief       Function call to initialize the I2C driver\
  * @details     This function must be called from an RTOS thread if using RTOS, and must be called before any I2C call
- * @note
+ * @note        After this call transactions can be queued with I2cSubmitTransaction() or the blocking wrappers.
  */
 int32_t I2cInitializeDriver(void)
 {
@@ -155,13 +324,11 @@ int32_t I2cInitializeDriver(void)
     if (STATUS_OK != error) goto exit;
 
     I2cDriverRegisterSensorBusCallbacks();
+    I2cDmaInitialize();
 
-    sensorI2cMutexHandle = xSemaphoreCreateMutex();
-
-    sensorI2cSemaphoreHandle = xSemaphoreCreateBinary();
-    // xSemaphoreGive(sensorI2cSemaphoreHandle);
+    sensorI2cMutexHandle = xSemaphoreCreateMutexStatic(&sensorI2cMutexBuffer);
 
-    if (NULL == sensorI2cMutexHandle || NULL == sensorI2cSemaphoreHandle) {
+    if (NULL == sensorI2cMutexHandle) {
         error = STATUS_SUSPEND;  // Could not initialize mutex!
         goto exit;
     }
@@ -173,7 +340,8 @@ exit:
 /**
  * @fn    int32_t I2cWriteData(I2C_Data *data)
  * @brief       Function call to write an specified number of bytes on the given I2C bus
- * @details
+ * @details     Starts the write on the hardware right away. Used by the transaction engine; application code should queue
+ *              an I2C_Transaction instead so it does not collide with transfers already on the bus.
  * @param[in]   data Pointer to I2C data structure which has all the information needed to send an I2C message
  * @return      Returns an error message in case of error. See ErrCodes.h
  * @note
@@ -211,7 +379,8 @@ exit:
 /**
  * @fn    int32_t I2cReadData(I2C_Data *data)
  * @brief       Function call to read an specified number of bytes on the given I2C bus
- * @details
+ * @details     Starts the read on the hardware right away. Used by the transaction engine; application code should queue
+ *              an I2C_Transaction instead so it does not collide with transfers already on the bus.
  * @param[in]   data Pointer to I2C data structure which has all the information needed to send an I2C message
  * @return      Returns an error message in case of error. See ErrCodes.h
  * @note
@@ -222,7 +391,7 @@ int32_t I2cReadData(I2C_Data *data)
     enum status_code hwError;
 
     // Check parameters
-    if (data == NULL || data->msgOut == NULL) {
+    if (data == NULL || data->msgIn == NULL) {
         error = ERR_INVALID_ARG;
         goto exit;
     }
@@ -245,6 +414,58 @@ exit:
     return error;
 }
 
+/**
+ * @fn    static int32_t I2cDmaWriteData(uint8_t address, const uint8_t *header, uint8_t headerLen, const uint8_t *msgOut, uint8_t lenOut)
+ * @brief       Function call to write header + data on the I2C bus through DMA, in a single auto length transfer
+ * @details     The header and the data are gathered by a two descriptor chain, so neither has to be copied. Only the last
+ *              descriptor raises an interrupt; the SERCOM sends START, address and length on its own. The SERCOM
+ *              master-on-bus and error interrupts are enabled from the start, so a NACK or a lost bus ends the write.
+ * @param[in]   address 7-bit I2C device address
+ * @param[in]   header Bytes sent first. May be NULL if headerLen is 0
+ * @param[in]   headerLen Length of header
+ * @param[in]   msgOut Bytes sent after the header
+ * @param[in]   lenOut Length of msgOut. headerLen + lenOut must not exceed I2C_MAX_CHUNK_LEN
+ * @return      Returns an error message in case of error. See ErrCodes.h
+ * @note        Used by the transaction engine, with interrupts masked
+ */
+static int32_t I2cDmaWriteData(uint8_t address, const uint8_t *header, uint8_t headerLen, const uint8_t *msgOut, uint8_t lenOut)
+{
+    struct dma_descriptor_config descriptorConfig;
+    DmacDescriptor *dataDescriptor = &i2cDmaDescriptors[(headerLen > 0) ? 1 : 0];
+
+    dma_descriptor_get_config_defaults(&descriptorConfig);
+    descriptorConfig.dst_increment_enable = false;
+    descriptorConfig.destination_address = (uint32_t)(&i2cSensorBusInstance.hw->I2CM.DATA.reg);
+
+    // Source addresses of incrementing descriptors point past the end of the block
+    if (headerLen > 0) {
+        descriptorConfig.block_transfer_count = headerLen;
+        descriptorConfig.source_address = (uint32_t)header + headerLen;
+        descriptorConfig.next_descriptor_address = (uint32_t)dataDescriptor;
+        dma_descriptor_create(&i2cDmaDescriptors[0], &descriptorConfig);
+    }
+
+    descriptorConfig.block_action = DMA_BLOCK_ACTION_INT;
+    descriptorConfig.block_transfer_count = lenOut;
+    descriptorConfig.source_address = (uint32_t)msgOut + lenOut;
+    descriptorConfig.next_descriptor_address = 0;
+    dma_descriptor_create(dataDescriptor, &descriptorConfig);
+
+    dma_update_descriptor(&i2cDmaResource, &i2cDmaDescriptors[0]);
+    if (STATUS_OK != dma_start_transfer_job(&i2cDmaResource)) {
+        return ERROR_IO;
+    }
+
+    i2cDmaWaitEnd = false;
+    i2cDmaActive = true;
+    while (i2c_master_is_syncing(&i2cSensorBusInstance)) {
+    }
+    i2c_master_dma_set_transfer(&i2cSensorBusInstance, address, headerLen + lenOut, I2C_TRANSFER_WRITE);
+    i2cSensorBusInstance.hw->I2CM.INTFLAG.reg = SERCOM_I2CM_INTFLAG_ERROR;
+    i2cSensorBusInstance.hw->I2CM.INTENSET.reg = SERCOM_I2CM_INTENSET_MB | SERCOM_I2CM_INTENSET_ERROR;
+    return ERROR_NONE;
+}
+
 /**
  * @fn			int32_t I2cFreeMutex(eI2cBuses bus)
  * @brief       Frees the mutex of the given I2C bus
@@ -280,179 +501,644 @@ int32_t I2cGetMutex(TickType_t waitTime)
     return error;
 }
 
-static int32_t I2cGetSemaphoreHandle(SemaphoreHandle_t *handle)
+/******************************************************************************
+ * Transaction Engine
+ ******************************************************************************/
+
+/**
+ * @fn			static I2C_Transaction *I2cEnginePop(void)
+ * @brief       Removes the next transaction to run from the priority lanes
+ * @return      Highest priority pending transaction, or NULL if nothing is queued
+ * @note        Must be called with interrupts masked (critical section or SERCOM interrupt)
+ */
+static I2C_Transaction *I2cEnginePop(void)
 {
-    int32_t error = ERROR_NONE;
-    *handle = sensorI2cSemaphoreHandle;
-    return error;
+    for (uint8_t lane = 0; lane < I2C_PRIORITY_MAX; lane++) {
+        I2C_Transaction *transaction = i2cQueueHead[lane];
+        if (transaction != NULL) {
+            i2cQueueHead[lane] = transaction->next;
+            if (i2cQueueHead[lane] == NULL) {
+                i2cQueueTail[lane] = NULL;
+            }
+            transaction->next = NULL;
+            i2cEngineStats.queueDepth--;
+            return transaction;
+        }
+    }
+    return NULL;
 }
 
 /**
- * @fn			static uint8_t I2cGetTaskErrorStatus(I2C_Data *data)
- * @brief       Sets the error state of the latest I2C bus transaction for a given I2C data, which holds which physical I2C
- *bus we are using.
- * @details     This error flag is set to indicate when a I2C transaction has failed on a given I2C bus (encapsulated in
- *the I2C data structure).
- * @return      Returns an error message in case of error. See ErrCodes.h
- * @note
+ * @fn			static void I2cEnginePush(I2C_Transaction *transaction)
+ * @brief       Appends a transaction at the end of its priority lane
+ * @note        Must be called with interrupts masked (critical section or SERCOM interrupt)
  */
-static uint8_t I2cGetTaskErrorStatus(void)
+static void I2cEnginePush(I2C_Transaction *transaction)
 {
-    return sensorTransmitError;
+    eI2cPriority lane = transaction->priority;
+
+    transaction->next = NULL;
+    transaction->status = ERROR_BUSY;
+    if (i2cQueueTail[lane] == NULL) {
+        i2cQueueHead[lane] = transaction;
+    } else {
+        i2cQueueTail[lane]->next = transaction;
+    }
+    i2cQueueTail[lane] = transaction;
+
+    i2cEngineStats.submitted++;
+    i2cEngineStats.queueDepth++;
+    if (i2cEngineStats.queueDepth > i2cEngineStats.maxQueueDepth) {
+        i2cEngineStats.maxQueueDepth = i2cEngineStats.queueDepth;
+    }
 }
 
 /**
- * @fn			static uint8_t I2cSetTaskErrorStatus(I2C_Data *data, uint8_t value)
- * @brief       Sets the error state of the latest I2C bus transaction for a given I2C data, which holds which physical I2C
- *bus we are using.
- * @details     This error flag is set to indicate when a I2C transaction has failed on a given I2C bus (encapsulated in
- *the I2C data structure).
- * @param[in]   value Value to which to set the error flag to.
- * @return      Returns an error message in case of error. See ErrCodes.h
- * @note
+ * @fn			static bool I2cEngineUnlink(I2C_Transaction *transaction)
+ * @brief       Removes a pending transaction from its priority lane
+ * @return      Returns true if the transaction was found in the lane
+ * @note        Must be called with interrupts masked (critical section or SERCOM interrupt)
  */
-static void I2cSetTaskErrorStatus(uint8_t value)
+static bool I2cEngineUnlink(I2C_Transaction *transaction)
 {
-    sensorTransmitError = value;
+    eI2cPriority lane = transaction->priority;
+    I2C_Transaction *previous = NULL;
+
+    for (I2C_Transaction *iter = i2cQueueHead[lane]; iter != NULL; iter = iter->next) {
+        if (iter == transaction) {
+            if (previous == NULL) {
+                i2cQueueHead[lane] = iter->next;
+            } else {
+                previous->next = iter->next;
+            }
+            if (i2cQueueTail[lane] == iter) {
+                i2cQueueTail[lane] = previous;
+            }
+            iter->next = NULL;
+            i2cEngineStats.queueDepth--;
+            return true;
+        }
+        previous = iter;
+    }
+    return false;
 }
 
 /**
-  * @fn			int32_t I2cWriteDataWait(I2C_Data *data, const TickType_t delay, const TickType_t xMaxBlockTime)
-  * @brief       This is the main function to use to write data from an I2C device on a given I2C Bus. This function is blocking.
-  * @details     This function writes data from an I2C device, by writing the requested bytes.This function is blocking (bare-metal) or it
-                                 makes the current thread sleep until the I2C bus has finished the transaction (FREERTOS version).
-                                 On FreeRtos, this function gets the mutex for the respective I2C bus.
-  * @param[in]   data Pointer to I2C data structure which has all the information needed to send an I2C message
-  * @param[in]   delay Delay that the I2C device needs to return the response. Can be 0 if the response is ready instantly. It can be
-                                 the delay an I2C device needs to make a measurement.
-  * @param[in]   xMaxBlockTime Maximum time for the thread to wait until the I2C mutex is free.
-  * @return      Returns an error message in case of error.
-  * @note
-  */
-int32_t I2cWriteDataWait(I2C_Data *data, const TickType_t xMaxBlockTime)
+ * @fn			static uint32_t I2cEngineTimestampUs(void)
+ * @brief       Microsecond timestamp built from the tick count and the SysTick down counter
+ * @note        Must be called with interrupts masked. Only differences between two timestamps are meaningful.
+ */
+static uint32_t I2cEngineTimestampUs(void)
 {
-    int32_t error = ERROR_NONE;
-    SemaphoreHandle_t semHandle = NULL;
+    uint32_t reload = SysTick->LOAD + 1;
+    uint32_t ticks = xTaskGetTickCountFromISR();
+    uint32_t elapsed = reload - 1 - SysTick->VAL;
+
+    // The counter wrapped but the tick interrupt has not run yet
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && elapsed < reload / 2) {
+        ticks++;
+    }
+    return (ticks * portTICK_PERIOD_MS * 1000) + (elapsed * portTICK_PERIOD_MS * 1000) / reload;
+}
+
+/**
+ * @fn			static bool I2cEngineUseDma(I2C_Transaction *transaction)
+ * @brief       Decides whether the write segment of a transaction goes through DMA
+ * @details     DMA runs auto length transfers, so a write without header must fit in a single one. Writes with a header are
+ *              chunked anyway, and can always use DMA.
+ */
+static bool I2cEngineUseDma(I2C_Transaction *transaction)
+{
+    if (!i2cDmaReady || 0 == i2cDmaThreshold || 0 == transaction->data.lenOut) {
+        return false;
+    }
+    if (0 == transaction->headerLen && transaction->data.lenOut > I2C_MAX_CHUNK_LEN) {
+        return false;
+    }
+    return (transaction->headerLen + transaction->data.lenOut) >= i2cDmaThreshold;
+}
+
+/**
+ * @fn			static int32_t I2cEngineStartWrite(I2C_Transaction *transaction)
+ * @brief       Puts the next chunk of the write segment of a transaction on the bus
+ * @details     Without a header the whole segment is one chunk. With a header, every chunk is the header followed by up to
+ *              I2C_MAX_CHUNK_LEN - headerLen bytes of data, gathered by DMA or copied to a bounce buffer on the interrupt path.
+ * @note        Must be called with interrupts masked (critical section or SERCOM interrupt)
+ */
+static int32_t I2cEngineStartWrite(I2C_Transaction *transaction)
+{
+    const uint8_t *chunk = transaction->data.msgOut + transaction->outOffset;
+    uint16_t remaining = transaction->data.lenOut - transaction->outOffset;
+    I2C_Data chunkData;
+
+    transaction->chunkLen = remaining;
+    if (transaction->headerLen > 0 && remaining > (I2C_MAX_CHUNK_LEN - transaction->headerLen)) {
+        transaction->chunkLen = I2C_MAX_CHUNK_LEN - transaction->headerLen;
+    }
+
+    if (transaction->useDma) {
+        return I2cDmaWriteData(transaction->data.address, transaction->header, transaction->headerLen, chunk,
+                               (uint8_t)transaction->chunkLen);
+    }
+
+    chunkData.address = transaction->data.address;
+    chunkData.msgOut = chunk;
+    chunkData.lenOut = transaction->chunkLen;
+    chunkData.msgIn = NULL;
+    chunkData.lenIn = 0;
+    if (transaction->headerLen > 0) {
+        memcpy(i2cBounceBuffer, transaction->header, transaction->headerLen);
+        memcpy(&i2cBounceBuffer[transaction->headerLen], chunk, transaction->chunkLen);
+        chunkData.msgOut = i2cBounceBuffer;
+        chunkData.lenOut = transaction->headerLen + transaction->chunkLen;
+    }
+    return I2cWriteData(&chunkData);
+}
+
+/**
+ * @fn			static void I2cEngineSetBusy(bool busy)
+ * @brief       Marks the bus busy or free, holding a sleep lock while a transfer is on it
+ * @details     The SERCOM runs on GCLK 0 and the DMA path needs the AHB clock, so the CPU may only sleep in IDLE 0 until
+ *              the transfer ends.
+ * @note        Must be called with interrupts masked (critical section or SERCOM interrupt)
+ */
+static void I2cEngineSetBusy(bool busy)
+{
+    if (busy && !i2cEngineBusy) {
+        sleepmgr_lock_mode(SLEEPMGR_IDLE_0);
+    } else if (!busy && i2cEngineBusy) {
+        sleepmgr_unlock_mode(SLEEPMGR_IDLE_0);
+    }
+    i2cEngineBusy = busy;
+}
+
+/**
+ * @fn			static void I2cEngineFinish(int32_t status, BaseType_t *pxHigherPriorityTaskWoken)
+ * @brief       Retires the active transaction and reports its result to its owner
+ * @details     The owner is told through the completion callback and/or the I2C_NOTIFY_BIT task notification. If the owner
+ *              already cancelled the transaction there is nobody to tell and only the bus is released.
+ * @note        Must be called with interrupts masked (critical section or SERCOM interrupt)
+ */
+static void I2cEngineFinish(int32_t status, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    I2C_Transaction *transaction = i2cActiveTransaction;
+
+    i2cActiveTransaction = NULL;
+    I2cEngineSetBusy(false);
+    if (transaction == NULL) {
+        return;
+    }
+
+    i2cEngineStats.busyTicks += xTaskGetTickCountFromISR() - i2cActiveStartTick;
+    transaction->durationUs = I2cEngineTimestampUs() - i2cActiveStartUs;
+
+    I2C_Mode_Stats *mode = transaction->useDma ? &i2cEngineStats.dma : &i2cEngineStats.isr;
+    mode->transactions++;
+    mode->bytes += transaction->data.lenOut + transaction->data.lenIn;
+    if (transaction->headerLen > 0) {
+        mode->bytes += transaction->headerLen * ((transaction->data.lenOut + (I2C_MAX_CHUNK_LEN - transaction->headerLen) - 1) /
+                                                 (I2C_MAX_CHUNK_LEN - transaction->headerLen));
+    }
+    mode->interrupts += transaction->interrupts;
+    mode->busyUs += transaction->durationUs;
+
+    if (status == ERROR_NONE) {
+        i2cEngineStats.completed++;
+    } else {
+        i2cEngineStats.errors++;
+    }
+
+    // The owner may reuse the descriptor from its callback, so read everything we need first
+    TaskHandle_t notifyTask = transaction->notifyTask;
+    I2cTransactionCallback callback = transaction->callback;
+
+    transaction->status = status;
+    if (callback != NULL) {
+        callback(transaction, pxHigherPriorityTaskWoken);
+    }
+    if (notifyTask != NULL) {
+        xTaskNotifyFromISR(notifyTask, I2C_NOTIFY_BIT, eSetBits, pxHigherPriorityTaskWoken);
+    }
+}
+
+/**
+ * @fn			static void I2cEngineStartNext(BaseType_t *pxHigherPriorityTaskWoken)
+ * @brief       Puts the next queued transaction on the bus, if the bus is free
+ * @details     Transactions that fail to start are completed with ERROR_IO and the next one is tried, so a bad descriptor
+ *              never stalls the queue.
+ * @note        Must be called with interrupts masked (critical section or SERCOM interrupt)
+ */
+static void I2cEngineStartNext(BaseType_t *pxHigherPriorityTaskWoken)
+{
+    while (!i2cEngineBusy && !i2cEngineRecovering) {
+        I2C_Transaction *transaction = I2cEnginePop();
+        if (transaction == NULL) {
+            I2cSensorBusState.i2cState = I2C_BUS_READY;
+            return;
+        }
+
+        TickType_t now = xTaskGetTickCountFromISR();
+        TickType_t waited = now - transaction->submitTick;
+        i2cEngineStats.waitTicks += waited;
+        if (waited > i2cEngineStats.maxWaitTicks) {
+            i2cEngineStats.maxWaitTicks = waited;
+        }
+
+        i2cActiveTransaction = transaction;
+        i2cActiveStartTick = now;
+        i2cActiveStartUs = I2cEngineTimestampUs();
+        I2cEngineSetBusy(true);
+        I2cSensorBusState.i2cState = I2C_BUS_BUSY;
+        I2cSensorBusState.currentAddress = transaction->data.address;
+        I2cSensorBusState.readLen = transaction->data.lenIn;
+
+        int32_t error;
+        transaction->interrupts = 0;
+        transaction->outOffset = 0;
+        transaction->useDma = I2cEngineUseDma(transaction);
+        if (transaction->data.lenOut > 0) {
+            transaction->phase = I2C_PHASE_WRITE;
+            error = I2cEngineStartWrite(transaction);
+        } else {
+            transaction->phase = I2C_PHASE_READ;
+            error = I2cReadData(&transaction->data);
+        }
+
+        if (ERROR_NONE != error) {
+            I2cEngineFinish(ERROR_IO, pxHigherPriorityTaskWoken);
+        }
+    }
+}
+
+/**
+ * @fn			static void I2cEngineComplete(int32_t status, BaseType_t *pxHigherPriorityTaskWoken)
+ * @brief       Retires the active transaction and starts the next one back-to-back
+ * @note        Called from the SERCOM interrupt callbacks
+ */
+static void I2cEngineComplete(int32_t status, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    I2cEngineFinish(status, pxHigherPriorityTaskWoken);
+    I2cEngineStartNext(pxHigherPriorityTaskWoken);
+}
+
+/**
+ * @fn			static void I2cEngineWriteDone(int32_t status, BaseType_t *pxHigherPriorityTaskWoken)
+ * @brief       Advances the active transaction once a chunk of its write segment is on the wire
+ * @details     Starts the next chunk, then the read segment, and completes the transaction when there is nothing left.
+ * @note        Called from the SERCOM interrupt, for both the interrupt and the DMA paths
+ */
+static void I2cEngineWriteDone(int32_t status, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    I2C_Transaction *transaction = i2cActiveTransaction;
+
+    if (transaction != NULL && ERROR_NONE == status) {
+        transaction->outOffset += transaction->chunkLen;
+        if (transaction->outOffset < transaction->data.lenOut) {
+            if (ERROR_NONE != I2cEngineStartWrite(transaction)) {
+                I2cEngineComplete(ERROR_IO, pxHigherPriorityTaskWoken);
+            }
+            return;
+        }
+        if (transaction->data.lenIn > 0) {
+            transaction->phase = I2C_PHASE_READ;
+            if (ERROR_NONE != I2cReadData(&transaction->data)) {
+                I2cEngineComplete(ERROR_IO, pxHigherPriorityTaskWoken);
+            }
+            return;
+        }
+    }
+    I2cEngineComplete(status, pxHigherPriorityTaskWoken);
+}
 
-    //---0. Get Mutex
-    error = I2cGetMutex(WAIT_I2C_LINE_MS);
+/**
+ * @fn			static void I2cEngineRecoverBus(void)
+ * @brief       Resets the SERCOM after an in-flight transaction was cancelled, then resumes the queue
+ * @details     A transfer that does not complete in time means the bus or the peripheral is stuck. Resetting and
+ *              reconfiguring the SERCOM releases it, and no stale interrupt can complete the next transaction by mistake.
+ * @note        Task context only
+ */
+static void I2cEngineRecoverBus(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (i2cDmaReady) {
+        dma_abort_job(&i2cDmaResource);
+    }
+    i2cDmaActive = false;
+    i2cDmaWaitEnd = false;
+    i2c_master_reset(&i2cSensorBusInstance);
+    if (STATUS_OK == I2cDriverConfigureSensorBus()) {
+        I2cDriverRegisterSensorBusCallbacks();
+    }
+
+    taskENTER_CRITICAL();
+    i2cEngineRecovering = false;
+    I2cEngineSetBusy(false);
+    I2cEngineStartNext(&xHigherPriorityTaskWoken);
+    taskEXIT_CRITICAL();
+
+    if (xHigherPriorityTaskWoken != pdFALSE) {
+        taskYIELD();
+    }
+}
+
+/**
+ * @fn			static int32_t I2cValidateTransaction(I2C_Transaction *transaction)
+ * @brief       Checks that a transaction descriptor can be queued
+ * @return      Returns ERROR_NONE if the descriptor is valid, an error code otherwise
+ */
+static int32_t I2cValidateTransaction(I2C_Transaction *transaction)
+{
+    if (transaction == NULL || transaction->priority >= I2C_PRIORITY_MAX) {
+        return ERROR_INVALID_ARG;
+    }
+    if ((transaction->data.lenOut == 0 && transaction->data.lenIn == 0) ||
+        (transaction->data.lenOut > 0 && transaction->data.msgOut == NULL) ||
+        (transaction->data.lenIn > 0 && transaction->data.msgIn == NULL)) {
+        return ERROR_INVALID_DATA;
+    }
+    if (transaction->headerLen > 0 &&
+        (transaction->header == NULL || transaction->data.lenOut == 0 || transaction->headerLen >= I2C_MAX_CHUNK_LEN)) {
+        return ERROR_INVALID_DATA;
+    }
+    if (transaction->status == ERROR_BUSY) {
+        return ERROR_BUSY;  // Already queued or in flight
+    }
+    return ERROR_NONE;
+}
+
+/**
+ * @fn			void I2cInitTransaction(I2C_Transaction *transaction, I2C_Data *data, eI2cPriority priority)
+ * @brief       Fills a transaction descriptor from an I2C data structure
+ * @details     The header, callback, notification task and context are cleared; set them after this call if needed.
+ * @param[out]  transaction Descriptor to initialize
+ * @param[in]   data Address and write/read segments. Copied into the descriptor, but the buffers it points to are not.
+ * @param[in]   priority Priority lane to queue the transaction on
+ */
+void I2cInitTransaction(I2C_Transaction *transaction, I2C_Data *data, eI2cPriority priority)
+{
+    transaction->data = *data;
+    transaction->priority = priority;
+    transaction->header = NULL;
+    transaction->headerLen = 0;
+    transaction->callback = NULL;
+    transaction->notifyTask = NULL;
+    transaction->context = NULL;
+    transaction->status = ERROR_NONE;
+    transaction->submitTick = 0;
+    transaction->interrupts = 0;
+    transaction->durationUs = 0;
+    transaction->outOffset = 0;
+    transaction->chunkLen = 0;
+    transaction->useDma = false;
+    transaction->phase = I2C_PHASE_WRITE;
+    transaction->next = NULL;
+}
+
+/**
+ * @fn			int32_t I2cSubmitTransaction(I2C_Transaction *transaction)
+ * @brief       Queues a transaction on the sensor bus without blocking
+ * @details     If the bus is idle the transaction starts immediately, otherwise it runs from the SERCOM interrupt as soon
+ *              as the transactions ahead of it are done. The owner learns about completion through the descriptor callback
+ *              or task notification, or by calling I2cWaitTransaction().
+ * @param[in]   transaction Descriptor initialized with I2cInitTransaction(). Must stay valid until it completes.
+ * @return      Returns ERROR_NONE if the transaction was queued, an error code otherwise
+ */
+int32_t I2cSubmitTransaction(I2C_Transaction *transaction)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    int32_t error = I2cValidateTransaction(transaction);
     if (ERROR_NONE != error) goto exit;
 
-    //---1. Get Semaphore Handle
-    error = I2cGetSemaphoreHandle(&semHandle);
+    transaction->submitTick = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    I2cEnginePush(transaction);
+    I2cEngineStartNext(&xHigherPriorityTaskWoken);
+    taskEXIT_CRITICAL();
+
+    if (xHigherPriorityTaskWoken != pdFALSE) {
+        taskYIELD();
+    }
+
+exit:
+    return error;
+}
+
+/**
+ * @fn			int32_t I2cSubmitTransactionFromISR(I2C_Transaction *transaction, BaseType_t *pxHigherPriorityTaskWoken)
+ * @brief       Interrupt safe version of I2cSubmitTransaction()
+ * @param[in]   transaction Descriptor initialized with I2cInitTransaction(). Must stay valid until it completes.
+ * @param[out]  pxHigherPriorityTaskWoken Set to pdTRUE if a context switch should be requested on ISR exit
+ * @return      Returns ERROR_NONE if the transaction was queued, an error code otherwise
+ */
+int32_t I2cSubmitTransactionFromISR(I2C_Transaction *transaction, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    int32_t error = I2cValidateTransaction(transaction);
     if (ERROR_NONE != error) goto exit;
 
-    //---2. Initiate sending data
+    transaction->submitTick = xTaskGetTickCountFromISR();
+
+    UBaseType_t uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    I2cEnginePush(transaction);
+    I2cEngineStartNext(pxHigherPriorityTaskWoken);
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+exit:
+    return error;
+}
+
+/**
+ * @fn			int32_t I2cCancelTransaction(I2C_Transaction *transaction)
+ * @brief       Withdraws a transaction so its descriptor can be released
+ * @details     A queued transaction is simply removed. A transaction already on the bus is aborted by resetting the SERCOM.
+ *              Either way no callback or notification is delivered for it afterwards.
+ * @param[in]   transaction Descriptor previously passed to I2cSubmitTransaction()
+ * @return      Returns ERROR_NONE if the transaction was cancelled, ERROR_NOT_FOUND if it had already completed
+ * @note        Task context only
+ */
+int32_t I2cCancelTransaction(I2C_Transaction *transaction)
+{
+    bool inFlight = false;
+
+    taskENTER_CRITICAL();
+    if (transaction->status != ERROR_BUSY) {
+        taskEXIT_CRITICAL();
+        return ERROR_NOT_FOUND;
+    }
+    if (transaction == i2cActiveTransaction) {
+        i2cActiveTransaction = NULL;
+        i2cEngineRecovering = true;
+        inFlight = true;
+    } else {
+        I2cEngineUnlink(transaction);
+    }
+    transaction->status = ERROR_ABORTED;
+    i2cEngineStats.cancelled++;
+    taskEXIT_CRITICAL();
 
-    error = I2cWriteData(data);
-    if (ERROR_NONE != error) {
-        goto exitError0;
+    if (inFlight) {
+        I2cEngineRecoverBus();
     }
+    return ERROR_NONE;
+}
 
-    //---2. Wait for binary semaphore to tell us that we are done!
-    if (xSemaphoreTake(semHandle, xMaxBlockTime) == pdTRUE) {
-        /* The transmission ended as expected. We now delay until the I2C sensor is finished */
-        if (I2cGetTaskErrorStatus()) {
-            I2cSetTaskErrorStatus(false);
-            if (error != ERROR_NONE) {
-                error = ERROR_I2C_HANG_RESET;
-            } else {
-                error = ERROR_ABORTED;
+/**
+ * @fn			int32_t I2cWaitTransaction(I2C_Transaction *transaction, const TickType_t xMaxBlockTime)
+ * @brief       Blocks the calling task until a transaction it owns completes
+ * @details     The transaction must have been submitted with notifyTask set to the calling task. If it does not complete in
+ *              time it is cancelled, so the descriptor can be released as soon as this function returns.
+ * @param[in]   transaction Descriptor previously passed to I2cSubmitTransaction()
+ * @param[in]   xMaxBlockTime Maximum time to wait, including the time spent queued behind other transactions
+ * @return      Returns the transaction result, or ERROR_TIMEOUT if it was cancelled
+ */
+int32_t I2cWaitTransaction(I2C_Transaction *transaction, const TickType_t xMaxBlockTime)
+{
+    TimeOut_t xTimeOut;
+    TickType_t xTicksToWait = xMaxBlockTime;
+    uint32_t notifiedValue;
+
+    vTaskSetTimeOutState(&xTimeOut);
+    while (transaction->status == ERROR_BUSY) {
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) != pdFALSE) {
+            if (ERROR_NONE == I2cCancelTransaction(transaction)) {
+                return ERROR_TIMEOUT;
             }
-            goto exitError0;
+            break;  // It completed while we were giving up on it
         }
-    } else {
-        /* The call to ulTaskNotifyTake() timed out. */
-        error = ERR_TIMEOUT;
-        goto exitError0;
+        xTaskNotifyWait(0, I2C_NOTIFY_BIT, &notifiedValue, xTicksToWait);
     }
+    return transaction->status;
+}
+
+/**
+ * @fn			int32_t I2cTransferWait(I2C_Transaction *transaction, const TickType_t xMaxBlockTime)
+ * @brief       Queues a transaction and blocks the calling task until it completes
+ * @param[in]   transaction Descriptor initialized with I2cInitTransaction(). Can live on the caller stack.
+ * @param[in]   xMaxBlockTime Maximum time to wait, including the time spent queued behind other transactions
+ * @return      Returns the transaction result
+ */
+int32_t I2cTransferWait(I2C_Transaction *transaction, const TickType_t xMaxBlockTime)
+{
+    int32_t error;
+
+    transaction->notifyTask = xTaskGetCurrentTaskHandle();
+    error = I2cSubmitTransaction(transaction);
+    if (ERROR_NONE != error) goto exit;
+
+    error = I2cWaitTransaction(transaction, xMaxBlockTime);
 
-    //---8. Release Mutex
-    error |= I2cFreeMutex();
-// xSemaphoreGive(semHandle);
 exit:
     return error;
+}
 
-exitError0:
-    error |= I2cFreeMutex();
-    // xSemaphoreGive(semHandle);
-    return error;
+/**
+ * @fn			void I2cGetEngineStats(I2C_Engine_Stats *stats)
+ * @brief       Takes a consistent snapshot of the transaction engine counters
+ * @details     Bus utilisation is busyTicks over the elapsed ticks; queueing overhead is waitTicks over completed transactions.
+ * @param[out]  stats Structure the counters are copied to
+ */
+void I2cGetEngineStats(I2C_Engine_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = i2cEngineStats;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			bool I2cIsBusy(void)
+ * @brief       Tells if a transaction is on the bus or waiting for it, so bulk writers can postpone theirs
+ */
+bool I2cIsBusy(void)
+{
+    return i2cEngineBusy || i2cEngineRecovering || i2cEngineStats.queueDepth > 0;
+}
+
+/**
+ * @fn			void I2cSetDmaThreshold(uint16_t threshold)
+ * @brief       Sets the size from which writes go through DMA instead of one SERCOM interrupt per byte
+ * @param[in]   threshold Minimum write size in bytes, header included. 0 sends everything through the interrupt path.
+ * @note        Takes effect for transactions that reach the bus after the call.
+ */
+void I2cSetDmaThreshold(uint16_t threshold)
+{
+    taskENTER_CRITICAL();
+    i2cDmaThreshold = threshold;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			uint16_t I2cGetDmaThreshold(void)
+ * @brief       Returns the size from which writes go through DMA, or 0 if DMA is disabled or unavailable
+ */
+uint16_t I2cGetDmaThreshold(void)
+{
+    return i2cDmaReady ? i2cDmaThreshold : 0;
+}
+
+/**
+  * @fn			int32_t I2cWriteDataWait(I2C_Data *data, const TickType_t xMaxBlockTime)
+  * @brief       This is the main function to use to write data from an I2C device on a given I2C Bus. This function is blocking.
+  * @details     Queues a write-only transaction on the normal priority lane and makes the current thread sleep until the
+                                 transaction engine has finished it. Other tasks keep queueing transactions meanwhile.
+  * @param[in]   data Pointer to I2C data structure which has all the information needed to send an I2C message. The read segment is ignored.
+  * @param[in]   xMaxBlockTime Maximum time for the thread to wait for the transfer, on top of WAIT_I2C_LINE_MS of queueing.
+  * @return      Returns an error message in case of error.
+  * @note
+  */
+int32_t I2cWriteDataWait(I2C_Data *data, const TickType_t xMaxBlockTime)
+{
+    I2C_Transaction transaction;
+
+    if (data == NULL) {
+        return ERROR_INVALID_ARG;
+    }
+
+    I2cInitTransaction(&transaction, data, I2C_PRIORITY_NORMAL);
+    transaction.data.lenIn = 0;
+    return I2cTransferWait(&transaction, WAIT_I2C_LINE_MS + xMaxBlockTime);
 }
 
 /**
   * @fn			int32_t I2cReadDataWait(I2C_Data *data, const TickType_t delay, const TickType_t xMaxBlockTime)
   * @brief       This is the main function to use to read data from an I2C device on a given I2C Bus. This function is blocking.
-  * @details     This function reads data from an I2C device, by first writing to the address (I2C device address + register) and then reading the requested bytes. This
-                                 function is blocking (bare-metal) or it makes the current thread sleep until the I2C bus has finished the transaction (FREERTOS version).
-                                 On FreeRtos, this function gets the mutex for the respective I2C bus.
+  * @details     This function reads data from an I2C device, by first writing to the address (I2C device address + register) and then reading the requested bytes.
+                                 With no delay both segments run as one queued transaction. With a delay the write and the read are queued
+                                 separately, so the bus serves other tasks while the device is busy (e.g. measuring).
   * @param[in]   data Pointer to I2C data structure which has all the information needed to send an I2C message
   * @param[in]   delay Delay that the I2C device needs to return the response. Can be 0 if the response is ready instantly. It can be the delay an I2C device needs to make a measurement.
-  * @param[in]   xMaxBlockTime Maximum time for the thread to wait until the I2C mutex is free.
+  * @param[in]   xMaxBlockTime Maximum time for the thread to wait for each transfer, on top of WAIT_I2C_LINE_MS of queueing.
   * @return      Returns an error message in case of error. See ErrCodes.h
-  * @note        THIS IS THE FREERTOS VERSION! DO NOT Declare #define USE_FREERTOS if you wish to use the baremetal version!
+  * @note
   */
 int32_t I2cReadDataWait(I2C_Data *data, const TickType_t delay, const TickType_t xMaxBlockTime)
 {
     int32_t error = ERROR_NONE;
-    SemaphoreHandle_t semHandle = NULL;
+    I2C_Transaction transaction;
 
-    //---0. Get Mutex
-    error = I2cGetMutex(WAIT_I2C_LINE_MS);
-    if (ERROR_NONE != error) goto exit;
+    if (data == NULL) {
+        error = ERROR_INVALID_ARG;
+        goto exit;
+    }
 
-    //---1. Get Semaphore Handle
-    error = I2cGetSemaphoreHandle(&semHandle);
-    if (ERROR_NONE != error) goto exit;
+    I2cInitTransaction(&transaction, data, I2C_PRIORITY_NORMAL);
+    if (0 == delay) {
+        error = I2cTransferWait(&transaction, WAIT_I2C_LINE_MS + xMaxBlockTime);
+        goto exit;
+    }
 
-    //---2. Initiate sending data
+    //---1. Send the command, then release the bus while the device works
+    transaction.data.lenIn = 0;
+    error = I2cTransferWait(&transaction, WAIT_I2C_LINE_MS + xMaxBlockTime);
+    if (ERROR_NONE != error) goto exit;
 
-    error = I2cWriteData(data);
-    if (ERROR_NONE != error) {
-        goto exitError0;
-    }
+    vTaskDelay(delay);
 
-    //---2. Wait for binary semaphore to tell us that we are done!
-    if (xSemaphoreTake(semHandle, xMaxBlockTime) == pdTRUE) {
-        /* The transmission ended as expected. We now delay until the I2C sensor is finished */
-        if (I2cGetTaskErrorStatus()) {
-            I2cSetTaskErrorStatus(false);
-            error = ERROR_ABORTED;
-            goto exitError0;
-        }
-        vTaskDelay(delay);
-    } else {
-        /* The call to ulTaskNotifyTake() timed out. */
-        error = ERR_TIMEOUT;
-        goto exitError0;
-    }
-
-    //---6. Initiate Read data
-    error = I2cReadData(data);
-    if (ERROR_NONE != error) {
-        goto exitError0;
-    }
-    //---7. Wait for notification
-    if (xSemaphoreTake(semHandle, xMaxBlockTime) == pdTRUE) {
-        /* The transmission ended as expected. We now delay until the I2C sensor is finished */
-        if (I2cGetTaskErrorStatus()) {
-            I2cSetTaskErrorStatus(false);
-            error = ERROR_ABORTED;
-            goto exitError0;
-        }
-    } else {
-        /* The call to ulTaskNotifyTake() timed out. */
-        error = ERR_TIMEOUT;
-        goto exitError0;
-    }
+    //---2. Read the response
+    I2cInitTransaction(&transaction, data, I2C_PRIORITY_NORMAL);
+    transaction.data.lenOut = 0;
+    error = I2cTransferWait(&transaction, WAIT_I2C_LINE_MS + xMaxBlockTime);
 
-    //---8. Release Mutex
-    error = I2cFreeMutex();
-// xSemaphoreGive(semHandle);
 exit:
     return error;
-
-exitError0:
-    error = I2cFreeMutex();
-    // xSemaphoreGive(semHandle);
-    return error;
 }
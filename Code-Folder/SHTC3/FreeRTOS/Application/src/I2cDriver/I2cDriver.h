@@ -20,9 +20,13 @@ extern "C" {
 
 #include "i2c_master.h"
 #include "i2c_master_interrupt.h"
+#include "dma.h"
 
 #define I2C_INIT_ATTEMPTS 3
 #define WAIT_I2C_LINE_MS 300
+#define I2C_NOTIFY_BIT (1UL << 31)  ///< Task notification bit set when a queued I2C transaction completes
+#define I2C_DMA_THRESHOLD 32        ///< Default size (bytes) from which a write goes through DMA instead of the SERCOM interrupt
+#define I2C_MAX_CHUNK_LEN 255       ///< Longest write the SERCOM can run in auto length mode (ADDR.LEN)
 
 #define ERROR_NONE 0
 #define ERROR_INVALID_DATA -1
@@ -87,6 +91,63 @@ typedef struct I2C_Bus_State {
 
 } I2C_Bus_State;
 
+/// Priority lane of a queued I2C transaction. The highest non-empty lane is served first, FIFO within a lane.
+typedef enum eI2cPriority {
+    I2C_PRIORITY_HIGH = 0,  ///< Latency sensitive traffic (alarm path, interrupt status reads)
+    I2C_PRIORITY_NORMAL,    ///< Default lane, used by the blocking wrappers
+    I2C_PRIORITY_LOW,       ///< Bulk traffic that can wait (display frames)
+    I2C_PRIORITY_MAX,       ///< Number of priority lanes
+} eI2cPriority;
+
+struct I2C_Transaction;
+
+/// Completion callback of a queued transaction. Called from interrupt context, so it must be short and only use FromISR APIs.
+typedef void (*I2cTransactionCallback)(struct I2C_Transaction *transaction, BaseType_t *pxHigherPriorityTaskWoken);
+
+/// Descriptor of a queued I2C transaction. The write segment (if any) is sent first, then the read segment (if any).
+/// The descriptor is owned by the driver from I2cSubmitTransaction() until it completes, so it must stay valid until then.
+typedef struct I2C_Transaction {
+    I2C_Data data;                    ///< Device address and write/read segments
+    eI2cPriority priority;            ///< Priority lane to queue the transaction on
+    const uint8_t *header;            ///< Bytes sent ahead of every chunk of the write segment (e.g. a control byte). May be NULL
+    uint8_t headerLen;                ///< Length of header. With a header, the write is split in chunks of up to I2C_MAX_CHUNK_LEN bytes
+    I2cTransactionCallback callback;  ///< Completion callback (ISR context). May be NULL
+    TaskHandle_t notifyTask;          ///< Task that gets I2C_NOTIFY_BIT set on completion. May be NULL
+    void *context;                    ///< User pointer, untouched by the driver
+    volatile int32_t status;          ///< ERROR_BUSY while queued or in flight, then the final error code
+    TickType_t submitTick;            ///< Tick at which the transaction was submitted (driver use)
+    uint16_t interrupts;              ///< Interrupts taken to run the transaction, valid once it completes
+    uint32_t durationUs;              ///< Time the transaction spent on the bus (us), valid once it completes
+    uint16_t outOffset;               ///< Bytes of the write segment already sent (driver use)
+    uint16_t chunkLen;                ///< Bytes of the write segment in the chunk on the bus (driver use)
+    bool useDma;                      ///< Write segment runs through DMA (driver use)
+    uint8_t phase;                    ///< Segment currently on the bus (driver use)
+    struct I2C_Transaction *next;     ///< Next transaction in the same lane (driver use)
+} I2C_Transaction;
+
+/// Counters of one transfer mode (SERCOM interrupt per byte, or DMA)
+typedef struct I2C_Mode_Stats {
+    uint32_t transactions;  ///< Transactions run in this mode
+    uint32_t bytes;         ///< Bytes moved (write and read segments, headers included)
+    uint32_t interrupts;    ///< Interrupts taken by those transactions
+    uint32_t busyUs;        ///< Accumulated time those transactions spent on the bus (us)
+} I2C_Mode_Stats;
+
+/// Counters of the I2C transaction engine, used to measure queueing overhead and bus utilisation
+typedef struct I2C_Engine_Stats {
+    uint32_t submitted;      ///< Transactions accepted by I2cSubmitTransaction()
+    uint32_t completed;      ///< Transactions that finished without error
+    uint32_t errors;         ///< Transactions that finished with a bus error
+    uint32_t cancelled;      ///< Transactions cancelled by their owner (timeouts)
+    uint32_t queueDepth;     ///< Transactions currently waiting for the bus
+    uint32_t maxQueueDepth;  ///< High-water mark of queueDepth
+    uint32_t waitTicks;      ///< Accumulated ticks transactions spent queued before reaching the bus
+    uint32_t maxWaitTicks;   ///< Longest time a transaction spent queued
+    uint32_t busyTicks;      ///< Accumulated ticks the bus spent running transactions
+    I2C_Mode_Stats isr;      ///< Transactions run byte by byte from the SERCOM interrupt
+    I2C_Mode_Stats dma;      ///< Transactions whose write segment ran through DMA
+} I2C_Engine_Stats;
+
 int32_t I2cReadDataWait(I2C_Data *data, const TickType_t delay, const TickType_t xMaxBlockTime);
 int32_t I2cWriteDataWait(I2C_Data *data, const TickType_t xMaxBlockTime);
 int32_t I2cGetMutex(TickType_t waitTime);
@@ -94,6 +155,16 @@ int32_t I2cFreeMutex(void);
 int32_t I2cReadData(I2C_Data *data);
 int32_t I2cWriteData(I2C_Data *data);
 int32_t I2cInitializeDriver(void);
+void I2cInitTransaction(I2C_Transaction *transaction, I2C_Data *data, eI2cPriority priority);
+int32_t I2cSubmitTransaction(I2C_Transaction *transaction);
+int32_t I2cSubmitTransactionFromISR(I2C_Transaction *transaction, BaseType_t *pxHigherPriorityTaskWoken);
+int32_t I2cCancelTransaction(I2C_Transaction *transaction);
+int32_t I2cWaitTransaction(I2C_Transaction *transaction, const TickType_t xMaxBlockTime);
+int32_t I2cTransferWait(I2C_Transaction *transaction, const TickType_t xMaxBlockTime);
+void I2cGetEngineStats(I2C_Engine_Stats *stats);
+bool I2cIsBusy(void);
+void I2cSetDmaThreshold(uint16_t threshold);
+uint16_t I2cGetDmaThreshold(void);
 void I2cDriverRegisterSensorBusCallbacks(void);
 void I2cSensorsError(struct i2c_master_module *const module);
 void I2cSensorsRxComplete(struct i2c_master_module *const module);
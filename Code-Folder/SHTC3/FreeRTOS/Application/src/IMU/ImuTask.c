@@ -0,0 +1,412 @@
+/**************************************************************************/ /**
+ * @file      ImuTask.c
+ * @brief     LSM6DSO pipeline. Batches the accelerometer in the IMU FIFO while the box moves, and reports drops, taps
+ *            and orientation changes detected by the IMU embedded functions
+ * @details   The MCU never polls the IMU. INT2 carries the embedded function events (free fall, wake-up, taps, 6D,
+ *            activity/inactivity), latched until their sources are read. Motion data is only batched between a wake-up and
+ *            the next inactivity: the IMU then fills its FIFO on its own and INT1 rises when IMU_FIFO_BATCH samples are
+ *            waiting, so the task reads the FIFO status and all the waiting words in two I2C transactions. While the box is
+ *            still, the task sleeps until the IMU flags something.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "IMU/ImuTask.h"
+
+#include "I2cDriver/I2cDriver.h"
+#include "IMU/lsm6dso_reg.h"
+#include "SampleBus/SampleBus.h"
+#include "SerialConsole.h"
+#include "WifiHandlerThread/WifiHandler.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define IMU_FIFO_TIMEOUT_MS (2 * IMU_FIFO_BATCH * 1000 / IMU_FIFO_ODR_HZ)  ///< Read the FIFO anyway if no watermark edge came for two batches
+#define IMU_LSB_TO_MG(raw) ((int16_t)(((int32_t)(raw) * 61) / 1000))       ///< +/-2 g full scale: 0.061 mg/LSB
+
+#define IMU_WAKE_UP_THRESHOLD 2   ///< Wake-up threshold, FS/64 per LSB: 62.5 mg
+#define IMU_SLEEP_DURATION 2      ///< Stillness before inactivity, 512/ODR per LSB: about 10 s
+#define IMU_FREE_FALL_DURATION 15 ///< Free fall duration, 1/ODR per LSB: about 145 ms, a 10 cm drop
+#define IMU_TAP_THRESHOLD 8       ///< Tap threshold on each axis, FS/32 per LSB: 500 mg
+#define IMU_TAP_SHOCK 2           ///< Maximum tap duration
+#define IMU_TAP_QUIET 1           ///< Quiet time after a tap
+#define IMU_TAP_DURATION 7        ///< Maximum time between the two taps of a double tap
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static TaskHandle_t imuTaskHandle = NULL;                               ///< Task notified by the IMU interrupts
+static Imu_Fifo_Stats imuFifoStats;                                     ///< Pipeline counters, see ImuGetFifoStats()
+static Imu_Event_Stats imuEventStats;                                   ///< Event counters, see ImuGetEventStats()
+static uint8_t imuFifoWords[IMU_FIFO_BATCH * IMU_FIFO_WORD_LEN];        ///< Raw FIFO words of one burst read
+static bool imuFifoStreaming = false;                                   ///< True while the FIFO batches motion data
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static int32_t ImuFifoConfigure(void);
+static int32_t ImuEventConfigure(void);
+static void ImuConfigureInterrupt(uint32_t pin, uint32_t mux, uint8_t line, extint_callback_t callback);
+static void ImuFifoSetStreaming(bool streaming);
+static void ImuFifoDrain(void);
+static void ImuEventHandle(void);
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void ImuFifoWatermarkCallback(void)
+ * @brief       EXTINT callback of INT1. Wakes the IMU task to read the FIFO
+ */
+static void ImuFifoWatermarkCallback(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (imuTaskHandle != NULL) {
+        xTaskNotifyFromISR(imuTaskHandle, IMU_NOTIFY_FIFO, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @fn			static void ImuEventCallback(void)
+ * @brief       EXTINT callback of INT2. Wakes the IMU task to read the event sources
+ */
+static void ImuEventCallback(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (imuTaskHandle != NULL) {
+        xTaskNotifyFromISR(imuTaskHandle, IMU_NOTIFY_EVENT, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/******************************************************************************
+ * IMU Thread
+ ******************************************************************************/
+
+/**
+ * @fn			void vImuTask(void *pvParameters)
+ * @brief       Configures the IMU, then handles its events and drains its FIFO
+ * @details     The task blocks without timeout while the box is still. The task stops if no LSM6DSO answers on the bus.
+ * @param[in]   pvParameters Unused
+ * @note        I2C must be initialized before this task starts
+ */
+void vImuTask(void *pvParameters)
+{
+    uint32_t notified;
+
+    imuTaskHandle = xTaskGetCurrentTaskHandle();
+
+    if (ImuProbe() != ERROR_NONE || InitImu() != ERROR_NONE || ImuFifoConfigure() != ERROR_NONE ||
+        ImuEventConfigure() != ERROR_NONE) {
+        SerialConsoleWriteString("IMU: LSM6DSO not found, IMU task stopped\r\n");
+        vTaskSuspend(NULL);
+    }
+    ImuConfigureInterrupt(IMU_INT1_EIC_PIN, IMU_INT1_EIC_MUX, IMU_INT1_EIC_LINE, ImuFifoWatermarkCallback);
+    ImuConfigureInterrupt(IMU_INT2_EIC_PIN, IMU_INT2_EIC_MUX, IMU_INT2_EIC_LINE, ImuEventCallback);
+    SerialConsoleWriteString("Initialized IMU FIFO and events\r\n");
+
+    ImuEventHandle();  // Clears events latched before INT2 was enabled
+
+    for (;;) {
+        notified = 0;
+        xTaskNotifyWait(0, IMU_NOTIFY_FIFO | IMU_NOTIFY_EVENT, &notified,
+                        imuFifoStreaming ? pdMS_TO_TICKS(IMU_FIFO_TIMEOUT_MS) : portMAX_DELAY);
+
+        if (notified & IMU_NOTIFY_EVENT) {
+            imuEventStats.wakeups++;
+            ImuEventHandle();
+        }
+        if (imuFifoStreaming && ((notified & IMU_NOTIFY_FIFO) || notified == 0)) {  // Watermark, or timeout
+            imuFifoStats.wakeups++;
+            ImuFifoDrain();
+        }
+    }
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static int32_t ImuFifoConfigure(void)
+ * @brief       Sets up accelerometer batching and routes the FIFO watermark to INT1
+ * @details     The FIFO is left in bypass mode; ImuFifoSetStreaming() starts it on motion. The gyroscope, enabled by
+ *              InitImu() but not used, is turned off.
+ * @return      Returns 0 if every register write succeeded
+ */
+static int32_t ImuFifoConfigure(void)
+{
+    stmdev_ctx_t *ctx = GetImuStruct();
+    lsm6dso_pin_int1_route_t int1Route = {0};
+    int32_t error = ERROR_NONE;
+
+    error |= lsm6dso_fifo_mode_set(ctx, LSM6DSO_BYPASS_MODE);  // Empties the FIFO
+    error |= lsm6dso_gy_data_rate_set(ctx, LSM6DSO_GY_ODR_OFF);
+    error |= lsm6dso_xl_data_rate_set(ctx, LSM6DSO_XL_ODR_104Hz);
+    error |= lsm6dso_fifo_watermark_set(ctx, IMU_FIFO_BATCH);
+    error |= lsm6dso_fifo_xl_batch_set(ctx, LSM6DSO_XL_BATCHED_AT_26Hz);
+    error |= lsm6dso_fifo_gy_batch_set(ctx, LSM6DSO_GY_NOT_BATCHED);
+
+    int1Route.fifo_th = PROPERTY_ENABLE;
+    error |= lsm6dso_pin_int1_route_set(ctx, int1Route);
+
+    return error;
+}
+
+/**
+ * @fn			static int32_t ImuEventConfigure(void)
+ * @brief       Programs the free fall, wake-up, tap, 6D and activity/inactivity functions and routes them to INT2
+ * @details     Interrupts are latched, so INT2 stays high until ImuEventHandle() reads the sources and every event gives
+ *              a single rising edge. Must run after ImuFifoConfigure(): routing INT2 also enables the embedded function
+ *              interrupts, which routing INT1 alone would turn off.
+ * @return      Returns 0 if every register write succeeded
+ */
+static int32_t ImuEventConfigure(void)
+{
+    stmdev_ctx_t *ctx = GetImuStruct();
+    lsm6dso_pin_int2_route_t int2Route = {0};
+    int32_t error = ERROR_NONE;
+
+    error |= lsm6dso_int_notification_set(ctx, LSM6DSO_ALL_INT_LATCHED);
+
+    error |= lsm6dso_wkup_ths_weight_set(ctx, LSM6DSO_LSb_FS_DIV_64);
+    error |= lsm6dso_wkup_threshold_set(ctx, IMU_WAKE_UP_THRESHOLD);
+    error |= lsm6dso_wkup_dur_set(ctx, 0);
+    error |= lsm6dso_act_sleep_dur_set(ctx, IMU_SLEEP_DURATION);
+    error |= lsm6dso_act_mode_set(ctx, LSM6DSO_XL_AND_GY_NOT_AFFECTED);
+    error |= lsm6dso_act_pin_notification_set(ctx, LSM6DSO_DRIVE_SLEEP_CHG_EVENT);
+
+    error |= lsm6dso_ff_threshold_set(ctx, LSM6DSO_FF_TSH_312mg);
+    error |= lsm6dso_ff_dur_set(ctx, IMU_FREE_FALL_DURATION);
+
+    error |= lsm6dso_tap_detection_on_x_set(ctx, PROPERTY_ENABLE);
+    error |= lsm6dso_tap_detection_on_y_set(ctx, PROPERTY_ENABLE);
+    error |= lsm6dso_tap_detection_on_z_set(ctx, PROPERTY_ENABLE);
+    error |= lsm6dso_tap_threshold_x_set(ctx, IMU_TAP_THRESHOLD);
+    error |= lsm6dso_tap_threshold_y_set(ctx, IMU_TAP_THRESHOLD);
+    error |= lsm6dso_tap_threshold_z_set(ctx, IMU_TAP_THRESHOLD);
+    error |= lsm6dso_tap_shock_set(ctx, IMU_TAP_SHOCK);
+    error |= lsm6dso_tap_quiet_set(ctx, IMU_TAP_QUIET);
+    error |= lsm6dso_tap_dur_set(ctx, IMU_TAP_DURATION);
+    error |= lsm6dso_tap_mode_set(ctx, LSM6DSO_BOTH_SINGLE_DOUBLE);
+
+    error |= lsm6dso_6d_threshold_set(ctx, LSM6DSO_DEG_60);
+
+    int2Route.free_fall = PROPERTY_ENABLE;
+    int2Route.wake_up = PROPERTY_ENABLE;
+    int2Route.single_tap = PROPERTY_ENABLE;
+    int2Route.double_tap = PROPERTY_ENABLE;
+    int2Route.six_d = PROPERTY_ENABLE;
+    int2Route.sleep_change = PROPERTY_ENABLE;
+    error |= lsm6dso_pin_int2_route_set(ctx, NULL, int2Route);  // No OIS auxiliary interface
+
+    return error;
+}
+
+/**
+ * @fn			static void ImuConfigureInterrupt(uint32_t pin, uint32_t mux, uint8_t line, extint_callback_t callback)
+ * @brief       Configures the EIC line of an IMU interrupt pin to call back on its rising edge
+ * @param[in]   pin EIC pin (PIN_Pxxx_EIC_EXTINTn)
+ * @param[in]   mux EIC pin mux (MUX_Pxxx_EIC_EXTINTn)
+ * @param[in]   line EIC line of the pin
+ * @param[in]   callback Called from the EIC interrupt
+ */
+static void ImuConfigureInterrupt(uint32_t pin, uint32_t mux, uint8_t line, extint_callback_t callback)
+{
+    struct extint_chan_conf config_extint_chan;
+
+    extint_chan_get_config_defaults(&config_extint_chan);
+    config_extint_chan.gpio_pin = pin;
+    config_extint_chan.gpio_pin_mux = mux;
+    config_extint_chan.gpio_pin_pull = EXTINT_PULL_NONE;  // INT1 and INT2 are push-pull
+    config_extint_chan.detection_criteria = EXTINT_DETECT_RISING;
+    extint_chan_set_config(line, &config_extint_chan);
+
+    extint_register_callback(callback, line, EXTINT_CALLBACK_TYPE_DETECT);
+    extint_chan_enable_callback(line, EXTINT_CALLBACK_TYPE_DETECT);
+}
+
+/**
+ * @fn			static void ImuFifoSetStreaming(bool streaming)
+ * @brief       Starts batching motion data in the FIFO, or stops it and empties the FIFO
+ * @param[in]   streaming True to batch, false to go back to bypass
+ */
+static void ImuFifoSetStreaming(bool streaming)
+{
+    if (streaming == imuFifoStreaming) {
+        return;
+    }
+    if (lsm6dso_fifo_mode_set(GetImuStruct(), streaming ? LSM6DSO_STREAM_MODE : LSM6DSO_BYPASS_MODE) != 0) {
+        imuFifoStats.errors++;
+        return;
+    }
+    imuFifoStreaming = streaming;
+}
+
+/**
+ * @fn			static void ImuFifoDrain(void)
+ * @brief       Reads full batches out of the FIFO until less than a batch is left
+ * @details     Each batch is one read of FIFO_STATUS1/2 and one burst read of the FIFO words: with auto-increment the
+ *              register address rolls back from FIFO_DATA_OUT_Z_H to FIFO_DATA_OUT_TAG, so consecutive words come out of a
+ *              single transaction. Looping until the level drops below the watermark re-arms INT1, which only rises again
+ *              once the level crosses the watermark. Each batch goes to the uplink, and its last sample to the sample bus.
+ */
+static void ImuFifoDrain(void)
+{
+    stmdev_ctx_t *ctx = GetImuStruct();
+    uint8_t status[2];
+    Imu_Batch batch;
+    Sample_Record record = {0};
+
+    for (;;) {
+        if (lsm6dso_read_reg(ctx, LSM6DSO_FIFO_STATUS1, status, sizeof(status)) != 0) {
+            imuFifoStats.errors++;
+            return;
+        }
+
+        lsm6dso_fifo_status2_t *status2 = (lsm6dso_fifo_status2_t *)&status[1];
+        uint16_t level = status[0] | ((uint16_t)status2->diff_fifo << 8);
+        if (status2->fifo_ovr_ia) {
+            imuFifoStats.overruns++;
+        }
+        if (level < IMU_FIFO_BATCH) {
+            return;
+        }
+
+        if (lsm6dso_read_reg(ctx, LSM6DSO_FIFO_DATA_OUT_TAG, imuFifoWords, sizeof(imuFifoWords)) != 0) {
+            imuFifoStats.errors++;
+            return;
+        }
+
+        batch.timestamp = xTaskGetTickCount();
+        batch.samplePeriodMs = 1000 / IMU_FIFO_ODR_HZ;
+        batch.overrun = status2->fifo_ovr_ia;
+        if (ImuFifoDecode(imuFifoWords, IMU_FIFO_BATCH, &batch, &imuFifoStats.otherTags) == 0) {
+            continue;
+        }
+        imuFifoStats.samples += batch.count;
+
+        if (WifiAddImuBatchToQueue(&batch) == pdPASS) {
+            imuFifoStats.batches++;
+        } else {
+            imuFifoStats.uplinkDrops++;
+        }
+
+        record.timestamp = batch.timestamp;
+        record.sensor = SAMPLE_SENSOR_LSM6DSO;
+        record.status = ERROR_NONE;
+        record.channelCount = 3;
+        record.channel[SAMPLE_IMU_X] = batch.sample[batch.count - 1][0];
+        record.channel[SAMPLE_IMU_Y] = batch.sample[batch.count - 1][1];
+        record.channel[SAMPLE_IMU_Z] = batch.sample[batch.count - 1][2];
+        SampleBusPublish(&record);
+    }
+}
+
+/**
+ * @fn			static void ImuEventHandle(void)
+ * @brief       Reads the event sources, publishes them as an event record and starts or stops motion batching
+ * @details     ALL_INT_SRC, WAKE_UP_SRC, TAP_SRC and D6D_SRC are consecutive, so one transaction reads them all, which
+ *              also releases the latched INT2.
+ */
+static void ImuEventHandle(void)
+{
+    uint8_t sources[4];
+    Sample_Record record = {0};
+
+    if (lsm6dso_read_reg(GetImuStruct(), LSM6DSO_ALL_INT_SRC, sources, sizeof(sources)) != 0) {
+        imuEventStats.errors++;
+        return;
+    }
+
+    lsm6dso_wake_up_src_t *wakeUpSrc = (lsm6dso_wake_up_src_t *)&sources[1];
+    uint32_t events = sources[0] & IMU_EVENT_MASK;
+    if (events == 0) {
+        return;
+    }
+
+    imuEventStats.freeFalls += (events & IMU_EVENT_FREE_FALL) ? 1 : 0;
+    imuEventStats.wakeUps += (events & IMU_EVENT_WAKE_UP) ? 1 : 0;
+    imuEventStats.taps += (events & IMU_EVENT_SINGLE_TAP) ? 1 : 0;
+    imuEventStats.doubleTaps += (events & IMU_EVENT_DOUBLE_TAP) ? 1 : 0;
+    imuEventStats.orientations += (events & IMU_EVENT_ORIENTATION) ? 1 : 0;
+    imuEventStats.sleepChanges += (events & IMU_EVENT_SLEEP_CHANGE) ? 1 : 0;
+
+    // Batch motion data from the first wake-up until the IMU reports the box still again
+    if (events & IMU_EVENT_WAKE_UP) {
+        ImuFifoSetStreaming(true);
+    } else if ((events & IMU_EVENT_SLEEP_CHANGE) && wakeUpSrc->sleep_state) {
+        ImuFifoSetStreaming(false);
+    }
+
+    record.timestamp = xTaskGetTickCount();
+    record.sensor = SAMPLE_SENSOR_IMU_EVENT;
+    record.status = ERROR_NONE;
+    record.channelCount = 3;
+    record.channel[SAMPLE_IMU_EVENT_FLAGS] = events;
+    record.channel[SAMPLE_IMU_EVENT_ORIENTATION] = sources[3] & 0x3F;  // XL, XH, YL, YH, ZL, ZH
+    record.channel[SAMPLE_IMU_EVENT_MOVING] = !wakeUpSrc->sleep_state;
+    SampleBusPublish(&record);
+}
+
+/**
+ * @fn			uint8_t ImuFifoDecode(const uint8_t *words, uint16_t wordCount, Imu_Batch *batch, uint32_t *otherTags)
+ * @brief       Decodes raw FIFO words into the accelerometer samples of a batch
+ * @details     Words tagged other than accelerometer (e.g. a configuration change) are skipped and counted. Has no
+ *              hardware access, so recorded FIFO dumps can be fed to it directly.
+ * @param[in]   words FIFO words, IMU_FIFO_WORD_LEN bytes each (tag, X L/H, Y L/H, Z L/H)
+ * @param[in]   wordCount Number of words
+ * @param[out]  batch Batch whose sample and count are filled. At most IMU_FIFO_BATCH samples are kept
+ * @param[in,out] otherTags Incremented for each word skipped
+ * @return      Number of samples decoded
+ */
+uint8_t ImuFifoDecode(const uint8_t *words, uint16_t wordCount, Imu_Batch *batch, uint32_t *otherTags)
+{
+    uint8_t count = 0;
+
+    for (uint16_t i = 0; i < wordCount; i++, words += IMU_FIFO_WORD_LEN) {
+        if ((words[0] >> 3) != LSM6DSO_XL_NC_TAG || count >= IMU_FIFO_BATCH) {
+            (*otherTags)++;
+            continue;
+        }
+        batch->sample[count][0] = IMU_LSB_TO_MG((int16_t)(words[1] | (words[2] << 8)));
+        batch->sample[count][1] = IMU_LSB_TO_MG((int16_t)(words[3] | (words[4] << 8)));
+        batch->sample[count][2] = IMU_LSB_TO_MG((int16_t)(words[5] | (words[6] << 8)));
+        count++;
+    }
+
+    batch->count = count;
+    return count;
+}
+
+/**
+ * @fn			void ImuGetFifoStats(Imu_Fifo_Stats *stats)
+ * @brief       Copies the counters of the IMU pipeline
+ * @param[out]  stats Structure the counters are copied to
+ */
+void ImuGetFifoStats(Imu_Fifo_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = imuFifoStats;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			void ImuGetEventStats(Imu_Event_Stats *stats)
+ * @brief       Copies the counters of the IMU events
+ * @param[out]  stats Structure the counters are copied to
+ */
+void ImuGetEventStats(Imu_Event_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = imuEventStats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,97 @@
+/**************************************************************************/ /**
+ * @file      ImuTask.h
+ * @brief     LSM6DSO pipeline. Batches the accelerometer in the IMU FIFO while the box moves, and reports drops, taps
+ *            and orientation changes detected by the IMU embedded functions
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef IMU_TASK_H_
+#define IMU_TASK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define IMU_TASK_SIZE 300                         ///< Stack of the IMU task (words)
+
+#define IMU_INT1_EIC_PIN PIN_PA02A_EIC_EXTINT2    ///< LSM6DSO INT1 (FIFO watermark), EXT1 header pin 3
+#define IMU_INT1_EIC_MUX MUX_PA02A_EIC_EXTINT2
+#define IMU_INT1_EIC_LINE 2
+#define IMU_INT2_EIC_PIN PIN_PA03A_EIC_EXTINT3    ///< LSM6DSO INT2 (embedded function events), EXT1 header pin 4
+#define IMU_INT2_EIC_MUX MUX_PA03A_EIC_EXTINT3
+#define IMU_INT2_EIC_LINE 3
+
+#define IMU_FIFO_ODR_HZ 26           ///< Batching rate. The accelerometer itself runs at 104 Hz for the tap detection
+#define IMU_FIFO_BATCH 16            ///< FIFO watermark: samples read per wakeup and per uplink batch
+#define IMU_FIFO_WORD_LEN 7          ///< Bytes of one FIFO word: tag + X, Y, Z
+#define IMU_NOTIFY_FIFO (1UL << 0)   ///< Task notification bit set by the watermark interrupt
+#define IMU_NOTIFY_EVENT (1UL << 1)  ///< Task notification bit set by the embedded function interrupt
+
+/// Event flags of an IMU event record, same bits as the LSM6DSO ALL_INT_SRC register
+#define IMU_EVENT_FREE_FALL (1UL << 0)     ///< Free fall: the box is dropped
+#define IMU_EVENT_WAKE_UP (1UL << 1)       ///< Acceleration above the wake-up threshold: the box is moved
+#define IMU_EVENT_SINGLE_TAP (1UL << 2)    ///< Single knock on the box
+#define IMU_EVENT_DOUBLE_TAP (1UL << 3)    ///< Double knock on the box
+#define IMU_EVENT_ORIENTATION (1UL << 4)   ///< The box was turned to another face (6D)
+#define IMU_EVENT_SLEEP_CHANGE (1UL << 5)  ///< The box became still, or started moving
+#define IMU_EVENT_MASK 0x3FUL
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Batch of accelerometer samples as sent on the uplink. Naturally aligned, so it is published byte for byte
+typedef struct Imu_Batch {
+    uint32_t timestamp;                  ///< Tick the batch was read at (last sample)
+    uint16_t samplePeriodMs;             ///< Time between two samples
+    uint8_t count;                       ///< Valid entries of sample
+    uint8_t overrun;                     ///< 1 if the FIFO overflowed before this batch, samples were lost
+    int16_t sample[IMU_FIFO_BATCH][3];   ///< X, Y, Z acceleration, mg
+} Imu_Batch;
+
+/// Counters of the IMU pipeline
+typedef struct Imu_Fifo_Stats {
+    uint32_t wakeups;       ///< Times the task woke up to read the FIFO
+    uint32_t samples;       ///< Accelerometer samples decoded
+    uint32_t batches;       ///< Batches handed to the uplink
+    uint32_t uplinkDrops;   ///< Batches dropped because the uplink queue was full
+    uint32_t overruns;      ///< FIFO overflows seen
+    uint32_t otherTags;     ///< FIFO words skipped because they were not accelerometer data
+    uint32_t errors;        ///< Failed I2C transactions
+} Imu_Fifo_Stats;
+
+/// Counters of the IMU embedded function events
+typedef struct Imu_Event_Stats {
+    uint32_t wakeups;       ///< Times the task woke up on INT2
+    uint32_t freeFalls;     ///< IMU_EVENT_FREE_FALL seen
+    uint32_t wakeUps;       ///< IMU_EVENT_WAKE_UP seen
+    uint32_t taps;          ///< IMU_EVENT_SINGLE_TAP seen
+    uint32_t doubleTaps;    ///< IMU_EVENT_DOUBLE_TAP seen
+    uint32_t orientations;  ///< IMU_EVENT_ORIENTATION seen
+    uint32_t sleepChanges;  ///< IMU_EVENT_SLEEP_CHANGE seen
+    uint32_t errors;        ///< Failed I2C transactions
+} Imu_Event_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+void vImuTask(void *pvParameters);
+uint8_t ImuFifoDecode(const uint8_t *words, uint16_t wordCount, Imu_Batch *batch, uint32_t *otherTags);
+void ImuGetFifoStats(Imu_Fifo_Stats *stats);
+void ImuGetEventStats(Imu_Event_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IMU_TASK_H_ */
@@ -13141,6 +13141,7 @@ stmdev_ctx_t dev_ctx = {.write_reg = platform_write, .read_reg = platform_read};
 
 uint8_t msgOutImu[64]; ///<USE ME AS A BUFFER FOR platform_write and platform_read
 I2C_Data imuData; ///<Use me as a structure to communicate with the IMU on platform_write and platform_read
+static uint32_t imuBusTransactions = 0; ///< I2C transactions made by platform_write and platform_read
 
 /**************************************************************************//**
  * @fn			static int32_t platform_write(void *handle, uint8_t reg, uint8_t *bufp,uint16_t len)
@@ -13170,6 +13171,7 @@ static int32_t platform_write(void *handle, uint8_t reg, uint8_t *bufp,uint16_t
 	imuData.lenOut = len + 1;
 	imuData.lenIn = len;
 	imuData.msgIn = bufp;
+	imuBusTransactions++;
 	return I2cWriteDataWait(&imuData, 100);
 
 }
@@ -13196,7 +13198,8 @@ static  int32_t platform_read(void *handle, uint8_t reg, uint8_t *bufp, uint16_t
 	imuData.lenIn = len;
 	imuData.lenOut = 1;
 	imuData.msgOut = &msgOutImu;
-	return I2cReadDataWait(&imuData, 100, 100);
+	imuBusTransactions++;
+	return I2cReadDataWait(&imuData, 0, 100);	//registers answer right away, register write and read in one transaction
 }
 
 
@@ -13243,6 +13246,31 @@ int32_t error = 0;
   return error;
 }
 
+/**************************************************************************//**
+ * @fn			int32_t ImuProbe(void)
+ * @brief       Checks that an LSM6DSO answers on the bus
+ * @details     To call before InitImu(), so a board without IMU fails cleanly instead of polling the reset bit forever.
+ * @return      Returns 0 if the device ID matches
+*****************************************************************************/
+int32_t ImuProbe(void)
+{
+	uint8_t whoAmI = 0;
+
+	if (lsm6dso_device_id_get(&dev_ctx, &whoAmI) != 0 || whoAmI != LSM6DSO_ID) {
+		return ERROR_NOT_FOUND;
+	}
+	return ERROR_NONE;
+}
+
+/**************************************************************************//**
+ * @fn			uint32_t ImuGetBusTransactions(void)
+ * @brief       Returns the number of I2C transactions made to the IMU since start
+*****************************************************************************/
+uint32_t ImuGetBusTransactions(void)
+{
+	return imuBusTransactions;
+}
+
 char serialConsoleOutputBuf[50];
 
 void vI2cTask(void *pvParameters)
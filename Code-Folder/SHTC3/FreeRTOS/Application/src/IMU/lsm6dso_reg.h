@@ -4464,6 +4464,8 @@ int32_t lsm6dso_embedded_sens_off(stmdev_ctx_t *ctx);
 
 stmdev_ctx_t * GetImuStruct(void);
 int32_t InitImu(void);
+int32_t ImuProbe(void);
+uint32_t ImuGetBusTransactions(void);
 
 /**
   * @}
@@ -0,0 +1,277 @@
+/**************************************************************************/ /**
+ * @file      Input.c
+ * @brief     Lid inputs and SW0. Interrupt driven, handled on the timer service and published on the sample bus
+ * @details   Each lid switch has its own EIC line, triggered on both edges. The first edge of a burst stamps the event
+ *            and every edge restarts a one-shot debounce timer; once the switch has been quiet for INPUT_DEBOUNCE_MS the
+ *            timer callback reads the pin, and a changed level is published as a SAMPLE_SENSOR_LID record. Subscribers
+ *            get it through their sample bus task notification, with the tick of the first edge as timestamp.
+ *            SW0 triggers on its falling edge only: the interrupt posts a deferred event, whose handler publishes a
+ *            SAMPLE_SENSOR_BUTTON record unless the last press is less than INPUT_DEBOUNCE_MS old.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Input/Input.h"
+
+#include <asf.h>
+#include <timers.h>
+
+#include "Defer/Defer.h"
+#include "I2cDriver/I2cDriver.h"
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Wiring of one input
+typedef struct Input_Pin {
+    uint8_t pin;      ///< GPIO, read once debounced
+    uint32_t eicPin;  ///< EIC pin (PIN_Pxxx_EIC_EXTINTn)
+    uint32_t eicMux;  ///< EIC pin mux
+    uint8_t line;     ///< EIC line
+} Input_Pin;
+
+/// Debounce state of one input
+typedef struct Input_State {
+    TimerHandle_t timer;             ///< Debounce timer
+    StaticTimer_t timerBuffer;
+    volatile bool settling;          ///< True from the first edge of a burst until the level is taken
+    volatile TickType_t firstEdge;   ///< Tick of the first edge of the current burst
+    volatile TickType_t lastEdge;    ///< Tick of the last edge of the current burst
+    Input_Stats stats;
+} Input_State;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+/// Lid switches pull their pin low while the lid is closed
+static const Input_Pin inputPins[INPUT_MAX] = {
+    {PIN_PA25, PIN_PA25A_EIC_EXTINT13, MUX_PA25A_EIC_EXTINT13, 13},
+    {PIN_PA21, PIN_PA21A_EIC_EXTINT5, MUX_PA21A_EIC_EXTINT5, 5},
+    {PIN_PA20, PIN_PA20A_EIC_EXTINT4, MUX_PA20A_EIC_EXTINT4, 4},
+};
+
+static Input_State inputState[INPUT_MAX];
+static TickType_t inputButtonLast;  ///< Tick of the last SW0 press published
+static bool inputButtonSeen;        ///< False until the first SW0 press
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static void InputDebounceTimerCallback(TimerHandle_t timer);
+static void InputButtonHandler(const Defer_Event *event);
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void InputEdgeCallback(void)
+ * @brief       EXTINT callback shared by the lid lines. Stamps the burst and restarts its debounce timer
+ */
+static void InputEdgeCallback(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint8_t line = extint_get_current_channel();
+    TickType_t now = xTaskGetTickCountFromISR();
+
+    for (uint8_t i = 0; i < INPUT_MAX; i++) {
+        if (inputPins[i].line != line) {
+            continue;
+        }
+        Input_State *state = &inputState[i];
+        state->stats.edges++;
+        if (!state->settling) {
+            state->settling = true;
+            state->firstEdge = now;
+        }
+        state->lastEdge = now;
+        xTimerResetFromISR(state->timer, &xHigherPriorityTaskWoken);
+        break;
+    }
+
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @fn			static void InputButtonCallback(void)
+ * @brief       EXTINT callback of SW0. Only queues the press: it is published by InputButtonHandler()
+ */
+static void InputButtonCallback(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    Defer_Payload payload = {.button = {BUTTON_0_EIC_LINE}};
+
+    DeferFromISR(DEFER_EVENT_BUTTON, &payload, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @fn			static void InputButtonHandler(const Defer_Event *event)
+ * @brief       Deferred handler of SW0, publishes the press. Bounces within INPUT_DEBOUNCE_MS of a press are dropped
+ * @param[in]   event DEFER_EVENT_BUTTON event
+ */
+static void InputButtonHandler(const Defer_Event *event)
+{
+    Sample_Record record = {0};
+    TickType_t now = xTaskGetTickCount();
+
+    if (inputButtonSeen && now - inputButtonLast < pdMS_TO_TICKS(INPUT_DEBOUNCE_MS)) {
+        return;
+    }
+    inputButtonSeen = true;
+    inputButtonLast = now;
+
+    record.timestamp = now;
+    record.sensor = SAMPLE_SENSOR_BUTTON;
+    record.status = ERROR_NONE;
+    SampleBusPublish(&record);
+}
+
+/**
+ * @fn			static void InputDebounceTimerCallback(TimerHandle_t timer)
+ * @brief       Takes the level of a lid once it has been quiet for INPUT_DEBOUNCE_MS, and publishes it if it changed
+ * @details     Runs on the timer service. If the timer command queue was full during a long bounce, the timer may fire
+ *              early: it is then restarted for the rest of the quiet time.
+ * @param[in]   timer Debounce timer, its ID is the input index
+ */
+static void InputDebounceTimerCallback(TimerHandle_t timer)
+{
+    uint8_t index = (uint8_t)(uint32_t)pvTimerGetTimerID(timer);
+    Input_State *state = &inputState[index];
+    Sample_Record record = {0};
+    TickType_t firstEdge;
+    TickType_t quiet;
+
+    taskENTER_CRITICAL();
+    quiet = xTaskGetTickCount() - state->lastEdge;
+    firstEdge = state->firstEdge;
+    if (quiet >= pdMS_TO_TICKS(INPUT_DEBOUNCE_MS)) {
+        state->settling = false;
+    }
+    taskEXIT_CRITICAL();
+
+    if (quiet < pdMS_TO_TICKS(INPUT_DEBOUNCE_MS)) {
+        xTimerChangePeriod(timer, pdMS_TO_TICKS(INPUT_DEBOUNCE_MS) - quiet, 0);
+        return;
+    }
+
+    bool open = port_pin_get_input_level(inputPins[index].pin);
+    if (open == state->stats.open) {
+        state->stats.glitches++;
+        return;
+    }
+    state->stats.open = open;
+    state->stats.events++;
+
+    record.timestamp = firstEdge;
+    record.sensor = SAMPLE_SENSOR_LID;
+    record.status = ERROR_NONE;
+    record.channelCount = 3;
+    record.channel[SAMPLE_LID_INDEX] = index;
+    record.channel[SAMPLE_LID_OPEN] = open;
+    record.channel[SAMPLE_LID_DEBOUNCE] = xTaskGetTickCount() - firstEdge;
+    SampleBusPublish(&record);
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			int32_t InputInit(void)
+ * @brief       Creates the debounce timers and enables the EIC lines of the lids and of SW0
+ * @return      Returns 0 on success, ERROR_NO_MEMORY if a timer could not be created
+ * @note        The initial levels are read here and are not published
+ */
+int32_t InputInit(void)
+{
+    struct extint_chan_conf config_extint_chan;
+
+    for (uint8_t i = 0; i < INPUT_MAX; i++) {
+        inputState[i].timer = xTimerCreateStatic("debounce", pdMS_TO_TICKS(INPUT_DEBOUNCE_MS), pdFALSE,
+                                                 (void *)(uint32_t)i, InputDebounceTimerCallback, &inputState[i].timerBuffer);
+        if (inputState[i].timer == NULL) {
+            return ERROR_NO_MEMORY;
+        }
+
+        extint_chan_get_config_defaults(&config_extint_chan);
+        config_extint_chan.gpio_pin = inputPins[i].eicPin;
+        config_extint_chan.gpio_pin_mux = inputPins[i].eicMux;
+        config_extint_chan.gpio_pin_pull = EXTINT_PULL_UP;
+        config_extint_chan.detection_criteria = EXTINT_DETECT_BOTH;
+        extint_chan_set_config(inputPins[i].line, &config_extint_chan);
+
+        inputState[i].stats.open = port_pin_get_input_level(inputPins[i].pin);
+
+        extint_register_callback(InputEdgeCallback, inputPins[i].line, EXTINT_CALLBACK_TYPE_DETECT);
+        extint_chan_enable_callback(inputPins[i].line, EXTINT_CALLBACK_TYPE_DETECT);
+    }
+
+    DeferRegister(DEFER_EVENT_BUTTON, InputButtonHandler);
+    extint_chan_get_config_defaults(&config_extint_chan);
+    config_extint_chan.gpio_pin = BUTTON_0_EIC_PIN;
+    config_extint_chan.gpio_pin_mux = BUTTON_0_EIC_MUX;
+    config_extint_chan.gpio_pin_pull = EXTINT_PULL_UP;
+    config_extint_chan.detection_criteria = EXTINT_DETECT_FALLING;
+    extint_chan_set_config(BUTTON_0_EIC_LINE, &config_extint_chan);
+    extint_register_callback(InputButtonCallback, BUTTON_0_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
+    extint_chan_enable_callback(BUTTON_0_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
+
+    return ERROR_NONE;
+}
+
+/**
+ * @fn			bool InputIsOpen(uint8_t input)
+ * @brief       Returns the debounced state of a lid
+ * @param[in]   input eInputId of the lid
+ * @return      True if the lid is open
+ */
+bool InputIsOpen(uint8_t input)
+{
+    return (input < INPUT_MAX) ? inputState[input].stats.open : false;
+}
+
+/**
+ * @fn			void InputEventHandled(const Sample_Record *record)
+ * @brief       Called by a subscriber once it has acted on a lid record, to account the press-to-handler latency
+ * @details     The latency runs from the first edge of the burst, so it includes the debounce time.
+ * @param[in]   record SAMPLE_SENSOR_LID record read from the sample bus
+ */
+void InputEventHandled(const Sample_Record *record)
+{
+    uint32_t index = record->channel[SAMPLE_LID_INDEX];
+    uint32_t latency = xTaskGetTickCount() - record->timestamp;
+
+    if (record->sensor != SAMPLE_SENSOR_LID || index >= INPUT_MAX) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    Input_Stats *stats = &inputState[index].stats;
+    stats->handled++;
+    stats->lastLatencyTicks = latency;
+    stats->sumLatencyTicks += latency;
+    if (latency > stats->maxLatencyTicks) {
+        stats->maxLatencyTicks = latency;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			void InputGetStats(uint8_t input, Input_Stats *stats)
+ * @brief       Copies the counters of an input
+ * @param[in]   input eInputId of the input
+ * @param[out]  stats Structure the counters are copied to
+ */
+void InputGetStats(uint8_t input, Input_Stats *stats)
+{
+    if (input >= INPUT_MAX) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    *stats = inputState[input].stats;
+    taskEXIT_CRITICAL();
+}
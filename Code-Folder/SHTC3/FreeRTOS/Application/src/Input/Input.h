@@ -0,0 +1,64 @@
+/**************************************************************************/ /**
+ * @file      Input.h
+ * @brief     Lid inputs and SW0. Interrupt driven, handled on the timer service and published on the sample bus
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "SampleBus/SampleBus.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define INPUT_DEBOUNCE_MS 20  ///< Time a lid switch must stay quiet before its level is taken
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Inputs handled by the module
+typedef enum eInputId {
+    INPUT_LID_1 = 0,  ///< Compartment 1 lid, PA25
+    INPUT_LID_2,      ///< Compartment 2 lid, PA21
+    INPUT_LID_3,      ///< Compartment 3 lid, PA20
+    INPUT_MAX,
+} eInputId;
+
+/// Counters of one input
+typedef struct Input_Stats {
+    bool open;                   ///< Debounced state
+    uint32_t edges;              ///< Edges seen by the EIC, bounces included
+    uint32_t events;             ///< Debounced changes published
+    uint32_t glitches;           ///< Edge bursts that settled back to the previous state
+    uint32_t handled;            ///< Events reported handled with InputEventHandled()
+    uint32_t lastLatencyTicks;   ///< First edge to handler, last event
+    uint32_t maxLatencyTicks;    ///< First edge to handler, worst event
+    uint32_t sumLatencyTicks;    ///< First edge to handler, summed over handled events
+} Input_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t InputInit(void);
+bool InputIsOpen(uint8_t input);
+void InputEventHandled(const Sample_Record *record);
+void InputGetStats(uint8_t input, Input_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INPUT_H_ */
@@ -0,0 +1,304 @@
+/**************************************************************************/ /**
+ * @file      MemPool.c
+ * @brief     Fixed-block memory pools. Size classes with O(1) alloc and free, behind pvPortMalloc() and for drivers
+ * @details   Replaces heap_1. The configTOTAL_HEAP_SIZE arena is split into pools of 32, 64, 128, 512 and 1024 byte
+ *            blocks, each with its own free list, and a large region for bigger requests. A request takes a block of
+ *            the smallest class it fits in, or of the next bigger class if that one is empty, so alloc and free never
+ *            walk more than the five classes and can never fragment. The large region serves the rare request above
+ *            1 KB, which must live forever: it is allocated heap_1 style and cannot be freed. Tasks, queues, semaphores
+ *            and timers are allocated statically, see TaskTable/TaskTable.h, so the pools only hold driver buffers.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "MemPool/MemPool.h"
+
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define MEM_POOL_CLASSES (MEM_POOL_COUNT - 1)  ///< Size classes, the last pool is the large region
+#define MEM_POOL_LARGE MEM_POOL_CLASSES        ///< Index of the large region
+
+#define MEM_POOL_CLASS_BYTES (32 * 8 + 64 * 4 + 128 * 4 + 512 * 2 + 1024 * 1)  ///< Must match memPoolClasses
+#define MEM_POOL_LARGE_BYTES (configTOTAL_HEAP_SIZE - MEM_POOL_CLASS_BYTES)
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Size and number of blocks of a class
+typedef struct MemPool_Class {
+    const char *name;
+    uint16_t blockSize;
+    uint16_t blocks;
+} MemPool_Class;
+
+/// Free list of a pool
+typedef struct MemPool_Block {
+    struct MemPool_Block *next;
+} MemPool_Block;
+
+/// State of a pool
+typedef struct MemPool {
+    uint8_t *start;            ///< First byte of the pool in the arena
+    uint8_t *end;              ///< First byte after the pool
+    MemPool_Block *freeList;   ///< Free blocks. Unused by the large region
+    uint8_t *largeNext;        ///< Large region only: first free byte
+    MemPool_Stats stats;
+} MemPool;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+/// Sized for the driver buffers of the box: the console ring buffers fit 32 bytes, the HTTP headers 64 or 128, the
+/// HTTP receive buffer 512
+static const MemPool_Class memPoolClasses[MEM_POOL_CLASSES] = {
+    {"32", 32, 8}, {"64", 64, 4}, {"128", 128, 4}, {"512", 512, 2}, {"1024", 1024, 1},
+};
+
+_Static_assert(MEM_POOL_CLASS_BYTES < configTOTAL_HEAP_SIZE, "Memory pools do not fit configTOTAL_HEAP_SIZE");
+
+static uint8_t memPoolArena[configTOTAL_HEAP_SIZE] __attribute__((aligned(portBYTE_ALIGNMENT)));
+static MemPool memPools[MEM_POOL_COUNT];
+static bool memPoolReady = false;
+static size_t memPoolFree;         ///< Bytes free, all pools
+static size_t memPoolMinFree;      ///< Lowest memPoolFree seen
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static void MemPoolInit(void);
+static void *MemPoolTake(size_t size, uint8_t *failedPool);
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void MemPoolInit(void)
+ * @brief       Carves the arena into the pools and threads their free lists. Runs on the first allocation
+ * @note        Scheduler suspended
+ */
+static void MemPoolInit(void)
+{
+    uint8_t *next = memPoolArena;
+
+    for (uint8_t i = 0; i < MEM_POOL_CLASSES; i++) {
+        MemPool *pool = &memPools[i];
+        const MemPool_Class *class = &memPoolClasses[i];
+
+        pool->start = next;
+        pool->freeList = NULL;
+        for (uint16_t j = class->blocks; j > 0; j--) {
+            MemPool_Block *block = (MemPool_Block *)(next + (j - 1) * class->blockSize);
+            block->next = pool->freeList;
+            pool->freeList = block;
+        }
+        next += class->blocks * class->blockSize;
+        pool->end = next;
+        pool->stats.name = class->name;
+        pool->stats.blockSize = class->blockSize;
+        pool->stats.blocks = class->blocks;
+    }
+
+    memPools[MEM_POOL_LARGE].start = next;
+    memPools[MEM_POOL_LARGE].largeNext = next;
+    memPools[MEM_POOL_LARGE].end = memPoolArena + configTOTAL_HEAP_SIZE;
+    memPools[MEM_POOL_LARGE].stats.name = "large";
+    memPools[MEM_POOL_LARGE].stats.blocks = MEM_POOL_LARGE_BYTES;
+
+    memPoolFree = configTOTAL_HEAP_SIZE;
+    memPoolMinFree = memPoolFree;
+    memPoolReady = true;
+}
+
+/**
+ * @fn			static void *MemPoolTake(size_t size, uint8_t *failedPool)
+ * @brief       Takes a block from the smallest class size fits in, or from the next bigger class that has one
+ * @param[in]   size Bytes requested
+ * @param[out]  failedPool Pool the request was for, set when it fails
+ * @return      Returns the block, or NULL
+ * @note        Scheduler suspended
+ */
+static void *MemPoolTake(size_t size, uint8_t *failedPool)
+{
+    uint8_t first = 0;
+
+    while (first < MEM_POOL_CLASSES && memPoolClasses[first].blockSize < size) {
+        first++;
+    }
+    *failedPool = first;
+
+    if (first == MEM_POOL_LARGE) {
+        MemPool *large = &memPools[MEM_POOL_LARGE];
+        size = (size + portBYTE_ALIGNMENT - 1) & ~((size_t)portBYTE_ALIGNMENT_MASK);
+        if ((size_t)(large->end - large->largeNext) < size) {
+            large->stats.failures++;
+            return NULL;
+        }
+        void *block = large->largeNext;
+        large->largeNext += size;
+        large->stats.allocs++;
+        large->stats.used += size;
+        large->stats.highWater = large->stats.used;
+        memPoolFree -= size;
+        return block;
+    }
+
+    for (uint8_t i = first; i < MEM_POOL_CLASSES; i++) {
+        MemPool *pool = &memPools[i];
+        MemPool_Block *block = pool->freeList;
+        if (block == NULL) {
+            continue;
+        }
+        pool->freeList = block->next;
+        pool->stats.allocs++;
+        if (++pool->stats.used > pool->stats.highWater) {
+            pool->stats.highWater = pool->stats.used;
+        }
+        if (i != first) {
+            memPools[first].stats.spills++;
+        }
+        memPoolFree -= pool->stats.blockSize;
+        return block;
+    }
+
+    memPools[first].stats.failures++;
+    return NULL;
+}
+
+/**
+ * @fn			void *MemPoolAlloc(size_t size)
+ * @brief       Allocates a block of at least size bytes
+ * @param[in]   size Bytes needed
+ * @return      Returns the block, or NULL after calling vApplicationPoolFailedHook() with the pool that ran out
+ * @note        Task context, or before the scheduler starts
+ */
+void *MemPoolAlloc(size_t size)
+{
+    void *block = NULL;
+    uint8_t failedPool = 0;
+
+    if (size == 0) {
+        return NULL;
+    }
+
+    vTaskSuspendAll();
+    if (!memPoolReady) {
+        MemPoolInit();
+    }
+    block = MemPoolTake(size, &failedPool);
+    if (memPoolFree < memPoolMinFree) {
+        memPoolMinFree = memPoolFree;
+    }
+    traceMALLOC(block, size);
+    (void)xTaskResumeAll();
+
+    if (block == NULL) {
+        vApplicationPoolFailedHook(memPools[failedPool].stats.name, size);
+    }
+    return block;
+}
+
+/**
+ * @fn			void MemPoolFree(void *block)
+ * @brief       Returns a block to its pool
+ * @param[in]   block Block from MemPoolAlloc() or pvPortMalloc(). NULL is ignored
+ * @note        Blocks of the large region cannot be freed
+ */
+void MemPoolFree(void *block)
+{
+    uint8_t *address = block;
+
+    if (block == NULL) {
+        return;
+    }
+
+    vTaskSuspendAll();
+    for (uint8_t i = 0; i < MEM_POOL_CLASSES; i++) {
+        MemPool *pool = &memPools[i];
+        if (address < pool->start || address >= pool->end) {
+            continue;
+        }
+        configASSERT(((address - pool->start) % pool->stats.blockSize) == 0);
+        ((MemPool_Block *)block)->next = pool->freeList;
+        pool->freeList = block;
+        pool->stats.used--;
+        memPoolFree += pool->stats.blockSize;
+        traceFREE(block, pool->stats.blockSize);
+        break;
+    }
+    configASSERT(address < memPools[MEM_POOL_LARGE].start);
+    (void)xTaskResumeAll();
+}
+
+/**
+ * @fn			void MemPoolGetStats(uint8_t pool, MemPool_Stats *stats)
+ * @brief       Copies the counters of a pool
+ * @param[in]   pool Pool index, 0 for the smallest class up to MEM_POOL_COUNT - 1 for the large region
+ * @param[out]  stats Structure the counters are copied to
+ */
+void MemPoolGetStats(uint8_t pool, MemPool_Stats *stats)
+{
+    if (pool >= MEM_POOL_COUNT) {
+        return;
+    }
+    vTaskSuspendAll();
+    if (!memPoolReady) {
+        MemPoolInit();
+    }
+    *stats = memPools[pool].stats;
+    (void)xTaskResumeAll();
+}
+
+/**
+ * @fn			void *pvPortMalloc(size_t xWantedSize)
+ * @brief       FreeRTOS allocator, served by the pools
+ * @return      Returns the block, or NULL once vApplicationPoolFailedHook() has reported the empty pool. The failure
+ *              is left to the caller, as the kernel and the drivers check for NULL, instead of stopping the box
+ */
+void *pvPortMalloc(size_t xWantedSize)
+{
+    return MemPoolAlloc(xWantedSize);
+}
+
+/**
+ * @fn			void vPortFree(void *pv)
+ * @brief       FreeRTOS allocator, served by the pools
+ */
+void vPortFree(void *pv)
+{
+    MemPoolFree(pv);
+}
+
+/**
+ * @fn			void vPortInitialiseBlocks(void)
+ * @brief       Kept for the heap_x API. The pools initialize on the first allocation
+ */
+void vPortInitialiseBlocks(void)
+{
+}
+
+/**
+ * @fn			size_t xPortGetFreeHeapSize(void)
+ * @brief       Bytes free in all pools. A request may still fail if its class and the bigger ones are empty
+ */
+size_t xPortGetFreeHeapSize(void)
+{
+    return memPoolReady ? memPoolFree : configTOTAL_HEAP_SIZE;
+}
+
+/**
+ * @fn			size_t xPortGetMinimumEverFreeHeapSize(void)
+ * @brief       Lowest xPortGetFreeHeapSize() seen since boot
+ */
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return memPoolReady ? memPoolMinFree : configTOTAL_HEAP_SIZE;
+}
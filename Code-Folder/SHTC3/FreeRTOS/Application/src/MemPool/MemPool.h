@@ -0,0 +1,53 @@
+/**************************************************************************/ /**
+ * @file      MemPool.h
+ * @brief     Fixed-block memory pools. Size classes with O(1) alloc and free, behind pvPortMalloc() and for drivers
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef MEM_POOL_H_
+#define MEM_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define MEM_POOL_COUNT 6  ///< Size classes, plus the large block region
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Counters of one pool
+typedef struct MemPool_Stats {
+    const char *name;    ///< Size class, "large" for the region of blocks above the biggest class
+    uint16_t blockSize;  ///< Bytes per block, 0 for the large region
+    uint16_t blocks;     ///< Blocks in the pool. Bytes for the large region
+    uint16_t used;       ///< Blocks in use. Bytes for the large region
+    uint16_t highWater;  ///< Highest used
+    uint32_t allocs;     ///< Blocks handed out
+    uint32_t spills;     ///< Requests served by a bigger class because this one was empty
+    uint32_t failures;   ///< Requests that could not be served at all
+} MemPool_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+void *MemPoolAlloc(size_t size);
+void MemPoolFree(void *block);
+void MemPoolGetStats(uint8_t pool, MemPool_Stats *stats);
+void vApplicationPoolFailedHook(const char *pool, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEM_POOL_H_ */
@@ -2,39 +2,32 @@
 * @file      SSD1306_Driver.c
 * @brief     Driver for the SSD1306 OLED display, utilizing the I2C driver for SAMW25.
 * @details   This driver allows basic operations with the SSD1306 display, such as initialization, clearing the display, and updating the screen.
+*            The drawing functions only write the framebuffer and mark the columns they touch as dirty, per page.
+*            SSD1306_UpdateScreen() then sends only the dirty column range of each page, through a column/page address
+*            window, so changing one digit costs a few dozen bytes instead of the 1024 of the frame.
+*            Commands go out as streams: one control byte followed by any number of commands, in one I2C transaction.
+*            The init sequence is a single stream from a const table, and the address window of an update another one.
 ******************************************************************************/
 #include "CliThread/CliThread.h"
 #include "I2cDriver.h"
 #include <string.h> // For memset
-#include "fonts.h"
+#include "OLED/SSD1306.h"
 #define ABS(x)   ((x) > 0 ? (x) : -(x))
 
 
 /******************************************************************************
 * Defines and Typedefs
 ******************************************************************************/
-#define SSD1306_I2C_ADDRESS 0x3D  // Adjust if your display has a different address
-
-// Define color types
-typedef enum {
-SSD1306_COLOR_BLACK = 0,
-SSD1306_COLOR_WHITE = 1
-} SSD1306_COLOR_t;
-
-
-typedef struct {
-uint16_t CurrentX;
-uint16_t CurrentY;
-uint8_t Inverted;
-uint8_t Initialized;
-} SSD1306_t;
-
-
 // Fundamental Commands
+#define SSD1306_SET_COLUMN_ADDRESS 0x21  // Column window start and end, horizontal addressing mode
+#define SSD1306_SET_PAGE_ADDRESS 0x22    // Page window start and end, horizontal addressing mode
+#define SSD1306_DISPLAY_OFF 0xAE
+#define SSD1306_DISPLAY_ON 0xAF
 
+#define SSD1306_CHARGE_PUMP_MS 10  // Charge pump settling, between enabling it and switching the panel on
 
-#define SSD1306_WIDTH 128
-#define SSD1306_HEIGHT 64
+#define SSD1306_PAGES (SSD1306_HEIGHT / 8)
+#define SSD1306_CLEAN 0xFF  // ssd1306DirtyFirst of a page with nothing to send
 
 
 
@@ -42,6 +35,9 @@ uint8_t Initialized;
 * Local Function Prototypes
 ******************************************************************************/
 static void SSD1306_WriteCommand(uint8_t cmd);
+static int32_t SSD1306_WriteCommands(const uint8_t* cmds, uint16_t count);
+static void SSD1306_MarkDirty(uint16_t x0, uint16_t x1, uint8_t page0, uint8_t page1);
+static void SSD1306_Blit(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* data, SSD1306_COLOR_t color);
 
 /******************************************************************************
 * Global Variables
@@ -61,6 +57,8 @@ void SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color);
 void SSD1306_GotoXY(uint16_t x, uint16_t y);
 char SSD1306_Putc(char ch, FontDef_t* Font, SSD1306_COLOR_t color);
 char SSD1306_Puts(char* str, FontDef_t* Font, SSD1306_COLOR_t color);
+void SSD1306_DrawBitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* data, SSD1306_COLOR_t color);
+void SSD1306_ShiftLeft(uint16_t x, uint16_t w, uint8_t page0, uint8_t page1);
 void SSD1306_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, SSD1306_COLOR_t c);
 void SSD1306_DrawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1306_COLOR_t c);
 void SSD1306_DrawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1306_COLOR_t c);
@@ -74,162 +72,201 @@ void SSD1306_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t
 ******************************************************************************/
 static SSD1306_t SSD1306; // SSD1306 device handle
 static uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
+static uint8_t ssd1306DirtyFirst[SSD1306_PAGES] = {[0 ... SSD1306_PAGES - 1] = SSD1306_CLEAN};  // First column of each page changed since the last update, SSD1306_CLEAN if none
+static uint8_t ssd1306DirtyLast[SSD1306_PAGES];   // Last column of each page changed since the last update
+static SSD1306_Stats ssd1306Stats;
+
+// Power-up configuration, sent as one command stream. Ends with the charge pump enabled: the panel is switched on
+// by SSD1306_Init() once it has settled
+static const uint8_t ssd1306InitCommands[] = {
+	SSD1306_DISPLAY_OFF,
+	0x20, 0x00,	// Memory addressing mode: horizontal
+	0xB0,		// Set page start address
+	0xC8,		// COM output scan direction
+	0x00,		// Set low column address
+	0x10,		// Set high column address
+	0x40,		// Set start line address
+	0x81, 0xFF,	// Set contrast control
+	0xA1,		// Segment re-map
+	0xA6,		// Normal display
+	0xA8, 0x3F,	// Multiplex ratio
+	0xA4,		// Output follows RAM content
+	0xD3, 0x00,	// Set display offset
+	0xD5, 0xF0,	// Set display clock divide ratio
+	0xD9, 0x22,	// Set pre-charge period
+	0xDA, 0x12,	// Set COM pins hardware configuration
+	0xDB, 0x20,	// Set vcomh
+	0x8D, 0x14,	// Charge pump setting: enabled
+};
 
 /******************************************************************************
 * Functions
 ******************************************************************************/
-static void SSD1306_WriteCommand(uint8_t cmd) {
+/**
+ * @fn		static int32_t SSD1306_WriteCommands(const uint8_t* cmds, uint16_t count)
+ * @brief	Sends a command stream: one control byte, then count command and argument bytes, in one transaction
+ * @details	With Co = 0 the controller takes every following byte as a command, so a whole sequence costs the bytes
+ *		of its commands plus one, and one bus transaction instead of one per byte. Longer streams than a chunk of
+ *		the I2C driver get the control byte again ahead of each chunk, which the controller accepts the same way.
+ * @return	Returns ERROR_NONE, or the error of the I2C driver
+ */
+static int32_t SSD1306_WriteCommands(const uint8_t* cmds, uint16_t count) {
+	static const uint8_t controlByte = 0x00; // Co = 0, D/C# = 0 for a stream of commands
 	I2C_Data i2cData;
-	uint8_t* buffer = malloc(2); // Allocate memory for command and control byte
-	if (buffer == NULL) {
-		// Handle memory allocation failure; e.g., log an error or set an error flag
-		SerialConsoleWriteString("Error allocating memory for command");
-		return;
-	}
-
-	buffer[0] = 0x00; // Co = 0, D/C# = 0 for command mode
-	buffer[1] = cmd;  // Command byte
+	I2C_Transaction transaction;
 
 	i2cData.address = SSD1306_I2C_ADDRESS;
-	i2cData.msgOut = buffer;
-	i2cData.lenOut = 2;
+	i2cData.msgOut = cmds;
+	i2cData.lenOut = count;
+	i2cData.msgIn = NULL;
+	i2cData.lenIn = 0;
+
+	// Same lane as the data writes, so the address window of an update always goes out right before its pixels
+	I2cInitTransaction(&transaction, &i2cData, I2C_PRIORITY_LOW);
+	transaction.header = &controlByte;
+	transaction.headerLen = 1;
 
-	// Use I2cWriteDataWait to ensure the command is transmitted and handle errors
-	int32_t status = I2cWriteDataWait(&i2cData, 10);
+	int32_t status = I2cTransferWait(&transaction, WAIT_I2C_LINE_MS + 100);
 	if (status != ERROR_NONE) {
 		// Log error or handle it according to your error handling policy
 		SerialConsoleWriteString("Error sending I2C command");
 	}
+	return status;
+}
 
-	free(buffer); // Free the allocated memory
-
+static void SSD1306_WriteCommand(uint8_t cmd) {
+	SSD1306_WriteCommands(&cmd, 1);
 }
 
 
 static void SSD1306_WriteData(uint8_t* data, uint16_t count) {
+	static const uint8_t controlByte = 0x40; // Co = 0, D/C# = 1 for data
 	I2C_Data i2cData;
-	uint8_t* buffer = malloc(count + 1); // Allocate memory for data plus control byte
-	if (buffer == NULL) {
-		// Handle memory allocation failure
-		SerialConsoleWriteString("Error allocating memory for data");
-		return;
-	}
-
-	buffer[0] = 0x40; // Co = 0, D/C# = 1 for data
-	memcpy(&buffer[1], data, count); // Copy the data after the control byte
+	I2C_Transaction transaction;
 
 	i2cData.address = SSD1306_I2C_ADDRESS;
-	i2cData.msgOut = buffer;
-	i2cData.lenOut = count + 1;
+	i2cData.msgOut = data;
+	i2cData.lenOut = count;
+	i2cData.msgIn = NULL;
+	i2cData.lenIn = 0;
+
+	// The driver sends the control byte ahead of every chunk, so large writes go out through DMA straight from the caller buffer
+	I2cInitTransaction(&transaction, &i2cData, I2C_PRIORITY_LOW);
+	transaction.header = &controlByte;
+	transaction.headerLen = 1;
 
-	// Use I2cWriteDataWait to ensure the data is transmitted and handle errors
-	int32_t status = I2cWriteData(&i2cData);
+	int32_t status = I2cTransferWait(&transaction, WAIT_I2C_LINE_MS + 100);
 	if (status != ERROR_NONE) {
 		// Log error or handle it according to your error handling policy
 		SerialConsoleWriteString("Error sending I2C data");
 	}
+}
 
-	free(buffer); // Free the allocated memory
-	vTaskDelay(pdMS_TO_TICKS(10)); 
+/**
+ * @fn		static void SSD1306_MarkDirty(uint16_t x0, uint16_t x1, uint8_t page0, uint8_t page1)
+ * @brief	Widens the dirty column range of pages page0 to page1 to include columns x0 to x1
+ */
+static void SSD1306_MarkDirty(uint16_t x0, uint16_t x1, uint8_t page0, uint8_t page1) {
+	for (uint8_t page = page0; page <= page1; page++) {
+		if (ssd1306DirtyFirst[page] == SSD1306_CLEAN || x0 < ssd1306DirtyFirst[page]) {
+			ssd1306DirtyFirst[page] = x0;
+		}
+		if (x1 > ssd1306DirtyLast[page]) {
+			ssd1306DirtyLast[page] = x1;
+		}
+	}
 }
 
-// Initialize the SSD1306 display
+/**
+ * @fn		uint8_t SSD1306_Init(void)
+ * @brief	Configures the controller, switches the panel on and clears the framebuffer
+ * @details	The configuration is one command stream. The only wait is for the charge pump to settle before the panel
+ *		is switched on; the datasheet puts no delay between the other commands. The panel lights up to 100 ms
+ *		after display on, which needs no wait either: the controller RAM can be written meanwhile.
+ * @return	Returns 1, or 0 if the controller did not take the commands
+ */
 uint8_t SSD1306_Init(void) {
-// Initial command sequence
-SSD1306_WriteCommand(0xAE); // Display off
-vTaskDelay(pdMS_TO_TICKS(2));  
-SSD1306_WriteCommand(0x20); // Memory addressing mode
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x00); // Horizontal addressing mode
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xB0); // Set page start address
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xC8); // COM output scan direction
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x00); // Set low column address
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x10); // Set high column address
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x40); // Set start line address
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x81); // Set contrast control
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xFF);
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xA1); // Segment re-map
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xA6); // Normal display
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xA8); // Multiplex ratio
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x3F);
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xA4); // Output follows RAM content
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xD3); // Set display offset
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x00);
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xD5); // Set display clock divide ratio
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xF0);
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xD9); // Set pre-charge period
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x22);
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xDA); // Set COM pins hardware configuration
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x12);
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0xDB); // Set vcomh
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x20);
-vTaskDelay(pdMS_TO_TICKS(2)); 
-SSD1306_WriteCommand(0x8D); // Charge pump setting
-vTaskDelay(pdMS_TO_TICKS(10)); 
-SSD1306_WriteCommand(0x14);
-vTaskDelay(pdMS_TO_TICKS(10)); 
-SSD1306_WriteCommand(0xAF); // Turn on SSD1306 panel
-vTaskDelay(pdMS_TO_TICKS(10)); 
-
-// Clear screen
-memset(SSD1306_Buffer, 0, sizeof(SSD1306_Buffer));
-static SSD1306_t SSD1306;
-
-// Set default values for position and flag
-SSD1306.CurrentX = 0;
-SSD1306.CurrentY = 0;
-SSD1306.Inverted = 0;
-SSD1306.Initialized = 1;
-
-return 1; // Initialization successful
+	static const uint8_t displayOn = SSD1306_DISPLAY_ON;
+
+	if (SSD1306_WriteCommands(ssd1306InitCommands, sizeof(ssd1306InitCommands)) != ERROR_NONE) {
+		return 0;
+	}
+	vTaskDelay(pdMS_TO_TICKS(SSD1306_CHARGE_PUMP_MS));
+	if (SSD1306_WriteCommands(&displayOn, 1) != ERROR_NONE) {
+		return 0;
+	}
+
+	// Clear screen. The whole frame is dirty: the controller RAM holds garbage after power-up
+	memset(SSD1306_Buffer, 0, sizeof(SSD1306_Buffer));
+	SSD1306_MarkDirty(0, SSD1306_WIDTH - 1, 0, SSD1306_PAGES - 1);
+
+	// Set default values for position and flag
+	SSD1306.CurrentX = 0;
+	SSD1306.CurrentY = 0;
+	SSD1306.Inverted = 0;
+	SSD1306.Initialized = 1;
+
+	return 1; // Initialization successful
 }
 
+/**
+ * @fn		void SSD1306_UpdateScreen(void)
+ * @brief	Sends the parts of the framebuffer changed since the last update
+ * @details	Each dirty page is sent as one data write into a column/page address window covering its dirty columns.
+ *		Consecutive pages dirty over the full width are contiguous in the buffer and go out as one write, so a full
+ *		frame is still a single 1024-byte transfer.
+ */
 void SSD1306_UpdateScreen(void) {
-// Assume SSD1306_Buffer is globally defined and contains the screen data
-SSD1306_WriteData(SSD1306_Buffer, SSD1306_WIDTH * SSD1306_HEIGHT / 8);
-vTaskDelay(pdMS_TO_TICKS(10)); 
+	uint16_t bytes = 0;
+	uint8_t page = 0;
+
+	while (page < SSD1306_PAGES) {
+		uint8_t first = ssd1306DirtyFirst[page];
+		uint8_t last = ssd1306DirtyLast[page];
+		uint8_t end = page;
+
+		if (first == SSD1306_CLEAN) {
+			page++;
+			continue;
+		}
+		if (first == 0 && last == SSD1306_WIDTH - 1) {
+			while (end + 1 < SSD1306_PAGES && ssd1306DirtyFirst[end + 1] == 0 && ssd1306DirtyLast[end + 1] == SSD1306_WIDTH - 1) {
+				end++;
+			}
+		}
+		for (uint8_t i = page; i <= end; i++) {
+			ssd1306DirtyFirst[i] = SSD1306_CLEAN;
+			ssd1306DirtyLast[i] = 0;
+		}
+
+		const uint8_t window[] = {SSD1306_SET_COLUMN_ADDRESS, first, last, SSD1306_SET_PAGE_ADDRESS, page, end};
+		SSD1306_WriteCommands(window, sizeof(window));
+		uint16_t count = (end - page) * SSD1306_WIDTH + (last - first + 1);
+		SSD1306_WriteData(&SSD1306_Buffer[page * SSD1306_WIDTH + first], count);
+
+		// Control byte and the window, then the data with a control byte per chunk of the I2C driver
+		bytes += 1 + sizeof(window) + count + (count + I2C_MAX_CHUNK_LEN - 2) / (I2C_MAX_CHUNK_LEN - 1);
+		page = end + 1;
+	}
+
+	ssd1306Stats.updates++;
+	ssd1306Stats.lastBytes = bytes;
+	ssd1306Stats.totalBytes += bytes;
 }
 
-
-/* void SSD1306_UpdateScreen(void) {
-	for (uint8_t i = 0; i < 8; i++) {
-		SSD1306_WriteCommand(0xB0 + i);
-		SSD1306_WriteCommand(0x00);
-		SSD1306_WriteCommand(0x10);
-
-		// Continuously write all pixels of a single page (line)
-		I2C_Data i2cData;
-		i2cData.address = SSD1306_I2C_ADDRESS;
-		i2cData.msgOut = &SSD1306_Buffer[SSD1306_WIDTH * i];
-		i2cData.lenOut = SSD1306_WIDTH;
-		I2cWriteDataWait(&i2cData,200);
-	}
-	}*/
+/**
+ * @fn		void SSD1306_GetStats(SSD1306_Stats *stats)
+ * @brief	Copies the update counters: updates, bytes sent by the last one and in total (I2C address bytes excluded)
+ */
+void SSD1306_GetStats(SSD1306_Stats *stats) {
+	taskENTER_CRITICAL();
+	*stats = ssd1306Stats;
+	taskEXIT_CRITICAL();
+}
 
 	void SSD1306_Clear(void) {
 	memset(SSD1306_Buffer, 0, sizeof(SSD1306_Buffer));
+	SSD1306_MarkDirty(0, SSD1306_WIDTH - 1, 0, SSD1306_PAGES - 1);
 	}
 
 	/******************************************************************************
@@ -238,24 +275,25 @@ vTaskDelay(pdMS_TO_TICKS(10));
 
 
 	void SSD1306_Fill(SSD1306_COLOR_t color) {
-	// Fill the rest of the buffer
-	memset(&SSD1306_Buffer[1], (color == SSD1306_COLOR_BLACK) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer) - 1);
+	memset(SSD1306_Buffer, (color == SSD1306_COLOR_BLACK) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer));
+	SSD1306_MarkDirty(0, SSD1306_WIDTH - 1, 0, SSD1306_PAGES - 1);
 	}
 
 	void SSD1306_ON(void) {
-	SSD1306_WriteCommand(0xAF); // Display on
+	SSD1306_WriteCommand(SSD1306_DISPLAY_ON);
 	}
 
 	void SSD1306_OFF(void) {
-	SSD1306_WriteCommand(0xAE); // Display off
+	SSD1306_WriteCommand(SSD1306_DISPLAY_OFF);
 	}
 
 
 	void SSD1306_ToggleInvert(void) {
 	SSD1306.Inverted = !SSD1306.Inverted;
-	for (uint16_t i = 1; i < sizeof(SSD1306_Buffer); i++) { // start from 1
+	for (uint16_t i = 0; i < sizeof(SSD1306_Buffer); i++) {
 	SSD1306_Buffer[i] = ~SSD1306_Buffer[i];
 	}
+	SSD1306_MarkDirty(0, SSD1306_WIDTH - 1, 0, SSD1306_PAGES - 1);
 	}
 
 	void SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color) {
@@ -269,11 +307,16 @@ vTaskDelay(pdMS_TO_TICKS(10));
 	color = (SSD1306_COLOR_t)!color;
 	}
 	
-	// Set color
+	// Set color. The control byte is sent by the I2C driver, the buffer holds the pixels only
+	uint8_t *byte = &SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH];
+	uint8_t old = *byte;
 	if (color == SSD1306_COLOR_WHITE) {
-	SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH + 1] |= 1 << (y % 8); // +1 to account for the control byte
+	*byte |= 1 << (y % 8);
 	} else {
-	SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH + 1] &= ~(1 << (y % 8)); // +1 to account for the control byte
+	*byte &= ~(1 << (y % 8));
+	}
+	if (*byte != old) {
+	SSD1306_MarkDirty(x, x, y / 8, y / 8);
 	}
 	}
 	void SSD1306_GotoXY(uint16_t x, uint16_t y) {
@@ -282,29 +325,67 @@ vTaskDelay(pdMS_TO_TICKS(10));
 	SSD1306.CurrentY = y;
 	}
 
+	/**
+	 * @fn		static void SSD1306_Blit(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* data, SSD1306_COLOR_t color)
+	 * @brief	Copies a page-major bitmap to the buffer: set bits in color, clear bits in the other color
+	 * @details	Each bitmap byte covers 8 rows of one column, as in the buffer. At a row that is not a multiple of 8 it
+	 *		straddles two buffer bytes: it is shifted into both, and the cell mask keeps the pixels around the bitmap.
+	 *		The caller checks that the bitmap fits on the screen.
+	 */
+	static void SSD1306_Blit(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* data, SSD1306_COLOR_t color) {
+	uint8_t pages = (h + 7) / 8;
+	uint8_t shift = y % 8;
+
+	// Pixels are written as white, so the inverted mode and black bitmaps both draw the complement
+	uint8_t invert = ((color == SSD1306_COLOR_WHITE) == (SSD1306.Inverted != 0)) ? 0xFF : 0x00;
+
+	for (uint8_t page = 0; page < pages; page++) {
+	uint8_t rows = h - page * 8;
+	uint16_t mask = (rows >= 8) ? 0xFF : ((1 << rows) - 1);
+	uint8_t *dest = &SSD1306_Buffer[(y / 8 + page) * SSD1306_WIDTH + x];
+	bool changed = false;
+
+	mask <<= shift;
+	for (uint8_t col = 0; col < w; col++) {
+	uint16_t bits = ((data[page * w + col] ^ invert) << shift) & mask;
+	uint8_t old = dest[col];
+	dest[col] = (old & ~mask) | bits;
+	changed |= (dest[col] != old);
+	if (mask > 0xFF) {
+	// Rows of the next buffer page; it exists, the bitmap fits on the screen
+	old = dest[col + SSD1306_WIDTH];
+	dest[col + SSD1306_WIDTH] = (old & ~(mask >> 8)) | (bits >> 8);
+	changed |= (dest[col + SSD1306_WIDTH] != old);
+	}
+	}
+	if (changed) {
+	SSD1306_MarkDirty(x, x + w - 1, y / 8 + page, (mask > 0xFF) ? y / 8 + page + 1 : y / 8 + page);
+	}
+	}
+	}
+
+	/**
+	 * @fn		char SSD1306_Putc(char ch, FontDef_t* Font, SSD1306_COLOR_t color)
+	 * @brief	Draws a character at the cursor, glyph pixels in color and the rest of its cell in the other color
+	 * @details	The glyphs are stored in the page layout of the buffer and copied a byte per column, see SSD1306_Blit().
+	 *		The bounds are checked once for the whole glyph.
+	 * @return	Returns the character, 0 if it does not fit on the screen or has no glyph
+	 */
 	char SSD1306_Putc(char ch, FontDef_t* Font, SSD1306_COLOR_t color) {
-	uint32_t i, b, j;
+	uint8_t pages = (Font->FontHeight + 7) / 8;
 
 	/* Check available space in LCD */
 	if (
 	SSD1306_WIDTH <= (SSD1306.CurrentX + Font->FontWidth) ||
-	SSD1306_HEIGHT <= (SSD1306.CurrentY + Font->FontHeight)
+	SSD1306_HEIGHT <= (SSD1306.CurrentY + Font->FontHeight) ||
+	ch < ' ' || ch > '~'
 	) {
 	/* Error */
 	return 0;
 	}
 
-	/* Go through font */
-	for (i = 0; i < Font->FontHeight; i++) {
-	b = Font->data[(ch - 32) * Font->FontHeight + i];
-	for (j = 0; j < Font->FontWidth; j++) {
-	if ((b << j) & 0x8000) {
-	SSD1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR_t) color);
-	} else {
-	SSD1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR_t)!color);
-	}
-	}
-	}
+	SSD1306_Blit(SSD1306.CurrentX, SSD1306.CurrentY, Font->FontWidth, Font->FontHeight,
+	&Font->data[(ch - ' ') * Font->FontWidth * pages], color);
 
 	/* Increase pointer */
 	SSD1306.CurrentX += Font->FontWidth;
@@ -313,6 +394,47 @@ vTaskDelay(pdMS_TO_TICKS(10));
 	return ch;
 	}
 
+	/**
+	 * @fn		void SSD1306_DrawBitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* data, SSD1306_COLOR_t color)
+	 * @brief	Draws a bitmap stored like the fonts: w bytes per 8-row page, LSB = top row. Nothing is drawn if it
+	 *		does not fit on the screen
+	 */
+	void SSD1306_DrawBitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* data, SSD1306_COLOR_t color) {
+	if (w == 0 || h == 0 || x + w > SSD1306_WIDTH || y + h > SSD1306_HEIGHT) {
+	return;
+	}
+	SSD1306_Blit(x, y, w, h, data, color);
+	}
+
+	/**
+	 * @fn		void SSD1306_ShiftLeft(uint16_t x, uint16_t w, uint8_t page0, uint8_t page1)
+	 * @brief	Moves the columns x + 1 to x + w - 1 of pages page0 to page1 one column left, in the buffer
+	 * @details	The last column keeps its pixels, for the caller to draw the new one. Only the bytes whose value changes
+	 *		are marked dirty, so a flat trace costs little to send even though every column moved.
+	 */
+	void SSD1306_ShiftLeft(uint16_t x, uint16_t w, uint8_t page0, uint8_t page1) {
+	if (w < 2 || x + w > SSD1306_WIDTH || page0 > page1 || page1 >= SSD1306_PAGES) {
+	return;
+	}
+	for (uint8_t page = page0; page <= page1; page++) {
+	uint8_t *row = &SSD1306_Buffer[page * SSD1306_WIDTH + x];
+	uint16_t first = w;
+	uint16_t last = 0;
+	for (uint16_t col = 0; col + 1 < w; col++) {
+	if (row[col] != row[col + 1]) {
+	row[col] = row[col + 1];
+	if (first == w) {
+	first = col;
+	}
+	last = col;
+	}
+	}
+	if (first < w) {
+	SSD1306_MarkDirty(x + first, x + last, page, page);
+	}
+	}
+	}
+
 	char SSD1306_Puts(char* str, FontDef_t* Font, SSD1306_COLOR_t color) {
 	/* Write characters */
 	while (*str) {
@@ -32,6 +32,13 @@ extern "C" {
 		uint8_t Initialized;      // Flag to check if the display has been initialized.
 	} SSD1306_t;
 
+	// Counters of SSD1306_UpdateScreen(). Bytes include the control and command bytes, not the I2C address.
+	typedef struct {
+		uint32_t updates;         // Calls of SSD1306_UpdateScreen().
+		uint16_t lastBytes;       // Bytes sent by the last update, 0 if nothing had changed.
+		uint32_t totalBytes;      // Bytes sent by all updates.
+	} SSD1306_Stats;
+
 	/******************************************************************************
 	* Public function prototypes
 	******************************************************************************/
@@ -39,9 +46,12 @@ extern "C" {
 	// Function to initialize the SSD1306 display.
 	uint8_t SSD1306_Init(void);
 
-	// Function to update the entire screen based on the current buffer.
+	// Function to send the parts of the buffer changed since the last update to the screen.
 	void SSD1306_UpdateScreen(void);
 
+	// Function to read the counters of the screen updates.
+	void SSD1306_GetStats(SSD1306_Stats *stats);
+
 	// Function to clear the display buffer (set all pixels to off/black).
 	void SSD1306_Clear(void);
 
@@ -69,6 +79,12 @@ extern "C" {
 	// Function to draw a string of characters starting at the current cursor location.
 	char SSD1306_Puts(char* str, FontDef_t* Font, SSD1306_COLOR_t color);
 
+	// Function to draw a bitmap stored like the fonts (page-major, LSB = top row) with its top-left corner at x, y.
+	void SSD1306_DrawBitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t* data, SSD1306_COLOR_t color);
+
+	// Function to move a region of whole pages one column left in the buffer, the last column is left for the caller.
+	void SSD1306_ShiftLeft(uint16_t x, uint16_t w, uint8_t page0, uint8_t page1);
+
 	// Function to draw a line between two points with a specified color.
 	void SSD1306_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, SSD1306_COLOR_t color);
 
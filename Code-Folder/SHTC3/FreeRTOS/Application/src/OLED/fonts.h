@@ -1,13 +1,14 @@
 #ifndef FONTS_H
 #define FONTS_H
 
+#include <stdint.h>
 #include "string.h"
 #include <stdio.h>
 
 typedef struct {
 	uint8_t FontWidth;    /*!< Font width in pixels */
 	uint8_t FontHeight;   /*!< Font height in pixels */
-	const uint16_t *data; /*!< Pointer to data font data array */
+	const uint8_t *data;  /*!< Glyphs from ' ', page-major: FontWidth bytes per 8-row page, LSB = top row */
 } FontDef_t;
 
 /**
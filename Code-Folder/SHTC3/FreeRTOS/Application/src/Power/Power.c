@@ -0,0 +1,170 @@
+/**************************************************************************/ /**
+ * @file      Power.c
+ * @brief     Tickless idle. Sleeps in the deepest mode the active peripherals allow, timed by TC4 on the 32 kHz clock
+ * @details   FreeRTOS calls PowerSuppressTicksAndSleep() from the idle task when no task is due for at least
+ *            configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks. SysTick is stopped, TC4 is loaded with the idle time and the
+ *            CPU sleeps in the mode sleepmgr_get_sleep_mode() returns. Drivers whose clock is GCLK 0 hold a sleepmgr
+ *            lock while they are busy, so standby is only entered when nothing but the 32 kHz domain has work: the RTC
+ *            calendar, the EIC and TC4. On wakeup the ticks slept are read back from TC4 and stepped into the kernel,
+ *            so vTaskDelay(), software timers and the MQTT timeouts keep their time across the sleep.
+ *            The RTC is not used for this: it runs the calendar of the medication schedule.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Power/Power.h"
+
+#include <asf.h>
+#include <task.h>
+
+#include "CpuStats/CpuStats.h"
+#include "I2cDriver/I2cDriver.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static struct tc_module powerTc;
+static bool powerReady = false;
+static Power_Stats powerStats;
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void PowerTimerCallback(struct tc_module *const module)
+ * @brief       TC4 compare interrupt, the end of a sleep. Only counts it: the sleep was already accounted for
+ */
+static void PowerTimerCallback(struct tc_module *const module)
+{
+    powerStats.timerWakeups++;
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			int32_t PowerInit(void)
+ * @brief       Initializes the TC4 wakeup timer. The kernel keeps its tick until this is done
+ * @return      Returns 0 on success, ERROR_IO if TC4 could not be initialized
+ * @note        sleepmgr_init() is called by main() instead, before any driver can take a sleepmgr lock
+ */
+int32_t PowerInit(void)
+{
+    struct tc_config config_tc;
+
+    tc_get_config_defaults(&config_tc);
+    config_tc.clock_source = GCLK_GENERATOR_6;
+    config_tc.clock_prescaler = TC_CLOCK_PRESCALER_DIV16;
+    config_tc.counter_size = TC_COUNTER_SIZE_16BIT;
+    config_tc.wave_generation = TC_WAVE_GENERATION_NORMAL_FREQ;
+    config_tc.run_in_standby = true;
+    config_tc.counter_16_bit.compare_capture_channel[TC_COMPARE_CAPTURE_CHANNEL_0] = 0xFFFF;
+    if (tc_init(&powerTc, TC4, &config_tc) != STATUS_OK) {
+        return ERROR_IO;
+    }
+
+    tc_register_callback(&powerTc, PowerTimerCallback, TC_CALLBACK_CC_CHANNEL0);
+    tc_enable_callback(&powerTc, TC_CALLBACK_CC_CHANNEL0);
+    tc_enable(&powerTc);
+    tc_stop_counter(&powerTc);
+
+    powerReady = true;
+    return ERROR_NONE;
+}
+
+/**
+ * @fn			void PowerSuppressTicksAndSleep(TickType_t expectedIdleTicks)
+ * @brief       portSUPPRESS_TICKS_AND_SLEEP() of the application. Sleeps for up to expectedIdleTicks without the tick
+ * @details     Called by the idle task with the scheduler suspended. Interrupts are masked from the moment SysTick stops
+ *              until the ticks slept are stepped in, so an interrupt that wakes the CPU early is only served once the
+ *              kernel time is right again. Idle times shorter than POWER_STANDBY_MIN_TICKS sleep in IDLE 2 at most.
+ *              Time is counted in 1/POWER_TIMER_HZ of a tick: the part of the tick SysTick had already counted when it
+ *              stopped is added to the TC4 time, and SysTick restarts with only the rest of that tick, as the reference
+ *              Cortex-M0 port does, so no sleep loses the tick in progress.
+ * @param[in]   expectedIdleTicks Ticks until the next task is due
+ */
+void PowerSuppressTicksAndSleep(TickType_t expectedIdleTicks)
+{
+    enum sleepmgr_mode mode = sleepmgr_get_sleep_mode();
+
+    if (!powerReady) {
+        return;
+    }
+    if (mode == SLEEPMGR_ACTIVE) {
+        powerStats.sleeps[SLEEPMGR_ACTIVE]++;
+        return;
+    }
+    if (mode == SLEEPMGR_STANDBY && expectedIdleTicks < POWER_STANDBY_MIN_TICKS) {
+        mode = SLEEPMGR_IDLE_2;
+    }
+    if (expectedIdleTicks > POWER_MAX_IDLE_TICKS) {
+        expectedIdleTicks = POWER_MAX_IDLE_TICKS;
+    }
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    // A tick that expired before the stop is still pending: it must be counted by the kernel first
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0) {
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        powerStats.aborted++;
+        __enable_irq();
+        return;
+    }
+
+    uint32_t period = SysTick->LOAD + 1;  // SysTick counts of one tick
+    uint32_t started = ((period - 1 - SysTick->VAL) * POWER_TIMER_HZ) / period;
+    uint32_t counts = ((uint32_t)expectedIdleTicks * POWER_TIMER_HZ - started) / configTICK_RATE_HZ;
+    if (counts == 0) {
+        counts = 1;
+    }
+
+    tc_set_compare_value(&powerTc, TC_COMPARE_CAPTURE_CHANNEL_0, counts);
+    tc_start_counter(&powerTc);  // Retriggers from 0
+    system_set_sleepmode((enum system_sleepmode)(mode - 1));
+    system_sleep();
+
+    uint32_t elapsed = tc_get_count_value(&powerTc);
+    tc_stop_counter(&powerTc);
+
+    uint32_t scaled = elapsed * configTICK_RATE_HZ + started;
+    TickType_t ticks = scaled / POWER_TIMER_HZ;
+    uint32_t rest = scaled % POWER_TIMER_HZ;  // Part of the tick in progress already elapsed
+    if (ticks > expectedIdleTicks) {
+        ticks = expectedIdleTicks;
+        rest = 0;
+    }
+    vTaskStepTick(ticks);
+    powerStats.sleeps[mode]++;
+    powerStats.ticks[mode] += ticks;
+    if (mode == SLEEPMGR_STANDBY) {
+        CpuStatsAdvance(ticks);  // The run-time counter runs on GCLK 0
+    }
+
+    // Writing VAL reloads SysTick from LOAD: the rest of the tick first, then full periods again
+    uint32_t remaining = ((POWER_TIMER_HZ - rest) * period) / POWER_TIMER_HZ;
+    SysTick->LOAD = (remaining > 0) ? remaining - 1 : period - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = period - 1;
+    __enable_irq();
+}
+
+/**
+ * @fn			void PowerGetStats(Power_Stats *stats)
+ * @brief       Copies the counters of the tickless idle
+ * @param[out]  stats Structure the counters are copied to
+ */
+void PowerGetStats(Power_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = powerStats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,51 @@
+/**************************************************************************/ /**
+ * @file      Power.h
+ * @brief     Tickless idle. Sleeps in the deepest mode the active peripherals allow, timed by TC4 on the 32 kHz clock
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef POWER_H_
+#define POWER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <sleepmgr.h>
+#include <stdint.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define POWER_TIMER_HZ 2048            ///< TC4 count rate, GCLK6 (ULP32K) divided by 16
+#define POWER_MAX_IDLE_TICKS 30000     ///< Longest sleep in one go, fits the 16-bit TC4 at POWER_TIMER_HZ
+#define POWER_STANDBY_MIN_TICKS 10     ///< Shorter idle times sleep in IDLE 2, waking from standby relocks the DPLL
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Counters of the tickless idle
+typedef struct Power_Stats {
+    uint32_t sleeps[SLEEPMGR_NR_OF_MODES];  ///< Sleeps per sleepmgr mode. SLEEPMGR_ACTIVE counts idles a lock kept awake
+    uint32_t ticks[SLEEPMGR_NR_OF_MODES];   ///< Ticks slept per sleepmgr mode
+    uint32_t aborted;                       ///< Sleeps abandoned because a task became ready while entering them
+    uint32_t timerWakeups;                  ///< Sleeps that ran to their end, the others were cut short by an interrupt
+} Power_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t PowerInit(void);
+void PowerSuppressTicksAndSleep(TickType_t expectedIdleTicks);
+void PowerGetStats(Power_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POWER_H_ */
@@ -0,0 +1,251 @@
+/**************************************************************************/ /**
+ * @file      Rules.c
+ * @brief     Threshold rule engine. Raises and clears alarms from sample bus records, with hysteresis and dwell time
+ * @details   Each record is checked against the rules of its sensor only, in one pass over the table, without
+ *            allocation. A rule is raised once its condition has held for its dwell time, and cleared only once the value
+ *            is back past the threshold by the hysteresis, so a value sitting on a threshold raises it once. Time is taken
+ *            from the record timestamps, so a recorded trace replays with the same alarm timing.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Rules/Rules.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <task.h>
+
+#include "Buzzer/Buzzer.h"
+#include "I2cDriver/I2cDriver.h"
+#include "SerialConsole.h"
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Effect of an eRuleAction
+typedef struct Rule_Action {
+    const char *name;               ///< Name used by the MQTT rule updates and the CLI
+    const char *message;            ///< Console message when the rule is raised
+    const Buzzer_Pattern *pattern;  ///< Buzzer pattern played when raised, NULL for none
+    bool sustain;                   ///< Post the pattern again on every sample while raised
+} Rule_Action;
+
+/// Evaluation state of one rule
+typedef struct Rule_State {
+    TickType_t since;  ///< Timestamp of the first record the condition held on
+    Rule_Status status;
+} Rule_State;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const Rule_Action ruleActions[RULE_ACTION_MAX] = {
+    {"none", NULL, NULL, false},
+    {"log", "threshold crossed", NULL, false},
+    {"damage", "pill damage", &buzzerPatternDamage, false},
+    {"fire", "there is a fire!!! run", &buzzerPatternFire, true},
+};
+
+/// Rules the box starts with: fire above 50.0 C, pill damage above 28.0 C or 80.0 %RH
+static Rule rules[RULES_MAX] = {
+    {SAMPLE_SENSOR_SHTC3, SAMPLE_SHTC3_TEMPERATURE, RULE_ABOVE, RULE_ACTION_FIRE, 500, 20, 0},
+    {SAMPLE_SENSOR_SHTC3, SAMPLE_SHTC3_TEMPERATURE, RULE_ABOVE, RULE_ACTION_DAMAGE, 280, 10, 2000},
+    {SAMPLE_SENSOR_SHTC3, SAMPLE_SHTC3_HUMIDITY, RULE_ABOVE, RULE_ACTION_DAMAGE, 800, 30, 2000},
+};
+
+static Rule_State ruleState[RULES_MAX];
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static void RulesRaise(uint8_t index, const Rule *rule, bool raised);
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			void RulesEvaluate(const Sample_Record *record)
+ * @brief       Updates every rule of the record sensor with the record, and runs the actions of the rules raised
+ * @param[in]   record Record read from the sample bus. Records with an error status are skipped
+ * @note        Called from a single task. RulesSet() may run concurrently from another one
+ */
+void RulesEvaluate(const Sample_Record *record)
+{
+    if (record->status != ERROR_NONE) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < RULES_MAX; i++) {
+        Rule rule;
+        taskENTER_CRITICAL();
+        rule = rules[i];
+        taskEXIT_CRITICAL();
+
+        if (rule.action == RULE_ACTION_NONE || rule.sensor != record->sensor || rule.channel >= record->channelCount) {
+            continue;
+        }
+
+        Rule_State *state = &ruleState[i];
+        int32_t value = record->channel[rule.channel];
+        state->status.lastValue = value;
+
+        if (state->status.active) {
+            bool cleared = (rule.comparator == RULE_ABOVE) ? (value <= rule.threshold - rule.hysteresis)
+                                                           : (value >= rule.threshold + rule.hysteresis);
+            if (cleared) {
+                state->status.active = false;
+                RulesRaise(i, &rule, false);
+            } else if (ruleActions[rule.action].sustain) {
+                BuzzerPlay(ruleActions[rule.action].pattern);
+            }
+            continue;
+        }
+
+        bool holds = (rule.comparator == RULE_ABOVE) ? (value > rule.threshold) : (value < rule.threshold);
+        if (!holds) {
+            state->status.pending = false;
+            continue;
+        }
+        if (!state->status.pending) {
+            state->status.pending = true;
+            state->since = record->timestamp;
+        }
+        if (record->timestamp - state->since >= pdMS_TO_TICKS(rule.dwellMs)) {
+            state->status.pending = false;
+            state->status.active = true;
+            state->status.raised++;
+            RulesRaise(i, &rule, true);
+        }
+    }
+}
+
+/**
+ * @fn			int32_t RulesSet(uint8_t index, const Rule *rule)
+ * @brief       Replaces a rule. Its state is reset, so it is raised again if its condition still holds
+ * @param[in]   index Rule slot, 0 to RULES_MAX - 1
+ * @param[in]   rule New rule. Action RULE_ACTION_NONE frees the slot
+ * @return      Returns 0 on success, ERROR_INVALID_ARG if the slot or a field is out of range
+ */
+int32_t RulesSet(uint8_t index, const Rule *rule)
+{
+    if (index >= RULES_MAX || rule->sensor >= SAMPLE_SENSOR_MAX || rule->channel >= SAMPLE_MAX_CHANNELS ||
+        rule->comparator > RULE_BELOW || rule->action >= RULE_ACTION_MAX || rule->hysteresis < 0 ||
+        rule->dwellMs > RULES_MAX_DWELL_MS) {
+        return ERROR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL();
+    rules[index] = *rule;
+    memset(&ruleState[index], 0, sizeof(ruleState[index]));
+    taskEXIT_CRITICAL();
+    return ERROR_NONE;
+}
+
+/**
+ * @fn			int32_t RulesParse(const char *text, size_t length)
+ * @brief       Sets a rule from a text update, as received on RULES_TOPIC
+ * @details     Format: "<slot> <sensor> <channel> <'>'|'<'> <threshold> <hysteresis> <dwellMs> <action>", numbers in the
+ *              units of the sample bus, action one of none, log, damage, fire. E.g. "1 0 0 > 300 10 5000 damage" raises
+ *              pill damage once the temperature stays above 30.0 C for 5 s. dwellMs is at most RULES_MAX_DWELL_MS (1 h).
+ * @param[in]   text Update, not null terminated
+ * @param[in]   length Length of text
+ * @return      Returns 0 on success, ERROR_BAD_FORMAT if the text cannot be parsed, ERROR_INVALID_ARG if a field is out
+ *              of range
+ */
+int32_t RulesParse(const char *text, size_t length)
+{
+    char line[64];
+    char comparator;
+    char action[8];
+    unsigned int index, sensor, channel;
+    long threshold, hysteresis;
+    unsigned long dwellMs;
+    Rule rule;
+
+    if (length >= sizeof(line)) {
+        return ERROR_BAD_FORMAT;
+    }
+    memcpy(line, text, length);
+    line[length] = '\0';
+
+    if (sscanf(line, "%u %u %u %c %ld %ld %lu %7s", &index, &sensor, &channel, &comparator, &threshold, &hysteresis,
+               &dwellMs, action) != 8) {
+        return ERROR_BAD_FORMAT;
+    }
+    if (comparator != '>' && comparator != '<') {
+        return ERROR_BAD_FORMAT;
+    }
+
+    rule.action = RULE_ACTION_MAX;
+    for (uint8_t i = 0; i < RULE_ACTION_MAX; i++) {
+        if (strcmp(action, ruleActions[i].name) == 0) {
+            rule.action = i;
+        }
+    }
+    if (rule.action == RULE_ACTION_MAX || index > UINT8_MAX || sensor > UINT8_MAX || channel > UINT8_MAX ||
+        dwellMs > RULES_MAX_DWELL_MS) {
+        return ERROR_INVALID_ARG;
+    }
+
+    rule.sensor = sensor;
+    rule.channel = channel;
+    rule.comparator = (comparator == '>') ? RULE_ABOVE : RULE_BELOW;
+    rule.threshold = threshold;
+    rule.hysteresis = hysteresis;
+    rule.dwellMs = dwellMs;
+    return RulesSet(index, &rule);
+}
+
+/**
+ * @fn			void RulesGet(uint8_t index, Rule *rule, Rule_Status *status)
+ * @brief       Copies a rule and its state
+ * @param[in]   index Rule slot
+ * @param[out]  rule Structure the rule is copied to
+ * @param[out]  status Structure the state is copied to
+ */
+void RulesGet(uint8_t index, Rule *rule, Rule_Status *status)
+{
+    if (index >= RULES_MAX) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    *rule = rules[index];
+    *status = ruleState[index].status;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			const char *RulesGetActionName(uint8_t action)
+ * @brief       Returns the name of an eRuleAction
+ */
+const char *RulesGetActionName(uint8_t action)
+{
+    return (action < RULE_ACTION_MAX) ? ruleActions[action].name : "?";
+}
+
+/**
+ * @fn			static void RulesRaise(uint8_t index, const Rule *rule, bool raised)
+ * @brief       Runs the action of a rule that was just raised, or reports it cleared
+ * @param[in]   index Rule slot
+ * @param[in]   rule Rule
+ * @param[in]   raised True when raised, false when cleared
+ */
+static void RulesRaise(uint8_t index, const Rule *rule, bool raised)
+{
+    const Rule_Action *action = &ruleActions[rule->action];
+    char line[48];
+
+    if (raised) {
+        snprintf(line, sizeof(line), "%s (rule %u)\r\n", action->message, (unsigned)index);
+        if (action->pattern != NULL) {
+            BuzzerPlay(action->pattern);
+        }
+    } else {
+        snprintf(line, sizeof(line), "rule %u cleared\r\n", (unsigned)index);
+    }
+    SerialConsoleWriteString(line);
+}
@@ -0,0 +1,82 @@
+/**************************************************************************/ /**
+ * @file      Rules.h
+ * @brief     Threshold rule engine. Raises and clears alarms from sample bus records, with hysteresis and dwell time
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef RULES_H_
+#define RULES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "SampleBus/SampleBus.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define RULES_MAX 8                    ///< Rule slots, the unused ones have action RULE_ACTION_NONE
+#define RULES_TOPIC "mqttRules"        ///< MQTT topic a rule update is received on, see RulesParse()
+#define RULES_MAX_DWELL_MS 3600000UL   ///< Longest dwell time accepted, so pdMS_TO_TICKS() cannot overflow
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Comparison of a rule
+typedef enum eRuleComparator {
+    RULE_ABOVE = 0,  ///< Raised while the value is above the threshold, cleared at threshold - hysteresis
+    RULE_BELOW,      ///< Raised while the value is below the threshold, cleared at threshold + hysteresis
+} eRuleComparator;
+
+/// What a rule does when it is raised
+typedef enum eRuleAction {
+    RULE_ACTION_NONE = 0,  ///< Slot unused
+    RULE_ACTION_LOG,       ///< Console message only
+    RULE_ACTION_DAMAGE,    ///< Pill damage: one chirp when raised
+    RULE_ACTION_FIRE,      ///< Fire: alarm pattern, posted again on every sample while raised
+    RULE_ACTION_MAX,
+} eRuleAction;
+
+/// One rule. The table is in RAM so rules can be replaced at runtime
+typedef struct Rule {
+    uint8_t sensor;      ///< eSampleSensor the rule watches
+    uint8_t channel;     ///< Channel of the record, see the SAMPLE_<SENSOR>_<CHANNEL> defines
+    uint8_t comparator;  ///< eRuleComparator
+    uint8_t action;      ///< eRuleAction
+    int32_t threshold;   ///< Same unit as the channel
+    int32_t hysteresis;  ///< Distance back past the threshold needed to clear the rule
+    uint32_t dwellMs;    ///< Time the condition must hold before the rule is raised, up to RULES_MAX_DWELL_MS
+} Rule;
+
+/// State of one rule
+typedef struct Rule_Status {
+    bool active;        ///< Rule raised
+    bool pending;       ///< Condition true, dwell time running
+    uint32_t raised;    ///< Times the rule was raised
+    int32_t lastValue;  ///< Last value evaluated
+} Rule_Status;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+void RulesEvaluate(const Sample_Record *record);
+int32_t RulesSet(uint8_t index, const Rule *rule);
+int32_t RulesParse(const char *text, size_t length);
+void RulesGet(uint8_t index, Rule *rule, Rule_Status *status);
+const char *RulesGetActionName(uint8_t action);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RULES_H_ */
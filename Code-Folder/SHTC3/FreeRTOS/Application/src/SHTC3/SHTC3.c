@@ -13,56 +13,396 @@
 #include "SHTC3.h"
 #include "i2c_master.h"
 #include "i2c_master_interrupt.h"
-#include "I2cDriver\I2cDriver.h"
+#include "I2cDriver/I2cDriver.h"
 #include "stdint.h"
 #include "SerialConsole.h"
 
 
-int32_t SHTC3_ReadTemperatureAndHumidity(uint8_t *buffer, uint8_t count);
-int SHTC3_Init(void);
+static eSHTC3PowerMode shtc3PowerMode = SHTC3_POWER_NORMAL;  ///< Measurement mode used by the next measurement
+static eSHTC3State shtc3State = SHTC3_STATE_SLEEP;           ///< Where the sensor is in its measurement cycle
+static volatile TickType_t shtc3WakeTick;                    ///< Tick at which the sensor was last woken up
+static volatile TickType_t shtc3TriggerTick;                 ///< Tick at which the running conversion was triggered
+static uint32_t shtc3SampleBusUs;                            ///< Bus time of the sample in progress (us)
+static SHTC3_Stats shtc3Stats;                               ///< Driver counters, see SHTC3_GetStats()
 
-//data structure for SHTC3Data
-I2C_Data SHTC3Data;
+/// Transfer of the driver. One at a time: each step checks the previous one completed before queuing the next, so
+/// the descriptor and its buffers are static instead of living on the stack of a blocked caller
+static I2C_Transaction shtc3Transaction;
+static uint8_t shtc3Command[2];
+static uint8_t shtc3Response[SHTC3_RESPONSE_SIZE];
 
 /******************************************************************************
  * Functions
  ******************************************************************************/
 
 /**
- * @brief   Initializes the SHTC3 sensor by sending a wakeup command.
+ * @brief   Completion callback of the SHTC3 transfers, interrupt context. Accounts the bus time and stamps the wake-up
+ *          and trigger commands, from which the wake-up and conversion times run
+ */
+static void SHTC3_TransferDone(I2C_Transaction *transaction, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	TickType_t now = xTaskGetTickCountFromISR();
+
+	shtc3SampleBusUs += transaction->durationUs;
+	shtc3Stats.busUs += transaction->durationUs;
+	if (transaction->status != ERROR_NONE) {
+		shtc3Stats.busErrors++;
+	} else if (shtc3State == SHTC3_STATE_WAKING) {
+		shtc3WakeTick = now;
+	} else if (shtc3State == SHTC3_STATE_MEASURING) {
+		shtc3TriggerTick = now;
+	}
+}
+
+/**
+ * @brief   Result of the last transfer, without blocking
+ * @details A transfer still queued after WAIT_I2C_LINE_MS + WAIT_TIME is cancelled, as the blocking transfers did.
+ * @return  Returns ERROR_BUSY while it is queued or on the bus, then its result, ERROR_TIMEOUT if it was cancelled
+ */
+static int32_t SHTC3_Pending(void)
+{
+	if (shtc3Transaction.status != ERROR_BUSY) {
+		return shtc3Transaction.status;
+	}
+	if (xTaskGetTickCount() - shtc3Transaction.submitTick < pdMS_TO_TICKS(WAIT_I2C_LINE_MS + WAIT_TIME)) {
+		return ERROR_BUSY;
+	}
+	if (I2cCancelTransaction(&shtc3Transaction) == ERROR_NONE) {
+		shtc3Stats.busErrors++;
+		shtc3Transaction.status = ERROR_TIMEOUT;
+	}
+	return shtc3Transaction.status;
+}
+
+/**
+ * @brief   Queues a transfer on the SHTC3 without waiting for it
+ * @param   data Address and write/read segments. The buffers must be static
+ * @return  Returns 0 if the transfer was queued, otherwise returns an error code.
+ */
+static int32_t SHTC3_Submit(I2C_Data *data)
+{
+	I2cInitTransaction(&shtc3Transaction, data, I2C_PRIORITY_NORMAL);
+	shtc3Transaction.callback = SHTC3_TransferDone;
+	return I2cSubmitTransaction(&shtc3Transaction);
+}
+
+/**
+ * @brief   Queues a 16-bit command to the SHTC3
+ * @param   cmd1 Command MSB
+ * @param   cmd2 Command LSB
+ * @return  Returns 0 if the command was queued, otherwise returns an error code.
+ */
+static int32_t SHTC3_SendCommand(uint8_t cmd1, uint8_t cmd2)
+{
+	I2C_Data data;
+
+	shtc3Command[0] = cmd1;
+	shtc3Command[1] = cmd2;
+	data.address = SHTC3_ADDR;
+	data.msgOut = shtc3Command;
+	data.lenOut = sizeof(shtc3Command);
+	data.msgIn = NULL;
+	data.lenIn = 0;
+	return SHTC3_Submit(&data);
+}
+
+/**
+ * @brief   Blocks the calling task until the last transfer completed. Task context only, not from the executor
+ * @return  Returns the result of the transfer
+ */
+static int32_t SHTC3_WaitTransfer(void)
+{
+	int32_t error;
+
+	while ((error = SHTC3_Pending()) == ERROR_BUSY) {
+		vTaskDelay(1);
+	}
+	return error;
+}
+
+/**
+ * @brief   Converts a raw temperature word to tenths of degree Celsius, rounded: T = -45 + 175 * raw / 2^16
+ */
+static int16_t SHTC3_ConvertTemperature(uint16_t raw)
+{
+	return (int16_t)(-450 + (int32_t)((1750UL * raw + 32768UL) >> 16));
+}
+
+/**
+ * @brief   Converts a raw humidity word to tenths of percent, rounded: RH = 100 * raw / 2^16
+ */
+static uint16_t SHTC3_ConvertHumidity(uint16_t raw)
+{
+	return (uint16_t)((1000UL * raw + 32768UL) >> 16);
+}
+
+/**
+ * @fn		uint8_t SHTC3_Crc8(const uint8_t *data, uint8_t count)
+ * @brief	Computes the SHTC3 CRC-8 (polynomial 0x31, initial value 0xFF, no reflection, no final XOR)
+ * @details 	The sensor sends one CRC after each 16-bit word. CRC of 0xBEEF is 0x92.
+ * @return		Returns the CRC of the given bytes.
+ */
+uint8_t SHTC3_Crc8(const uint8_t *data, uint8_t count)
+{
+	uint8_t crc = SHTC3_CRC_INIT;
+
+	for (uint8_t i = 0; i < count; i++) {
+		crc ^= data[i];
+		for (uint8_t bit = 0; bit < 8; bit++) {
+			crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ SHTC3_CRC_POLYNOMIAL) : (uint8_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+/**
+ * @brief   Initializes the SHTC3 sensor by sending a wakeup command, then puts it back to sleep until the first measurement.
  * @return  Returns 0 if no errors occur, otherwise returns an error code.
+ * @note    Blocks until the commands are sent: task context, before the executor runs the measurement steps
  */
-int SHTC3_Init(void){
+int32_t SHTC3_Init(void){
 	
 	 //Sending wakeup command to initialize
-     uint8_t cmd[] = {SHTC3_WAKEUP_CMD1, SHTC3_WAKEUP_CMD2};
+	int32_t error = SHTC3_Wake();
+	if (error == ERROR_NONE) {
+		error = SHTC3_WaitTransfer();
+	}
+	if (error != ERROR_NONE) {
+		shtc3State = SHTC3_STATE_SLEEP;
+		return error;
+	}
+	vTaskDelay(SHTC3_GetWakeupTicks());
 
-     SHTC3Data.address = SHTC3_ADDR;
-     SHTC3Data.msgOut = (const uint8_t *) &cmd[0];
-     SHTC3Data.lenOut = sizeof(cmd);
-     SHTC3Data.lenIn = 0;
-     int32_t error = I2cWriteDataWait(&SHTC3Data, WAIT_TIME);
-	
-     return error;
+	error = SHTC3_Sleep();
+	return (error != ERROR_NONE) ? error : SHTC3_WaitTransfer();
 }
 
 /**
- * @fn		int32_t SHTC3_Read_Data(uint8_t *buffer, uint8_t count)
- * @brief	//Sending command to measure temperature first, then RH, in normal power mode, no clock stretching
- * @details 	Assumes I2C is already initialized
+ * @fn		int32_t SHTC3_Wake(void)
+ * @brief	First step of a measurement: queues the wake-up command and returns
+ * @details 	Wait SHTC3_GetWakeupTicks() before SHTC3_Trigger(). Nothing blocks, so the steps can run as executor jobs.
+
+ * @return		Returns 0 if the command was queued, ERROR_BUSY if a measurement is running or the sleep command of the last
+ *			one is still queued.
+ */
+int32_t SHTC3_Wake(void)
+{
+	int32_t error = SHTC3_Pending();
+
+	if (shtc3State != SHTC3_STATE_SLEEP || error == ERROR_BUSY) {
+		return ERROR_BUSY;
+	}
 
+	shtc3SampleBusUs = 0;
+	shtc3WakeTick = xTaskGetTickCount();
+	shtc3State = SHTC3_STATE_WAKING;
+	error = SHTC3_SendCommand(SHTC3_WAKEUP_CMD1, SHTC3_WAKEUP_CMD2);
+	if (error != ERROR_NONE) {
+		shtc3State = SHTC3_STATE_SLEEP;
+	}
+	return error;
+}
+
+/**
+ * @fn		int32_t SHTC3_Trigger(void)
+ * @brief	Second step of a measurement: queues a temperature-first measurement, without clock stretching
+ * @details 	The bus is released as soon as the command is sent; the sensor converts on its own. Wait for
+ *			SHTC3_GetMeasurementTicks() before calling SHTC3_ReadMeasurement().
+
+ * @return		Returns 0 if the command was queued, ERROR_BUSY while the wake-up command is queued or the sensor is waking
+ *			up (call again later), ERROR_NOT_READY if the sensor was not woken up, or the error of the wake-up command.
+ * @note		Uses the mode selected with SHTC3_SetPowerMode()
+ */
+int32_t SHTC3_Trigger(void)
+{
+	int32_t error;
+
+	if (shtc3State != SHTC3_STATE_WAKING) {
+		return ERROR_NOT_READY;
+	}
+	error = SHTC3_Pending();
+	if (error == ERROR_BUSY) {
+		return ERROR_BUSY;
+	}
+	if (error != ERROR_NONE) {
+		shtc3State = SHTC3_STATE_SLEEP;
+		return error;
+	}
+	if (xTaskGetTickCount() - shtc3WakeTick < SHTC3_GetWakeupTicks()) {
+		return ERROR_BUSY;
+	}
+
+	shtc3TriggerTick = xTaskGetTickCount();
+	shtc3State = SHTC3_STATE_MEASURING;
+	if (shtc3PowerMode == SHTC3_POWER_LOW) {
+		error = SHTC3_SendCommand(SHT3_TH_LPM_NCS_MEASURE_CMD1, SHT3_TH_LPM_NCS_MEASURE_CMD2);
+	} else {
+		error = SHTC3_SendCommand(SHT3_TH_NM_NCS_MEASURE_CMD1, SHT3_TH_NM_NCS_MEASURE_CMD2);
+	}
+	if (error != ERROR_NONE) {
+		SHTC3_Sleep();
+	}
+	return error;
+}
+
+/**
+ * @fn		int32_t SHTC3_ReadMeasurement(SHTC3_Sample *sample)
+ * @brief	Last step of a measurement: reads the result, checks both CRCs and queues the sleep command
+ * @details 	The first call queues the read once the conversion time has elapsed and returns ERROR_BUSY, as do the calls
+ *			until it completes. The sensor NACKs its address until the conversion is done, so reading too early fails
+ *			with a bus error.
+
+ * @param[out]	sample Converted sample. Only written if the read succeeds and both CRCs match
+ * @return		Returns 0 if no errors, ERROR_BUSY until the result is in (call again later), ERROR_INVALID_DATA on a CRC
+ *			mismatch, ERROR_NOT_READY if no measurement was started.
+ */
+int32_t SHTC3_ReadMeasurement(SHTC3_Sample *sample)
+{
+	I2C_Data data;
+	int32_t error;
+
+	if (shtc3State != SHTC3_STATE_MEASURING && shtc3State != SHTC3_STATE_READING) {
+		return ERROR_NOT_READY;
+	}
+	error = SHTC3_Pending();
+	if (error == ERROR_BUSY) {
+		return ERROR_BUSY;
+	}
+
+	if (shtc3State == SHTC3_STATE_MEASURING && error == ERROR_NONE) {
+		if (xTaskGetTickCount() - shtc3TriggerTick < SHTC3_GetMeasurementTicks()) {
+			return ERROR_BUSY;
+		}
+		shtc3State = SHTC3_STATE_READING;
+		data.address = SHTC3_ADDR;
+		data.msgOut = NULL;
+		data.lenOut = 0;
+		data.msgIn = shtc3Response;
+		data.lenIn = sizeof(shtc3Response);
+		error = SHTC3_Submit(&data);
+		if (error == ERROR_NONE) {
+			return ERROR_BUSY;
+		}
+	}
+
+	if (error == ERROR_NONE) {
+		if (SHTC3_Crc8(&shtc3Response[0], 2) != shtc3Response[2] || SHTC3_Crc8(&shtc3Response[3], 2) != shtc3Response[5]) {
+			shtc3Stats.crcErrors++;
+			error = ERROR_INVALID_DATA;
+		} else {
+			sample->temperature = SHTC3_ConvertTemperature((uint16_t)((shtc3Response[0] << 8) | shtc3Response[1]));
+			sample->humidity = SHTC3_ConvertHumidity((uint16_t)((shtc3Response[3] << 8) | shtc3Response[4]));
+			shtc3Stats.samples++;
+		}
+	}
+
+	int32_t sleepError = SHTC3_Sleep();
+	shtc3Stats.lastBusUs = shtc3SampleBusUs;
+	return (error != ERROR_NONE) ? error : sleepError;
+}
+
+/**
+ * @fn		int32_t SHTC3_Sleep(void)
+ * @brief	Queues the sleep command, after which the sensor draws 0.3 uA instead of 45 uA idle
+ * @details 	The next SHTC3_Wake() returns ERROR_BUSY until the command is sent.
+ * @return		Returns 0 if the command was queued, ERROR_BUSY if the last transfer is still queued.
+ */
+int32_t SHTC3_Sleep(void)
+{
+	if (SHTC3_Pending() == ERROR_BUSY) {
+		return ERROR_BUSY;
+	}
+	shtc3State = SHTC3_STATE_SLEEP;
+	shtc3Stats.awakeTicks += xTaskGetTickCount() - shtc3WakeTick;
+	return SHTC3_SendCommand(SHTC3_SLEEP_CMD1, SHTC3_SLEEP_CMD2);
+}
+
+/**
+ * @fn		int32_t SHTC3_ReadTemperatureAndHumidity(SHTC3_Sample *sample)
+ * @brief	Runs a full measurement cycle: wake, trigger, wait with the bus released, read, check CRC, sleep
+ * @details 	Assumes I2C is already initialized. The calling task sleeps between the steps, so this is for task
+ *			context only: the acquisition executor runs the steps itself.
+
+ * @param[out]	sample Converted sample
  * @return		Returns 0 if no errors.
  * @note
  */
-int32_t SHTC3_ReadTemperatureAndHumidity(uint8_t *buffer, uint8_t count){
+int32_t SHTC3_ReadTemperatureAndHumidity(SHTC3_Sample *sample){
 	
-	//Sending command to measure temperature first, then RH, in normal power mode, no clock stretching
-	uint8_t cmd[] = {SHT3_TH_NM_NCS_MEASURE_CMD1, SHT3_TH_NM_NCS_MEASURE_CMD2};
-	SHTC3Data.address = SHTC3_ADDR;
-	SHTC3Data.msgOut = (const uint8_t*) &cmd[0];
-	SHTC3Data.lenOut = sizeof(cmd);
-	SHTC3Data.msgIn = buffer;
-	SHTC3Data.lenIn = count;
-	int error = I2cReadDataWait(&SHTC3Data, WAIT_TIME, WAIT_TIME);
+	int32_t error = SHTC3_Wake();
+	if (error != ERROR_NONE) {
+		return error;
+	}
+
+	vTaskDelay(SHTC3_GetWakeupTicks());
+	while ((error = SHTC3_Trigger()) == ERROR_BUSY) {
+		vTaskDelay(1);
+	}
+	if (error != ERROR_NONE) {
+		return error;
+	}
+
+	vTaskDelay(SHTC3_GetMeasurementTicks());
+	while ((error = SHTC3_ReadMeasurement(sample)) == ERROR_BUSY) {
+		vTaskDelay(1);
+	}
 	return error;
 }
+
+/**
+ * @fn		uint32_t SHTC3_GetWakeupTicks(void)
+ * @brief	Returns how long to wait between SHTC3_Wake() and SHTC3_Trigger()
+ * @return		Delay in ticks, rounded up so that a wait of this length always covers the wake-up time.
+ */
+uint32_t SHTC3_GetWakeupTicks(void)
+{
+	return pdMS_TO_TICKS(SHTC3_WAKEUP_TIME_MS) + 1;
+}
+
+/**
+ * @fn		uint32_t SHTC3_GetMeasurementTicks(void)
+ * @brief	Returns how long to wait between SHTC3_Trigger() and SHTC3_ReadMeasurement() in the current mode
+ * @return		Delay in ticks, rounded up so that a wait of this length always covers the conversion.
+ */
+uint32_t SHTC3_GetMeasurementTicks(void)
+{
+	if (shtc3PowerMode == SHTC3_POWER_LOW) {
+		return pdMS_TO_TICKS(SHTC3_MEASURE_LPM_TIME_MS) + 1;
+	}
+	return pdMS_TO_TICKS(SHTC3_MEASURE_NM_TIME_MS) + 1;
+}
+
+/**
+ * @brief   Selects the measurement mode used from the next measurement on
+ */
+void SHTC3_SetPowerMode(eSHTC3PowerMode mode)
+{
+	shtc3PowerMode = mode;
+}
+
+/**
+ * @brief   Returns the measurement mode in use
+ */
+eSHTC3PowerMode SHTC3_GetPowerMode(void)
+{
+	return shtc3PowerMode;
+}
+
+/**
+ * @brief   Returns where the sensor is in its measurement cycle
+ */
+eSHTC3State SHTC3_GetState(void)
+{
+	return shtc3State;
+}
+
+/**
+ * @brief   Copies the driver counters
+ * @param   stats Structure the counters are copied to
+ */
+void SHTC3_GetStats(SHTC3_Stats *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = shtc3Stats;
+	taskEXIT_CRITICAL();
+}
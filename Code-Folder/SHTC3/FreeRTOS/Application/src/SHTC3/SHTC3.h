@@ -16,6 +16,7 @@
  ******************************************************************************/
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include <math.h>
 
 /******************************************************************************
@@ -26,6 +27,8 @@
 #define SHTC3_WAKEUP_CMD1 0x35
 #define SHTC3_WAKEUP_CMD2 0x17
 #define SHTC3_SLEEP_CMD 0xB098
+#define SHTC3_SLEEP_CMD1 0xB0
+#define SHTC3_SLEEP_CMD2 0x98
 #define SHTC3_SOFT_RESET_CMD 0x805D
 #define SHTC3_ID_REG 0xEFC8
 
@@ -36,6 +39,8 @@
 #define SHT3_TH_NM_NCS_MEASURE_CMD2 0x66  ///< Command to measure temperature first, then RH, in normal power mode, no clock stretching
 
 #define SHT3_TH_LPM_NCS_MEASURE_CMD 0x609C  ///< Command to measure temperature first, then RH, in low power mode, no clock stretching
+#define SHT3_TH_LPM_NCS_MEASURE_CMD1 0x60   ///< Command to measure temperature first, then RH, in low power mode, no clock stretching
+#define SHT3_TH_LPM_NCS_MEASURE_CMD2 0x9C   ///< Command to measure temperature first, then RH, in low power mode, no clock stretching
 
 #define SHT3_HT_NM_NCS_MEASURE_CMD 0x58E0 ///< Command to measure RH first, then temperature, in normal power mode, no clock stretching
 #define SHT3_HT_LPM_NCS_MEASURE_CMD 0x401A  ///< Command to measure RH first, then temperature, in low power mode, no clock stretching
@@ -46,19 +51,63 @@
 #define SHT3_HT_NM_CS_MEASURE_CMD 0x5C24 ///< Command to measure RH first, then temperature, in normal power mode,  clock stretching
 #define SHT3_HT_LPM_CS_MEASURE_CMD 0x44DE  ///< Command to measure RH first, then temperature, in low power mode, clock stretching
 
+#define SHTC3_WAKEUP_TIME_MS 1       ///< Wake-up time is 240 us max, rounded up to the tick
+#define SHTC3_MEASURE_NM_TIME_MS 13  ///< Measurement duration in normal mode is 12.1 ms max
+#define SHTC3_MEASURE_LPM_TIME_MS 1  ///< Measurement duration in low power mode is 0.8 ms max
+
+#define SHTC3_RESPONSE_SIZE 6   ///< Temperature word, CRC, humidity word, CRC
+#define SHTC3_CRC_POLYNOMIAL 0x31  ///< CRC-8 polynomial x^8 + x^5 + x^4 + 1
+#define SHTC3_CRC_INIT 0xFF        ///< CRC-8 initial value
+
 /******************************************************************************
  * Structures and Enumerations
  ******************************************************************************/
+/// Measurement mode. Low power mode trades repeatability for a ~15x shorter conversion.
+typedef enum eSHTC3PowerMode {
+	SHTC3_POWER_NORMAL = 0,  ///< Normal mode, 12.1 ms conversion
+	SHTC3_POWER_LOW,         ///< Low power mode, 0.8 ms conversion
+} eSHTC3PowerMode;
+
+/// Where the sensor is in its wake / measure / sleep cycle
+typedef enum eSHTC3State {
+	SHTC3_STATE_SLEEP = 0,  ///< Sensor asleep, or its sleep command queued. A measurement can be started
+	SHTC3_STATE_WAKING,     ///< Wake-up command queued or sensor waking up. The measurement can be triggered once awake
+	SHTC3_STATE_MEASURING,  ///< Conversion running, bus free. The result can be read once the measurement time elapsed
+	SHTC3_STATE_READING,    ///< Result read queued or on the bus
+} eSHTC3State;
+
+/// One SHTC3 sample, in fixed point
+typedef struct SHTC3_Sample {
+	int16_t temperature;  ///< Temperature in tenths of degree Celsius
+	uint16_t humidity;    ///< Relative humidity in tenths of percent
+} SHTC3_Sample;
+
+/// Counters of the SHTC3 driver, to follow the sensor and bus cost of each sample
+typedef struct SHTC3_Stats {
+	uint32_t samples;     ///< Samples read with a valid CRC
+	uint32_t crcErrors;   ///< Samples dropped because of a CRC mismatch
+	uint32_t busErrors;   ///< I2C transfers that failed
+	uint32_t busUs;       ///< Accumulated time the driver kept the I2C bus busy (us)
+	uint32_t awakeTicks;  ///< Accumulated ticks the sensor spent awake
+	uint32_t lastBusUs;   ///< I2C bus time of the last sample (us)
+} SHTC3_Stats;
 
 /******************************************************************************
  * Global Function Declaration
  ******************************************************************************/
-//int SHTC3_Init(void);
-//int SHTC3_SendI2cCommand(uint8_t *buf, uint8_t size);
-//int SHTC3_Read_Data(uint8_t *buf, uint8_t size);
-//int SHTC3_Init(uint8_t *buffer, uint8_t count);
-int SHTC3_Init(void);
-int32_t SHTC3_ReadTemperatureAndHumidity(uint8_t *buffer, uint8_t count);
+int32_t SHTC3_Init(void);
+int32_t SHTC3_ReadTemperatureAndHumidity(SHTC3_Sample *sample);
+int32_t SHTC3_Wake(void);
+int32_t SHTC3_Trigger(void);
+int32_t SHTC3_ReadMeasurement(SHTC3_Sample *sample);
+int32_t SHTC3_Sleep(void);
+uint32_t SHTC3_GetWakeupTicks(void);
+uint32_t SHTC3_GetMeasurementTicks(void);
+void SHTC3_SetPowerMode(eSHTC3PowerMode mode);
+eSHTC3PowerMode SHTC3_GetPowerMode(void);
+eSHTC3State SHTC3_GetState(void);
+void SHTC3_GetStats(SHTC3_Stats *stats);
+uint8_t SHTC3_Crc8(const uint8_t *data, uint8_t count);
 
 #ifdef __cplusplus
 }
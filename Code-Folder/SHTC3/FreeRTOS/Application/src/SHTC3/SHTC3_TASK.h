@@ -15,12 +15,10 @@
 #include "SHTC3/SHTC3.h"
 //#include "Pulse rate/pulse.h"
 
-#define SHTC3_TASK_SIZE	300
-#define SHTC3_PRIORITY (configMAX_PRIORITIES -1)  //2
 #define TEMP_TOPIC "Mqtttemp"
 #define MOIST_TOPIC "Mqttmoist"
 
-void SHTC3Task(void *pvParameters);
+int32_t SHTC3TaskReadSample(void);
 
 
 #endif /* SHTC3_TASK_H_ */
\ No newline at end of file
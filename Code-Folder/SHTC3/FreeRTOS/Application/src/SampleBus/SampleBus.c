@@ -0,0 +1,210 @@
+/**************************************************************************/ /**
+ * @file      SampleBus.c
+ * @brief     Sensor sample bus. One ring of timestamped sensor records shared by every subscriber
+ * @details   Publishing writes the record once into the ring; each subscriber only keeps the sequence number of the next
+ *            record it will read. A subscriber that falls more than SAMPLE_BUS_DEPTH records behind loses the oldest
+ *            ones, which is counted in its drops, and never blocks the publisher or the other subscribers.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "SampleBus/SampleBus.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define SAMPLE_BUS_INDEX(sequence) ((sequence) & (SAMPLE_BUS_DEPTH - 1))
+
+#if (SAMPLE_BUS_DEPTH & (SAMPLE_BUS_DEPTH - 1)) != 0
+#error "SAMPLE_BUS_DEPTH must be a power of two"
+#endif
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// State of one subscriber
+struct Sample_Subscriber {
+    const char *name;             ///< Name printed by the CLI
+    uint32_t sensorMask;          ///< SAMPLE_SENSOR_MASK() of the sensors read by this subscriber
+    TaskHandle_t notifyTask;      ///< Task notified on every publish of a subscribed sensor, or NULL to poll
+    uint32_t notifyBits;          ///< Notification bits set on notifyTask
+    SemaphoreHandle_t semaphore;  ///< Semaphore given on every publish of a subscribed sensor, or NULL
+    uint32_t next;                ///< Sequence number of the next record to read
+    uint32_t received;            ///< Records read
+    uint32_t drops;               ///< Subscribed records overwritten before being read
+    uint32_t maxDepth;            ///< Highest number of unread records
+};
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static Sample_Record sampleRing[SAMPLE_BUS_DEPTH];                          ///< Last published records
+static uint32_t sampleHead = 0;                                             ///< Sequence number of the next record published
+static Sample_Subscriber sampleSubscribers[SAMPLE_BUS_MAX_SUBSCRIBERS];     ///< Subscriber table
+static uint8_t sampleSubscriberCount = 0;                                   ///< Used entries of sampleSubscribers
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			Sample_Subscriber *SampleBusSubscribe(const char *name, uint32_t sensorMask, TaskHandle_t notifyTask, uint32_t notifyBits)
+ * @brief       Adds a subscriber to the bus. It receives the records published from now on
+ * @param[in]   name Name printed by the CLI
+ * @param[in]   sensorMask Sensors to receive, SAMPLE_SENSOR_MASK() bits or SAMPLE_SENSOR_ALL
+ * @param[in]   notifyTask Task notified with notifyBits (eSetBits) on every publish of a subscribed sensor. NULL to poll
+ * @param[in]   notifyBits Notification bits set on notifyTask
+ * @return      Subscriber handle, or NULL if the subscriber table is full
+ * @note        Subscribers cannot be removed. The table is sized for the tasks of the application
+ */
+Sample_Subscriber *SampleBusSubscribe(const char *name, uint32_t sensorMask, TaskHandle_t notifyTask, uint32_t notifyBits)
+{
+    Sample_Subscriber *subscriber = NULL;
+
+    taskENTER_CRITICAL();
+    if (sampleSubscriberCount < SAMPLE_BUS_MAX_SUBSCRIBERS) {
+        subscriber = &sampleSubscribers[sampleSubscriberCount];
+        subscriber->name = name;
+        subscriber->sensorMask = sensorMask;
+        subscriber->notifyTask = notifyTask;
+        subscriber->notifyBits = notifyBits;
+        subscriber->semaphore = NULL;
+        subscriber->next = sampleHead;
+        sampleSubscriberCount++;
+    }
+    taskEXIT_CRITICAL();
+
+    return subscriber;
+}
+
+/**
+ * @fn			void SampleBusPublish(Sample_Record *record)
+ * @brief       Publishes a record to every subscriber
+ * @details     The record is copied once into the ring and its sequence number is set. Subscribers whose oldest unread
+ *              record is the one being overwritten move past it, counting a drop if they subscribed to its sensor.
+ * @param[in,out] record Record to publish. sequence is written by the bus
+ * @note        Task context only. Publishers may run in any task, the slot is claimed inside the critical section
+ */
+void SampleBusPublish(Sample_Record *record)
+{
+    taskENTER_CRITICAL();
+    Sample_Record *slot = &sampleRing[SAMPLE_BUS_INDEX(sampleHead)];
+    for (uint8_t i = 0; i < sampleSubscriberCount; i++) {
+        Sample_Subscriber *subscriber = &sampleSubscribers[i];
+        if (sampleHead - subscriber->next >= SAMPLE_BUS_DEPTH) {
+            if (subscriber->sensorMask & SAMPLE_SENSOR_MASK(slot->sensor)) {
+                subscriber->drops++;
+            }
+            subscriber->next++;
+        }
+    }
+
+    record->sequence = sampleHead;
+    *slot = *record;
+    sampleHead++;
+
+    for (uint8_t i = 0; i < sampleSubscriberCount; i++) {
+        Sample_Subscriber *subscriber = &sampleSubscribers[i];
+        if (sampleHead - subscriber->next > subscriber->maxDepth) {
+            subscriber->maxDepth = sampleHead - subscriber->next;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    for (uint8_t i = 0; i < sampleSubscriberCount; i++) {
+        Sample_Subscriber *subscriber = &sampleSubscribers[i];
+        if (!(subscriber->sensorMask & SAMPLE_SENSOR_MASK(record->sensor))) {
+            continue;
+        }
+        if (subscriber->notifyTask != NULL) {
+            xTaskNotify(subscriber->notifyTask, subscriber->notifyBits, eSetBits);
+        }
+        if (subscriber->semaphore != NULL) {
+            xSemaphoreGive(subscriber->semaphore);
+        }
+    }
+}
+
+/**
+ * @fn			void SampleBusSetSemaphore(Sample_Subscriber *subscriber, SemaphoreHandle_t semaphore)
+ * @brief       Gives a binary semaphore on every publish of a subscribed sensor, instead of or as well as the notification
+ * @details     For a subscriber that waits on a queue set, which task notifications cannot be part of. A give while the
+ *              semaphore is still available is lost, so the subscriber reads until SampleBusRead() returns false.
+ * @param[in]   subscriber Handle returned by SampleBusSubscribe()
+ * @param[in]   semaphore Binary semaphore, NULL to stop
+ */
+void SampleBusSetSemaphore(Sample_Subscriber *subscriber, SemaphoreHandle_t semaphore)
+{
+    subscriber->semaphore = semaphore;
+}
+
+/**
+ * @fn			bool SampleBusRead(Sample_Subscriber *subscriber, Sample_Record *record)
+ * @brief       Reads the oldest unread record of a subscribed sensor
+ * @details     Records of other sensors are skipped. Never blocks: a subscriber with a notify task waits on its
+ *              notification bits, and then reads until this function returns false.
+ * @param[in]   subscriber Handle returned by SampleBusSubscribe()
+ * @param[out]  record Copy of the record read
+ * @return      True if a record was read
+ */
+bool SampleBusRead(Sample_Subscriber *subscriber, Sample_Record *record)
+{
+    bool found = false;
+
+    taskENTER_CRITICAL();
+    while (subscriber->next != sampleHead) {
+        const Sample_Record *slot = &sampleRing[SAMPLE_BUS_INDEX(subscriber->next)];
+        subscriber->next++;
+        if (subscriber->sensorMask & SAMPLE_SENSOR_MASK(slot->sensor)) {
+            *record = *slot;
+            subscriber->received++;
+            found = true;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return found;
+}
+
+/**
+ * @fn			uint32_t SampleBusGetPublished(void)
+ * @brief       Returns the number of records published since start
+ */
+uint32_t SampleBusGetPublished(void)
+{
+    return sampleHead;
+}
+
+/**
+ * @fn			uint8_t SampleBusGetSubscriberCount(void)
+ * @brief       Returns the number of subscribers of the bus
+ */
+uint8_t SampleBusGetSubscriberCount(void)
+{
+    return sampleSubscriberCount;
+}
+
+/**
+ * @fn			void SampleBusGetSubscriberStats(uint8_t index, Sample_Subscriber_Stats *stats)
+ * @brief       Copies the counters of a subscriber
+ * @param[in]   index Index of the subscriber, below SampleBusGetSubscriberCount()
+ * @param[out]  stats Structure the counters are copied to
+ */
+void SampleBusGetSubscriberStats(uint8_t index, Sample_Subscriber_Stats *stats)
+{
+    if (index >= sampleSubscriberCount) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    stats->name = sampleSubscribers[index].name;
+    stats->received = sampleSubscribers[index].received;
+    stats->drops = sampleSubscribers[index].drops;
+    stats->depth = sampleHead - sampleSubscribers[index].next;
+    stats->maxDepth = sampleSubscribers[index].maxDepth;
+    taskEXIT_CRITICAL();
+}
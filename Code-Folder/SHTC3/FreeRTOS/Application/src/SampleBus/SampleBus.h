@@ -0,0 +1,100 @@
+/**************************************************************************/ /**
+ * @file      SampleBus.h
+ * @brief     Sensor sample bus. One ring of timestamped sensor records shared by every subscriber
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef SAMPLE_BUS_H_
+#define SAMPLE_BUS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define SAMPLE_BUS_DEPTH 16            ///< Records kept in the ring. Must be a power of two
+#define SAMPLE_BUS_MAX_SUBSCRIBERS 4   ///< MQTT publisher, display, alarm evaluation and logger
+#define SAMPLE_MAX_CHANNELS 3          ///< Channels carried by one record
+
+#define SAMPLE_SENSOR_MASK(sensor) (1UL << (sensor))  ///< Bit of a sensor in a subscriber mask
+#define SAMPLE_SENSOR_ALL 0xFFFFFFFFUL                ///< Subscriber mask receiving every sensor
+
+#define SAMPLE_SHTC3_TEMPERATURE 0      ///< SHTC3 channel: temperature, tenths of degree C
+#define SAMPLE_SHTC3_HUMIDITY 1         ///< SHTC3 channel: relative humidity, tenths of %RH
+#define SAMPLE_IMU_X 0                  ///< LSM6DSO channel: X acceleration, mg
+#define SAMPLE_IMU_Y 1                  ///< LSM6DSO channel: Y acceleration, mg
+#define SAMPLE_IMU_Z 2                  ///< LSM6DSO channel: Z acceleration, mg
+#define SAMPLE_IMU_EVENT_FLAGS 0        ///< IMU event channel: IMU_EVENT_* flags
+#define SAMPLE_IMU_EVENT_ORIENTATION 1  ///< IMU event channel: 6D position (D6D_SRC XL..ZH bits)
+#define SAMPLE_IMU_EVENT_MOVING 2       ///< IMU event channel: 1 while the box moves, 0 once it is still
+#define SAMPLE_LID_INDEX 0              ///< Lid channel: eInputId of the lid
+#define SAMPLE_LID_OPEN 1               ///< Lid channel: 1 if the lid was opened, 0 if it was closed
+#define SAMPLE_LID_DEBOUNCE 2           ///< Lid channel: ticks from the first edge to the publish
+#define SAMPLE_DOSE_COMPARTMENT 0       ///< Dose channel: eInputId of the compartment
+#define SAMPLE_DOSE_SLOT 1              ///< Dose channel: schedule slot
+#define SAMPLE_DOSE_LATE 2              ///< Dose channel: minutes between the dose time and the reminder
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Sensors that publish on the bus
+typedef enum eSampleSensor {
+    SAMPLE_SENSOR_SHTC3 = 0,  ///< Temperature and humidity
+    SAMPLE_SENSOR_LSM6DSO,    ///< Accelerometer
+    SAMPLE_SENSOR_IMU_EVENT,  ///< Drop, knock, orientation and motion events of the LSM6DSO
+    SAMPLE_SENSOR_LID,        ///< Debounced lid changes, timestamped at the first edge
+    SAMPLE_SENSOR_DOSE,       ///< Dose reminders of the medication schedule
+    SAMPLE_SENSOR_BUTTON,     ///< SW0 presses, no channels
+    SAMPLE_SENSOR_MAX,
+} eSampleSensor;
+
+/// One sample of a sensor
+typedef struct Sample_Record {
+    uint32_t sequence;                     ///< Set by the bus, increments on every publish
+    TickType_t timestamp;                  ///< Tick the sample was read at
+    uint8_t sensor;                        ///< eSampleSensor that produced the sample
+    uint8_t channelCount;                  ///< Valid entries of channel
+    int32_t status;                        ///< ERROR_NONE, or the error of the read (channels are then invalid)
+    int32_t channel[SAMPLE_MAX_CHANNELS];  ///< Sensor values, see the SAMPLE_<SENSOR>_<CHANNEL> defines
+} Sample_Record;
+
+/// Opaque subscriber handle
+typedef struct Sample_Subscriber Sample_Subscriber;
+
+/// Counters of one subscriber
+typedef struct Sample_Subscriber_Stats {
+    const char *name;   ///< Name given at subscription
+    uint32_t received;  ///< Records read
+    uint32_t drops;     ///< Records of a subscribed sensor overwritten before being read
+    uint32_t depth;     ///< Records waiting to be read
+    uint32_t maxDepth;  ///< Highest depth seen
+} Sample_Subscriber_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+Sample_Subscriber *SampleBusSubscribe(const char *name, uint32_t sensorMask, TaskHandle_t notifyTask, uint32_t notifyBits);
+void SampleBusPublish(Sample_Record *record);
+void SampleBusSetSemaphore(Sample_Subscriber *subscriber, SemaphoreHandle_t semaphore);
+bool SampleBusRead(Sample_Subscriber *subscriber, Sample_Record *record);
+uint32_t SampleBusGetPublished(void);
+uint8_t SampleBusGetSubscriberCount(void);
+void SampleBusGetSubscriberStats(uint8_t index, Sample_Subscriber_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SAMPLE_BUS_H_ */
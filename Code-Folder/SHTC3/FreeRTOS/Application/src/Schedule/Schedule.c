@@ -0,0 +1,684 @@
+/**************************************************************************/ /**
+ * @file      Schedule.c
+ * @brief     Medication schedule. Daily and weekly dose times per compartment, timed by the RTC calendar alarm
+ * @details   The RTC calendar runs on local time, set from the WINC network time. Every dose slot has exactly one
+ *            pending deadline, its next due minute, kept in a min-heap: only the nearest deadline is armed in RTC alarm
+ *            0. When the alarm matches, the owner task is notified and ScheduleService() signals every dose that is due,
+ *            pushes their next occurrence and arms the new nearest one. The reminder therefore does not depend on the
+ *            network, and the device does not need to wake up until the next dose. The dose slots and the time zone are
+ *            kept in a flash row, and an RTC a reset left counting is taken over as it is: after a watchdog reset or a
+ *            crash the schedule runs on at once, without waiting for Wi-Fi, the network time or an MQTT schedule update.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Schedule/Schedule.h"
+
+#include <asf.h>
+#include <semphr.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Buzzer/Buzzer.h"
+#include "I2cDriver/I2cDriver.h"
+#include "Input/Input.h"
+#include "SampleBus/SampleBus.h"
+#include "SerialConsole.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define SCHEDULE_MINUTES_PER_DAY 1440
+#define SCHEDULE_EPOCH_YEAR 2000    ///< Minute 0 is 2000-01-01 00:00, a Saturday
+#define SCHEDULE_EPOCH_WEEKDAY 6
+#define SCHEDULE_STORE_MAGIC 0x53434844UL                          ///< "SCHD"
+#define SCHEDULE_ROW_SIZE (NVMCTRL_PAGE_SIZE * NVMCTRL_ROW_PAGES)  ///< Flash erase unit
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Pending deadline of a dose slot
+typedef struct Schedule_Deadline {
+    uint32_t due;  ///< Minute since the epoch, local time
+    uint8_t slot;  ///< Dose slot
+} Schedule_Deadline;
+
+/// Dose slots and time zone as kept in flash
+typedef struct Schedule_Store {
+    uint32_t magic;
+    int16_t utcOffsetMin;
+    uint16_t reserved;
+    Schedule_Entry entries[SCHEDULE_MAX_ENTRIES];
+    uint32_t check;  ///< ScheduleChecksum() of the fields above
+} Schedule_Store;
+
+/// Flash row holding the store. It spans a whole erase row, so erasing it touches nothing else
+typedef union Schedule_Row {
+    Schedule_Store store;
+    uint8_t bytes[SCHEDULE_ROW_SIZE];
+} Schedule_Row;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static struct rtc_module scheduleRtc;
+static SemaphoreHandle_t scheduleMutex = NULL;  ///< Guards the slots, the heap and the RTC alarm
+static StaticSemaphore_t scheduleMutexBuffer;
+static TaskHandle_t scheduleNotifyTask = NULL;
+static uint32_t scheduleNotifyBits;
+
+static Schedule_Entry scheduleEntries[SCHEDULE_MAX_ENTRIES];
+static Schedule_Deadline scheduleHeap[SCHEDULE_MAX_ENTRIES];  ///< Min-heap on due, one deadline per used slot
+static uint8_t scheduleHeapSize = 0;
+static Schedule_Stats scheduleStats;
+static int16_t scheduleUtcOffsetMin = SCHEDULE_UTC_OFFSET_MIN;
+
+/// Erased until the first ScheduleSave(). volatile, so reads are not folded into the initializer
+static const volatile Schedule_Row scheduleRow __attribute__((aligned(SCHEDULE_ROW_SIZE))) = {
+    .bytes = {[0 ... SCHEDULE_ROW_SIZE - 1] = 0xFF}};
+
+extern struct rtc_module *_rtc_instance[RTC_INST_NUM];  ///< ASF table the RTC interrupt finds its module in
+
+_Static_assert(sizeof(Schedule_Store) <= NVMCTRL_PAGE_SIZE, "Schedule store does not fit a flash page");
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static uint32_t ScheduleDaysFromDate(uint16_t year, uint8_t month, uint8_t day);
+static uint32_t ScheduleNextDue(const Schedule_Entry *entry, uint32_t after);
+static void ScheduleHeapPush(uint32_t due, uint8_t slot);
+static void ScheduleHeapPop(void);
+static void ScheduleRebuild(uint32_t now);
+static void ScheduleArm(void);
+static uint32_t ScheduleReadMinute(void);
+static uint32_t ScheduleChecksum(const Schedule_Store *store);
+static void ScheduleLoad(void);
+static int32_t ScheduleSave(void);
+static bool ScheduleRtcAttach(void);
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void ScheduleAlarmCallback(void)
+ * @brief       RTC alarm 0 match: a dose is due. The work is deferred to the owner task
+ */
+static void ScheduleAlarmCallback(void)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if (scheduleNotifyTask != NULL) {
+        xTaskNotifyFromISR(scheduleNotifyTask, scheduleNotifyBits, eSetBits, &xHigherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			int32_t ScheduleInit(TaskHandle_t notifyTask, uint32_t notifyBits)
+ * @brief       Loads the dose slots from flash, starts the RTC calendar and registers the task that services the alarms
+ * @details     If the RTC still counts a time set before a system reset, it is kept as it is and the schedule is armed
+ *              on it right away. Otherwise the RTC starts from 2000-01-01 and doses wait for ScheduleSetTime().
+ * @param[in]   notifyTask Task notified when a dose is due. It must then call ScheduleService()
+ * @param[in]   notifyBits Notification bits set on notifyTask
+ * @return      Returns 0 on success, ERROR_NO_MEMORY if the mutex could not be created
+ * @note        The RTC is clocked at 1.024 kHz by GCLK 2 and counts seconds
+ */
+int32_t ScheduleInit(TaskHandle_t notifyTask, uint32_t notifyBits)
+{
+    struct rtc_calendar_config config_rtc;
+    struct nvm_config config_nvm;
+
+    scheduleMutex = xSemaphoreCreateMutexStatic(&scheduleMutexBuffer);
+    if (scheduleMutex == NULL) {
+        return ERROR_NO_MEMORY;
+    }
+    scheduleNotifyTask = notifyTask;
+    scheduleNotifyBits = notifyBits;
+
+    nvm_get_config_defaults(&config_nvm);
+    config_nvm.manual_page_write = false;
+    nvm_set_config(&config_nvm);
+    ScheduleLoad();
+
+    if (!ScheduleRtcAttach()) {
+        rtc_calendar_get_config_defaults(&config_rtc);
+        config_rtc.prescaler = RTC_CALENDAR_PRESCALER_DIV_1024;
+        config_rtc.clock_24h = true;
+        config_rtc.year_init_value = SCHEDULE_EPOCH_YEAR;
+        config_rtc.alarm[RTC_CALENDAR_ALARM_0].mask = RTC_CALENDAR_ALARM_MASK_DISABLED;
+        rtc_calendar_init(&scheduleRtc, RTC, &config_rtc);
+        rtc_calendar_enable(&scheduleRtc);
+    }
+
+    rtc_calendar_register_callback(&scheduleRtc, ScheduleAlarmCallback, RTC_CALENDAR_CALLBACK_ALARM_0);
+    rtc_calendar_enable_callback(&scheduleRtc, RTC_CALENDAR_CALLBACK_ALARM_0);
+
+    xSemaphoreTake(scheduleMutex, portMAX_DELAY);
+    if (scheduleStats.timeValid) {
+        ScheduleRebuild(ScheduleReadMinute());
+        ScheduleArm();
+    }
+    xSemaphoreGive(scheduleMutex);
+    return ERROR_NONE;
+}
+
+/**
+ * @fn			void ScheduleSetTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+ * @brief       Sets the RTC from a UTC time and re-arms the schedule on it
+ * @details     Doses between the old and the new time are not signalled: every deadline is recomputed from the new time.
+ * @param[in]   year..second UTC date and time, as given by the network time
+ */
+void ScheduleSetTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+{
+    struct rtc_calendar_time time;
+    uint32_t local;
+
+    if (scheduleMutex == NULL || year < SCHEDULE_EPOCH_YEAR + 1) {
+        return;
+    }
+
+    xSemaphoreTake(scheduleMutex, portMAX_DELAY);
+    local = ScheduleDaysFromDate(year, month, day) * SCHEDULE_MINUTES_PER_DAY + hour * 60 + minute + scheduleUtcOffsetMin;
+
+    rtc_calendar_get_time_defaults(&time);
+    ScheduleMinuteToDate(local, &time.year, &time.month, &time.day, &time.hour, &time.minute);
+    time.second = second;
+
+    rtc_calendar_set_time(&scheduleRtc, &time);
+    scheduleStats.timeValid = true;
+    scheduleStats.timeSets++;
+    ScheduleRebuild(local);
+    ScheduleArm();
+    xSemaphoreGive(scheduleMutex);
+}
+
+/**
+ * @fn			void ScheduleService(void)
+ * @brief       Signals the doses that are due and arms the next deadline. Called by the task given to ScheduleInit()
+ * @details     Each due dose plays the pill reminder, logs its compartment and is published on the sample bus. The loop
+ *              runs again if the next deadline already passed while arming, so a deadline is never armed in the past.
+ */
+void ScheduleService(void)
+{
+    char line[40];
+
+    if (scheduleMutex == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(scheduleMutex, portMAX_DELAY);
+    while (scheduleStats.timeValid && scheduleHeapSize > 0) {
+        uint32_t now = ScheduleReadMinute();
+        if (scheduleHeap[0].due > now) {
+            ScheduleArm();
+            if (scheduleHeap[0].due > ScheduleReadMinute()) {
+                break;
+            }
+            continue;
+        }
+
+        Schedule_Deadline deadline = scheduleHeap[0];
+        const Schedule_Entry *entry = &scheduleEntries[deadline.slot];
+        Sample_Record record = {0};
+
+        ScheduleHeapPop();
+        ScheduleHeapPush(ScheduleNextDue(entry, now), deadline.slot);
+
+        scheduleStats.fired++;
+        if (now - deadline.due > 1) {
+            scheduleStats.late++;
+        }
+
+        record.timestamp = xTaskGetTickCount();
+        record.sensor = SAMPLE_SENSOR_DOSE;
+        record.status = ERROR_NONE;
+        record.channelCount = 3;
+        record.channel[SAMPLE_DOSE_COMPARTMENT] = entry->compartment;
+        record.channel[SAMPLE_DOSE_SLOT] = deadline.slot;
+        record.channel[SAMPLE_DOSE_LATE] = now - deadline.due;
+        SampleBusPublish(&record);
+
+        BuzzerPlay(&buzzerPatternPill);
+        snprintf(line, sizeof(line), "dose due: box %u\r\n", (unsigned)entry->compartment + 1);
+        SerialConsoleWriteString(line);
+    }
+    xSemaphoreGive(scheduleMutex);
+}
+
+/**
+ * @fn			int32_t ScheduleSet(uint8_t slot, const Schedule_Entry *entry)
+ * @brief       Replaces a dose slot, re-arms the schedule and stores the slots in flash
+ * @param[in]   slot Dose slot, 0 to SCHEDULE_MAX_ENTRIES - 1
+ * @param[in]   entry New dose time. days 0 frees the slot
+ * @return      Returns 0 on success, ERROR_INVALID_ARG if a field is out of range, ERROR_IO if the slots could not be
+ *              stored (the new slot is still used until the next reset)
+ */
+int32_t ScheduleSet(uint8_t slot, const Schedule_Entry *entry)
+{
+    int32_t error;
+
+    if (slot >= SCHEDULE_MAX_ENTRIES || entry->compartment >= INPUT_MAX || entry->hour > 23 || entry->minute > 59 ||
+        entry->days > SCHEDULE_DAYS_DAILY || scheduleMutex == NULL) {
+        return ERROR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(scheduleMutex, portMAX_DELAY);
+    taskENTER_CRITICAL();
+    scheduleEntries[slot] = *entry;
+    taskEXIT_CRITICAL();
+    if (scheduleStats.timeValid) {
+        ScheduleRebuild(ScheduleReadMinute());
+        ScheduleArm();
+    }
+    error = ScheduleSave();
+    xSemaphoreGive(scheduleMutex);
+    return error;
+}
+
+/**
+ * @fn			int32_t ScheduleSetUtcOffset(int16_t minutes)
+ * @brief       Sets the time zone of the box, moves the RTC to the new local time and stores the zone in flash
+ * @details     There are no daylight saving rules on the device: the offset is updated when the clocks change.
+ * @param[in]   minutes Local time minus UTC, SCHEDULE_UTC_OFFSET_LOWEST to SCHEDULE_UTC_OFFSET_HIGHEST
+ * @return      Returns 0 on success, ERROR_INVALID_ARG if the offset is out of range, ERROR_IO if it could not be stored
+ */
+int32_t ScheduleSetUtcOffset(int16_t minutes)
+{
+    int32_t error;
+
+    if (minutes < SCHEDULE_UTC_OFFSET_LOWEST || minutes > SCHEDULE_UTC_OFFSET_HIGHEST || scheduleMutex == NULL) {
+        return ERROR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(scheduleMutex, portMAX_DELAY);
+    if (scheduleStats.timeValid && minutes != scheduleUtcOffsetMin) {
+        struct rtc_calendar_time time;
+        uint32_t local;
+
+        rtc_calendar_get_time(&scheduleRtc, &time);
+        local = ScheduleDaysFromDate(time.year, time.month, time.day) * SCHEDULE_MINUTES_PER_DAY + time.hour * 60 +
+                time.minute + (minutes - scheduleUtcOffsetMin);
+        ScheduleMinuteToDate(local, &time.year, &time.month, &time.day, &time.hour, &time.minute);
+        rtc_calendar_set_time(&scheduleRtc, &time);
+        ScheduleRebuild(local);
+        ScheduleArm();
+    }
+    scheduleUtcOffsetMin = minutes;
+    error = ScheduleSave();
+    xSemaphoreGive(scheduleMutex);
+    return error;
+}
+
+/**
+ * @fn			int32_t ScheduleParse(const char *text, size_t length)
+ * @brief       Sets a dose slot or the time zone from a text update, as received on SCHEDULE_TOPIC
+ * @details     Format: "<slot> <box> <hh>:<mm> <days>", box 1 to 3, local time, days a hexadecimal mask with bit 0 for
+ *              Sunday. E.g. "0 1 08:30 7f" is box 1 every day at 8:30, "1 2 20:00 41" box 2 on Saturdays and Sundays,
+ *              "1 2 00:00 0" frees slot 1. "tz <minutes>" sets the local time minus UTC, e.g. "tz -240".
+ * @param[in]   text Update, not null terminated
+ * @param[in]   length Length of text
+ * @return      Returns 0 on success, ERROR_BAD_FORMAT if the text cannot be parsed, ERROR_INVALID_ARG if a field is out
+ *              of range
+ */
+int32_t ScheduleParse(const char *text, size_t length)
+{
+    char line[32];
+    unsigned int slot, box, hour, minute, days;
+    int offset;
+    Schedule_Entry entry;
+
+    if (length >= sizeof(line)) {
+        return ERROR_BAD_FORMAT;
+    }
+    memcpy(line, text, length);
+    line[length] = '\0';
+
+    if (sscanf(line, "tz %d", &offset) == 1) {
+        if (offset < SCHEDULE_UTC_OFFSET_LOWEST || offset > SCHEDULE_UTC_OFFSET_HIGHEST) {
+            return ERROR_INVALID_ARG;
+        }
+        return ScheduleSetUtcOffset(offset);
+    }
+    if (sscanf(line, "%u %u %u:%u %x", &slot, &box, &hour, &minute, &days) != 5) {
+        return ERROR_BAD_FORMAT;
+    }
+    if (slot > UINT8_MAX || box < 1 || box > INPUT_MAX || hour > 23 || minute > 59 || days > SCHEDULE_DAYS_DAILY) {
+        return ERROR_INVALID_ARG;
+    }
+
+    entry.compartment = box - 1;
+    entry.hour = hour;
+    entry.minute = minute;
+    entry.days = days;
+    return ScheduleSet(slot, &entry);
+}
+
+/**
+ * @fn			void ScheduleGet(uint8_t slot, Schedule_Entry *entry)
+ * @brief       Copies a dose slot
+ */
+void ScheduleGet(uint8_t slot, Schedule_Entry *entry)
+{
+    if (slot >= SCHEDULE_MAX_ENTRIES) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    *entry = scheduleEntries[slot];
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			void ScheduleGetStats(Schedule_Stats *stats)
+ * @brief       Copies the counters of the schedule
+ */
+void ScheduleGetStats(Schedule_Stats *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = scheduleStats;
+    stats->pending = scheduleHeapSize;
+    stats->utcOffsetMin = scheduleUtcOffsetMin;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			uint32_t ScheduleGetMinute(void)
+ * @brief       Returns the current local minute since 2000-01-01, 0 if the time is not set
+ */
+uint32_t ScheduleGetMinute(void)
+{
+    return (scheduleStats.timeValid) ? ScheduleReadMinute() : 0;
+}
+
+/**
+ * @fn			void ScheduleMinuteToDate(uint32_t minute, uint16_t *year, uint8_t *month, uint8_t *day, uint8_t *hour, uint8_t *min)
+ * @brief       Converts a minute since 2000-01-01 to a calendar date and time
+ */
+void ScheduleMinuteToDate(uint32_t minute, uint16_t *year, uint8_t *month, uint8_t *day, uint8_t *hour, uint8_t *min)
+{
+    static const uint8_t monthDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    uint32_t days = minute / SCHEDULE_MINUTES_PER_DAY;
+    uint16_t y = SCHEDULE_EPOCH_YEAR;
+    uint8_t m = 0;
+
+    *hour = (minute % SCHEDULE_MINUTES_PER_DAY) / 60;
+    *min = minute % 60;
+
+    for (;;) {
+        uint16_t yearDays = ((y % 4) == 0) ? 366 : 365;  // 2000 to 2099
+        if (days < yearDays) {
+            break;
+        }
+        days -= yearDays;
+        y++;
+    }
+    for (;;) {
+        uint8_t length = monthDays[m] + ((m == 1 && (y % 4) == 0) ? 1 : 0);
+        if (days < length) {
+            break;
+        }
+        days -= length;
+        m++;
+    }
+
+    *year = y;
+    *month = m + 1;
+    *day = days + 1;
+}
+
+/**
+ * @fn			static uint32_t ScheduleDaysFromDate(uint16_t year, uint8_t month, uint8_t day)
+ * @brief       Returns the days since 2000-01-01 of a date, 2000 to 2099
+ */
+static uint32_t ScheduleDaysFromDate(uint16_t year, uint8_t month, uint8_t day)
+{
+    static const uint16_t daysBeforeMonth[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    uint32_t years = year - SCHEDULE_EPOCH_YEAR;
+    uint32_t days = years * 365 + (years + 3) / 4;  // Leap days of the years before, 2000 included
+
+    days += daysBeforeMonth[month - 1] + (day - 1);
+    if (month > 2 && (year % 4) == 0) {
+        days++;
+    }
+    return days;
+}
+
+/**
+ * @fn			static uint32_t ScheduleNextDue(const Schedule_Entry *entry, uint32_t after)
+ * @brief       Returns the first minute after the given one at which a dose is due
+ * @param[in]   entry Dose slot, with at least one day set
+ * @param[in]   after Minute since the epoch. The result is strictly later
+ */
+static uint32_t ScheduleNextDue(const Schedule_Entry *entry, uint32_t after)
+{
+    uint32_t day = after / SCHEDULE_MINUTES_PER_DAY;
+    uint32_t minuteOfDay = entry->hour * 60 + entry->minute;
+
+    for (uint8_t k = 0; k <= 7; k++) {
+        uint32_t due = (day + k) * SCHEDULE_MINUTES_PER_DAY + minuteOfDay;
+        uint8_t weekday = (day + k + SCHEDULE_EPOCH_WEEKDAY) % 7;
+        if (due > after && (entry->days & (1 << weekday))) {
+            return due;
+        }
+    }
+    return UINT32_MAX;
+}
+
+/**
+ * @fn			static void ScheduleHeapPush(uint32_t due, uint8_t slot)
+ * @brief       Adds a deadline to the min-heap
+ */
+static void ScheduleHeapPush(uint32_t due, uint8_t slot)
+{
+    uint8_t i = scheduleHeapSize++;
+
+    while (i > 0) {
+        uint8_t parent = (i - 1) / 2;
+        if (scheduleHeap[parent].due <= due) {
+            break;
+        }
+        scheduleHeap[i] = scheduleHeap[parent];
+        i = parent;
+    }
+    scheduleHeap[i].due = due;
+    scheduleHeap[i].slot = slot;
+}
+
+/**
+ * @fn			static void ScheduleHeapPop(void)
+ * @brief       Removes the nearest deadline from the min-heap
+ */
+static void ScheduleHeapPop(void)
+{
+    Schedule_Deadline last = scheduleHeap[--scheduleHeapSize];
+    uint8_t i = 0;
+
+    for (;;) {
+        uint8_t child = 2 * i + 1;
+        if (child >= scheduleHeapSize) {
+            break;
+        }
+        if (child + 1 < scheduleHeapSize && scheduleHeap[child + 1].due < scheduleHeap[child].due) {
+            child++;
+        }
+        if (last.due <= scheduleHeap[child].due) {
+            break;
+        }
+        scheduleHeap[i] = scheduleHeap[child];
+        i = child;
+    }
+    scheduleHeap[i] = last;
+}
+
+/**
+ * @fn			static void ScheduleRebuild(uint32_t now)
+ * @brief       Recomputes the deadline of every used slot from the given minute
+ */
+static void ScheduleRebuild(uint32_t now)
+{
+    scheduleHeapSize = 0;
+    for (uint8_t slot = 0; slot < SCHEDULE_MAX_ENTRIES; slot++) {
+        if (scheduleEntries[slot].days != 0) {
+            ScheduleHeapPush(ScheduleNextDue(&scheduleEntries[slot], now), slot);
+        }
+    }
+}
+
+/**
+ * @fn			static void ScheduleArm(void)
+ * @brief       Programs RTC alarm 0 on the nearest deadline, or disables it if there is none
+ */
+static void ScheduleArm(void)
+{
+    struct rtc_calendar_alarm_time alarm;
+
+    rtc_calendar_get_time_defaults(&alarm.time);
+    if (scheduleHeapSize == 0) {
+        alarm.mask = RTC_CALENDAR_ALARM_MASK_DISABLED;
+        scheduleStats.nextMinute = 0;
+    } else {
+        ScheduleMinuteToDate(scheduleHeap[0].due, &alarm.time.year, &alarm.time.month, &alarm.time.day, &alarm.time.hour,
+                             &alarm.time.minute);
+        alarm.time.second = 0;
+        alarm.mask = RTC_CALENDAR_ALARM_MASK_YEAR;
+        scheduleStats.nextMinute = scheduleHeap[0].due;
+    }
+    rtc_calendar_set_alarm(&scheduleRtc, &alarm, RTC_CALENDAR_ALARM_0);
+}
+
+/**
+ * @fn			static uint32_t ScheduleReadMinute(void)
+ * @brief       Reads the RTC and returns the current minute since the epoch
+ */
+static uint32_t ScheduleReadMinute(void)
+{
+    struct rtc_calendar_time time;
+
+    rtc_calendar_get_time(&scheduleRtc, &time);
+    return ScheduleDaysFromDate(time.year, time.month, time.day) * SCHEDULE_MINUTES_PER_DAY + time.hour * 60 + time.minute;
+}
+
+/**
+ * @fn			static uint32_t ScheduleChecksum(const Schedule_Store *store)
+ * @brief       Checksum of a store, to tell one written by ScheduleSave() from erased or reprogrammed flash
+ */
+static uint32_t ScheduleChecksum(const Schedule_Store *store)
+{
+    const uint8_t *byte = (const uint8_t *)store;
+    uint32_t sum = SCHEDULE_STORE_MAGIC;
+
+    for (size_t i = 0; i < offsetof(Schedule_Store, check); i++) {
+        sum = (sum << 5) + (sum >> 27) + byte[i];
+    }
+    return sum;
+}
+
+/**
+ * @fn			static void ScheduleLoad(void)
+ * @brief       Restores the dose slots and the time zone from flash. An erased or corrupt row leaves the defaults
+ */
+static void ScheduleLoad(void)
+{
+    Schedule_Store store;
+    uint8_t *byte = (uint8_t *)&store;
+
+    for (size_t i = 0; i < sizeof(store); i++) {
+        byte[i] = scheduleRow.bytes[i];
+    }
+    if (store.magic != SCHEDULE_STORE_MAGIC || store.check != ScheduleChecksum(&store) ||
+        store.utcOffsetMin < SCHEDULE_UTC_OFFSET_LOWEST || store.utcOffsetMin > SCHEDULE_UTC_OFFSET_HIGHEST) {
+        scheduleStats.stored = false;
+        return;
+    }
+    memcpy(scheduleEntries, store.entries, sizeof(scheduleEntries));
+    scheduleUtcOffsetMin = store.utcOffsetMin;
+    scheduleStats.stored = true;
+}
+
+/**
+ * @fn			static int32_t ScheduleSave(void)
+ * @brief       Writes the dose slots and the time zone to flash, unless the row already holds them
+ * @details     Retained MQTT updates come again on every connection, so an unchanged schedule is not rewritten.
+ * @return      Returns 0 on success, ERROR_IO if the row could not be written
+ * @note        Called with scheduleMutex held. The CPU stalls on flash reads for the few ms the row takes to erase
+ */
+static int32_t ScheduleSave(void)
+{
+    Schedule_Store store;
+    const uint8_t *byte = (const uint8_t *)&store;
+    uint32_t address = (uint32_t)&scheduleRow;
+    enum status_code status;
+
+    memset(&store, 0, sizeof(store));
+    store.magic = SCHEDULE_STORE_MAGIC;
+    store.utcOffsetMin = scheduleUtcOffsetMin;
+    memcpy(store.entries, scheduleEntries, sizeof(store.entries));
+    store.check = ScheduleChecksum(&store);
+
+    scheduleStats.stored = true;
+    for (size_t i = 0; i < sizeof(store); i++) {
+        if (scheduleRow.bytes[i] != byte[i]) {
+            scheduleStats.stored = false;
+            break;
+        }
+    }
+    if (scheduleStats.stored) {
+        return ERROR_NONE;
+    }
+
+    do {
+        status = nvm_erase_row(address);
+    } while (status == STATUS_BUSY);
+    if (status == STATUS_OK) {
+        do {
+            status = nvm_write_buffer(address, byte, sizeof(store));
+        } while (status == STATUS_BUSY);
+    }
+    while (!nvm_is_ready()) {
+    }
+
+    scheduleStats.stored = (status == STATUS_OK) && (scheduleRow.store.check == store.check);
+    return scheduleStats.stored ? ERROR_NONE : ERROR_IO;
+}
+
+/**
+ * @fn			static bool ScheduleRtcAttach(void)
+ * @brief       Takes over an RTC that kept counting through a system reset, without resetting it
+ * @details     If the reset left the RTC running in calendar mode on a time later than the epoch year, that time was set
+ *              by ScheduleSetTime() before the reset and is still valid. A power-on leaves it disabled.
+ * @return      Returns true if the RTC was taken over, false if it must be initialized
+ */
+static bool ScheduleRtcAttach(void)
+{
+    struct system_gclk_chan_config gclk_chan_conf;
+    struct rtc_calendar_time time;
+
+    if (!(RTC->MODE2.CTRL.reg & RTC_MODE2_CTRL_ENABLE) || RTC->MODE2.CTRL.bit.MODE != 2) {
+        return false;
+    }
+
+    system_apb_clock_set_mask(SYSTEM_CLOCK_APB_APBA, PM_APBAMASK_RTC);
+    if (!system_gclk_chan_is_enabled(RTC_GCLK_ID)) {
+        system_gclk_chan_get_config_defaults(&gclk_chan_conf);
+        gclk_chan_conf.source_generator = GCLK_GENERATOR_2;
+        system_gclk_chan_set_config(RTC_GCLK_ID, &gclk_chan_conf);
+        system_gclk_chan_enable(RTC_GCLK_ID);
+    }
+
+    memset(&scheduleRtc, 0, sizeof(scheduleRtc));
+    scheduleRtc.hw = RTC;
+    scheduleRtc.clock_24h = true;
+    scheduleRtc.year_init_value = SCHEDULE_EPOCH_YEAR;
+    _rtc_instance[0] = &scheduleRtc;
+
+    rtc_calendar_get_time(&scheduleRtc, &time);
+    scheduleStats.timeValid = (time.year > SCHEDULE_EPOCH_YEAR);
+    return true;
+}
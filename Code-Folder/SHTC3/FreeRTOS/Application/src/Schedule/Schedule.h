@@ -0,0 +1,75 @@
+/**************************************************************************/ /**
+ * @file      Schedule.h
+ * @brief     Medication schedule. Daily and weekly dose times per compartment, timed by the RTC calendar alarm
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef SCHEDULE_H_
+#define SCHEDULE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define SCHEDULE_MAX_ENTRIES 12            ///< Dose slots, four per compartment
+#define SCHEDULE_TOPIC "mqttSchedule"      ///< MQTT topic a schedule update is received on, see ScheduleParse()
+#define SCHEDULE_UTC_OFFSET_MIN (-300)     ///< Local time minus UTC until one is set. The RTC runs on local time
+#define SCHEDULE_UTC_OFFSET_LOWEST (-720)  ///< Range of ScheduleSetUtcOffset(), UTC-12:00...
+#define SCHEDULE_UTC_OFFSET_HIGHEST 840    ///< ...to UTC+14:00
+#define SCHEDULE_DAYS_DAILY 0x7F           ///< Day mask of a daily dose. Bit 0 is Sunday, bit 6 Saturday
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// One dose time
+typedef struct Schedule_Entry {
+    uint8_t compartment;  ///< eInputId of the compartment the dose is in
+    uint8_t hour;         ///< Local time, 0 to 23
+    uint8_t minute;       ///< 0 to 59
+    uint8_t days;         ///< Days the dose is due, SCHEDULE_DAYS_DAILY for every day. 0 frees the slot
+} Schedule_Entry;
+
+/// Counters of the schedule
+typedef struct Schedule_Stats {
+    bool timeValid;        ///< False until the RTC was set from the network time. Stays true across a reset
+    bool stored;           ///< True if the dose slots and the time zone match the copy in flash
+    uint8_t pending;       ///< Dose times in the deadline heap
+    int16_t utcOffsetMin;  ///< Local time minus UTC
+    uint32_t nextMinute;   ///< Minute of the armed RTC alarm, since 2000-01-01 local time. 0 if none is armed
+    uint32_t fired;        ///< Doses signalled
+    uint32_t late;         ///< Doses signalled more than a minute after their time (RTC set forward, or busy task)
+    uint32_t timeSets;     ///< Times the RTC was set
+} Schedule_Stats;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t ScheduleInit(TaskHandle_t notifyTask, uint32_t notifyBits);
+void ScheduleSetTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second);
+void ScheduleService(void);
+int32_t ScheduleSet(uint8_t slot, const Schedule_Entry *entry);
+int32_t ScheduleSetUtcOffset(int16_t minutes);
+int32_t ScheduleParse(const char *text, size_t length);
+void ScheduleGet(uint8_t slot, Schedule_Entry *entry);
+void ScheduleGetStats(Schedule_Stats *stats);
+uint32_t ScheduleGetMinute(void);
+void ScheduleMinuteToDate(uint32_t minute, uint16_t *year, uint8_t *month, uint8_t *day, uint8_t *hour, uint8_t *min);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHEDULE_H_ */
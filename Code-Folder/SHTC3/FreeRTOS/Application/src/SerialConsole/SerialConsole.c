@@ -121,6 +121,7 @@ void SerialConsoleWriteString(const char *string)
         }
 
         if (usart_get_job_status(&usart_instance, USART_TRANSCEIVER_TX) == STATUS_OK) {
+            sleepmgr_lock_mode(SLEEPMGR_IDLE_2);  // The SERCOM runs on GCLK 0: no standby until the buffer is sent
             circular_buf_get(cbufTx, (uint8_t *)&latestTx);  // Perform only if the SERCOM TX is free (not busy)
             usart_write_buffer_job(&usart_instance, (uint8_t *)&latestTx, 1);
         }
@@ -273,6 +274,8 @@ void usart_write_callback(struct usart_module *const usart_module)
     if (circular_buf_get(cbufTx, (uint8_t *)&latestTx) != -1)  // Only continue if there are more characters to send
     {
         usart_write_buffer_job(&usart_instance, (uint8_t *)&latestTx, 1);
+    } else {
+        sleepmgr_unlock_mode(SLEEPMGR_IDLE_2);
     }
 }
 
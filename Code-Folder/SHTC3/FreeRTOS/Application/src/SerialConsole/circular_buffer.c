@@ -22,6 +22,7 @@
  #include <assert.h>
 
  #include "circular_buffer.h"
+ #include "MemPool/MemPool.h"
 
 
  // The definition of our circular buffer structure is hidden from the user
@@ -64,8 +65,10 @@
  {
 	// assert(buffer && size);
 
-	 cbuf_handle_t cbuf = malloc(sizeof(circular_buf_t));
-	 //assert(cbuf);
+	 cbuf_handle_t cbuf = MemPoolAlloc(sizeof(circular_buf_t));
+	 if (cbuf == NULL) {
+		 return NULL;
+	 }
 
 	 cbuf->buffer = buffer;
 	 cbuf->max = size;
@@ -79,7 +82,7 @@
  void circular_buf_free(cbuf_handle_t cbuf)
  {
 	// assert(cbuf);
-	 free(cbuf);
+	 MemPoolFree(cbuf);
  }
 
  void circular_buf_reset(cbuf_handle_t cbuf)
@@ -0,0 +1,293 @@
+/**************************************************************************/ /**
+ * @file      StackMon.c
+ * @brief     Stack monitor. Samples the stack high-water mark of every task and recommends a size for each stack
+ * @details   A job of the executor reads uxTaskGetStackHighWaterMark() of the tasks of the task table, the idle task
+ *            and the timer service every STACK_MON_SAMPLE_MS. The fewest free words seen per task are kept in a record
+ *            in the .noinit section, which the startup code does not clear: it survives a reset, so the history grows
+ *            over every boot until a power-on or StackMonClear(). The record is matched by task name and validated by a
+ *            checksum, so a power-on or a changed stack size starts afresh. A task falling below STACK_MON_WARN_WORDS
+ *            is logged once, which names the task before the overflow check fires. vApplicationStackOverflowHook()
+ *            stores the task name in the record. The next boot moves it out of the record, so each overflow is
+ *            reported by the boot that follows it only.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "StackMon/StackMon.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "Exec/Exec.h"
+#include "I2cDriver/I2cDriver.h"
+#include "SerialConsole.h"
+#include "TaskTable/TaskTable.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define STACK_MON_MAGIC 0x5354414BUL  ///< "STAK"
+#define STACK_MON_ROUND_WORDS 8       ///< Recommended sizes are rounded up to this
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// History of one task in the record
+typedef struct StackMon_Slot {
+    char name[configMAX_TASK_NAME_LEN];
+    uint16_t words;     ///< Stack size when the history was started
+    uint16_t freeEver;  ///< Fewest free words seen
+} StackMon_Slot;
+
+/// Record kept across resets in .noinit
+typedef struct StackMon_Record {
+    uint32_t magic;
+    uint16_t boots;
+    char overflow[configMAX_TASK_NAME_LEN];
+    StackMon_Slot slot[STACK_MON_MAX_TASKS];
+    uint32_t check;  ///< StackMonChecksum() of the fields above
+} StackMon_Record;
+
+/// Task sampled in this boot
+typedef struct StackMon_Live {
+    TaskHandle_t handle;
+    uint16_t words;
+    uint16_t freeNow;
+    bool warned;
+    StackMon_Slot *slot;
+} StackMon_Live;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static StackMon_Record stackMonRecord __attribute__((section(".noinit")));
+static StackMon_Live stackMonLive[STACK_MON_MAX_TASKS];
+static uint8_t stackMonCount;
+static char stackMonOverflow[configMAX_TASK_NAME_LEN];  ///< Task that overflowed just before this boot, "" if none
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static uint32_t StackMonChecksum(void);
+static StackMon_Slot *StackMonFindSlot(const char *name, uint16_t words);
+static uint16_t StackMonRecommend(uint16_t words, uint16_t freeEver);
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static TickType_t StackMonSampleJob(void *arg)
+ * @brief       Executor job, samples the high-water mark of every task and logs the ones close to overflow
+ * @note        Runs on the timer service stack, so the log line is built without printf
+ */
+static TickType_t StackMonSampleJob(void *arg)
+{
+    for (uint8_t i = 0; i < stackMonCount; i++) {
+        StackMon_Live *live = &stackMonLive[i];
+        uint16_t freeWords = (uint16_t)uxTaskGetStackHighWaterMark(live->handle);
+
+        taskENTER_CRITICAL();
+        if (freeWords < live->freeNow) {
+            live->freeNow = freeWords;
+        }
+        if (freeWords < live->slot->freeEver) {
+            live->slot->freeEver = freeWords;
+            stackMonRecord.check = StackMonChecksum();
+        }
+        taskEXIT_CRITICAL();
+
+        if (freeWords < STACK_MON_WARN_WORDS && !live->warned) {
+            char line[48] = "WARN: stack of ";
+            strncat(line, pcTaskGetName(live->handle), configMAX_TASK_NAME_LEN);
+            strcat(line, " close to overflow\r\n");
+            SerialConsoleWriteString(line);
+            live->warned = true;
+        }
+    }
+    return EXEC_DONE;
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static uint32_t StackMonChecksum(void)
+ * @brief       Checksum of the record, to tell a record left by the last boot from the random content after a power-on
+ */
+static uint32_t StackMonChecksum(void)
+{
+    const uint8_t *byte = (const uint8_t *)&stackMonRecord;
+    uint32_t sum = STACK_MON_MAGIC;
+
+    for (size_t i = 0; i < offsetof(StackMon_Record, check); i++) {
+        sum = (sum << 5) + (sum >> 27) + byte[i];
+    }
+    return sum;
+}
+
+/**
+ * @fn			static StackMon_Slot *StackMonFindSlot(const char *name, uint16_t words)
+ * @brief       Slot of the record holding the history of a task. Starts a new history if there is none, or if the
+ *              stack size changed since it was started
+ * @return      Returns the slot, NULL if the record is full
+ */
+static StackMon_Slot *StackMonFindSlot(const char *name, uint16_t words)
+{
+    StackMon_Slot *empty = NULL;
+
+    for (uint8_t i = 0; i < STACK_MON_MAX_TASKS; i++) {
+        StackMon_Slot *slot = &stackMonRecord.slot[i];
+        if (slot->name[0] == '\0') {
+            if (empty == NULL) {
+                empty = slot;
+            }
+            continue;
+        }
+        if (strncmp(slot->name, name, configMAX_TASK_NAME_LEN) == 0) {
+            if (slot->words != words) {
+                slot->words = words;
+                slot->freeEver = words;
+            }
+            return slot;
+        }
+    }
+
+    if (empty != NULL) {
+        strncpy(empty->name, name, configMAX_TASK_NAME_LEN - 1);
+        empty->words = words;
+        empty->freeEver = words;
+    }
+    return empty;
+}
+
+/**
+ * @fn			static uint16_t StackMonRecommend(uint16_t words, uint16_t freeEver)
+ * @brief       Stack size to give a task: the deepest use seen plus a margin, rounded up
+ */
+static uint16_t StackMonRecommend(uint16_t words, uint16_t freeEver)
+{
+    uint16_t used = words - freeEver;
+    uint16_t margin = (used * STACK_MON_MARGIN_PERCENT) / 100;
+
+    if (margin < STACK_MON_MARGIN_MIN_WORDS) {
+        margin = STACK_MON_MARGIN_MIN_WORDS;
+    }
+    return ((used + margin + STACK_MON_ROUND_WORDS - 1) / STACK_MON_ROUND_WORDS) * STACK_MON_ROUND_WORDS;
+}
+
+/**
+ * @fn			int32_t StackMonInit(void)
+ * @brief       Validates the record left by the last boot and starts sampling
+ * @return      Returns 0 on success, ERROR_NO_RESOURCE if the record has no room for every task (those are not
+ *              monitored), or the ExecAdd() error if the job could not be registered
+ * @note        Call after TaskTableStart(), from the timer service task: the idle and timer service tasks exist then,
+ *              and ExecAdd() must be called from it
+ */
+int32_t StackMonInit(void)
+{
+    TaskTable_Stack stacks[STACK_MON_MAX_TASKS];
+    uint8_t count = TaskTableGetStacks(stacks, STACK_MON_MAX_TASKS);
+    int32_t error = ERROR_NONE;
+
+    if (stackMonRecord.magic != STACK_MON_MAGIC || stackMonRecord.check != StackMonChecksum()) {
+        memset(&stackMonRecord, 0, sizeof(stackMonRecord));
+        stackMonRecord.magic = STACK_MON_MAGIC;
+    } else {
+        stackMonRecord.boots++;
+        memcpy(stackMonOverflow, stackMonRecord.overflow, configMAX_TASK_NAME_LEN);
+        memset(stackMonRecord.overflow, 0, configMAX_TASK_NAME_LEN);
+    }
+
+    stackMonCount = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        StackMon_Slot *slot = StackMonFindSlot(pcTaskGetName(stacks[i].handle), stacks[i].words);
+        if (slot == NULL) {
+            error = ERROR_NO_RESOURCE;
+            continue;
+        }
+        stackMonLive[stackMonCount].handle = stacks[i].handle;
+        stackMonLive[stackMonCount].words = stacks[i].words;
+        stackMonLive[stackMonCount].freeNow = stacks[i].words;
+        stackMonLive[stackMonCount].warned = false;
+        stackMonLive[stackMonCount].slot = slot;
+        stackMonCount++;
+    }
+    stackMonRecord.check = StackMonChecksum();
+
+    static const Exec_Job job = {"stack", STACK_MON_SAMPLE_MS, STACK_MON_SAMPLE_MS / 2, 0, EXEC_LANE_LOW,
+                                 StackMonSampleJob, NULL};
+    int32_t index = ExecAdd(&job);
+    return (index < 0) ? index : error;
+}
+
+/**
+ * @fn			uint8_t StackMonGetTasks(StackMon_Task *tasks, uint8_t maxTasks)
+ * @brief       Stack use and recommended stack size of every monitored task
+ * @param[out]  tasks Tasks, in task table order, then the idle task and the timer service
+ * @param[in]   maxTasks Size of tasks
+ * @return      Returns the number of tasks written
+ */
+uint8_t StackMonGetTasks(StackMon_Task *tasks, uint8_t maxTasks)
+{
+    uint8_t count = 0;
+
+    taskENTER_CRITICAL();
+    for (; count < stackMonCount && count < maxTasks; count++) {
+        StackMon_Live *live = &stackMonLive[count];
+        strncpy(tasks[count].name, live->slot->name, configMAX_TASK_NAME_LEN);
+        tasks[count].words = live->words;
+        tasks[count].freeNow = live->freeNow;
+        tasks[count].freeEver = live->slot->freeEver;
+        tasks[count].recommended = StackMonRecommend(live->words, live->slot->freeEver);
+    }
+    taskEXIT_CRITICAL();
+    return count;
+}
+
+/**
+ * @fn			void StackMonGetInfo(StackMon_Info *info)
+ * @brief       Boots the history covers and the task that overflowed just before this boot
+ */
+void StackMonGetInfo(StackMon_Info *info)
+{
+    taskENTER_CRITICAL();
+    info->boots = stackMonRecord.boots;
+    memcpy(info->overflow, stackMonOverflow, configMAX_TASK_NAME_LEN);
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			void StackMonClear(void)
+ * @brief       Starts the history afresh, for instance after resizing stacks from the recommendations
+ */
+void StackMonClear(void)
+{
+    taskENTER_CRITICAL();
+    stackMonRecord.boots = 0;
+    memset(stackMonRecord.overflow, 0, configMAX_TASK_NAME_LEN);
+    memset(stackMonOverflow, 0, configMAX_TASK_NAME_LEN);
+    for (uint8_t i = 0; i < stackMonCount; i++) {
+        stackMonLive[i].freeNow = stackMonLive[i].words;
+        stackMonLive[i].warned = false;
+        stackMonLive[i].slot->freeEver = stackMonLive[i].words;
+    }
+    stackMonRecord.check = StackMonChecksum();
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @fn			void StackMonOverflow(const char *name)
+ * @brief       Records the task the stack overflow hook fired for, to be reported after the reset
+ * @note        Called by vApplicationStackOverflowHook(), from the context switch
+ */
+void StackMonOverflow(const char *name)
+{
+    strncpy(stackMonRecord.overflow, name, configMAX_TASK_NAME_LEN - 1);
+    stackMonRecord.overflow[configMAX_TASK_NAME_LEN - 1] = '\0';
+    stackMonRecord.check = StackMonChecksum();
+}
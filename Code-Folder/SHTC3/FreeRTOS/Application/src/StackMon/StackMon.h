@@ -0,0 +1,64 @@
+/**************************************************************************/ /**
+ * @file      StackMon.h
+ * @brief     Stack monitor. Samples the stack high-water mark of every task and recommends a size for each stack
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef STACK_MON_H_
+#define STACK_MON_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define STACK_MON_MAX_TASKS 8           ///< Tasks monitored: the task table, the idle task and the timer service
+#define STACK_MON_SAMPLE_MS 1000        ///< High-water mark sampling period
+#define STACK_MON_REPORT_MS 600000      ///< Period the report is published over MQTT
+#define STACK_MON_WARN_WORDS 24         ///< A task with fewer free words than this is logged as close to overflow
+#define STACK_MON_MARGIN_PERCENT 25     ///< Recommended size: deepest use seen plus this share of it...
+#define STACK_MON_MARGIN_MIN_WORDS 32   ///< ...and never less than this, for the interrupt frames stacked on top
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Stack use of one task
+typedef struct StackMon_Task {
+    char name[configMAX_TASK_NAME_LEN];
+    uint16_t words;        ///< Stack size
+    uint16_t freeNow;      ///< Fewest free words since this boot
+    uint16_t freeEver;     ///< Fewest free words since the record was cleared, resets included
+    uint16_t recommended;  ///< Recommended stack size, from freeEver
+} StackMon_Task;
+
+/// Record kept across resets
+typedef struct StackMon_Info {
+    uint16_t boots;                              ///< Boots the record survived, 0 after a power-on
+    char overflow[configMAX_TASK_NAME_LEN];      ///< Task the overflow hook fired for, just before this boot. "" if none
+} StackMon_Info;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t StackMonInit(void);
+uint8_t StackMonGetTasks(StackMon_Task *tasks, uint8_t maxTasks);
+void StackMonGetInfo(StackMon_Info *info);
+void StackMonClear(void);
+void StackMonOverflow(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACK_MON_H_ */
@@ -0,0 +1,241 @@
+/**************************************************************************/ /**
+ * @file      TaskTable.c
+ * @brief     Tasks and queues of the application, declared in one table and allocated statically
+ * @details   TASK_TABLE and QUEUE_TABLE are expanded here into the stacks, TCBs, queue structures and queue storage of
+ *            every entry, and into the constant tables TaskTableStart() creates them from. The idle task and the timer
+ *            service get their memory from here too, through the vApplicationGet...TaskMemory() hooks. The total is
+ *            computed by the preprocessor and checked against TASK_TABLE_RAM_BUDGET, so an entry that grows too big
+ *            fails the build instead of the heap at boot. The heap is left to the drivers' buffers.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "TaskTable/TaskTable.h"
+
+#include <queue.h>
+
+#include "Alarm/AlarmTask.h"
+#include "CliThread/CliThread.h"
+#include "Display/DisplayTask.h"
+#include "I2cDriver/I2cDriver.h"
+#include "IMU/ImuTask.h"
+#include "WifiHandlerThread/WifiHandler.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define TASK_TABLE_TASK_BYTES(id, function, name, words, priority) +((words) * sizeof(StackType_t) + sizeof(StaticTask_t))
+#define TASK_TABLE_QUEUE_BYTES(id, handle, length, type) +((length) * sizeof(type) + sizeof(StaticQueue_t))
+#define TASK_TABLE_KERNEL_BYTES \
+    ((configMINIMAL_STACK_SIZE + configTIMER_TASK_STACK_DEPTH) * sizeof(StackType_t) + 2 * sizeof(StaticTask_t))
+
+/// Static RAM of the table, bytes
+#define TASK_TABLE_RAM_BYTES \
+    (TASK_TABLE_KERNEL_BYTES TASK_TABLE(TASK_TABLE_TASK_BYTES) QUEUE_TABLE(TASK_TABLE_QUEUE_BYTES))
+
+#define TASK_TABLE_KERNEL_ROWS 2  ///< Idle task and timer service, reported after the table entries
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Constant part of a task entry
+typedef struct TaskTable_Task {
+    TaskFunction_t function;
+    const char *name;
+    StackType_t *stack;
+    uint16_t words;
+    UBaseType_t priority;
+} TaskTable_Task;
+
+/// Constant part of a queue entry
+typedef struct TaskTable_Queue {
+    QueueHandle_t *handle;
+    const char *name;
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+} TaskTable_Queue;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+_Static_assert(TASK_TABLE_RAM_BYTES <= TASK_TABLE_RAM_BUDGET, "Tasks and queues do not fit TASK_TABLE_RAM_BUDGET");
+_Static_assert(TASK_PRIORITY_ALARM > configTIMER_TASK_PRIORITY && configTIMER_TASK_PRIORITY > TASK_PRIORITY_SENSING &&
+                   TASK_PRIORITY_SENSING > TASK_PRIORITY_NETWORK && TASK_PRIORITY_NETWORK > TASK_PRIORITY_UI &&
+                   TASK_PRIORITY_UI > tskIDLE_PRIORITY,
+               "Task priorities do not follow the priority map of TaskTable.h");
+
+#define TASK_TABLE_STACK(id, function, name, words, priority) static StackType_t taskStack_##id[words];
+TASK_TABLE(TASK_TABLE_STACK)
+#undef TASK_TABLE_STACK
+
+#define QUEUE_TABLE_STORAGE(id, handle, length, type) static uint8_t queueStorage_##id[(length) * sizeof(type)];
+QUEUE_TABLE(QUEUE_TABLE_STORAGE)
+#undef QUEUE_TABLE_STORAGE
+
+#define QUEUE_TABLE_HANDLE(id, handle, length, type) extern QueueHandle_t handle;
+QUEUE_TABLE(QUEUE_TABLE_HANDLE)
+#undef QUEUE_TABLE_HANDLE
+
+#define TASK_TABLE_ENTRY(id, function, name, words, priority) {function, name, taskStack_##id, words, priority},
+static const TaskTable_Task taskTable[TASK_ID_MAX] = {TASK_TABLE(TASK_TABLE_ENTRY)};
+#undef TASK_TABLE_ENTRY
+
+#define QUEUE_TABLE_ENTRY(id, handle, length, type) {&handle, #id, queueStorage_##id, length, sizeof(type)},
+static const TaskTable_Queue queueTable[QUEUE_ID_MAX] = {QUEUE_TABLE(QUEUE_TABLE_ENTRY)};
+#undef QUEUE_TABLE_ENTRY
+
+static StaticTask_t taskTcb[TASK_ID_MAX];
+static TaskHandle_t taskHandles[TASK_ID_MAX];
+static StaticQueue_t queueControl[QUEUE_ID_MAX];
+
+static StaticTask_t idleTcb;
+static StackType_t idleStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t timerTcb;
+static StackType_t timerStack[configTIMER_TASK_STACK_DEPTH];
+
+/******************************************************************************
+ * Callback Functions
+ ******************************************************************************/
+
+/**
+ * @fn			void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *words)
+ * @brief       Memory of the idle task, asked for by vTaskStartScheduler()
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *words)
+{
+    *tcb = &idleTcb;
+    *stack = idleStack;
+    *words = configMINIMAL_STACK_SIZE;
+}
+
+/**
+ * @fn			void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *words)
+ * @brief       Memory of the timer service task, asked for by vTaskStartScheduler()
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *words)
+{
+    *tcb = &timerTcb;
+    *stack = timerStack;
+    *words = configTIMER_TASK_STACK_DEPTH;
+}
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			int32_t TaskTableStart(void)
+ * @brief       Creates the queues, then the tasks of the table, in table order
+ * @details     All queues exist before the first task runs, so no task has to wait for another to create them
+ * @return      Returns 0 on success, ERROR_INVALID_ARG if an entry could not be created. The others still are
+ */
+int32_t TaskTableStart(void)
+{
+    int32_t error = ERROR_NONE;
+
+    for (uint8_t i = 0; i < QUEUE_ID_MAX; i++) {
+        const TaskTable_Queue *queue = &queueTable[i];
+        *queue->handle = xQueueCreateStatic(queue->length, queue->itemSize, queue->storage, &queueControl[i]);
+        if (*queue->handle == NULL) {
+            error = ERROR_INVALID_ARG;
+        }
+    }
+
+    for (uint8_t i = 0; i < TASK_ID_MAX; i++) {
+        const TaskTable_Task *task = &taskTable[i];
+        taskHandles[i] =
+            xTaskCreateStatic(task->function, task->name, task->words, NULL, task->priority, task->stack, &taskTcb[i]);
+        if (taskHandles[i] == NULL) {
+            error = ERROR_INVALID_ARG;
+        }
+    }
+
+    return error;
+}
+
+/**
+ * @fn			TaskHandle_t TaskTableGetHandle(eTaskTableTask task)
+ * @brief       Handle of a task of the table
+ * @return      Returns the handle, NULL before TaskTableStart()
+ */
+TaskHandle_t TaskTableGetHandle(eTaskTableTask task)
+{
+    return (task < TASK_ID_MAX) ? taskHandles[task] : NULL;
+}
+
+/**
+ * @fn			uint8_t TaskTableGetRam(TaskTable_Ram *ram, uint8_t maxEntries)
+ * @brief       RAM report: memory of every task and queue of the table, then of the idle task and the timer service
+ * @param[out]  ram Rows of the report
+ * @param[in]   maxEntries Size of ram
+ * @return      Returns the number of rows written
+ */
+uint8_t TaskTableGetRam(TaskTable_Ram *ram, uint8_t maxEntries)
+{
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < TASK_ID_MAX && count < maxEntries; i++, count++) {
+        ram[count].name = taskTable[i].name;
+        ram[count].stackBytes = taskTable[i].words * sizeof(StackType_t);
+        ram[count].controlBytes = sizeof(StaticTask_t);
+    }
+    for (uint8_t i = 0; i < QUEUE_ID_MAX && count < maxEntries; i++, count++) {
+        ram[count].name = queueTable[i].name;
+        ram[count].stackBytes = queueTable[i].length * queueTable[i].itemSize;
+        ram[count].controlBytes = sizeof(StaticQueue_t);
+    }
+    if (count + TASK_TABLE_KERNEL_ROWS <= maxEntries) {
+        ram[count].name = "IDLE";
+        ram[count].stackBytes = sizeof(idleStack);
+        ram[count].controlBytes = sizeof(idleTcb);
+        count++;
+        ram[count].name = "Tmr Svc";
+        ram[count].stackBytes = sizeof(timerStack);
+        ram[count].controlBytes = sizeof(timerTcb);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @fn			uint32_t TaskTableGetRamTotal(void)
+ * @brief       Static RAM of the table, the idle task and the timer service, bytes. Same as the sum of TaskTableGetRam()
+ */
+uint32_t TaskTableGetRamTotal(void)
+{
+    return TASK_TABLE_RAM_BYTES;
+}
+
+/**
+ * @fn			uint8_t TaskTableGetStacks(TaskTable_Stack *stacks, uint8_t maxEntries)
+ * @brief       Handle and stack size of every task of the table, then of the idle task and the timer service
+ * @param[out]  stacks Tasks
+ * @param[in]   maxEntries Size of stacks
+ * @return      Returns the number of tasks written. Call after vTaskStartScheduler(), which creates the kernel tasks
+ * @note        A statically allocated task's handle is its StaticTask_t, so the kernel tasks need no handle query
+ */
+uint8_t TaskTableGetStacks(TaskTable_Stack *stacks, uint8_t maxEntries)
+{
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < TASK_ID_MAX && count < maxEntries; i++) {
+        if (taskHandles[i] != NULL) {
+            stacks[count].handle = taskHandles[i];
+            stacks[count].words = taskTable[i].words;
+            count++;
+        }
+    }
+    if (count + TASK_TABLE_KERNEL_ROWS <= maxEntries) {
+        stacks[count].handle = (TaskHandle_t)&idleTcb;
+        stacks[count].words = configMINIMAL_STACK_SIZE;
+        count++;
+        stacks[count].handle = (TaskHandle_t)&timerTcb;
+        stacks[count].words = configTIMER_TASK_STACK_DEPTH;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,109 @@
+/**************************************************************************/ /**
+ * @file      TaskTable.h
+ * @brief     Tasks and queues of the application, declared in one table and allocated statically
+ * @details   Each TASK_TABLE entry is one task: ID, entry function, name, stack (words) and priority. Each QUEUE_TABLE
+ *            entry is one queue: ID, the global handle it is created in, length and item type. Stacks, TCBs, queue
+ *            structures and queue storage are arrays sized from the table at compile time, so none of them come from
+ *            the heap and the RAM they take is known before the code is flashed, see TASK_TABLE_RAM_BUDGET.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef TASK_TABLE_H_
+#define TASK_TABLE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <stdint.h>
+#include <task.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define TASK_TABLE_USE_CLI 1  ///< 0 to leave out the CLI task and the 1.7 KB of its stack and TCB
+
+/// Priority map, highest first. Every task takes its priority from here, so the order is reviewed in one place and a
+/// slow task of one level can only delay the levels below it:
+/// - Alarm: lid events, rule actions, the buzzer. Woken by notifications only, it runs for microseconds, so a fire or
+///   a lid is acted upon whatever the sensing is doing
+/// - Timer service, configTIMER_TASK_PRIORITY: sensing jobs of the executor, lid debounce and deferred interrupts.
+///   The jobs queue their I2C transfers and wait as executor waits, never blocking: a stalled bus delays the next
+///   samples, but not the debounce timers nor, through them, the lid events of the alarm
+/// - Sensing: IMU FIFO drain. The FIFO holds seconds of data
+/// - Network: Wi-Fi and MQTT. Publishing can wait behind sensing
+/// - UI: OLED dashboard and CLI. The dashboard postpones its frames while the I2C bus is busy
+/// Checked at compile time in TaskTable.c
+#define TASK_PRIORITY_ALARM (configMAX_PRIORITIES - 1)
+#define TASK_PRIORITY_SENSING (configMAX_PRIORITIES - 3)
+#define TASK_PRIORITY_NETWORK (configMAX_PRIORITIES - 4)
+#define TASK_PRIORITY_UI (configMAX_PRIORITIES - 5)
+
+#if (TASK_TABLE_USE_CLI == 1)
+#define TASK_TABLE_CLI(X) X(CLI, vCommandConsoleTask, "CLI_TASK", CLI_TASK_SIZE, TASK_PRIORITY_UI)
+#else
+#define TASK_TABLE_CLI(X)
+#endif
+
+/// Tasks, created in this order by TaskTableStart(): ID, function, name, stack words, priority
+#define TASK_TABLE(X)                                                      \
+    TASK_TABLE_CLI(X)                                                      \
+    X(WIFI, vWifiTask, "WIFI_TASK", WIFI_TASK_SIZE, TASK_PRIORITY_NETWORK) \
+    X(IMU, vImuTask, "IMU_TASK", IMU_TASK_SIZE, TASK_PRIORITY_SENSING)     \
+    X(ALARM, vAlarmTask, "ALARM_TASK", ALARM_TASK_SIZE, TASK_PRIORITY_ALARM) \
+    X(DISPLAY, vDisplayTask, "DISPLAY_TASK", DISPLAY_TASK_SIZE, TASK_PRIORITY_UI)
+
+/// Queues, created before any task: ID, handle, length, item type
+#define QUEUE_TABLE(X)                             \
+    X(WIFI_STATE, xQueueWifiState, 5, uint8_t)     \
+    X(IMU_BATCH, xQueueImuBuffer, 2, Imu_Batch)
+
+/// Static RAM the table, the idle task and the timer service may take, bytes. Checked at compile time. About 12.1 KB
+/// are used, CLI task included
+#define TASK_TABLE_RAM_BUDGET 13312
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+#define TASK_TABLE_ENUM(id, ...) TASK_ID_##id,
+/// Tasks of TASK_TABLE
+typedef enum eTaskTableTask { TASK_TABLE(TASK_TABLE_ENUM) TASK_ID_MAX } eTaskTableTask;
+#undef TASK_TABLE_ENUM
+
+#define QUEUE_TABLE_ENUM(id, ...) QUEUE_ID_##id,
+/// Queues of QUEUE_TABLE
+typedef enum eTaskTableQueue { QUEUE_TABLE(QUEUE_TABLE_ENUM) QUEUE_ID_MAX } eTaskTableQueue;
+#undef QUEUE_TABLE_ENUM
+
+/// RAM taken by one table entry, or by the kernel tasks
+typedef struct TaskTable_Ram {
+    const char *name;
+    uint16_t stackBytes;    ///< Task stack, or queue storage area
+    uint16_t controlBytes;  ///< StaticTask_t or StaticQueue_t
+} TaskTable_Ram;
+
+/// Stack of a task, for the stack monitor
+typedef struct TaskTable_Stack {
+    TaskHandle_t handle;
+    uint16_t words;  ///< Stack size
+} TaskTable_Stack;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t TaskTableStart(void);
+TaskHandle_t TaskTableGetHandle(eTaskTableTask task);
+uint8_t TaskTableGetRam(TaskTable_Ram *ram, uint8_t maxEntries);
+uint32_t TaskTableGetRamTotal(void);
+uint8_t TaskTableGetStacks(TaskTable_Stack *stacks, uint8_t maxEntries);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_TABLE_H_ */
@@ -0,0 +1,283 @@
+/**************************************************************************/ /**
+ * @file      Widget.c
+ * @brief     Retained widgets of the OLED: text, number with unit, icon and bar. Only the changed ones are redrawn
+ * @details   Each widget keeps the value it shows. Setting a value that differs from it marks the widget dirty, and
+ *            WidgetRender() draws the dirty widgets only, into the SSD1306 framebuffer. Text fields are drawn over
+ *            their full width, padded with spaces, so a shorter value erases the longer one. The framebuffer only
+ *            marks the bytes that really change, so SSD1306_UpdateScreen() then sends the changed glyphs only. The
+ *            widgets are not locked: they are set and rendered by the display task alone.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Widget/Widget.h"
+
+#include <string.h>
+
+#include "I2cDriver/I2cDriver.h"
+#include "OLED/SSD1306.h"
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Retained state of one widget
+typedef struct Widget_State {
+    const Widget_Def *def;
+    int32_t value;                ///< Number, icon and bar
+    char text[WIDGET_TEXT_LEN];   ///< Text
+    bool valid;                   ///< False until a value is set, or after WidgetSetInvalid()
+    bool dirty;                   ///< Value changed since the last render
+} Widget_State;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static Widget_State widgetState[WIDGET_MAX];
+static uint8_t widgetCount;
+
+/******************************************************************************
+ * Forward Declarations
+ ******************************************************************************/
+static void WidgetFormatNumber(const Widget_State *state, char *text);
+static void WidgetDrawField(const Widget_Def *def, const char *text, bool alignRight);
+static void WidgetDrawBar(const Widget_State *state);
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static void WidgetFormatNumber(const Widget_State *state, char *text)
+ * @brief       Writes the value of a number widget as text, with its decimal point and unit, without printf
+ * @param[out]  text At least WIDGET_TEXT_LEN characters. Set to "#" if the value and unit do not fit
+ */
+static void WidgetFormatNumber(const Widget_State *state, char *text)
+{
+    const Widget_Def *def = state->def;
+    char digits[11];
+    uint8_t count = 0;
+    uint8_t length = 0;
+
+    if (!state->valid) {
+        text[length++] = '-';
+        text[length++] = '-';
+    } else {
+        uint32_t magnitude = (state->value < 0) ? -(uint32_t)state->value : (uint32_t)state->value;
+        do {
+            digits[count++] = '0' + magnitude % 10;
+            magnitude /= 10;
+        } while ((magnitude > 0 || count <= def->decimals) && count < sizeof(digits));
+
+        if (count + 2 >= WIDGET_TEXT_LEN) {
+            strcpy(text, "#");
+            return;
+        }
+        if (state->value < 0) {
+            text[length++] = '-';
+        }
+        while (count > 0) {
+            if (count == def->decimals) {
+                text[length++] = '.';
+            }
+            text[length++] = digits[--count];
+        }
+    }
+
+    size_t unitLength = (def->unit != NULL) ? strlen(def->unit) : 0;
+    if (length + unitLength >= WIDGET_TEXT_LEN) {
+        strcpy(text, "#");
+        return;
+    }
+    memcpy(&text[length], def->unit, unitLength);
+    text[length + unitLength] = '\0';
+}
+
+/**
+ * @fn			static void WidgetDrawField(const Widget_Def *def, const char *text, bool alignRight)
+ * @brief       Draws a text over the full width of its field, padded with spaces. Longer texts are cut
+ */
+static void WidgetDrawField(const Widget_Def *def, const char *text, bool alignRight)
+{
+    char field[WIDGET_TEXT_LEN];
+    uint8_t width = (def->width < WIDGET_TEXT_LEN) ? def->width : WIDGET_TEXT_LEN - 1;
+    size_t length = strlen(text);
+
+    if (length > width) {
+        length = width;
+    }
+    memset(field, ' ', width);
+    memcpy(&field[alignRight ? width - length : 0], text, length);
+    field[width] = '\0';
+
+    SSD1306_GotoXY(def->x, def->y);
+    SSD1306_Puts(field, def->font, SSD1306_COLOR_WHITE);
+}
+
+/**
+ * @fn			static void WidgetDrawBar(const Widget_State *state)
+ * @brief       Draws the outline of a bar, filled from the left in proportion to the value
+ */
+static void WidgetDrawBar(const Widget_State *state)
+{
+    const Widget_Def *def = state->def;
+    int32_t inner = def->width - 2;
+    int32_t fill = 0;
+
+    if (state->valid && def->max > def->min) {
+        int32_t value = state->value;
+        if (value < def->min) {
+            value = def->min;
+        } else if (value > def->max) {
+            value = def->max;
+        }
+        fill = ((value - def->min) * inner) / (def->max - def->min);
+    }
+
+    // The rectangle functions include their last row and column
+    SSD1306_DrawRectangle(def->x, def->y, def->width - 1, def->height - 1, SSD1306_COLOR_WHITE);
+    if (fill > 0) {
+        SSD1306_DrawFilledRectangle(def->x + 1, def->y + 1, fill - 1, def->height - 3, SSD1306_COLOR_WHITE);
+    }
+    if (fill < inner) {
+        SSD1306_DrawFilledRectangle(def->x + 1 + fill, def->y + 1, inner - fill - 1, def->height - 3, SSD1306_COLOR_BLACK);
+    }
+}
+
+/**
+ * @fn			int32_t WidgetAdd(const Widget_Def *def)
+ * @brief       Adds a widget. It is drawn by the next render, invalid until its value is set
+ * @param[in]   def Widget description. Must stay valid: it is not copied
+ * @return      Returns the index of the widget, ERROR_NO_RESOURCE if WIDGET_MAX are added, ERROR_INVALID_ARG if the
+ *              description is incomplete
+ */
+int32_t WidgetAdd(const Widget_Def *def)
+{
+    if (def->type >= WIDGET_TYPE_MAX || ((def->type == WIDGET_TEXT || def->type == WIDGET_NUMBER) && def->font == NULL) ||
+        (def->type == WIDGET_ICON && def->bitmap == NULL) || (def->type == WIDGET_BAR && (def->width < 3 || def->height < 3))) {
+        return ERROR_INVALID_ARG;
+    }
+    if (widgetCount >= WIDGET_MAX) {
+        return ERROR_NO_RESOURCE;
+    }
+
+    Widget_State *state = &widgetState[widgetCount];
+    state->def = def;
+    state->value = 0;
+    state->text[0] = '\0';
+    state->valid = false;
+    state->dirty = true;
+    return widgetCount++;
+}
+
+/**
+ * @fn			void WidgetSetValue(uint8_t index, int32_t value)
+ * @brief       Sets the value of a number, icon or bar widget. Marks it dirty if the value changed
+ */
+void WidgetSetValue(uint8_t index, int32_t value)
+{
+    if (index >= widgetCount) {
+        return;
+    }
+    Widget_State *state = &widgetState[index];
+    if (!state->valid || state->value != value) {
+        state->value = value;
+        state->valid = true;
+        state->dirty = true;
+    }
+}
+
+/**
+ * @fn			void WidgetSetText(uint8_t index, const char *text)
+ * @brief       Sets the text of a text widget, cut to WIDGET_TEXT_LEN - 1 characters. Marks it dirty if it changed
+ */
+void WidgetSetText(uint8_t index, const char *text)
+{
+    if (index >= widgetCount) {
+        return;
+    }
+    Widget_State *state = &widgetState[index];
+    if (!state->valid || strncmp(state->text, text, WIDGET_TEXT_LEN - 1) != 0) {
+        strncpy(state->text, text, WIDGET_TEXT_LEN - 1);
+        state->text[WIDGET_TEXT_LEN - 1] = '\0';
+        state->valid = true;
+        state->dirty = true;
+    }
+}
+
+/**
+ * @fn			void WidgetSetInvalid(uint8_t index)
+ * @brief       Shows that a widget has no value, for instance after a sensor error
+ */
+void WidgetSetInvalid(uint8_t index)
+{
+    if (index >= widgetCount) {
+        return;
+    }
+    Widget_State *state = &widgetState[index];
+    if (state->valid) {
+        state->text[0] = '\0';
+        state->valid = false;
+        state->dirty = true;
+    }
+}
+
+/**
+ * @fn			bool WidgetIsDirty(void)
+ * @brief       Tells if a widget changed since the last render
+ */
+bool WidgetIsDirty(void)
+{
+    for (uint8_t i = 0; i < widgetCount; i++) {
+        if (widgetState[i].dirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @fn			uint8_t WidgetRender(void)
+ * @brief       Draws the dirty widgets into the framebuffer. SSD1306_UpdateScreen() sends them
+ * @return      Returns the number of widgets drawn
+ */
+uint8_t WidgetRender(void)
+{
+    char text[WIDGET_TEXT_LEN];
+    uint8_t drawn = 0;
+
+    for (uint8_t i = 0; i < widgetCount; i++) {
+        Widget_State *state = &widgetState[i];
+        const Widget_Def *def = state->def;
+        if (!state->dirty) {
+            continue;
+        }
+
+        switch (def->type) {
+            case WIDGET_TEXT:
+                WidgetDrawField(def, state->text, false);
+                break;
+            case WIDGET_NUMBER:
+                WidgetFormatNumber(state, text);
+                WidgetDrawField(def, text, true);
+                break;
+            case WIDGET_ICON:
+                if (state->valid && state->value != 0) {
+                    SSD1306_DrawBitmap(def->x, def->y, def->width, def->height, def->bitmap, SSD1306_COLOR_WHITE);
+                } else {
+                    SSD1306_DrawFilledRectangle(def->x, def->y, def->width - 1, def->height - 1, SSD1306_COLOR_BLACK);
+                }
+                break;
+            case WIDGET_BAR:
+                WidgetDrawBar(state);
+                break;
+            default:
+                break;
+        }
+        state->dirty = false;
+        drawn++;
+    }
+    return drawn;
+}
@@ -0,0 +1,70 @@
+/**************************************************************************/ /**
+ * @file      Widget.h
+ * @brief     Retained widgets of the OLED: text, number with unit, icon and bar. Only the changed ones are redrawn
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef WIDGET_H_
+#define WIDGET_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "OLED/fonts.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define WIDGET_MAX 8        ///< Widgets that can be added
+#define WIDGET_TEXT_LEN 12  ///< Longest text of a field, terminator included
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Widget types
+typedef enum eWidgetType {
+    WIDGET_TEXT = 0,  ///< Text, left aligned in its field
+    WIDGET_NUMBER,    ///< Fixed-point number followed by its unit, right aligned in its field. "--" while invalid
+    WIDGET_ICON,      ///< Bitmap, shown while the value is not 0
+    WIDGET_BAR,       ///< Horizontal bar, filled in proportion to the value between min and max. Empty while invalid
+    WIDGET_TYPE_MAX,
+} eWidgetType;
+
+/// Constant description of a widget
+typedef struct Widget_Def {
+    uint8_t type;           ///< eWidgetType
+    uint8_t x;              ///< Left column, pixels
+    uint8_t y;              ///< Top row, pixels
+    uint8_t width;          ///< Text and number: characters of the field. Icon and bar: pixels
+    uint8_t height;         ///< Icon and bar: pixels, at least 3 for a bar. Unused by text and number
+    uint8_t decimals;       ///< Number: digits after the point, the value is in units of 10^-decimals
+    FontDef_t *font;        ///< Text and number
+    const char *unit;       ///< Number: appended to the value. May be NULL
+    const uint8_t *bitmap;  ///< Icon: page-major like the fonts, width bytes per 8-row page
+    int32_t min;            ///< Bar: value of the empty bar
+    int32_t max;            ///< Bar: value of the full bar
+} Widget_Def;
+
+/******************************************************************************
+ * Global Function Declaration
+ ******************************************************************************/
+int32_t WidgetAdd(const Widget_Def *def);
+void WidgetSetValue(uint8_t index, int32_t value);
+void WidgetSetText(uint8_t index, const char *text);
+void WidgetSetInvalid(uint8_t index);
+bool WidgetIsDirty(void);
+uint8_t WidgetRender(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WIDGET_H_ */
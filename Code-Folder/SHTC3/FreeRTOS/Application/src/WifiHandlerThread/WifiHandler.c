@@ -14,6 +14,12 @@
 
 #include <errno.h>
 
+#include "Buzzer/Buzzer.h"
+#include "Rules/Rules.h"
+#include "Schedule/Schedule.h"
+#include "SampleBus/SampleBus.h"
+#include "StackMon/StackMon.h"
+
 /******************************************************************************
  * Defines
  ******************************************************************************/
@@ -22,18 +28,23 @@
  * Variables
  ******************************************************************************/
 volatile char mqtt_msg[64] = "{\"d\":{\"temp\":17}}\"";
-volatile char mqtt_msg_temp[64] = "{\"d\":{\"temp\":17}}\"";
 
 volatile uint32_t temperature = 1;
 int8_t wifiStateMachine = WIFI_MQTT_INIT;   ///< Global variable that determines the state of the WIFI handler.
-QueueHandle_t xQueueWifiState = NULL;       ///< Queue to determine the Wifi state from other threads.
-QueueHandle_t xQueueGameBuffer = NULL;      ///< Queue to send the next play to the cloud
-QueueHandle_t xQueueImuBuffer = NULL;       ///< Queue to send IMU data to the cloud
-QueueHandle_t xQueueDistanceBuffer = NULL;  ///< Queue to send the distance to the cloud
+QueueHandle_t xQueueWifiState = NULL;       ///< Queue to determine the Wifi state from other threads. Created by TaskTableStart()
+QueueHandle_t xQueueImuBuffer = NULL;       ///< Queue to send IMU data to the cloud. Created by TaskTableStart()
+
+static Sample_Subscriber *mqttSampleSubscriber = NULL;  ///< SHTC3 and IMU event records to publish, read from the sample bus
 
-//add your own Qhandler_t/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-QueueHandle_t xQueueTempBuffer = NULL;
-QueueHandle_t xQueueMoistBuffer  = NULL;
+static QueueSetHandle_t wifiEventSet = NULL;      ///< Everything the task waits on: state and IMU queues, the two semaphores below
+static SemaphoreHandle_t wifiWincEvent = NULL;    ///< Given by the WINC1500 interrupt
+static StaticSemaphore_t wifiWincEventBuffer;
+static SemaphoreHandle_t wifiSampleEvent = NULL;  ///< Given by the sample bus on every record of mqttSampleSubscriber
+static StaticSemaphore_t wifiSampleEventBuffer;
+static Imu_Batch wifiImuBatch;                    ///< Batch taken from xQueueImuBuffer, published by MQTT_HandleImuMessages()
+static bool wifiImuPending = false;               ///< True while wifiImuBatch is not published
+static TickType_t wifiLastPoll = 0;               ///< Tick of the last MQTT read, see WIFI_POLL_MS
+static Wifi_Loop_Stats wifiLoopStats;
 
 /*HTTP DOWNLOAD RELATED DEFINES AND VARIABLES*/
 
@@ -83,8 +94,16 @@ static void HTTP_DownloadFileInit(void);
 static void HTTP_DownloadFileTransaction(void);
 
 // add your own mqtt publish messages
-static void MQTT_HandleHumMessages(void);
-static void MQTT_HandleTemMessages(void);
+static void MQTT_HandleSensorMessages(void);
+static void MQTT_HandleButton(void);
+static void MQTT_PublishImuEvent(const Sample_Record *record);
+static void MQTT_HandleStackReport(void);
+
+static bool WifiEventsInit(void);
+static uint8_t WifiWaitEvent(TickType_t timeout);
+static TickType_t WifiPollDelay(void);
+static void WifiCountPublish(TickType_t timestamp);
+static void WifiWincEventCallback(void);
 /******************************************************************************
  * Callback Functions
  ******************************************************************************/
@@ -458,6 +477,7 @@ static void wifi_cb(uint8_t u8MsgType, void *pvMsg)
             uint8_t *pu8IPAddress = (uint8_t *)pvMsg;
             LogMessage(LOG_DEBUG_LVL, "wifi_cb: IP address is %u.%u.%u.%u\r\n", pu8IPAddress[0], pu8IPAddress[1], pu8IPAddress[2], pu8IPAddress[3]);
             add_state(WIFI_CONNECTED);
+            m2m_wifi_get_sytem_time();  // Sets the RTC of the medication schedule, see M2M_WIFI_RESP_GET_SYS_TIME
 
             if (do_download_flag == 1) {
                 start_download();
@@ -470,6 +490,14 @@ static void wifi_cb(uint8_t u8MsgType, void *pvMsg)
             }
         } break;
 
+        case M2M_WIFI_RESP_GET_SYS_TIME: {
+            tstrSystemTime *pstrTime = (tstrSystemTime *)pvMsg;
+            LogMessage(LOG_DEBUG_LVL, "wifi_cb: UTC %04u-%02u-%02u %02u:%02u:%02u\r\n", pstrTime->u16Year, pstrTime->u8Month,
+                       pstrTime->u8Day, pstrTime->u8Hour, pstrTime->u8Minute, pstrTime->u8Second);
+            ScheduleSetTime(pstrTime->u16Year, pstrTime->u8Month, pstrTime->u8Day, pstrTime->u8Hour, pstrTime->u8Minute,
+                            pstrTime->u8Second);
+        } break;
+
         default:
             break;
     }
@@ -560,10 +588,27 @@ void SubscribeHandlerAlarmTopic(MessageData *msgData)
 {
 	//from here we can let it start buzzing until the box is open (button unpressed), 
 	SerialConsoleWriteString("buzzer buzzzzzzing\r\n");
-	port_pin_set_output_level(PIN_PA11, true);		//buzzer buzz
+	BuzzerPlay(&buzzerPatternPill);		//buzzer buzz, stopped by the alarm task when a lid is opened
+}
 
-	
-//	port_pin_set_output_level(PIN_PA11, false);		//stop buzzer
+void SubscribeHandlerScheduleTopic(MessageData *msgData)
+{
+	//replace one dose slot of the medication schedule, see ScheduleParse() for the format
+	if (ScheduleParse((const char *)msgData->message->payload, msgData->message->payloadlen) == 0) {
+		SerialConsoleWriteString("dose schedule updated\r\n");
+	} else {
+		SerialConsoleWriteString("dose schedule update rejected\r\n");
+	}
+}
+
+void SubscribeHandlerRulesTopic(MessageData *msgData)
+{
+	//replace one alarm rule, see RulesParse() for the format
+	if (RulesParse((const char *)msgData->message->payload, msgData->message->payloadlen) == 0) {
+		SerialConsoleWriteString("alarm rule updated\r\n");
+	} else {
+		SerialConsoleWriteString("alarm rule update rejected\r\n");
+	}
 }
 
 
@@ -606,6 +651,8 @@ static void mqtt_callback(struct mqtt_module *module_inst, int type, union mqtt_
                 /* Subscribe chat topic. */
 				mqtt_subscribe(module_inst, "mqttButton", 2, SubscribeHandlerUpdateButtonTopic);
 				mqtt_subscribe(module_inst, "mqttBuzzer", 2, SubscribeHandlerAlarmTopic);	
+				mqtt_subscribe(module_inst, RULES_TOPIC, 2, SubscribeHandlerRulesTopic);
+				mqtt_subscribe(module_inst, SCHEDULE_TOPIC, 2, SubscribeHandlerScheduleTopic);
                 /* Enable USART receiving callback. */
 
                 LogMessage(LOG_DEBUG_LVL, "MQTT Connected\r\n");
@@ -653,35 +700,19 @@ static void configure_mqtt(void)
     }
 }
 
-// SETUP FOR EXTERNAL BUTTON INTERRUPT -- Used to send an MQTT Message
-
-void configure_extint_channel(void)
-{
-    struct extint_chan_conf config_extint_chan;
-    extint_chan_get_config_defaults(&config_extint_chan);
-    config_extint_chan.gpio_pin = BUTTON_0_EIC_PIN;
-    config_extint_chan.gpio_pin_mux = BUTTON_0_EIC_MUX;
-    config_extint_chan.gpio_pin_pull = EXTINT_PULL_UP;
-    config_extint_chan.detection_criteria = EXTINT_DETECT_FALLING;
-    extint_chan_set_config(BUTTON_0_EIC_LINE, &config_extint_chan);
-}
-
-void extint_detection_callback(void);
-void configure_extint_callbacks(void)
+/**
+ * @fn			static void MQTT_HandleButton(void)
+ * @brief       Publishes the example message of a SW0 press on TEMPERATURE_TOPIC, a counter from 1 to 40. The press is
+ *              published on the sample bus by Input.c
+ */
+static void MQTT_HandleButton(void)
 {
-    extint_register_callback(extint_detection_callback, BUTTON_0_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-    extint_chan_enable_callback(BUTTON_0_EIC_LINE, EXTINT_CALLBACK_TYPE_DETECT);
-}
+    char msg[32];
 
-volatile bool isPressed = false;
-void extint_detection_callback(void)
-{
-  // Publish some data after a button press and release. Note: just an example! This is not the most elegant way of doing this!
     temperature++;
     if (temperature > 40) temperature = 1;
-    snprintf(mqtt_msg_temp, 63, "{\"d\":{\"temp\":%d}}", temperature);
-    isPressed = true;
-     //Published in the Wifi thread main loop
+    snprintf(msg, sizeof(msg), "{\"d\":{\"temp\":%lu}}", (unsigned long)temperature);
+    mqtt_publish(&mqtt_inst, TEMPERATURE_TOPIC, msg, strlen(msg), 1, 0);
 }
 
 //Routine to initialize HTTP download of the OTAU file
@@ -773,11 +804,16 @@ static void MQTT_HandleTransactions(void)
 
     // Check if data has to be sent!
 
-	MQTT_HandleHumMessages();
-	MQTT_HandleTemMessages();
+	MQTT_HandleSensorMessages();
+	MQTT_HandleImuMessages();
+	MQTT_HandleStackReport();
 	
-    // Handle MQTT messages
-    if (mqtt_inst.isConnected) mqtt_yield(&mqtt_inst, 100);
+    // Handle MQTT messages. Inbound packets raise no WINC event until the client reads, so they are polled, on time
+    // even while records keep waking the task
+    if (WifiPollDelay() == 0) {
+        wifiLastPoll = xTaskGetTickCount();
+        if (mqtt_inst.isConnected) mqtt_yield(&mqtt_inst, WIFI_YIELD_MS);
+    }
 }
 
 //Main application function.
@@ -787,17 +823,17 @@ void vWifiTask(void *pvParameters)
     int8_t ret;
     vTaskDelay(100);
     init_state();
-    // Create buffers to send data	
-	xQueueWifiState = xQueueCreate(5, sizeof(uint32_t));
-	//ADD YOUR OWN XQueue temp and mosit buffer
-	xQueueTempBuffer = xQueueCreate(5, sizeof(uint16_t));
-	xQueueMoistBuffer = xQueueCreate(5, sizeof(uint16_t));
-	
-	
-	
-    if (xQueueWifiState == NULL || xQueueImuBuffer == NULL || xQueueGameBuffer == NULL || xQueueDistanceBuffer == NULL) {
+    // The queues come from TaskTable/TaskTable.h, only the sample bus subscription is made here
+	mqttSampleSubscriber = SampleBusSubscribe("mqtt", SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_SHTC3) | SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_IMU_EVENT) |
+	                                          SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_BUTTON), NULL, 0);
+
+    if (xQueueWifiState == NULL || mqttSampleSubscriber == NULL || xQueueImuBuffer == NULL) {
         SerialConsoleWriteString("ERROR Initializing Wifi Data queues!\r\n");
     }
+    if (!WifiEventsInit()) {
+        SerialConsoleWriteString("ERROR Initializing Wifi event set!\r\n");
+        vTaskSuspend(NULL);
+    }
 
     SerialConsoleWriteString("ESE516 - Wifi Init Code\r\n");
     /* Initialize the Timer. */
@@ -812,10 +848,6 @@ void vWifiTask(void *pvParameters)
     /* Initialize SD/MMC storage. */
     init_storage();
 
-    /*Initialize BUTTON 0 as an external interrupt*/
-    configure_extint_channel();
-    configure_extint_callbacks();
-
     /* Initialize Wi-Fi parameters structure. */
     memset((uint8_t *)&param, 0, sizeof(tstrWifiInitParam));
 
@@ -829,6 +861,7 @@ void vWifiTask(void *pvParameters)
         while (1) {
         }
     }
+    nm_bsp_register_event_cb(WifiWincEventCallback);
 
     LogMessage(LOG_DEBUG_LVL, "main: connecting to WiFi AP %s...\r\n", (char *)MAIN_WLAN_SSID);
 
@@ -843,6 +876,7 @@ void vWifiTask(void *pvParameters)
         m2m_wifi_handle_events(NULL);
         /* Checks the timer timeout. */
         sw_timer_task(&swt_module_inst);
+        WifiWaitEvent(pdMS_TO_TICKS(WIFI_POLL_MS));
     }
 
     vTaskDelay(1000);
@@ -877,13 +911,9 @@ void vWifiTask(void *pvParameters)
                 wifiStateMachine = WIFI_MQTT_INIT;
                 break;
         }
-        // Check if a new state was called
-        uint8_t DataToReceive = 0;
-        if (pdPASS == xQueueReceive(xQueueWifiState, &DataToReceive, 0)) {
-            wifiStateMachine = DataToReceive;  // Update new state
-        }
-
-        vTaskDelay(100);
+        // Sleep until there is work: a WINC event, a record to publish, a new state, or the next MQTT poll. The
+        // other states go on at once
+        WifiWaitEvent((wifiStateMachine == WIFI_MQTT_HANDLE) ? WifiPollDelay() : 0);
     }
     return;
 }
@@ -895,21 +925,253 @@ void WifiHandlerSetState(uint8_t state)
 	}
 }
 
+/**
+ int WifiAddImuBatchToQueue(Imu_Batch *batch)
+ * @brief	Queues a batch of accelerometer samples to be published on IMU_TOPIC
+ * @param[in]	batch Batch to publish. It is copied, so the caller can reuse it
+ * @return	pdPASS if queued, errQUEUE_FULL if the two queued batches are still unsent (the batch is dropped)
+*/
+int WifiAddImuBatchToQueue(Imu_Batch *batch)
+{
+	if (xQueueImuBuffer == NULL) {
+		return errQUEUE_FULL;
+	}
+	return xQueueSend(xQueueImuBuffer, batch, 0);
+}
+
+/**
+ static void MQTT_HandleImuMessages(void)
+ * @brief	Publishes the queued accelerometer batches
+ * @note	The payload is the Imu_Batch structure as is (little endian), cut after the last valid sample
+
+*/
+static void MQTT_HandleImuMessages(void)
+{
+	if (wifiImuPending) {
+		size_t len = offsetof(Imu_Batch, sample) + wifiImuBatch.count * sizeof(wifiImuBatch.sample[0]);
+		mqtt_publish(&mqtt_inst, IMU_TOPIC, (char *)&wifiImuBatch, len, 1, 0);
+		wifiImuPending = false;
+		WifiCountPublish(wifiImuBatch.timestamp);
+	}
+}
+
+
+/**
+ static void MQTT_PublishImuEvent(const Sample_Record *record)
+ * @brief	Publishes an IMU event record on Tamper_topic
+
+*/
+static void MQTT_PublishImuEvent(const Sample_Record *record)
+{
+	uint32_t events = record->channel[SAMPLE_IMU_EVENT_FLAGS];
+	const char *name;
+
+	if (events & IMU_EVENT_FREE_FALL) {
+		name = "drop";
+	} else if (events & (IMU_EVENT_SINGLE_TAP | IMU_EVENT_DOUBLE_TAP)) {
+		name = "knock";
+	} else if (events & IMU_EVENT_ORIENTATION) {
+		name = "tilt";
+	} else if (record->channel[SAMPLE_IMU_EVENT_MOVING]) {
+		name = "moved";
+	} else {
+		name = "still";
+	}
+	mqtt_publish(&mqtt_inst, Tamper_topic, name, strlen(name), 1, 0);
+}
+
+/**
+ static void MQTT_HandleSensorMessages(void)
+ * @brief	Publishes the SHTC3 and IMU event records waiting on the sample bus, and handles the SW0 presses
+ * @note	Failed reads are skipped, the broker keeps the last good value. An IMU event is published as the name of its most
+ *		serious flag: drop, knock, tilt, moved or still
+
+*/
+static void MQTT_HandleSensorMessages(void)
+{
+	Sample_Record record;
+	char mqtt_sensor_msg[64];
+
+	while (SampleBusRead(mqttSampleSubscriber, &record)) {
+		if (record.status != 0) {
+			continue;
+		}
+		if (record.sensor == SAMPLE_SENSOR_IMU_EVENT) {
+			MQTT_PublishImuEvent(&record);
+			WifiCountPublish(record.timestamp);
+			continue;
+		}
+		if (record.sensor == SAMPLE_SENSOR_BUTTON) {
+			MQTT_HandleButton();
+			continue;
+		}
+		int32_t temperature = record.channel[SAMPLE_SHTC3_TEMPERATURE];
+		int32_t humidity = record.channel[SAMPLE_SHTC3_HUMIDITY];
+
+		snprintf(mqtt_sensor_msg, sizeof(mqtt_sensor_msg), "%s%ld.%ld", (temperature < 0) ? "-" : "",
+		         labs(temperature) / 10, labs(temperature) % 10);
+		mqtt_publish(&mqtt_inst, Temp_topic, mqtt_sensor_msg, strlen(mqtt_sensor_msg), 2, 0);
+
+		snprintf(mqtt_sensor_msg, sizeof(mqtt_sensor_msg), "%ld.%ld", humidity / 10, humidity % 10);
+		mqtt_publish(&mqtt_inst, Hunmid_topic, mqtt_sensor_msg, strlen(mqtt_sensor_msg), 2, 0);
+		WifiCountPublish(record.timestamp);
+	}
+}
+
+/**
+ static void MQTT_HandleStackReport(void)
+ * @brief	Publishes the stack use of every task on Stack_topic every STACK_MON_REPORT_MS, once connected
+ * @note	One message per task: {"task":"IMU_TAS","size":300,"min":120,"rec":288} for IMU_TASK, whose name the kernel
+ *		cuts to configMAX_TASK_NAME_LEN - 1 characters. Sizes are in words, min is the fewest free words since the
+ *		history started
+
+*/
+static void MQTT_HandleStackReport(void)
+{
+	static TickType_t lastReport = 0;
+	static bool reported = false;
+	StackMon_Task tasks[STACK_MON_MAX_TASKS];
+	char mqtt_stack_msg[64];
+
+	if (!mqtt_inst.isConnected || (reported && (xTaskGetTickCount() - lastReport) < pdMS_TO_TICKS(STACK_MON_REPORT_MS))) {
+		return;
+	}
+	lastReport = xTaskGetTickCount();
+	reported = true;
+
+	uint8_t count = StackMonGetTasks(tasks, STACK_MON_MAX_TASKS);
+	for (uint8_t i = 0; i < count; i++) {
+		snprintf(mqtt_stack_msg, sizeof(mqtt_stack_msg), "{\"task\":\"%s\",\"size\":%u,\"min\":%u,\"rec\":%u}", tasks[i].name,
+		         tasks[i].words, tasks[i].freeEver, tasks[i].recommended);
+		mqtt_publish(&mqtt_inst, Stack_topic, mqtt_stack_msg, strlen(mqtt_stack_msg), 0, 0);
+	}
+}
+
+/**
+ static void WifiWincEventCallback(void)
+ * @brief	Called by the WINC1500 interrupt after the driver handler, wakes the task to run m2m_wifi_handle_events()
+
+*/
+static void WifiWincEventCallback(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	xSemaphoreGiveFromISR(wifiWincEvent, &xHigherPriorityTaskWoken);
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ static bool WifiEventsInit(void)
+ * @brief	Creates the queue set the task waits on: the state and IMU queues, the WINC and sample bus semaphores
+ * @return	False if the set could not be created or a member not added
+ * @note	A queue must be empty when added to a set, so anything queued before (at boot) is dropped
+
+*/
+static bool WifiEventsInit(void)
+{
+	bool ok;
+
+	wifiWincEvent = xSemaphoreCreateBinaryStatic(&wifiWincEventBuffer);
+	wifiSampleEvent = xSemaphoreCreateBinaryStatic(&wifiSampleEventBuffer);
+
+	vTaskSuspendAll();
+	xQueueReset(xQueueWifiState);
+	xQueueReset(xQueueImuBuffer);
+	// Empty, so the spaces are the lengths from the task table
+	wifiEventSet = xQueueCreateSet(uxQueueSpacesAvailable(xQueueWifiState) + uxQueueSpacesAvailable(xQueueImuBuffer) + 2);
+	ok = (wifiEventSet != NULL) && xQueueAddToSet(xQueueWifiState, wifiEventSet) == pdPASS &&
+	     xQueueAddToSet(xQueueImuBuffer, wifiEventSet) == pdPASS && xQueueAddToSet(wifiWincEvent, wifiEventSet) == pdPASS &&
+	     xQueueAddToSet(wifiSampleEvent, wifiEventSet) == pdPASS;
+	xTaskResumeAll();
+
+	if (ok) {
+		SampleBusSetSemaphore(mqttSampleSubscriber, wifiSampleEvent);
+	}
+	return ok;
+}
+
+/**
+ static uint8_t WifiWaitEvent(TickType_t timeout)
+ * @brief	Blocks on the queue set until a member is ready or the timeout elapses, and takes what woke the task
+ * @details	A new state is applied and an IMU batch is kept for MQTT_HandleImuMessages(). Records stay on the sample bus,
+ *		the semaphore only says there are some. Each member is taken once per selection, as queue sets require
+ * @return	The eWifiWake of the wake-up
 
-static void MQTT_HandleHumMessages(void) {
-	int32_t sensorData;
-	if (pdPASS == xQueueReceive(xQueueMoistBuffer, &sensorData, 0)) {
-		char mqtt_humidity_msg[64];
-		snprintf(mqtt_humidity_msg, sizeof(mqtt_humidity_msg), "%d", sensorData);
-		mqtt_publish(&mqtt_inst, Hunmid_topic, mqtt_humidity_msg, strlen(mqtt_humidity_msg), 2, 0);
+*/
+static uint8_t WifiWaitEvent(TickType_t timeout)
+{
+	QueueSetMemberHandle_t member = xQueueSelectFromSet(wifiEventSet, timeout);
+	uint8_t wake;
+
+	if (member == NULL) {
+		wake = WIFI_WAKE_POLL;
+	} else if (member == wifiWincEvent) {
+		xSemaphoreTake(wifiWincEvent, 0);
+		wake = WIFI_WAKE_WINC;
+	} else if (member == wifiSampleEvent) {
+		xSemaphoreTake(wifiSampleEvent, 0);
+		wake = WIFI_WAKE_SAMPLE;
+	} else if (member == xQueueImuBuffer) {
+		// A batch still pending here is overwritten, as a full queue would have dropped it
+		wifiImuPending = (xQueueReceive(xQueueImuBuffer, &wifiImuBatch, 0) == pdPASS);
+		wake = WIFI_WAKE_IMU;
+	} else {
+		uint8_t state;
+		if (xQueueReceive(xQueueWifiState, &state, 0) == pdPASS) {
+			wifiStateMachine = state;
+		}
+		wake = WIFI_WAKE_STATE;
 	}
+
+	taskENTER_CRITICAL();
+	wifiLoopStats.wakeUps[wake]++;
+	taskEXIT_CRITICAL();
+	return wake;
+}
+
+/**
+ static TickType_t WifiPollDelay(void)
+ * @brief	Returns the ticks left before the next MQTT poll, 0 if it is due
+
+*/
+static TickType_t WifiPollDelay(void)
+{
+	TickType_t elapsed = xTaskGetTickCount() - wifiLastPoll;
+
+	return (elapsed >= pdMS_TO_TICKS(WIFI_POLL_MS)) ? 0 : pdMS_TO_TICKS(WIFI_POLL_MS) - elapsed;
 }
 
-static void MQTT_HandleTemMessages(void) {
-	int32_t sensorData;
-	if (pdPASS == xQueueReceive(xQueueTempBuffer, &sensorData, 0)) {
-		char mqtt_temperature_msg[64];
-		snprintf(mqtt_temperature_msg, sizeof(mqtt_temperature_msg), "%d", sensorData);
-		mqtt_publish(&mqtt_inst,Temp_topic, mqtt_temperature_msg, strlen(mqtt_temperature_msg), 2, 0);
+/**
+ static void WifiCountPublish(TickType_t timestamp)
+ * @brief	Counts a published record or batch and its latency, from the tick the sample was read at
+ * @note	Records drained while the broker is not connected are not counted
+
+*/
+static void WifiCountPublish(TickType_t timestamp)
+{
+	uint32_t latency = xTaskGetTickCount() - timestamp;
+
+	if (!mqtt_inst.isConnected) {
+		return;
+	}
+	taskENTER_CRITICAL();
+	wifiLoopStats.published++;
+	wifiLoopStats.lastLatencyTicks = latency;
+	wifiLoopStats.sumLatencyTicks += latency;
+	if (latency > wifiLoopStats.maxLatencyTicks) {
+		wifiLoopStats.maxLatencyTicks = latency;
 	}
-}
\ No newline at end of file
+	taskEXIT_CRITICAL();
+}
+
+/**
+ void WifiGetLoopStats(Wifi_Loop_Stats *stats)
+ * @brief	Copies the wake-up and publish latency counters of the Wi-Fi task
+
+*/
+void WifiGetLoopStats(Wifi_Loop_Stats *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = wifiLoopStats;
+	taskEXIT_CRITICAL();
+}
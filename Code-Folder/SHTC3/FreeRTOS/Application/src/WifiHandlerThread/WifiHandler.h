@@ -25,6 +25,7 @@ extern "C" {
 //#include "secret.h"  // NOTE: You must make this file and include your Wi-Fi settings
 #include "socket/include/socket.h"
 #include "stdio_serial.h"
+#include "IMU/ImuTask.h"
 
 /******************************************************************************
  * Defines
@@ -36,9 +37,8 @@ extern "C" {
 #define WIFI_DOWNLOAD_HANDLE 3  ///< State for Wifi handler to Handle Download Connection
 
 #define WIFI_TASK_SIZE 1200			//default 1000
-#define vI2C_TASK_SIZE 500
-#define WIFI_PRIORITY (configMAX_PRIORITIES - 2)	//this is 3
-#define vI2C_PRIORITY 4								//the i2c must have a higher priority than 4
+#define WIFI_POLL_MS 500			///< Longest sleep of the Wi-Fi task: MQTT keep-alive and inbound messages, which raise no WINC event
+#define WIFI_YIELD_MS 10			///< Time given to the MQTT client to read inbound packets on each poll
 
 /** Wi-Fi AP Settings. */
 // Note: It is highly recommended that you save your Wi-Fi details in a separate header file, "secret.h", which is not committed to Github (added to gitignore).
@@ -130,6 +130,8 @@ struct RgbColorPacket {
 //add your one topic right here
 #define Temp_topic "Mqtttemp"
 #define Hunmid_topic "Mqttmoist"
+#define Tamper_topic "Mqtttamper"
+#define Stack_topic "Mqttstack"
 
 // Cloud MQTT User
 #define CLOUDMQTT_USER_ID "team1"
@@ -155,6 +157,24 @@ static const char main_mqtt_broker[] = "52.186.82.19";
 /******************************************************************************
  * Structures and Enumerations
  ******************************************************************************/
+/// What woke the Wi-Fi task
+typedef enum eWifiWake {
+    WIFI_WAKE_WINC = 0,  ///< WINC1500 interrupt: a network event to handle
+    WIFI_WAKE_SAMPLE,    ///< Record published on the sample bus
+    WIFI_WAKE_IMU,       ///< Accelerometer batch queued
+    WIFI_WAKE_STATE,     ///< State change requested by another task
+    WIFI_WAKE_POLL,      ///< WIFI_POLL_MS elapsed without an event
+    WIFI_WAKE_MAX,
+} eWifiWake;
+
+/// Counters of the event loop of the Wi-Fi task
+typedef struct Wifi_Loop_Stats {
+    uint32_t wakeUps[WIFI_WAKE_MAX];  ///< Wake-ups by eWifiWake
+    uint32_t published;               ///< Records and batches published
+    uint32_t lastLatencyTicks;        ///< Time from the read of the sample to its publish, last one
+    uint32_t maxLatencyTicks;         ///< Largest latency seen
+    uint32_t sumLatencyTicks;         ///< Accumulated latency, to compute the average over published
+} Wifi_Loop_Stats;
 
 /******************************************************************************
  * Global Function Declaration
@@ -164,15 +184,16 @@ void init_storage(void);
 void WifiHandlerSetState(uint8_t state);
 int WifiAddDistanceDataToQueue(uint16_t *distance);
 int WifiAddImuDataToQueue(struct ImuDataPacket *imuPacket);
+int WifiAddImuBatchToQueue(Imu_Batch *batch);
+void WifiGetLoopStats(Wifi_Loop_Stats *stats);
 int WifiAddGameDataToQueue(struct GameDataPacket *game);
 
 void SubscribeHandlerUpdateButtonTopic(MessageData *msgData);
 void SubscribeHandlerAlarmTopic(MessageData *msgData);
+void SubscribeHandlerRulesTopic(MessageData *msgData);
+void SubscribeHandlerScheduleTopic(MessageData *msgData);
 
 
-void configure_extint_channel(void);
-void configure_extint_callbacks(void);
-
 #ifdef __cplusplus
 }
 #endif
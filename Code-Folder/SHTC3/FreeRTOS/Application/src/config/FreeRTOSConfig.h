@@ -42,6 +42,9 @@
 #include <gclk.h>
 #include <stdint.h>
 void assert_triggered(const char *file, uint32_t line);
+void PowerSuppressTicksAndSleep(uint32_t expectedIdleTicks);
+void CpuStatsConfigureTimer(void);
+uint32_t CpuStatsGetCounter(void);
 #endif
 
 #define configUSE_PREEMPTION 1
@@ -50,24 +53,30 @@ void assert_triggered(const char *file, uint32_t line);
 #define configPRIO_BITS 2
 #define configCPU_CLOCK_HZ (system_gclk_gen_get_hz(GCLK_GENERATOR_0))
 #define configTICK_RATE_HZ ((portTickType)1000)
-#define configMAX_PRIORITIES (5)
+#define configMAX_PRIORITIES (6)
 #define configMINIMAL_STACK_SIZE ((unsigned short)100)
-/* configTOTAL_HEAP_SIZE is not used when heap_3.c is used. */
-#define configTOTAL_HEAP_SIZE ((size_t)(12000))
+/* Arena of the memory pools, MemPool/MemPool.c. Kernel objects are static, TaskTable/TaskTable.c: drivers only */
+#define configTOTAL_HEAP_SIZE ((size_t)(3584))
 #define configMAX_TASK_NAME_LEN (8)
 #define configUSE_TRACE_FACILITY 1
 #define configUSE_16_BIT_TICKS 0
 #define configIDLE_SHOULD_YIELD 1
 #define configUSE_MUTEXES 1
 #define configQUEUE_REGISTRY_SIZE 0
-#define configCHECK_FOR_STACK_OVERFLOW 1
+#define configCHECK_FOR_STACK_OVERFLOW 2  // Also checks the end of the stack is untouched, StackMon/StackMon.c logs first
 #define configUSE_RECURSIVE_MUTEXES 1
-#define configUSE_MALLOC_FAILED_HOOK 1
+#define configUSE_MALLOC_FAILED_HOOK 0  // MemPool/MemPool.c reports an empty pool and returns NULL to the caller
+#define configSUPPORT_STATIC_ALLOCATION 1  // Tasks and queues from TaskTable/TaskTable.h
 #define configUSE_COUNTING_SEMAPHORES 1
 #define configUSE_QUEUE_SETS 1
-#define configGENERATE_RUN_TIME_STATS 0
+#define configGENERATE_RUN_TIME_STATS 1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() CpuStatsConfigureTimer()  // CpuStats/CpuStats.c, TC5
+#define portGET_RUN_TIME_COUNTER_VALUE() CpuStatsGetCounter()
 #define configENABLE_BACKWARD_COMPATIBILITY 1
 #define configUSE_DAEMON_TASK_STARTUP_HOOK 1  // Ported from FreeRToS 9.0.0
+#define configUSE_TICKLESS_IDLE 1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
+#define portSUPPRESS_TICKS_AND_SLEEP(xExpectedIdleTime) PowerSuppressTicksAndSleep(xExpectedIdleTime)  // Power/Power.c, TC4
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 0
@@ -75,9 +84,9 @@ void assert_triggered(const char *file, uint32_t line);
 
 /* Software timer definitions. */
 #define configUSE_TIMERS 1
-#define configTIMER_TASK_PRIORITY (2)
-#define configTIMER_QUEUE_LENGTH 5
-#define configTIMER_TASK_STACK_DEPTH (128)
+#define configTIMER_TASK_PRIORITY (configMAX_PRIORITIES - 2)  // Sensing jobs, lid debounce: see the priority map, TaskTable.h
+#define configTIMER_QUEUE_LENGTH 11                          // Resets of three bouncing lids, and the drain of Defer/Defer.c
+#define configTIMER_TASK_STACK_DEPTH (320)                   // Also runs the executor jobs, Exec/Exec.c: sensor hooks
 
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
@@ -93,6 +102,7 @@ to exclude the API function. */
 #define INCLUDE_uxTaskGetStackHighWaterMark 1
 #define INCLUDE_xTaskGetIdleTaskHandle 0
 #define INCLUDE_xTimerGetTimerDaemonTaskHandle 0
+#define INCLUDE_xTimerPendFunctionCall 1
 #define INCLUDE_pcTaskGetTaskName 0
 #define INCLUDE_eTaskGetState 0
 
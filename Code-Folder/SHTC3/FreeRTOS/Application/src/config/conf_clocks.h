@@ -147,10 +147,10 @@
 #  define CONF_CLOCK_GCLK_1_OUTPUT_ENABLE         false
 
 /* Configure GCLK generator 2 (RTC) */
-#  define CONF_CLOCK_GCLK_2_ENABLE                true  ///> Used to run the buttons
-#  define CONF_CLOCK_GCLK_2_RUN_IN_STANDBY        true  ///> Need to be on all the time so we can run buttons in sleep
+#  define CONF_CLOCK_GCLK_2_ENABLE                true  ///> Runs the RTC calendar of the medication schedule
+#  define CONF_CLOCK_GCLK_2_RUN_IN_STANDBY        true  ///> Need to be on all the time so the dose alarm wakes us from sleep
 #  define CONF_CLOCK_GCLK_2_CLOCK_SOURCE          SYSTEM_CLOCK_SOURCE_ULP32K
-#  define CONF_CLOCK_GCLK_2_PRESCALER             1
+#  define CONF_CLOCK_GCLK_2_PRESCALER             32    ///> 1.024 kHz, the RTC prescaler divides it down to 1 Hz
 #  define CONF_CLOCK_GCLK_2_OUTPUT_ENABLE         false
 
 /* Configure GCLK generator 3 */
@@ -175,9 +175,9 @@
 #  define CONF_CLOCK_GCLK_5_OUTPUT_ENABLE         false
 
 /* Configure GCLK generator 6 */
-#  define CONF_CLOCK_GCLK_6_ENABLE                false
-#  define CONF_CLOCK_GCLK_6_RUN_IN_STANDBY        false
-#  define CONF_CLOCK_GCLK_6_CLOCK_SOURCE          SYSTEM_CLOCK_SOURCE_OSC8M
+#  define CONF_CLOCK_GCLK_6_ENABLE                true    ///< EIC and tickless idle timer, run in standby
+#  define CONF_CLOCK_GCLK_6_RUN_IN_STANDBY        true
+#  define CONF_CLOCK_GCLK_6_CLOCK_SOURCE          SYSTEM_CLOCK_SOURCE_ULP32K
 #  define CONF_CLOCK_GCLK_6_PRESCALER             1
 #  define CONF_CLOCK_GCLK_6_OUTPUT_ENABLE         false
 
@@ -33,6 +33,6 @@
 #ifndef CONF_EXTINT_H_INCLUDED
 #define CONF_EXTINT_H_INCLUDED
 
-#  define EXTINT_CLOCK_SOURCE      GCLK_GENERATOR_0
+#  define EXTINT_CLOCK_SOURCE      GCLK_GENERATOR_6  // Runs in standby, so lids, IMU and WINC interrupts wake the box
 
 #endif
@@ -37,6 +37,7 @@
 #include "iot/stream_writer.h"
 #include <stdio.h>
 #include <errno.h>
+#include "MemPool/MemPool.h"
 
 #define DEFAULT_USER_AGENT "atmel/1.0.2"
 
@@ -174,7 +175,7 @@ int http_client_init(struct http_client_module *const module, struct http_client
 
 	/* Allocate the buffer in the heap. */
 	if (module->config.recv_buffer == NULL) {
-		module->config.recv_buffer = malloc(config->recv_buffer_size);
+		module->config.recv_buffer = MemPoolAlloc(config->recv_buffer_size);
 		if (module->config.recv_buffer == NULL) {
 			return -ENOMEM;
 		}
@@ -204,11 +205,11 @@ int http_client_deinit(struct http_client_module *const module)
 	}
 
 	if (module->alloc_buffer != 0) {
-		free(module->config.recv_buffer);
+		MemPoolFree(module->config.recv_buffer);
 	}
 
 	if (module->req.ext_header != NULL) {
-		free(module->req.ext_header);
+		MemPoolFree(module->req.ext_header);
 	}
 
 	memset(module, 0, sizeof(struct http_client_module));
@@ -439,13 +440,14 @@ int http_client_send_request(struct http_client_module *const module, const char
 	}
 
 	if (module->req.ext_header != NULL) {
-		free(module->req.ext_header);
+		MemPoolFree(module->req.ext_header);
 	}
 	if (ext_header != NULL) {
-		module->req.ext_header = strdup(ext_header);
+		module->req.ext_header = MemPoolAlloc(strlen(ext_header) + 1);
 		if (module->req.ext_header == NULL) {
 			return -ENOMEM;
 		}
+		strcpy(module->req.ext_header, ext_header);
 	} else {
 		module->req.ext_header = NULL;
 	}
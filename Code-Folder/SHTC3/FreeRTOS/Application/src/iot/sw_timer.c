@@ -33,8 +33,47 @@
 
 #include "sw_timer.h"
 
+#if (SAMD21) && defined(__FREERTOS__)
+#include <FreeRTOS.h>
+#include <task.h>
+
+#define SW_TIMER_USE_RTOS_TICK 1
+#else
+#define SW_TIMER_USE_RTOS_TICK 0
+#endif
+
 /** Tick count of timer. */
 static uint32_t sw_timer_tick = 0;
+#if SW_TIMER_USE_RTOS_TICK
+/** Kernel tick count sw_timer_tick was last advanced to. */
+static TickType_t sw_timer_kernel_tick = 0;
+#endif
+
+/**
+ * \brief Get the tick count of the SW timer, in units of the timer accuracy.
+ *
+ * Under FreeRTOS the kernel tick is used instead of a TCC interrupt: tickless
+ * idle stops the TCC clock in standby but steps the kernel tick over the sleep.
+ * The count is advanced by the kernel ticks elapsed since the last call rather
+ * than derived from the kernel tick count, so it stays monotonic when the
+ * kernel tick count wraps and the signed expiry comparison keeps working.
+ *
+ * \param[in] module_inst Instance of the SW timer.
+ */
+static inline uint32_t sw_timer_get_tick(struct sw_timer_module *const module_inst)
+{
+#if SW_TIMER_USE_RTOS_TICK
+	TickType_t period = pdMS_TO_TICKS(module_inst->accuracy);
+	TickType_t elapsed;
+
+	taskENTER_CRITICAL();
+	elapsed = (xTaskGetTickCount() - sw_timer_kernel_tick) / period;
+	sw_timer_tick += elapsed;
+	sw_timer_kernel_tick += elapsed * period;
+	taskEXIT_CRITICAL();
+#endif
+	return sw_timer_tick;
+}
 
 /**
  * \brief TCC callback of SW timer.
@@ -43,7 +82,7 @@ static uint32_t sw_timer_tick = 0;
  *
  * \param[in] module Instance of the TCC.
  */
-#if (SAMD21)
+#if (SAMD21) && !SW_TIMER_USE_RTOS_TICK
 static void sw_timer_tcc_callback(struct tcc_module *const module)
 {
 	sw_timer_tick++;
@@ -76,7 +115,7 @@ void sw_timer_get_config_defaults(struct sw_timer_config *const config)
 
 void sw_timer_init(struct sw_timer_module *const module_inst, struct sw_timer_config *const config)
 {
-#if (SAMD21)
+#if (SAMD21) && !SW_TIMER_USE_RTOS_TICK
 	struct tcc_config tcc_conf;
 	struct tcc_module *tcc_module;
 	Tcc *hw[] = TCC_INSTS;
@@ -88,7 +127,7 @@ void sw_timer_init(struct sw_timer_module *const module_inst, struct sw_timer_co
 	Assert(config->tcc_callback_channel < TCC_NUM_CHANNELS);
 
 	module_inst->accuracy = config->accuracy;
-#if (SAMD21)
+#if (SAMD21) && !SW_TIMER_USE_RTOS_TICK
 	/* Start the TCC module. */
 	tcc_module = &module_inst->tcc_inst;
 	tcc_get_config_defaults(&tcc_conf, hw[config->tcc_dev]);
@@ -112,12 +151,12 @@ void sw_timer_init(struct sw_timer_module *const module_inst, struct sw_timer_co
 
 void sw_timer_enable(struct sw_timer_module *const module_inst)
 {
-#if (SAMD21)
+#if (SAMD21) && !SW_TIMER_USE_RTOS_TICK
 	struct tcc_module *tcc_module;
 #endif
 
 	Assert(module_inst);
-#if (SAMD21)
+#if (SAMD21) && !SW_TIMER_USE_RTOS_TICK
 	tcc_module = &module_inst->tcc_inst;
 
 	tcc_enable(tcc_module);
@@ -133,13 +172,13 @@ void sw_timer_enable(struct sw_timer_module *const module_inst)
 
 void sw_timer_disable(struct sw_timer_module *const module_inst)
 {
-#if (SAMD21)
+#if (SAMD21) && !SW_TIMER_USE_RTOS_TICK
 	struct tcc_module *tcc_module;
 #endif
 
 	Assert(module_inst);
 
-#if (SAMD21)
+#if (SAMD21) && !SW_TIMER_USE_RTOS_TICK
 	tcc_module = &module_inst->tcc_inst;
 	tcc_disable(tcc_module);
 #elif (SAM4S) || (SAMG53) || (SAMG55)
@@ -196,7 +235,7 @@ void sw_timer_enable_callback(struct sw_timer_module *const module_inst, int tim
 	handler = &module_inst->handler[timer_id];
 
 	handler->callback_enable = 1;
-	handler->expire_time = sw_timer_tick + (delay / module_inst->accuracy);
+	handler->expire_time = sw_timer_get_tick(module_inst) + (delay / module_inst->accuracy);
 }
 
 void sw_timer_disable_callback(struct sw_timer_module *const module_inst, int timer_id)
@@ -221,12 +260,12 @@ void sw_timer_task(struct sw_timer_module *const module_inst)
 	for (index = 0; index < CONF_SW_TIMER_COUNT; index++) {
 		if (module_inst->handler[index].used && module_inst->handler[index].callback_enable) {
 			handler = &module_inst->handler[index];
-			if ((int)(handler->expire_time - sw_timer_tick) < 0 && handler->busy == 0) {
+			if ((int)(handler->expire_time - sw_timer_get_tick(module_inst)) < 0 && handler->busy == 0) {
 				/* Enter critical section. */
 				handler->busy = 1;
 				/* Timer was expired. */
 				if (handler->period > 0) {
-					handler->expire_time = sw_timer_tick + handler->period;
+					handler->expire_time = sw_timer_get_tick(module_inst) + handler->period;
 				} else {
 					/* One shot. */
 					handler->callback_enable = 0;
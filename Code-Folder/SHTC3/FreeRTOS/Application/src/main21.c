@@ -23,9 +23,20 @@
 #include "OLED/fonts.h"
 #include "OLED/SSD1306.h"
 
-// to use the SHTC3, we create a SHTC3 and SHTC3Task, so include these code
+// the SHTC3 is sampled by the acquisition task through the SHTC3 task hook, so include these code
 #include "SHTC3/SHTC3.h"
 #include "SHTC3/SHTC3_TASK.h"
+#include "Acquisition/Acquisition.h"
+#include "IMU/ImuTask.h"
+#include "Input/Input.h"
+#include "Alarm/AlarmTask.h"
+#include "Buzzer/Buzzer.h"
+#include "Power/Power.h"
+#include "CpuStats/CpuStats.h"
+#include "MemPool/MemPool.h"
+#include "TaskTable/TaskTable.h"
+#include "StackMon/StackMon.h"
+#include "Exec/Exec.h"
 
 #include "IMU/lsm6dso_reg.h"
 
@@ -43,22 +54,14 @@ void vApplicationIdleHook(void);
 static void StartTasks(void);
 void vApplicationDaemonTaskStartupHook(void);
 
-void vApplicationStackOverflowHook(void);
-void vApplicationMallocFailedHook(void);
-void vApplicationTickHook(void);
-static void DisplayTask(void *pvParameters);
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name);
 
 
 /****
  * Variables
  ******************************************************************************/
-static TaskHandle_t cliTaskHandle = NULL;      //!< CLI task handle
-static TaskHandle_t daemonTaskHandle = NULL;   //!< Daemon task handle
-static TaskHandle_t wifiTaskHandle = NULL;     //!< Wifi task handle
 static TaskHandle_t uiTaskHandle = NULL;       //!< UI task handle
 static TaskHandle_t controlTaskHandle = NULL;  //!< Control task handle
-static TaskHandle_t SHTC3TaskHandle = NULL;  //!< Control task handle
-static TaskHandle_t displayTaskHandle = NULL;
 
 char bufferPrint[64];  ///< Buffer for daemon task
 
@@ -71,6 +74,7 @@ int main(void)
 {
     /* Initialize the board. */
     system_init();		//we set up user pin and LED right here
+    sleepmgr_init();    // Before any driver takes a sleep lock
     /* Initialize the UART console. */
     InitializeSerialConsole();
     // Initialize trace capabilities
@@ -95,6 +99,9 @@ void vApplicationDaemonTaskStartupHook(void)
 
     // Initialize HW that needs FreeRTOS Initialization
     SerialConsoleWriteString("\r\n\r\nInitialize HW...\r\n");
+    if (ExecInit() != ERROR_NONE) {
+        SerialConsoleWriteString("Executor initialization failed!\r\n");
+    }
     if (I2cInitializeDriver() != STATUS_OK) {	//the I2C driver only initialize right here, so if you initialize anything that needs the I2C communication 
         SerialConsoleWriteString("Error initializing I2C Driver!\r\n");
     } else {
@@ -106,94 +113,79 @@ void vApplicationDaemonTaskStartupHook(void)
 	  SerialConsoleWriteString("SSD1306 Successfully Initialized!\r\n");
 
   }
+    if (BuzzerInit() != ERROR_NONE) {
+        SerialConsoleWriteString("Buzzer initialization failed!\r\n");
+    }
+    if (InputInit() != ERROR_NONE) {
+        SerialConsoleWriteString("Lid inputs initialization failed!\r\n");
+    }
+    if (PowerInit() != ERROR_NONE) {
+        SerialConsoleWriteString("Tickless idle initialization failed!\r\n");
+    }
+    if (AcqInit() != ERROR_NONE) {
+        SerialConsoleWriteString("Acquisition initialization failed!\r\n");
+    }
+    if (CpuStatsInit() != ERROR_NONE) {
+        SerialConsoleWriteString("CPU usage window initialization failed!\r\n");
+    }
     StartTasks();
+    if (StackMonInit() != ERROR_NONE) {
+        SerialConsoleWriteString("Stack monitor initialization failed!\r\n");
+    }
+    StackMon_Info stackInfo;
+    StackMonGetInfo(&stackInfo);
+    if (stackInfo.overflow[0] != '\0') {
+        snprintf(bufferPrint, 64, "Stack overflow of %s before the reset!\r\n", stackInfo.overflow);
+        SerialConsoleWriteString(bufferPrint);
+    }
 
-    vTaskSuspend(daemonTaskHandle);
+    // Return to let the timer service run: the lid debounce timers and the executor jobs are serviced by this task
 }
 
 /**
  * function          StartTasks
  * @brief            Initialize application tasks
- * @details
+ * @details          Tasks and queues are listed in TaskTable/TaskTable.h and statically allocated. Prints the RAM each
+ *                   one takes, followed by the heap left for the drivers
  * @param[in]        None
  * @return           None
  */
 static void StartTasks(void)
 {
-    snprintf(bufferPrint, 64, "Heap before starting tasks: %d\r\n", xPortGetFreeHeapSize());
-    SerialConsoleWriteString(bufferPrint);
-
-    // Initialize Tasks here
-	
-	port_pin_set_output_level(PIN_PA11, false);		//buzzer stop buzz
+    TaskTable_Ram ram[TASK_ID_MAX + QUEUE_ID_MAX + 2];
+    uint8_t rows = TaskTableGetRam(ram, sizeof(ram) / sizeof(ram[0]));
 
-//    if (xTaskCreate(vCommandConsoleTask, "CLI_TASK", CLI_TASK_SIZE, NULL, CLI_PRIORITY, &cliTaskHandle) != pdPASS) {
-//       SerialConsoleWriteString("ERR: CLI task could not be initialized!\r\n");
-//    }
-
-   snprintf(bufferPrint, 64, "Heap after starting CLI: %d\r\n", xPortGetFreeHeapSize());
-    SerialConsoleWriteString(bufferPrint);
+    if (TaskTableStart() != ERROR_NONE) {
+        SerialConsoleWriteString("ERR: Tasks could not be initialized!\r\n");
+    }
 
-    if (xTaskCreate(vWifiTask, "WIFI_TASK", WIFI_TASK_SIZE, NULL, WIFI_PRIORITY, &wifiTaskHandle) != pdPASS) {
-       SerialConsoleWriteString("ERR: WIFI task could not be initialized!\r\n");
+    SerialConsoleWriteString("Static RAM (stack or storage + control):\r\n");
+    for (uint8_t i = 0; i < rows; i++) {
+        snprintf(bufferPrint, 64, "  %-10s %5u + %3u\r\n", ram[i].name, ram[i].stackBytes, ram[i].controlBytes);
+        SerialConsoleWriteString(bufferPrint);
     }
-    snprintf(bufferPrint, 64, "Heap after starting WIFI: %d\r\n", xPortGetFreeHeapSize());
+    snprintf(bufferPrint, 64, "  total      %5lu of %u\r\n", TaskTableGetRamTotal(), TASK_TABLE_RAM_BUDGET);
+    SerialConsoleWriteString(bufferPrint);
+    snprintf(bufferPrint, 64, "Heap after starting tasks: %d\r\n", xPortGetFreeHeapSize());
     SerialConsoleWriteString(bufferPrint);
-	
-	//create I2c task, this is the IMU task, we are not using IMU, so comment this code
-//	if (xTaskCreate(vI2cTask, "vI2cTask", vI2C_TASK_SIZE, NULL, vI2C_PRIORITY, NULL) != pdPASS) {
-//	    SerialConsoleWriteString("ERR: I2c task could not be initialized!\r\n");
-//	}
-	snprintf(bufferPrint, 64, "Heap after starting I2C: %d\r\n", xPortGetFreeHeapSize());
-	SerialConsoleWriteString(bufferPrint);
-	
-	// create a SHTC3 TASK //
-	if (xTaskCreate(SHTC3Task, "SHTC3 TASK", SHTC3_TASK_SIZE, NULL, SHTC3_PRIORITY, &SHTC3TaskHandle) != pdPASS) {
-		SerialConsoleWriteString("ERR: SHTC3 TASK could not be initialized!\r\n");
-	}
-	snprintf(bufferPrint, 64, "Heap after starting SHTC3 Task : %d\r\n", xPortGetFreeHeapSize());
-	SerialConsoleWriteString(bufferPrint);
-	// SHTC3 TASK //
-	
-	
-//	if (xTaskCreate(DisplayTask, "DISPLAY_TASK", 512, NULL, 5, &displayTaskHandle) != pdPASS) {	//DISPLAY_TASK_STACK_SIZE 512
-//		SerialConsoleWriteString("ERR: Display task could not be initialized!\r\n");
-//	}
-	
-
-
-}
-
-void vApplicationMallocFailedHook(void)
-{
-    SerialConsoleWriteString("Error on memory allocation on FREERTOS!\r\n");
-    while (1)
-        ;
 }
 
-void vApplicationStackOverflowHook(void)
+/**
+ * @brief    Logs the pool that ran out. The allocation returns NULL to its caller, which handles it
+ */
+void vApplicationPoolFailedHook(const char *pool, size_t size)
 {
-    SerialConsoleWriteString("Error on stack overflow on FREERTOS!\r\n");
-    while (1)
-        ;
+    char message[48];
+    snprintf(message, sizeof(message), "Memory pool %s exhausted (%u bytes)!\r\n", pool, (unsigned)size);
+    SerialConsoleWriteString(message);
 }
 
-#include "MCHP_ATWx.h"
-void vApplicationTickHook(void)
+/**
+ * @brief    Records the task in the stack monitor and resets. The console is not served from the context switch, so
+ *           the task is reported on the next boot
+ */
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name)
 {
-    SysTick_Handler_MQTT();
+    StackMonOverflow(name);
+    system_reset();
 }
-
-static void DisplayTask(void *pvParameters) {
-	while (1) {
-		SerialConsoleWriteString("Updating display...\r\n");
-		SSD1306_Fill(SSD1306_COLOR_BLACK);
-		SSD1306_GotoXY(10, 25);
-		SSD1306_Puts("MagicPB", &Font_11x18, SSD1306_COLOR_WHITE);
-
-		// Update the entire buffer for consistency
-		SSD1306_UpdateScreen();
-
-		vTaskDelay(1000);  // Update every second
-	}
-}
\ No newline at end of file
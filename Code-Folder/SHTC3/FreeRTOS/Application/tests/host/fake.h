@@ -0,0 +1,84 @@
+/**************************************************************************/ /**
+ * @file      fake.h
+ * @brief     State of the host fakes of the kernel, the ASF drivers and the application services
+ * @details   The code under test runs on one thread. A task that blocks (vTaskDelay(), xTaskNotifyWait()) first runs
+ *            fakeOnBlock, which the I2C based checks point at FakeI2cRun() so the bus completes its transfers as the
+ *            interrupts would, then advances the tick by the time it would have slept.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_FAKE_H_
+#define HOST_FAKE_H_
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <FreeRTOS.h>
+#include <asf.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Buzzer/Buzzer.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define FAKE_I2C_LOG_MAX 64     ///< Transfers kept in fakeI2cLog
+#define FAKE_I2C_DATA_MAX 1100  ///< Bytes kept per logged write, a full SSD1306 frame fits
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// One transfer the I2C master was asked for
+typedef struct Fake_I2c_Packet {
+    uint16_t address;
+    bool read;
+    uint16_t length;
+    uint8_t data[FAKE_I2C_DATA_MAX];  ///< Bytes written. Unused for reads
+} Fake_I2c_Packet;
+
+/// Fills the buffer of a read from the device at address
+typedef void (*Fake_I2c_Responder)(uint16_t address, uint8_t *data, uint16_t length);
+
+/******************************************************************************
+ * Kernel, fake_rtos.c
+ ******************************************************************************/
+extern TickType_t fakeTick;          ///< xTaskGetTickCount()
+extern TaskHandle_t fakeCurrentTask;  ///< xTaskGetCurrentTaskHandle()
+extern int fakeCriticalNesting;      ///< taskENTER_CRITICAL() depth, 0 outside
+extern int fakeSuspendNesting;       ///< vTaskSuspendAll() depth, 0 outside
+extern void (*fakeOnBlock)(void);    ///< Run each time a task would block, may be NULL
+
+uint32_t FakeNotifyTake(TaskHandle_t task);
+uint32_t FakeSemaphoreCount(SemaphoreHandle_t semaphore);
+
+/******************************************************************************
+ * I2C master and RTC, fake_asf.c
+ ******************************************************************************/
+extern Fake_I2c_Packet fakeI2cLog[FAKE_I2C_LOG_MAX];
+extern uint16_t fakeI2cLogCount;              ///< Transfers logged. Reset it to start a new log
+extern enum status_code fakeI2cStartStatus;   ///< Returned by the next packet jobs, STATUS_OK by default
+extern bool fakeI2cNack;                      ///< Complete the transfers with the error callback
+extern Fake_I2c_Responder fakeI2cResponder;   ///< Fills the reads, zeros if NULL
+extern int fakeSleepLocks;                    ///< sleepmgr_lock_mode() calls not unlocked yet
+
+bool FakeI2cPending(void);
+bool FakeI2cStep(void);
+void FakeI2cRun(void);
+
+extern struct rtc_calendar_time fakeRtcTime;
+extern struct rtc_calendar_alarm_time fakeRtcAlarm;
+extern uint32_t fakeNvmWrites;  ///< Rows written
+
+void FakeRtcFireAlarm(void);
+
+/******************************************************************************
+ * Application services, fake_app.c
+ ******************************************************************************/
+extern const Buzzer_Pattern *fakeBuzzerLast;  ///< Last pattern posted to BuzzerPlay()
+extern uint32_t fakeBuzzerPlays;
+extern char fakeConsoleLast[96];              ///< Last string written to the console
+extern uint32_t fakeConsoleWrites;
+
+#endif /* HOST_FAKE_H_ */
@@ -0,0 +1,61 @@
+/**************************************************************************/ /**
+ * @file      fake_app.c
+ * @brief     Host fake of the buzzer and the serial console. Both only record what they were asked to do
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Buzzer/Buzzer.h"
+#include "SerialConsole.h"
+#include "fake.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+const Buzzer_Pattern buzzerPatternFire = {"fire", 2700, 50, 250, 250, 0, BUZZER_PRIORITY_ALARM};
+const Buzzer_Pattern buzzerPatternPill = {"pill", 2000, 50, 100, 900, 0, BUZZER_PRIORITY_REMINDER};
+const Buzzer_Pattern buzzerPatternDamage = {"damage", 1500, 50, 80, 0, 1, BUZZER_PRIORITY_CHIRP};
+
+const Buzzer_Pattern *fakeBuzzerLast = NULL;
+uint32_t fakeBuzzerPlays = 0;
+char fakeConsoleLast[96];
+uint32_t fakeConsoleWrites = 0;
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+int32_t BuzzerPlay(const Buzzer_Pattern *pattern)
+{
+    fakeBuzzerLast = pattern;
+    fakeBuzzerPlays++;
+    return 0;
+}
+
+void BuzzerStop(uint8_t priority)
+{
+    fakeBuzzerLast = NULL;
+}
+
+void SerialConsoleWriteString(const char *string)
+{
+    strncpy(fakeConsoleLast, string, sizeof(fakeConsoleLast) - 1);
+    fakeConsoleLast[sizeof(fakeConsoleLast) - 1] = '\0';
+    fakeConsoleWrites++;
+}
+
+void LogMessage(enum eDebugLogLevels level, const char *format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    vsnprintf(fakeConsoleLast, sizeof(fakeConsoleLast), format, ap);
+    va_end(ap);
+    fakeConsoleWrites++;
+}
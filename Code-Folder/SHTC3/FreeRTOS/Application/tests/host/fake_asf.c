@@ -0,0 +1,414 @@
+/**************************************************************************/ /**
+ * @file      fake_asf.c
+ * @brief     Host fake of the ASF drivers called by the modules under test
+ * @details   The I2C master logs every packet job and holds it until FakeI2cStep(), which completes it through the
+ *            callbacks I2cDriver.c registered, as the SERCOM interrupt would. No DMA channel can be allocated, so the
+ *            driver runs every transfer on its interrupt path. The RTC calendar is a settable time with one alarm, and
+ *            the NVM writes straight into the flash row variable of the caller.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <asf.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "fake.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+FakeSysTick fakeSysTick = {.LOAD = 47999, .VAL = 47999};
+FakeScb fakeScb;
+Sercom fakeSercom0;
+Rtc fakeRtc;
+
+Fake_I2c_Packet fakeI2cLog[FAKE_I2C_LOG_MAX];
+uint16_t fakeI2cLogCount = 0;
+enum status_code fakeI2cStartStatus = STATUS_OK;
+bool fakeI2cNack = false;
+Fake_I2c_Responder fakeI2cResponder = NULL;
+int fakeSleepLocks = 0;
+
+struct rtc_calendar_time fakeRtcTime;
+struct rtc_calendar_alarm_time fakeRtcAlarm;
+uint32_t fakeNvmWrites = 0;
+
+struct rtc_module *_rtc_instance[RTC_INST_NUM];
+
+static struct i2c_master_module *fakeI2cModule;
+static i2c_master_callback_t fakeI2cCallbacks[3];
+static struct i2c_master_packet fakeI2cJob;  ///< Packet on the bus
+static bool fakeI2cJobRead;
+static bool fakeI2cJobPending = false;
+
+/******************************************************************************
+ * Core
+ ******************************************************************************/
+void sleepmgr_lock_mode(enum sleepmgr_mode mode)
+{
+    fakeSleepLocks++;
+}
+
+void sleepmgr_unlock_mode(enum sleepmgr_mode mode)
+{
+    fakeSleepLocks--;
+}
+
+/******************************************************************************
+ * I2C master
+ ******************************************************************************/
+
+/**
+ * @fn			static enum status_code FakeI2cStart(struct i2c_master_packet *const packet, bool read)
+ * @brief       Logs a packet job and keeps it on the bus until FakeI2cStep()
+ */
+static enum status_code FakeI2cStart(struct i2c_master_packet *const packet, bool read)
+{
+    if (fakeI2cStartStatus != STATUS_OK) {
+        return fakeI2cStartStatus;
+    }
+    configASSERT(!fakeI2cJobPending);
+
+    if (fakeI2cLogCount < FAKE_I2C_LOG_MAX) {
+        Fake_I2c_Packet *entry = &fakeI2cLog[fakeI2cLogCount++];
+        entry->address = packet->address;
+        entry->read = read;
+        entry->length = packet->data_length;
+        if (!read) {
+            configASSERT(packet->data_length <= FAKE_I2C_DATA_MAX);
+            memcpy(entry->data, packet->data, packet->data_length);
+        }
+    }
+    fakeI2cJob = *packet;
+    fakeI2cJobRead = read;
+    fakeI2cJobPending = true;
+    return STATUS_OK;
+}
+
+/**
+ * @fn			bool FakeI2cPending(void)
+ * @brief       Tells if a packet job is on the bus
+ */
+bool FakeI2cPending(void)
+{
+    return fakeI2cJobPending;
+}
+
+/**
+ * @fn			bool FakeI2cStep(void)
+ * @brief       Completes the packet job on the bus, as the SERCOM interrupt would
+ * @details     A read gets its bytes from fakeI2cResponder. With fakeI2cNack set the job ends with the error callback
+ * @return      Returns false if no job was on the bus
+ */
+bool FakeI2cStep(void)
+{
+    if (!fakeI2cJobPending) {
+        return false;
+    }
+    fakeI2cJobPending = false;
+
+    if (fakeI2cNack) {
+        fakeI2cCallbacks[I2C_MASTER_CALLBACK_ERROR](fakeI2cModule);
+        return true;
+    }
+    if (fakeI2cJobRead) {
+        if (fakeI2cResponder != NULL) {
+            fakeI2cResponder(fakeI2cJob.address, fakeI2cJob.data, fakeI2cJob.data_length);
+        } else {
+            memset(fakeI2cJob.data, 0, fakeI2cJob.data_length);
+        }
+        fakeI2cCallbacks[I2C_MASTER_CALLBACK_READ_COMPLETE](fakeI2cModule);
+    } else {
+        fakeI2cCallbacks[I2C_MASTER_CALLBACK_WRITE_COMPLETE](fakeI2cModule);
+    }
+    return true;
+}
+
+/**
+ * @fn			void FakeI2cRun(void)
+ * @brief       Completes packet jobs until the bus is idle
+ */
+void FakeI2cRun(void)
+{
+    while (FakeI2cStep()) {
+    }
+}
+
+void i2c_master_get_config_defaults(struct i2c_master_config *const config)
+{
+    memset(config, 0, sizeof(*config));
+}
+
+enum status_code i2c_master_init(struct i2c_master_module *const module, Sercom *const hw,
+                                 const struct i2c_master_config *const config)
+{
+    module->hw = hw;
+    fakeI2cModule = module;
+    return STATUS_OK;
+}
+
+void i2c_master_reset(struct i2c_master_module *const module)
+{
+    fakeI2cJobPending = false;
+}
+
+void i2c_master_enable(const struct i2c_master_module *const module)
+{
+}
+
+bool i2c_master_is_syncing(const struct i2c_master_module *const module)
+{
+    return false;
+}
+
+void i2c_master_register_callback(struct i2c_master_module *const module, const i2c_master_callback_t callback,
+                                  enum i2c_master_callback callback_type)
+{
+    fakeI2cCallbacks[callback_type] = callback;
+}
+
+void i2c_master_enable_callback(struct i2c_master_module *const module, enum i2c_master_callback callback_type)
+{
+}
+
+enum status_code i2c_master_write_packet_job(struct i2c_master_module *const module,
+                                             struct i2c_master_packet *const packet)
+{
+    return FakeI2cStart(packet, false);
+}
+
+enum status_code i2c_master_read_packet_job(struct i2c_master_module *const module,
+                                            struct i2c_master_packet *const packet)
+{
+    return FakeI2cStart(packet, true);
+}
+
+void i2c_master_dma_set_transfer(struct i2c_master_module *const module, uint16_t addr, uint8_t length,
+                                 enum i2c_transfer_direction direction)
+{
+}
+
+void _i2c_master_interrupt_handler(uint8_t instance)
+{
+}
+
+void _sercom_set_handler(const uint8_t instance_index, const sercom_handler_t interrupt_handler)
+{
+}
+
+uint8_t _sercom_get_sercom_inst_index(Sercom *const sercom_instance)
+{
+    return 0;
+}
+
+/******************************************************************************
+ * DMA
+ ******************************************************************************/
+void dma_get_config_defaults(struct dma_resource_config *config)
+{
+    memset(config, 0, sizeof(*config));
+}
+
+enum status_code dma_allocate(struct dma_resource *resource, struct dma_resource_config *config)
+{
+    return STATUS_ERR_NOT_FOUND;
+}
+
+void dma_register_callback(struct dma_resource *resource, dma_callback_t callback, enum dma_callback_type type)
+{
+}
+
+void dma_enable_callback(struct dma_resource *resource, enum dma_callback_type type)
+{
+}
+
+void dma_descriptor_get_config_defaults(struct dma_descriptor_config *config)
+{
+    memset(config, 0, sizeof(*config));
+}
+
+void dma_descriptor_create(DmacDescriptor *descriptor, struct dma_descriptor_config *config)
+{
+}
+
+enum status_code dma_update_descriptor(struct dma_resource *resource, DmacDescriptor *descriptor)
+{
+    return STATUS_OK;
+}
+
+enum status_code dma_start_transfer_job(struct dma_resource *resource)
+{
+    return STATUS_ERR_IO;
+}
+
+void dma_abort_job(struct dma_resource *resource)
+{
+}
+
+/******************************************************************************
+ * Clocks
+ ******************************************************************************/
+uint32_t system_gclk_gen_get_hz(const uint8_t generator)
+{
+    return 48000000UL;
+}
+
+void system_apb_clock_set_mask(const enum system_clock_apb_bus bus, const uint32_t mask)
+{
+}
+
+bool system_gclk_chan_is_enabled(const uint8_t channel)
+{
+    return true;
+}
+
+void system_gclk_chan_get_config_defaults(struct system_gclk_chan_config *const config)
+{
+    config->source_generator = GCLK_GENERATOR_0;
+}
+
+void system_gclk_chan_set_config(const uint8_t channel, struct system_gclk_chan_config *const config)
+{
+}
+
+void system_gclk_chan_enable(const uint8_t channel)
+{
+}
+
+/******************************************************************************
+ * RTC calendar
+ ******************************************************************************/
+void rtc_calendar_get_config_defaults(struct rtc_calendar_config *const config)
+{
+    memset(config, 0, sizeof(*config));
+    config->year_init_value = 2000;
+}
+
+enum status_code rtc_calendar_init(struct rtc_module *const module, Rtc *const hw,
+                                   const struct rtc_calendar_config *const config)
+{
+    memset(module, 0, sizeof(*module));
+    module->hw = hw;
+    module->clock_24h = config->clock_24h;
+    module->year_init_value = config->year_init_value;
+    _rtc_instance[0] = module;
+
+    rtc_calendar_get_time_defaults(&fakeRtcTime);
+    fakeRtcTime.year = config->year_init_value;
+    fakeRtcAlarm = config->alarm[RTC_CALENDAR_ALARM_0];
+    return STATUS_OK;
+}
+
+void rtc_calendar_enable(struct rtc_module *const module)
+{
+    module->hw->MODE2.CTRL.reg |= RTC_MODE2_CTRL_ENABLE;
+    module->hw->MODE2.CTRL.bit.MODE = 2;
+}
+
+void rtc_calendar_get_time_defaults(struct rtc_calendar_time *const time)
+{
+    memset(time, 0, sizeof(*time));
+    time->day = 1;
+    time->month = 1;
+    time->year = 2000;
+}
+
+void rtc_calendar_set_time(struct rtc_module *const module, const struct rtc_calendar_time *const time)
+{
+    fakeRtcTime = *time;
+}
+
+void rtc_calendar_get_time(struct rtc_module *const module, struct rtc_calendar_time *const time)
+{
+    *time = fakeRtcTime;
+}
+
+enum status_code rtc_calendar_set_alarm(struct rtc_module *const module,
+                                        const struct rtc_calendar_alarm_time *const alarm,
+                                        const enum rtc_calendar_alarm alarm_index)
+{
+    fakeRtcAlarm = *alarm;
+    return STATUS_OK;
+}
+
+enum status_code rtc_calendar_register_callback(struct rtc_module *const module, rtc_calendar_callback_t callback,
+                                                enum rtc_calendar_callback callback_type)
+{
+    module->callbacks[callback_type] = callback;
+    return STATUS_OK;
+}
+
+void rtc_calendar_enable_callback(struct rtc_module *const module, enum rtc_calendar_callback callback_type)
+{
+}
+
+/**
+ * @fn			void FakeRtcFireAlarm(void)
+ * @brief       Runs the alarm 0 callback, as the RTC interrupt would on a match
+ */
+void FakeRtcFireAlarm(void)
+{
+    struct rtc_module *module = _rtc_instance[0];
+
+    if (module != NULL && module->callbacks[RTC_CALENDAR_CALLBACK_ALARM_0] != NULL) {
+        module->callbacks[RTC_CALENDAR_CALLBACK_ALARM_0]();
+    }
+}
+
+/******************************************************************************
+ * NVM
+ ******************************************************************************/
+
+/**
+ * @fn			static uint8_t *FakeNvmRow(uint32_t address, size_t length)
+ * @brief       Makes the flash variable at address writable. It sits in read-only data, as it would in flash
+ */
+static uint8_t *FakeNvmRow(uint32_t address, size_t length)
+{
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)address & ~(page - 1);
+    uintptr_t end = ((uintptr_t)address + length + page - 1) & ~(page - 1);
+
+    configASSERT(mprotect((void *)start, end - start, PROT_READ | PROT_WRITE) == 0);
+    return (uint8_t *)(uintptr_t)address;
+}
+
+void nvm_get_config_defaults(struct nvm_config *const config)
+{
+    config->manual_page_write = true;
+}
+
+enum status_code nvm_set_config(const struct nvm_config *const config)
+{
+    return STATUS_OK;
+}
+
+enum status_code nvm_erase_row(const uint32_t row_address)
+{
+    if (row_address % (NVMCTRL_PAGE_SIZE * NVMCTRL_ROW_PAGES) != 0) {
+        return STATUS_ERR_BAD_ADDRESS;
+    }
+    memset(FakeNvmRow(row_address, NVMCTRL_PAGE_SIZE * NVMCTRL_ROW_PAGES), 0xFF, NVMCTRL_PAGE_SIZE * NVMCTRL_ROW_PAGES);
+    return STATUS_OK;
+}
+
+enum status_code nvm_write_buffer(const uint32_t destination_address, const uint8_t *buffer, uint16_t length)
+{
+    if (length > NVMCTRL_PAGE_SIZE) {
+        return STATUS_ERR_BAD_ADDRESS;
+    }
+    memcpy(FakeNvmRow(destination_address, length), buffer, length);
+    fakeNvmWrites++;
+    return STATUS_OK;
+}
+
+bool nvm_is_ready(void)
+{
+    return true;
+}
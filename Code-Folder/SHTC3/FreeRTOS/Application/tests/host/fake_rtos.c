@@ -0,0 +1,246 @@
+/**************************************************************************/ /**
+ * @file      fake_rtos.c
+ * @brief     Host fake of the FreeRTOS calls made by the modules under test
+ * @details   One tick per millisecond, as configTICK_RATE_HZ. Task notifications are kept per task handle, semaphores
+ *            count their gives in their static buffer, and blocking calls advance the tick instead of switching task.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <semphr.h>
+#include <string.h>
+#include <task.h>
+
+#include "fake.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define FAKE_NOTIFY_TASKS 8  ///< Tasks with a notification value
+
+/******************************************************************************
+ * Structures and Enumerations
+ ******************************************************************************/
+/// Notification value of one task
+typedef struct Fake_Notify {
+    TaskHandle_t task;
+    uint32_t value;
+    bool pending;
+} Fake_Notify;
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static StaticTask_t fakeMainTask;
+
+TickType_t fakeTick = 0;
+TaskHandle_t fakeCurrentTask = &fakeMainTask;
+int fakeCriticalNesting = 0;
+int fakeSuspendNesting = 0;
+void (*fakeOnBlock)(void) = NULL;
+
+static Fake_Notify fakeNotify[FAKE_NOTIFY_TASKS];
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+
+/**
+ * @fn			static Fake_Notify *FakeNotifyFind(TaskHandle_t task)
+ * @brief       Returns the notification value of a task, taking a free entry the first time
+ */
+static Fake_Notify *FakeNotifyFind(TaskHandle_t task)
+{
+    for (uint8_t i = 0; i < FAKE_NOTIFY_TASKS; i++) {
+        if (fakeNotify[i].task == task) {
+            return &fakeNotify[i];
+        }
+    }
+    for (uint8_t i = 0; i < FAKE_NOTIFY_TASKS; i++) {
+        if (fakeNotify[i].task == NULL) {
+            fakeNotify[i].task = task;
+            return &fakeNotify[i];
+        }
+    }
+    configASSERT(0);
+    return NULL;
+}
+
+/**
+ * @fn			uint32_t FakeNotifyTake(TaskHandle_t task)
+ * @brief       Returns the notification bits set on a task since the last call, and clears them
+ */
+uint32_t FakeNotifyTake(TaskHandle_t task)
+{
+    Fake_Notify *notify = FakeNotifyFind(task);
+    uint32_t value = notify->value;
+
+    notify->value = 0;
+    notify->pending = false;
+    return value;
+}
+
+/**
+ * @fn			uint32_t FakeSemaphoreCount(SemaphoreHandle_t semaphore)
+ * @brief       Returns the gives of a semaphore not taken yet
+ */
+uint32_t FakeSemaphoreCount(SemaphoreHandle_t semaphore)
+{
+    return *(uint32_t *)semaphore;
+}
+
+void FakeEnterCritical(void)
+{
+    fakeCriticalNesting++;
+}
+
+void FakeExitCritical(void)
+{
+    configASSERT(fakeCriticalNesting > 0);
+    fakeCriticalNesting--;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return fakeTick;
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return fakeTick;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return fakeCurrentTask;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction)
+{
+    Fake_Notify *notify = FakeNotifyFind(xTaskToNotify);
+
+    configASSERT(eAction == eSetBits);
+    notify->value |= ulValue;
+    notify->pending = true;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction,
+                              BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (pxHigherPriorityTaskWoken != NULL) {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+    return xTaskNotify(xTaskToNotify, ulValue, eAction);
+}
+
+/**
+ * @fn			BaseType_t xTaskNotifyWait(...)
+ * @brief       Lets the fakes run, then returns the notification of the current task, or times out at once
+ */
+BaseType_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue,
+                           TickType_t xTicksToWait)
+{
+    Fake_Notify *notify = FakeNotifyFind(fakeCurrentTask);
+
+    notify->value &= ~ulBitsToClearOnEntry;
+    if (!notify->pending && fakeOnBlock != NULL) {
+        fakeOnBlock();
+    }
+    if (!notify->pending) {
+        fakeTick += (xTicksToWait == portMAX_DELAY) ? 1 : xTicksToWait;
+        return pdFALSE;
+    }
+    if (pulNotificationValue != NULL) {
+        *pulNotificationValue = notify->value;
+    }
+    notify->value &= ~ulBitsToClearOnExit;
+    notify->pending = false;
+    return pdTRUE;
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    if (fakeOnBlock != NULL) {
+        fakeOnBlock();
+    }
+    fakeTick += xTicksToDelay;
+}
+
+void vTaskSuspend(TaskHandle_t xTaskToSuspend)
+{
+}
+
+void vTaskSuspendAll(void)
+{
+    fakeSuspendNesting++;
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    configASSERT(fakeSuspendNesting > 0);
+    fakeSuspendNesting--;
+    return pdFALSE;
+}
+
+void vTaskSetTimeOutState(TimeOut_t *const pxTimeOut)
+{
+    pxTimeOut->xOverflowCount = 0;
+    pxTimeOut->xTimeOnEntering = fakeTick;
+}
+
+BaseType_t xTaskCheckForTimeOut(TimeOut_t *const pxTimeOut, TickType_t *const pxTicksToWait)
+{
+    TickType_t elapsed = fakeTick - pxTimeOut->xTimeOnEntering;
+
+    if (*pxTicksToWait == portMAX_DELAY) {
+        return pdFALSE;
+    }
+    if (elapsed >= *pxTicksToWait) {
+        *pxTicksToWait = 0;
+        return pdTRUE;
+    }
+    *pxTicksToWait -= elapsed;
+    pxTimeOut->xTimeOnEntering = fakeTick;
+    return pdFALSE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *pxMutexBuffer)
+{
+    memset(pxMutexBuffer, 0, sizeof(*pxMutexBuffer));
+    *(uint32_t *)pxMutexBuffer = 1;
+    return pxMutexBuffer;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *pxSemaphoreBuffer)
+{
+    memset(pxSemaphoreBuffer, 0, sizeof(*pxSemaphoreBuffer));
+    return pxSemaphoreBuffer;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime)
+{
+    uint32_t *count = xSemaphore;
+
+    if (*count == 0) {
+        fakeTick += (xBlockTime == portMAX_DELAY) ? 0 : xBlockTime;
+        configASSERT(xBlockTime != portMAX_DELAY);  // Would deadlock the only thread
+        return pdFALSE;
+    }
+    (*count)--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+    (*(uint32_t *)xSemaphore)++;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t xSemaphore, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    return xSemaphoreGive(xSemaphore);
+}
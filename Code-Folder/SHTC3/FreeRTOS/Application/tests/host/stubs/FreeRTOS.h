@@ -0,0 +1,106 @@
+/**************************************************************************/ /**
+ * @file      FreeRTOS.h
+ * @brief     Host stand-in for the FreeRTOS kernel headers. Types and macros of the Cortex-M0 port, with the kernel
+ *            calls served by fake_rtos.c
+ * @details   The application FreeRTOSConfig.h is included as it is, so the tick rate, the heap size and the task name
+ *            length match the firmware. Critical sections only count their nesting, the code under test runs on one
+ *            thread.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_FREERTOS_H_
+#define HOST_FREERTOS_H_
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ * Port types, as portmacro.h of the ARM_CM0 port
+ ******************************************************************************/
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t StackType_t;
+#define portTickType TickType_t
+
+#include "FreeRTOSConfig.h"
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT 8
+#define portBYTE_ALIGNMENT_MASK 0x0007
+#define portYIELD_FROM_ISR(x) ((void)(x))
+#define taskYIELD()
+#define taskDISABLE_INTERRUPTS()
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000))
+
+/// A failed kernel assertion ends the test run instead of spinning
+#undef configASSERT
+#define configASSERT(x)                                                            \
+    if ((x) == 0) {                                                                \
+        fprintf(stderr, "%s:%d: configASSERT(%s) failed\n", __FILE__, __LINE__, #x); \
+        abort();                                                                   \
+    }
+
+#ifndef traceMALLOC
+#define traceMALLOC(pvAddress, uiSize)
+#endif
+#ifndef traceFREE
+#define traceFREE(pvAddress, uiSize)
+#endif
+
+/******************************************************************************
+ * Kernel types
+ ******************************************************************************/
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+typedef void *QueueSetHandle_t;
+typedef void *SemaphoreHandle_t;
+typedef void *TimerHandle_t;
+
+typedef struct StaticTask_t {
+    void *dummy[22];
+} StaticTask_t;
+
+typedef struct StaticQueue_t {
+    void *dummy[20];
+} StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+typedef struct TimeOut_t {
+    BaseType_t xOverflowCount;
+    TickType_t xTimeOnEntering;
+} TimeOut_t;
+
+typedef enum eNotifyAction {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+/******************************************************************************
+ * Critical sections, see fake_rtos.c
+ ******************************************************************************/
+void FakeEnterCritical(void);
+void FakeExitCritical(void);
+
+#define taskENTER_CRITICAL() FakeEnterCritical()
+#define taskEXIT_CRITICAL() FakeExitCritical()
+#define taskENTER_CRITICAL_FROM_ISR() (FakeEnterCritical(), 0)
+#define taskEXIT_CRITICAL_FROM_ISR(x) ((void)(x), FakeExitCritical())
+
+#endif /* HOST_FREERTOS_H_ */
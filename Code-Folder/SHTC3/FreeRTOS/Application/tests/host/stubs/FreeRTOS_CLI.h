@@ -0,0 +1,15 @@
+/**************************************************************************/ /**
+ * @file      FreeRTOS_CLI.h
+ * @brief     Host stand-in for the FreeRTOS+CLI header, for the command prototypes of CliThread.h
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_FREERTOS_CLI_H_
+#define HOST_FREERTOS_CLI_H_
+
+#include "FreeRTOS.h"
+
+typedef BaseType_t (*pdCOMMAND_LINE_CALLBACK)(char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString);
+
+#endif /* HOST_FREERTOS_CLI_H_ */
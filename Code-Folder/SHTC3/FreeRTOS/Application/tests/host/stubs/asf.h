@@ -0,0 +1,364 @@
+/**************************************************************************/ /**
+ * @file      asf.h
+ * @brief     Host stand-in for the ASF headers used by the modules under test, served by fake_asf.c
+ * @details   Only the I2C master, DMA, RTC calendar, NVM and clock calls of those modules are declared. Peripheral
+ *            registers are plain structures in RAM, so the drivers read and write them as on the SAMD21.
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_ASF_H_
+#define HOST_ASF_H_
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/******************************************************************************
+ * Compiler and status codes
+ ******************************************************************************/
+#define COMPILER_ALIGNED(a) __attribute__((aligned(a)))
+#define WEAK __attribute__((weak))
+
+enum status_code {
+    STATUS_OK = 0x00,
+    STATUS_BUSY = 0x05,
+    STATUS_SUSPEND = 0x06,
+    STATUS_ERR_IO = 0x10,
+    STATUS_ERR_BAD_ADDRESS = 0x13,
+    STATUS_ERR_NOT_FOUND = 0x18,
+    STATUS_ERR_NO_MEMORY = 0x1E,
+};
+typedef enum status_code status_code_genare_t;
+
+#define ERR_INVALID_ARG (-8)
+
+/******************************************************************************
+ * Core registers
+ ******************************************************************************/
+typedef struct {
+    uint32_t LOAD;
+    uint32_t VAL;
+} FakeSysTick;
+
+typedef struct {
+    uint32_t ICSR;
+} FakeScb;
+
+extern FakeSysTick fakeSysTick;
+extern FakeScb fakeScb;
+#define SysTick (&fakeSysTick)
+#define SCB (&fakeScb)
+#define SCB_ICSR_PENDSTSET_Msk (1UL << 26)
+
+enum sleepmgr_mode {
+    SLEEPMGR_ACTIVE = 0,
+    SLEEPMGR_IDLE_0,
+    SLEEPMGR_IDLE_1,
+    SLEEPMGR_IDLE_2,
+    SLEEPMGR_STANDBY,
+};
+void sleepmgr_lock_mode(enum sleepmgr_mode mode);
+void sleepmgr_unlock_mode(enum sleepmgr_mode mode);
+
+/******************************************************************************
+ * SERCOM I2C master
+ ******************************************************************************/
+typedef struct {
+    uint32_t reg;
+} FakeReg;
+
+typedef struct {
+    FakeReg CTRLA;
+    FakeReg CTRLB;
+    FakeReg INTENCLR;
+    FakeReg INTENSET;
+    FakeReg INTFLAG;
+    FakeReg STATUS;
+    FakeReg ADDR;
+    FakeReg DATA;
+} SercomI2cm;
+
+typedef union {
+    SercomI2cm I2CM;
+} Sercom;
+
+extern Sercom fakeSercom0;
+#define SERCOM0 (&fakeSercom0)
+#define SERCOM0_DMAC_ID_TX 0x02
+
+#define SERCOM_I2CM_INTENCLR_MB (1UL << 0)
+#define SERCOM_I2CM_INTENCLR_ERROR (1UL << 7)
+#define SERCOM_I2CM_INTENSET_MB (1UL << 0)
+#define SERCOM_I2CM_INTENSET_ERROR (1UL << 7)
+#define SERCOM_I2CM_INTFLAG_MB (1UL << 0)
+#define SERCOM_I2CM_INTFLAG_ERROR (1UL << 7)
+#define SERCOM_I2CM_STATUS_BUSERR (1UL << 0)
+#define SERCOM_I2CM_STATUS_ARBLOST (1UL << 1)
+#define SERCOM_I2CM_STATUS_RXNACK (1UL << 2)
+#define SERCOM_I2CM_STATUS_BUSSTATE_Msk (3UL << 4)
+#define SERCOM_I2CM_STATUS_BUSSTATE(x) (((uint32_t)(x) << 4) & SERCOM_I2CM_STATUS_BUSSTATE_Msk)
+#define SERCOM_I2CM_CTRLB_CMD(x) (((uint32_t)(x) & 3) << 16)
+
+#define PINMUX_PA08C_SERCOM0_PAD0 0x00080002UL
+#define PINMUX_PA09C_SERCOM0_PAD1 0x00090002UL
+
+struct i2c_master_module {
+    Sercom *hw;
+};
+
+struct i2c_master_config {
+    uint32_t pinmux_pad0;
+    uint32_t pinmux_pad1;
+    uint16_t buffer_timeout;
+};
+
+struct i2c_master_packet {
+    uint16_t address;
+    uint16_t data_length;
+    uint8_t *data;
+};
+
+enum i2c_master_callback {
+    I2C_MASTER_CALLBACK_WRITE_COMPLETE = 0,
+    I2C_MASTER_CALLBACK_READ_COMPLETE,
+    I2C_MASTER_CALLBACK_ERROR,
+};
+
+enum i2c_transfer_direction {
+    I2C_TRANSFER_WRITE = 0,
+    I2C_TRANSFER_READ = 1,
+};
+
+typedef void (*i2c_master_callback_t)(struct i2c_master_module *const module);
+typedef void (*sercom_handler_t)(uint8_t instance);
+
+void i2c_master_get_config_defaults(struct i2c_master_config *const config);
+enum status_code i2c_master_init(struct i2c_master_module *const module, Sercom *const hw,
+                                 const struct i2c_master_config *const config);
+void i2c_master_reset(struct i2c_master_module *const module);
+void i2c_master_enable(const struct i2c_master_module *const module);
+bool i2c_master_is_syncing(const struct i2c_master_module *const module);
+void i2c_master_register_callback(struct i2c_master_module *const module, const i2c_master_callback_t callback,
+                                  enum i2c_master_callback callback_type);
+void i2c_master_enable_callback(struct i2c_master_module *const module, enum i2c_master_callback callback_type);
+enum status_code i2c_master_write_packet_job(struct i2c_master_module *const module,
+                                             struct i2c_master_packet *const packet);
+enum status_code i2c_master_read_packet_job(struct i2c_master_module *const module,
+                                            struct i2c_master_packet *const packet);
+void i2c_master_dma_set_transfer(struct i2c_master_module *const module, uint16_t addr, uint8_t length,
+                                 enum i2c_transfer_direction direction);
+void _i2c_master_interrupt_handler(uint8_t instance);
+void _sercom_set_handler(const uint8_t instance_index, const sercom_handler_t interrupt_handler);
+uint8_t _sercom_get_sercom_inst_index(Sercom *const sercom_instance);
+
+/******************************************************************************
+ * DMA
+ ******************************************************************************/
+typedef struct {
+    uint16_t BTCTRL;
+    uint16_t BTCNT;
+    uint32_t SRCADDR;
+    uint32_t DSTADDR;
+    uint32_t DESCADDR;
+} DmacDescriptor;
+
+enum dma_transfer_trigger_action {
+    DMA_TRIGGER_ACTION_BLOCK = 0,
+    DMA_TRIGGER_ACTION_BEAT = 2,
+    DMA_TRIGGER_ACTION_TRANSACTION = 3,
+};
+
+enum dma_block_action {
+    DMA_BLOCK_ACTION_NOACT = 0,
+    DMA_BLOCK_ACTION_INT,
+    DMA_BLOCK_ACTION_SUSPEND,
+    DMA_BLOCK_ACTION_BOTH,
+};
+
+enum dma_callback_type {
+    DMA_CALLBACK_TRANSFER_ERROR = 0,
+    DMA_CALLBACK_TRANSFER_DONE,
+    DMA_CALLBACK_CHANNEL_SUSPEND,
+};
+
+struct dma_resource;
+typedef void (*dma_callback_t)(struct dma_resource *const resource);
+
+struct dma_resource {
+    uint8_t channel_id;
+    DmacDescriptor *descriptor;
+    dma_callback_t callback[3];
+};
+
+struct dma_resource_config {
+    uint8_t peripheral_trigger;
+    enum dma_transfer_trigger_action trigger_action;
+};
+
+struct dma_descriptor_config {
+    bool dst_increment_enable;
+    enum dma_block_action block_action;
+    uint16_t block_transfer_count;
+    uint32_t source_address;
+    uint32_t destination_address;
+    uint32_t next_descriptor_address;
+};
+
+void dma_get_config_defaults(struct dma_resource_config *config);
+enum status_code dma_allocate(struct dma_resource *resource, struct dma_resource_config *config);
+void dma_register_callback(struct dma_resource *resource, dma_callback_t callback, enum dma_callback_type type);
+void dma_enable_callback(struct dma_resource *resource, enum dma_callback_type type);
+void dma_descriptor_get_config_defaults(struct dma_descriptor_config *config);
+void dma_descriptor_create(DmacDescriptor *descriptor, struct dma_descriptor_config *config);
+enum status_code dma_update_descriptor(struct dma_resource *resource, DmacDescriptor *descriptor);
+enum status_code dma_start_transfer_job(struct dma_resource *resource);
+void dma_abort_job(struct dma_resource *resource);
+
+/******************************************************************************
+ * Clocks
+ ******************************************************************************/
+enum gclk_generator {
+    GCLK_GENERATOR_0 = 0,
+    GCLK_GENERATOR_1,
+    GCLK_GENERATOR_2,
+};
+
+enum system_clock_apb_bus {
+    SYSTEM_CLOCK_APB_APBA = 0,
+    SYSTEM_CLOCK_APB_APBB,
+    SYSTEM_CLOCK_APB_APBC,
+};
+
+struct system_gclk_chan_config {
+    enum gclk_generator source_generator;
+};
+
+#define PM_APBAMASK_RTC (1UL << 5)
+#define RTC_GCLK_ID 4
+
+uint32_t system_gclk_gen_get_hz(const uint8_t generator);
+void system_apb_clock_set_mask(const enum system_clock_apb_bus bus, const uint32_t mask);
+bool system_gclk_chan_is_enabled(const uint8_t channel);
+void system_gclk_chan_get_config_defaults(struct system_gclk_chan_config *const config);
+void system_gclk_chan_set_config(const uint8_t channel, struct system_gclk_chan_config *const config);
+void system_gclk_chan_enable(const uint8_t channel);
+
+/******************************************************************************
+ * RTC calendar
+ ******************************************************************************/
+typedef union {
+    struct {
+        uint16_t SWRST : 1;
+        uint16_t ENABLE : 1;
+        uint16_t MODE : 2;
+        uint16_t : 12;
+    } bit;
+    uint16_t reg;
+} FakeRtcCtrl;
+
+typedef struct {
+    struct {
+        FakeRtcCtrl CTRL;
+    } MODE2;
+} Rtc;
+
+extern Rtc fakeRtc;
+#define RTC (&fakeRtc)
+#define RTC_INST_NUM 1
+#define RTC_MODE2_CTRL_ENABLE (1U << 1)
+
+enum rtc_calendar_prescaler {
+    RTC_CALENDAR_PRESCALER_DIV_1 = 0,
+    RTC_CALENDAR_PRESCALER_DIV_1024 = 10,
+};
+
+enum rtc_calendar_alarm {
+    RTC_CALENDAR_ALARM_0 = 0,
+    RTC_NUM_OF_ALARMS,
+};
+
+enum rtc_calendar_alarm_mask {
+    RTC_CALENDAR_ALARM_MASK_DISABLED = 0,
+    RTC_CALENDAR_ALARM_MASK_SEC,
+    RTC_CALENDAR_ALARM_MASK_MIN,
+    RTC_CALENDAR_ALARM_MASK_HOUR,
+    RTC_CALENDAR_ALARM_MASK_DAY,
+    RTC_CALENDAR_ALARM_MASK_MONTH,
+    RTC_CALENDAR_ALARM_MASK_YEAR,
+};
+
+enum rtc_calendar_callback {
+    RTC_CALENDAR_CALLBACK_ALARM_0 = 0,
+    RTC_CALENDAR_CALLBACK_OVERFLOW,
+};
+
+typedef void (*rtc_calendar_callback_t)(void);
+
+struct rtc_calendar_time {
+    uint8_t second;
+    uint8_t minute;
+    uint8_t hour;
+    bool pm;
+    uint8_t day;
+    uint8_t month;
+    uint16_t year;
+};
+
+struct rtc_calendar_alarm_time {
+    struct rtc_calendar_time time;
+    enum rtc_calendar_alarm_mask mask;
+};
+
+struct rtc_calendar_config {
+    enum rtc_calendar_prescaler prescaler;
+    bool clear_on_match;
+    bool continuously_update;
+    bool clock_24h;
+    uint16_t year_init_value;
+    struct rtc_calendar_alarm_time alarm[RTC_NUM_OF_ALARMS];
+};
+
+struct rtc_module {
+    Rtc *hw;
+    bool clock_24h;
+    bool continuously_update;
+    uint16_t year_init_value;
+    rtc_calendar_callback_t callbacks[2];
+};
+
+void rtc_calendar_get_config_defaults(struct rtc_calendar_config *const config);
+enum status_code rtc_calendar_init(struct rtc_module *const module, Rtc *const hw,
+                                   const struct rtc_calendar_config *const config);
+void rtc_calendar_enable(struct rtc_module *const module);
+void rtc_calendar_get_time_defaults(struct rtc_calendar_time *const time);
+void rtc_calendar_set_time(struct rtc_module *const module, const struct rtc_calendar_time *const time);
+void rtc_calendar_get_time(struct rtc_module *const module, struct rtc_calendar_time *const time);
+enum status_code rtc_calendar_set_alarm(struct rtc_module *const module,
+                                        const struct rtc_calendar_alarm_time *const alarm,
+                                        const enum rtc_calendar_alarm alarm_index);
+enum status_code rtc_calendar_register_callback(struct rtc_module *const module, rtc_calendar_callback_t callback,
+                                                enum rtc_calendar_callback callback_type);
+void rtc_calendar_enable_callback(struct rtc_module *const module, enum rtc_calendar_callback callback_type);
+
+/******************************************************************************
+ * NVM
+ ******************************************************************************/
+#define NVMCTRL_PAGE_SIZE 64
+#define NVMCTRL_ROW_PAGES 4
+
+struct nvm_config {
+    bool manual_page_write;
+};
+
+void nvm_get_config_defaults(struct nvm_config *const config);
+enum status_code nvm_set_config(const struct nvm_config *const config);
+enum status_code nvm_erase_row(const uint32_t row_address);
+enum status_code nvm_write_buffer(const uint32_t destination_address, const uint8_t *buffer, uint16_t length);
+bool nvm_is_ready(void);
+
+#endif /* HOST_ASF_H_ */
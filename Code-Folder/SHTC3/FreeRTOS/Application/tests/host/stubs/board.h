@@ -0,0 +1,13 @@
+/**************************************************************************/ /**
+ * @file      board.h
+ * @brief     Host stand-in, everything is declared in asf.h
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_BOARD_H_
+#define HOST_BOARD_H_
+
+#include "asf.h"
+
+#endif /* HOST_BOARD_H_ */
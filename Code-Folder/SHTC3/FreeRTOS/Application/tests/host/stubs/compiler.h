@@ -0,0 +1,13 @@
+/**************************************************************************/ /**
+ * @file      compiler.h
+ * @brief     Host stand-in, everything is declared in asf.h
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_COMPILER_H_
+#define HOST_COMPILER_H_
+
+#include "asf.h"
+
+#endif /* HOST_COMPILER_H_ */
@@ -0,0 +1,13 @@
+/**************************************************************************/ /**
+ * @file      dma.h
+ * @brief     Host stand-in, everything is declared in asf.h
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_DMA_H_
+#define HOST_DMA_H_
+
+#include "asf.h"
+
+#endif /* HOST_DMA_H_ */
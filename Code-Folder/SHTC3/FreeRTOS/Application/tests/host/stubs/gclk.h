@@ -0,0 +1,11 @@
+/**************************************************************************/ /**
+ * @file      gclk.h
+ * @brief     Host stand-in, included by FreeRTOSConfig.h. Nothing is needed from it on the host
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_GCLK_H_
+#define HOST_GCLK_H_
+
+#endif /* HOST_GCLK_H_ */
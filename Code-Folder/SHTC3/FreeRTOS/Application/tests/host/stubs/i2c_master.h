@@ -0,0 +1,13 @@
+/**************************************************************************/ /**
+ * @file      i2c_master.h
+ * @brief     Host stand-in, everything is declared in asf.h
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_I2C_MASTER_H_
+#define HOST_I2C_MASTER_H_
+
+#include "asf.h"
+
+#endif /* HOST_I2C_MASTER_H_ */
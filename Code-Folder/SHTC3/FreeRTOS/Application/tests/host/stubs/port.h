@@ -0,0 +1,13 @@
+/**************************************************************************/ /**
+ * @file      port.h
+ * @brief     Host stand-in, everything is declared in asf.h
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_PORT_H_
+#define HOST_PORT_H_
+
+#include "asf.h"
+
+#endif /* HOST_PORT_H_ */
@@ -0,0 +1,11 @@
+/**************************************************************************/ /**
+ * @file      trcRecorder.h
+ * @brief     Host stand-in, included by FreeRTOSConfig.h. Nothing is needed from it on the host
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_TRCRECORDER_H_
+#define HOST_TRCRECORDER_H_
+
+#endif /* HOST_TRCRECORDER_H_ */
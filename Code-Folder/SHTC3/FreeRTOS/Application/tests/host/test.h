@@ -0,0 +1,59 @@
+/**************************************************************************/ /**
+ * @file      test.h
+ * @brief     Checks of the host tests. A failed check is printed and counted, and the test exits non-zero at the end
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <stdio.h>
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+static int testChecks = 0;
+static int testFailures = 0;
+
+/// Checks that cond holds
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        testChecks++;                                                         \
+        if (!(cond)) {                                                        \
+            testFailures++;                                                   \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                     \
+    } while (0)
+
+/// Checks that two integers are equal, and prints both if not
+#define CHECK_EQ(actual, expected)                                                                              \
+    do {                                                                                                        \
+        long long testActual = (long long)(actual);                                                             \
+        long long testExpected = (long long)(expected);                                                         \
+        testChecks++;                                                                                           \
+        if (testActual != testExpected) {                                                                       \
+            testFailures++;                                                                                     \
+            fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, testActual,       \
+                    testExpected);                                                                              \
+        }                                                                                                       \
+    } while (0)
+
+/// Runs one test function
+#define RUN(test)                       \
+    do {                                \
+        int testBefore = testFailures;  \
+        test();                         \
+        if (testFailures != testBefore) \
+            fprintf(stderr, "  in %s\n", #test); \
+    } while (0)
+
+/// Prints the result and returns the exit code of main()
+#define TEST_REPORT(name)                                                                                 \
+    (printf("%-16s %s: %d checks, %d failed\n", name, testFailures ? "FAIL" : "ok", testChecks, testFailures), \
+     testFailures ? 1 : 0)
+
+#endif /* HOST_TEST_H_ */
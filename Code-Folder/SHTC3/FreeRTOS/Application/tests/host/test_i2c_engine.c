@@ -0,0 +1,319 @@
+/**************************************************************************/ /**
+ * @file      test_i2c_engine.c
+ * @brief     Host checks of the transaction engine of I2cDriver/I2cDriver.c: priority lanes, FIFO order within a lane,
+ *            header chunking, cancellation, descriptor validation, error completion and the blocking wrappers
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "I2cDriver/I2cDriver.c"
+
+#include "fake.h"
+#include "test.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static StaticTask_t ownerTask;
+static uint8_t payload[600];
+static uint8_t readBack[4];
+static int callbackCalls;
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+static void CountCallback(I2C_Transaction *transaction, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    callbackCalls++;
+}
+
+static void Responder(uint16_t address, uint8_t *data, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = (uint8_t)(address + i);
+    }
+}
+
+/// Write-only transaction of one byte to address
+static void Prepare(I2C_Transaction *transaction, uint8_t address, eI2cPriority priority)
+{
+    I2C_Data data = {address, payload, NULL, 0, 1};
+
+    I2cInitTransaction(transaction, &data, priority);
+    transaction->callback = CountCallback;
+    transaction->notifyTask = &ownerTask;
+}
+
+static I2C_Engine_Stats Stats(void)
+{
+    I2C_Engine_Stats stats;
+
+    I2cGetEngineStats(&stats);
+    return stats;
+}
+
+static void TestPriorityOrder(void)
+{
+    I2C_Transaction first, low, normal1, high, normal2;
+    I2C_Engine_Stats before = Stats();
+
+    fakeI2cLogCount = 0;
+    callbackCalls = 0;
+    Prepare(&first, 0x10, I2C_PRIORITY_NORMAL);
+    Prepare(&low, 0x11, I2C_PRIORITY_LOW);
+    Prepare(&normal1, 0x12, I2C_PRIORITY_NORMAL);
+    Prepare(&high, 0x13, I2C_PRIORITY_HIGH);
+    Prepare(&normal2, 0x14, I2C_PRIORITY_NORMAL);
+
+    // The first one goes on the idle bus at once, the others queue behind it
+    CHECK_EQ(I2cSubmitTransaction(&first), ERROR_NONE);
+    CHECK_EQ(fakeI2cLogCount, 1);
+    CHECK_EQ(fakeSleepLocks, 1);
+    CHECK_EQ(I2cSubmitTransaction(&low), ERROR_NONE);
+    CHECK_EQ(I2cSubmitTransaction(&normal1), ERROR_NONE);
+    CHECK_EQ(I2cSubmitTransaction(&high), ERROR_NONE);
+    CHECK_EQ(I2cSubmitTransaction(&normal2), ERROR_NONE);
+    CHECK_EQ(Stats().queueDepth, 4);
+    CHECK(I2cIsBusy());
+    CHECK_EQ(first.status, ERROR_BUSY);
+
+    // Every completion starts the next transaction from the interrupt: highest lane first, FIFO within a lane
+    fakeTick += 5;
+    FakeI2cRun();
+    CHECK_EQ(fakeI2cLogCount, 5);
+    CHECK_EQ(fakeI2cLog[0].address, 0x10);
+    CHECK_EQ(fakeI2cLog[1].address, 0x13);
+    CHECK_EQ(fakeI2cLog[2].address, 0x12);
+    CHECK_EQ(fakeI2cLog[3].address, 0x14);
+    CHECK_EQ(fakeI2cLog[4].address, 0x11);
+
+    CHECK_EQ(first.status, ERROR_NONE);
+    CHECK_EQ(low.status, ERROR_NONE);
+    CHECK_EQ(callbackCalls, 5);
+    CHECK_EQ(FakeNotifyTake(&ownerTask), I2C_NOTIFY_BIT);
+    CHECK(!I2cIsBusy());
+    CHECK_EQ(fakeSleepLocks, 0);
+
+    I2C_Engine_Stats after = Stats();
+    CHECK_EQ(after.submitted - before.submitted, 5);
+    CHECK_EQ(after.completed - before.completed, 5);
+    CHECK_EQ(after.maxQueueDepth, 4);
+    CHECK_EQ(after.queueDepth, 0);
+    CHECK_EQ(after.maxWaitTicks, 5);
+    CHECK_EQ(after.isr.bytes - before.isr.bytes, 5);
+}
+
+static void TestWriteThenRead(void)
+{
+    static const uint8_t reg = 0x0F;
+    I2C_Data data = {0x6B, &reg, readBack, sizeof(readBack), 1};
+    I2C_Transaction transaction;
+
+    fakeI2cLogCount = 0;
+    fakeI2cResponder = Responder;
+    I2cInitTransaction(&transaction, &data, I2C_PRIORITY_HIGH);
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_NONE);
+    FakeI2cRun();
+    fakeI2cResponder = NULL;
+
+    CHECK_EQ(transaction.status, ERROR_NONE);
+    CHECK_EQ(fakeI2cLogCount, 2);
+    CHECK(!fakeI2cLog[0].read);
+    CHECK_EQ(fakeI2cLog[0].data[0], 0x0F);
+    CHECK(fakeI2cLog[1].read);
+    CHECK_EQ(fakeI2cLog[1].length, sizeof(readBack));
+    CHECK_EQ(readBack[0], 0x6B);
+    CHECK_EQ(readBack[3], 0x6E);
+}
+
+static void TestHeaderChunks(void)
+{
+    static const uint8_t control = 0x40;
+    I2C_Data data = {0x3D, payload, NULL, 0, sizeof(payload)};
+    I2C_Transaction transaction;
+    I2C_Engine_Stats before = Stats();
+
+    for (uint16_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)(i * 7);
+    }
+    fakeI2cLogCount = 0;
+    I2cInitTransaction(&transaction, &data, I2C_PRIORITY_LOW);
+    transaction.header = &control;
+    transaction.headerLen = 1;
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_NONE);
+    FakeI2cRun();
+    CHECK_EQ(transaction.status, ERROR_NONE);
+
+    // 600 bytes of data with a control byte ahead of each chunk: 254 + 254 + 92
+    CHECK_EQ(fakeI2cLogCount, 3);
+    CHECK_EQ(fakeI2cLog[0].length, I2C_MAX_CHUNK_LEN);
+    CHECK_EQ(fakeI2cLog[1].length, I2C_MAX_CHUNK_LEN);
+    CHECK_EQ(fakeI2cLog[2].length, 1 + 600 - 2 * (I2C_MAX_CHUNK_LEN - 1));
+
+    uint16_t offset = 0;
+    bool same = true;
+    for (uint8_t chunk = 0; chunk < 3; chunk++) {
+        CHECK_EQ(fakeI2cLog[chunk].data[0], 0x40);
+        for (uint16_t i = 1; i < fakeI2cLog[chunk].length; i++) {
+            same &= (fakeI2cLog[chunk].data[i] == payload[offset++]);
+        }
+    }
+    CHECK(same);
+    CHECK_EQ(offset, sizeof(payload));
+    CHECK_EQ(Stats().isr.bytes - before.isr.bytes, 603);
+    CHECK_EQ(Stats().isr.transactions - before.isr.transactions, 1);
+}
+
+static void TestCancel(void)
+{
+    I2C_Transaction active, a, b, c;
+    I2C_Engine_Stats before = Stats();
+
+    fakeI2cLogCount = 0;
+    callbackCalls = 0;
+    Prepare(&active, 0x20, I2C_PRIORITY_NORMAL);
+    Prepare(&a, 0x21, I2C_PRIORITY_NORMAL);
+    Prepare(&b, 0x22, I2C_PRIORITY_NORMAL);
+    Prepare(&c, 0x23, I2C_PRIORITY_NORMAL);
+    I2cSubmitTransaction(&active);
+    I2cSubmitTransaction(&a);
+    I2cSubmitTransaction(&b);
+    I2cSubmitTransaction(&c);
+
+    // A queued transaction leaves its lane without a callback, the others keep their order
+    CHECK_EQ(I2cCancelTransaction(&b), ERROR_NONE);
+    CHECK_EQ(b.status, ERROR_ABORTED);
+    CHECK_EQ(Stats().queueDepth, 2);
+    CHECK_EQ(I2cCancelTransaction(&b), ERROR_NOT_FOUND);
+
+    // The transaction on the bus is aborted by a bus reset, then the queue resumes
+    CHECK_EQ(I2cCancelTransaction(&active), ERROR_NONE);
+    CHECK_EQ(active.status, ERROR_ABORTED);
+    CHECK_EQ(fakeI2cLogCount, 2);
+    CHECK_EQ(fakeI2cLog[1].address, 0x21);
+
+    FakeI2cRun();
+    CHECK_EQ(fakeI2cLogCount, 3);
+    CHECK_EQ(fakeI2cLog[2].address, 0x23);
+    CHECK_EQ(callbackCalls, 2);
+    CHECK_EQ(a.status, ERROR_NONE);
+    CHECK_EQ(c.status, ERROR_NONE);
+    CHECK_EQ(I2cCancelTransaction(&c), ERROR_NOT_FOUND);
+    CHECK_EQ(Stats().cancelled - before.cancelled, 2);
+    CHECK_EQ(Stats().queueDepth, 0);
+    CHECK_EQ(fakeSleepLocks, 0);
+}
+
+static void TestValidation(void)
+{
+    static const uint8_t control = 0x00;
+    I2C_Transaction transaction;
+    I2C_Data empty = {0x10, NULL, NULL, 0, 0};
+    I2C_Data noBuffer = {0x10, NULL, NULL, 0, 2};
+
+    CHECK_EQ(I2cSubmitTransaction(NULL), ERROR_INVALID_ARG);
+
+    Prepare(&transaction, 0x10, I2C_PRIORITY_MAX);
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_INVALID_ARG);
+
+    I2cInitTransaction(&transaction, &empty, I2C_PRIORITY_NORMAL);
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_INVALID_DATA);
+    I2cInitTransaction(&transaction, &noBuffer, I2C_PRIORITY_NORMAL);
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_INVALID_DATA);
+
+    Prepare(&transaction, 0x10, I2C_PRIORITY_NORMAL);
+    transaction.headerLen = 1;
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_INVALID_DATA);
+    transaction.header = &control;
+    transaction.headerLen = I2C_MAX_CHUNK_LEN;
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_INVALID_DATA);
+
+    // A descriptor still queued or in flight cannot be submitted again
+    Prepare(&transaction, 0x10, I2C_PRIORITY_NORMAL);
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_NONE);
+    CHECK_EQ(I2cSubmitTransaction(&transaction), ERROR_BUSY);
+    FakeI2cRun();
+    CHECK_EQ(Stats().queueDepth, 0);
+}
+
+static void TestErrors(void)
+{
+    I2C_Transaction failed, next, nacked;
+    I2C_Engine_Stats before = Stats();
+
+    // A transfer the master refuses to start completes with ERROR_IO and does not stall the queue
+    fakeI2cStartStatus = STATUS_BUSY;
+    Prepare(&failed, 0x30, I2C_PRIORITY_NORMAL);
+    CHECK_EQ(I2cSubmitTransaction(&failed), ERROR_NONE);
+    CHECK_EQ(failed.status, ERROR_IO);
+    fakeI2cStartStatus = STATUS_OK;
+    Prepare(&next, 0x31, I2C_PRIORITY_NORMAL);
+    CHECK_EQ(I2cSubmitTransaction(&next), ERROR_NONE);
+    FakeI2cRun();
+    CHECK_EQ(next.status, ERROR_NONE);
+
+    // A NACK ends the transfer through the error callback
+    fakeI2cNack = true;
+    Prepare(&nacked, 0x32, I2C_PRIORITY_NORMAL);
+    I2cSubmitTransaction(&nacked);
+    FakeI2cRun();
+    fakeI2cNack = false;
+    CHECK_EQ(nacked.status, ERROR_ABORTED);
+    CHECK_EQ(Stats().errors - before.errors, 2);
+    CHECK_EQ(fakeSleepLocks, 0);
+}
+
+static void TestBlockingWrappers(void)
+{
+    uint8_t command[2] = {0x78, 0x66};
+    I2C_Data data = {0x70, command, readBack, 2, sizeof(command)};
+    I2C_Transaction transaction;
+
+    fakeOnBlock = FakeI2cRun;
+    fakeI2cResponder = Responder;
+    fakeI2cLogCount = 0;
+
+    // With a delay the command and the read are two transactions, and the bus is free in between
+    TickType_t start = fakeTick;
+    CHECK_EQ(I2cReadDataWait(&data, 13, 10), ERROR_NONE);
+    CHECK_EQ(fakeI2cLogCount, 2);
+    CHECK(!fakeI2cLog[0].read);
+    CHECK(fakeI2cLog[1].read);
+    CHECK(fakeTick - start >= 13);
+    CHECK_EQ(readBack[1], 0x71);
+
+    fakeI2cLogCount = 0;
+    CHECK_EQ(I2cWriteDataWait(&data, 10), ERROR_NONE);
+    CHECK_EQ(fakeI2cLogCount, 1);
+    CHECK_EQ(fakeI2cLog[0].length, 2);
+
+    // A bus that never completes: the wait gives up and cancels, and the descriptor is free again
+    fakeOnBlock = NULL;
+    start = fakeTick;
+    I2cInitTransaction(&transaction, &data, I2C_PRIORITY_NORMAL);
+    CHECK_EQ(I2cTransferWait(&transaction, 20), ERROR_TIMEOUT);
+    CHECK(fakeTick - start >= 20);
+    CHECK_EQ(transaction.status, ERROR_ABORTED);
+    CHECK(!I2cIsBusy());
+    CHECK(!FakeI2cPending());
+    fakeI2cResponder = NULL;
+}
+
+int main(void)
+{
+    CHECK_EQ(I2cInitializeDriver(), STATUS_OK);
+    CHECK_EQ(I2cGetDmaThreshold(), 0);
+
+    RUN(TestPriorityOrder);
+    RUN(TestWriteThenRead);
+    RUN(TestHeaderChunks);
+    RUN(TestCancel);
+    RUN(TestValidation);
+    RUN(TestErrors);
+    RUN(TestBlockingWrappers);
+    CHECK_EQ(fakeCriticalNesting, 0);
+    return TEST_REPORT("i2c_engine");
+}
@@ -0,0 +1,161 @@
+/**************************************************************************/ /**
+ * @file      test_mem_pool.c
+ * @brief     Host checks of MemPool/MemPool.c: size class choice, spills to a bigger class, failures and the free
+ *            heap accounting behind xPortGetFreeHeapSize()
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "MemPool/MemPool.c"
+
+#include <string.h>
+
+#include "fake.h"
+#include "test.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const char *hookPool = NULL;
+static size_t hookSize = 0;
+static int hookCalls = 0;
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+void vApplicationPoolFailedHook(const char *pool, size_t size)
+{
+    hookPool = pool;
+    hookSize = size;
+    hookCalls++;
+}
+
+static MemPool_Stats Stats(uint8_t pool)
+{
+    MemPool_Stats stats;
+
+    MemPoolGetStats(pool, &stats);
+    return stats;
+}
+
+static void TestClassChoice(void)
+{
+    CHECK(MemPoolAlloc(0) == NULL);
+    CHECK_EQ(xPortGetFreeHeapSize(), configTOTAL_HEAP_SIZE);
+
+    uint8_t *small = MemPoolAlloc(1);
+    uint8_t *exact = MemPoolAlloc(32);
+    uint8_t *medium = MemPoolAlloc(33);
+    uint8_t *big = MemPoolAlloc(500);
+
+    CHECK(small >= memPools[0].start && small < memPools[0].end);
+    CHECK(exact >= memPools[0].start && exact < memPools[0].end);
+    CHECK(medium >= memPools[1].start && medium < memPools[1].end);
+    CHECK(big >= memPools[3].start && big < memPools[3].end);
+    CHECK_EQ((uintptr_t)small % portBYTE_ALIGNMENT, 0);
+    CHECK_EQ(Stats(0).used, 2);
+    CHECK_EQ(Stats(1).used, 1);
+    CHECK_EQ(Stats(3).used, 1);
+    CHECK_EQ(xPortGetFreeHeapSize(), configTOTAL_HEAP_SIZE - 32 - 32 - 64 - 512);
+
+    // Blocks do not overlap: each can be filled without touching the others
+    memset(small, 0x11, 32);
+    memset(exact, 0x22, 32);
+    memset(medium, 0x33, 64);
+    CHECK_EQ(small[31], 0x11);
+    CHECK_EQ(exact[0], 0x22);
+
+    MemPoolFree(small);
+    MemPoolFree(exact);
+    MemPoolFree(medium);
+    MemPoolFree(big);
+    MemPoolFree(NULL);
+    CHECK_EQ(Stats(0).used, 0);
+    CHECK_EQ(Stats(0).highWater, 2);
+    CHECK_EQ(xPortGetFreeHeapSize(), configTOTAL_HEAP_SIZE);
+    CHECK_EQ(xPortGetMinimumEverFreeHeapSize(), configTOTAL_HEAP_SIZE - 32 - 32 - 64 - 512);
+
+    // The last block freed is the first handed out again
+    uint8_t *again = MemPoolAlloc(16);
+    CHECK(again == exact);
+    MemPoolFree(again);
+}
+
+static void TestSpill(void)
+{
+    void *blocks[8];
+    uint32_t spills = Stats(0).spills;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        blocks[i] = MemPoolAlloc(20);
+        CHECK(blocks[i] != NULL);
+    }
+    CHECK_EQ(Stats(0).used, 8);
+
+    uint8_t *spilled = MemPoolAlloc(20);
+    CHECK(spilled >= memPools[1].start && spilled < memPools[1].end);
+    CHECK_EQ(Stats(0).spills, spills + 1);
+    CHECK_EQ(Stats(1).used, 1);
+
+    MemPoolFree(spilled);
+    CHECK_EQ(Stats(1).used, 0);
+    for (uint8_t i = 0; i < 8; i++) {
+        MemPoolFree(blocks[i]);
+    }
+    CHECK_EQ(Stats(0).used, 0);
+}
+
+static void TestFailure(void)
+{
+    void *whole = MemPoolAlloc(1024);
+    uint32_t failures = Stats(4).failures;
+
+    CHECK(whole != NULL);
+    hookCalls = 0;
+    CHECK(MemPoolAlloc(1000) == NULL);
+    CHECK_EQ(hookCalls, 1);
+    CHECK(hookPool != NULL && strcmp(hookPool, "1024") == 0);
+    CHECK_EQ(hookSize, 1000);
+    CHECK_EQ(Stats(4).failures, failures + 1);
+
+    // An empty 512 class spills into the 1024 one, and fails with it once both are empty
+    void *a = MemPoolAlloc(512);
+    void *b = MemPoolAlloc(512);
+    CHECK(a != NULL && b != NULL);
+    CHECK(pvPortMalloc(400) == NULL);
+    CHECK(strcmp(hookPool, "512") == 0);
+    CHECK_EQ(Stats(3).failures, 1);
+
+    MemPoolFree(whole);
+    void *spilled = MemPoolAlloc(400);
+    CHECK(spilled == whole);
+    CHECK_EQ(Stats(3).spills, 1);
+
+    vPortFree(a);
+    vPortFree(b);
+    vPortFree(spilled);
+    CHECK_EQ(xPortGetFreeHeapSize(), configTOTAL_HEAP_SIZE);
+}
+
+static void TestLarge(void)
+{
+    hookCalls = 0;
+    CHECK(MemPoolAlloc(MEM_POOL_LARGE_BYTES + 1025) == NULL);
+    CHECK_EQ(hookCalls, 1);
+    CHECK(strcmp(hookPool, "large") == 0);
+    CHECK_EQ(Stats(MEM_POOL_LARGE).failures, 1);
+    CHECK_EQ(Stats(MEM_POOL_LARGE).blocks, MEM_POOL_LARGE_BYTES);
+}
+
+int main(void)
+{
+    RUN(TestClassChoice);
+    RUN(TestSpill);
+    RUN(TestFailure);
+    RUN(TestLarge);
+    CHECK_EQ(fakeSuspendNesting, 0);
+    return TEST_REPORT("mem_pool");
+}
@@ -0,0 +1,202 @@
+/**************************************************************************/ /**
+ * @file      test_rules.c
+ * @brief     Host checks of Rules/Rules.c: hysteresis, dwell time across a tick wrap, sustained actions and the
+ *            parsing of rule updates
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Rules/Rules.c"
+
+#include "fake.h"
+#include "test.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define RULE_FIRE 0      ///< Default rules, see Rules.c
+#define RULE_HOT 1
+#define RULE_HUMID 2
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+static void Climate(TickType_t timestamp, int32_t temperature, int32_t humidity)
+{
+    Sample_Record record = {0};
+
+    record.timestamp = timestamp;
+    record.sensor = SAMPLE_SENSOR_SHTC3;
+    record.status = ERROR_NONE;
+    record.channelCount = 2;
+    record.channel[SAMPLE_SHTC3_TEMPERATURE] = temperature;
+    record.channel[SAMPLE_SHTC3_HUMIDITY] = humidity;
+    RulesEvaluate(&record);
+}
+
+static Rule_Status Status(uint8_t index)
+{
+    Rule rule;
+    Rule_Status status;
+
+    RulesGet(index, &rule, &status);
+    return status;
+}
+
+static void TestHysteresis(void)
+{
+    fakeBuzzerPlays = 0;
+
+    // No dwell on the fire rule: raised on the first record above 50.0 C
+    Climate(0, 510, 400);
+    CHECK(Status(RULE_FIRE).active);
+    CHECK_EQ(Status(RULE_FIRE).raised, 1);
+    CHECK(fakeBuzzerLast == &buzzerPatternFire);
+    CHECK(strstr(fakeConsoleLast, "fire") != NULL);
+
+    // Sustained: the alarm is posted again while raised, and never raised twice
+    Climate(100, 505, 400);
+    CHECK_EQ(fakeBuzzerPlays, 2);
+    CHECK_EQ(Status(RULE_FIRE).raised, 1);
+
+    // Below the threshold but within the hysteresis, the rule holds
+    Climate(200, 481, 400);
+    CHECK(Status(RULE_FIRE).active);
+    Climate(300, 480, 400);
+    CHECK(!Status(RULE_FIRE).active);
+    CHECK(strstr(fakeConsoleLast, "rule 0 cleared") != NULL);
+    CHECK_EQ(Status(RULE_FIRE).lastValue, 480);
+
+    // A value sitting on the threshold does not raise it again
+    Climate(400, 500, 400);
+    CHECK(!Status(RULE_FIRE).active);
+    Climate(500, 501, 400);
+    CHECK_EQ(Status(RULE_FIRE).raised, 2);
+    Climate(600, 200, 400);
+    CHECK(!Status(RULE_FIRE).active);
+}
+
+static void TestDwell(void)
+{
+    // Pill damage holds 2 s. Start just before the tick wraps
+    TickType_t t0 = 0xFFFFFFFFUL - 500;
+
+    Climate(t0, 200, 810);
+    CHECK(Status(RULE_HUMID).pending);
+    Climate(t0 + 1000, 200, 790);
+    CHECK(!Status(RULE_HUMID).pending);
+
+    // The dwell restarts at the next record above the threshold
+    Climate(t0 + 1500, 200, 810);
+    Climate(t0 + 3000, 200, 810);
+    CHECK(!Status(RULE_HUMID).active);
+    CHECK(Status(RULE_HUMID).pending);
+    Climate(t0 + 3499, 200, 810);
+    CHECK(!Status(RULE_HUMID).active);
+    Climate(t0 + 3500, 200, 810);
+    CHECK(Status(RULE_HUMID).active);
+    CHECK(!Status(RULE_HUMID).pending);
+    CHECK(fakeBuzzerLast == &buzzerPatternDamage);
+
+    // Not sustained: no new chirp while raised
+    uint32_t plays = fakeBuzzerPlays;
+    Climate(t0 + 4000, 200, 820);
+    CHECK_EQ(fakeBuzzerPlays, plays);
+
+    Climate(t0 + 4500, 200, 770);
+    CHECK(!Status(RULE_HUMID).active);
+    CHECK_EQ(Status(RULE_HOT).raised, 0);
+}
+
+static void TestSkipped(void)
+{
+    Sample_Record record = {0};
+
+    // A failed read, a record of another sensor and a missing channel leave the rules alone
+    record.sensor = SAMPLE_SENSOR_SHTC3;
+    record.status = ERROR_IO;
+    record.channelCount = 2;
+    record.channel[SAMPLE_SHTC3_TEMPERATURE] = 900;
+    RulesEvaluate(&record);
+    CHECK(!Status(RULE_FIRE).active);
+
+    record.status = ERROR_NONE;
+    record.sensor = SAMPLE_SENSOR_LSM6DSO;
+    RulesEvaluate(&record);
+    CHECK(!Status(RULE_FIRE).active);
+
+    record.sensor = SAMPLE_SENSOR_SHTC3;
+    record.channelCount = 1;
+    record.channel[SAMPLE_SHTC3_HUMIDITY] = 900;
+    RulesEvaluate(&record);
+    CHECK(Status(RULE_FIRE).active);
+    CHECK(!Status(RULE_HUMID).pending);
+    Climate(0, 200, 400);
+}
+
+static void TestSetAndParse(void)
+{
+    Rule rule;
+    Rule_Status status;
+
+    rule = (Rule){SAMPLE_SENSOR_SHTC3, SAMPLE_SHTC3_TEMPERATURE, RULE_BELOW, RULE_ACTION_LOG, 50, 5, 0};
+    CHECK_EQ(RulesSet(RULES_MAX, &rule), ERROR_INVALID_ARG);
+    rule.hysteresis = -1;
+    CHECK_EQ(RulesSet(3, &rule), ERROR_INVALID_ARG);
+    rule.hysteresis = 5;
+    rule.dwellMs = RULES_MAX_DWELL_MS + 1;
+    CHECK_EQ(RulesSet(3, &rule), ERROR_INVALID_ARG);
+    rule.dwellMs = RULES_MAX_DWELL_MS;
+    CHECK_EQ(RulesSet(3, &rule), ERROR_NONE);
+
+    const char *update = "3 0 0 < 50 5 3000 log";
+    CHECK_EQ(RulesParse(update, strlen(update)), ERROR_NONE);
+    RulesGet(3, &rule, &status);
+    CHECK_EQ(rule.comparator, RULE_BELOW);
+    CHECK_EQ(rule.action, RULE_ACTION_LOG);
+    CHECK_EQ(rule.threshold, 50);
+    CHECK_EQ(rule.hysteresis, 5);
+    CHECK_EQ(rule.dwellMs, 3000);
+
+    // Below 5.0 C for 3 s, cleared at 5.5 C
+    Climate(10000, 40, 400);
+    Climate(13000, 40, 400);
+    CHECK(Status(3).active);
+    Climate(14000, 54, 400);
+    CHECK(Status(3).active);
+    Climate(15000, 55, 400);
+    CHECK(!Status(3).active);
+
+    const char *badComparator = "3 0 0 = 50 5 0 log";
+    const char *badAction = "3 0 0 > 50 5 0 alarm";
+    const char *tooLong = "3 0 0 > 50 5 3600001 log";
+    const char *missing = "3 0 0 > 50";
+    CHECK_EQ(RulesParse(badComparator, strlen(badComparator)), ERROR_BAD_FORMAT);
+    CHECK_EQ(RulesParse(badAction, strlen(badAction)), ERROR_INVALID_ARG);
+    CHECK_EQ(RulesParse(tooLong, strlen(tooLong)), ERROR_INVALID_ARG);
+    CHECK_EQ(RulesParse(missing, strlen(missing)), ERROR_BAD_FORMAT);
+    CHECK_EQ(RulesParse(update, 64), ERROR_BAD_FORMAT);
+
+    // Parsing reads only length bytes: the rest of the buffer is not part of the update
+    const char *trailing = "4 0 1 > 900 10 0 fire junk";
+    CHECK_EQ(RulesParse(trailing, strlen(trailing) - 5), ERROR_NONE);
+    RulesGet(4, &rule, &status);
+    CHECK_EQ(rule.channel, SAMPLE_SHTC3_HUMIDITY);
+    CHECK_EQ(rule.action, RULE_ACTION_FIRE);
+
+    CHECK(strcmp(RulesGetActionName(RULE_ACTION_DAMAGE), "damage") == 0);
+    CHECK(strcmp(RulesGetActionName(RULE_ACTION_MAX), "?") == 0);
+}
+
+int main(void)
+{
+    RUN(TestHysteresis);
+    RUN(TestDwell);
+    RUN(TestSkipped);
+    RUN(TestSetAndParse);
+    CHECK_EQ(fakeCriticalNesting, 0);
+    return TEST_REPORT("rules");
+}
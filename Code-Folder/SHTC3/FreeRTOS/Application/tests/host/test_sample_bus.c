@@ -0,0 +1,126 @@
+/**************************************************************************/ /**
+ * @file      test_sample_bus.c
+ * @brief     Host checks of SampleBus/SampleBus.c: sensor masks, sequence numbers, drops of a slow subscriber and
+ *            the depth counters
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "SampleBus/SampleBus.c"
+
+#include "fake.h"
+#include "test.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static StaticTask_t taskA;
+static StaticTask_t taskB;
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+static void Publish(uint8_t sensor, int32_t value)
+{
+    Sample_Record record = {0};
+
+    record.timestamp = fakeTick;
+    record.sensor = sensor;
+    record.channelCount = 1;
+    record.channel[0] = value;
+    SampleBusPublish(&record);
+}
+
+static Sample_Subscriber_Stats Stats(uint8_t index)
+{
+    Sample_Subscriber_Stats stats;
+
+    SampleBusGetSubscriberStats(index, &stats);
+    return stats;
+}
+
+static void TestMasks(void)
+{
+    static StaticSemaphore_t semaphoreBuffer;
+    Sample_Subscriber *climate = SampleBusSubscribe("climate", SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_SHTC3), &taskA, 0x1);
+    Sample_Subscriber *all = SampleBusSubscribe("all", SAMPLE_SENSOR_ALL, &taskB, 0x2);
+    SemaphoreHandle_t semaphore = xSemaphoreCreateBinaryStatic(&semaphoreBuffer);
+    Sample_Record record;
+
+    CHECK(climate != NULL && all != NULL);
+    SampleBusSetSemaphore(climate, semaphore);
+
+    Publish(SAMPLE_SENSOR_LSM6DSO, 1);
+    CHECK_EQ(FakeNotifyTake(&taskA), 0);
+    CHECK_EQ(FakeNotifyTake(&taskB), 0x2);
+    CHECK_EQ(FakeSemaphoreCount(semaphore), 0);
+
+    Publish(SAMPLE_SENSOR_SHTC3, 250);
+    CHECK_EQ(FakeNotifyTake(&taskA), 0x1);
+    CHECK_EQ(FakeSemaphoreCount(semaphore), 1);
+
+    // The subscriber of one sensor skips the records of the others
+    CHECK(SampleBusRead(climate, &record));
+    CHECK_EQ(record.sensor, SAMPLE_SENSOR_SHTC3);
+    CHECK_EQ(record.channel[0], 250);
+    CHECK_EQ(record.sequence, 1);
+    CHECK(!SampleBusRead(climate, &record));
+
+    CHECK(SampleBusRead(all, &record));
+    CHECK_EQ(record.sequence, 0);
+    CHECK(SampleBusRead(all, &record));
+    CHECK_EQ(record.sequence, 1);
+    CHECK(!SampleBusRead(all, &record));
+
+    CHECK_EQ(SampleBusGetPublished(), 2);
+    CHECK_EQ(Stats(0).received, 1);
+    CHECK_EQ(Stats(1).received, 2);
+    CHECK_EQ(Stats(1).depth, 0);
+    CHECK_EQ(Stats(1).maxDepth, 2);
+}
+
+static void TestDrops(void)
+{
+    Sample_Subscriber *slow = SampleBusSubscribe("slow", SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_SHTC3), NULL, 0);
+    uint32_t first = SampleBusGetPublished();
+    Sample_Record record;
+
+    CHECK(slow != NULL);
+
+    // Three records more than the ring holds: the three oldest are lost, two of them SHTC3 ones
+    for (uint8_t i = 0; i < SAMPLE_BUS_DEPTH + 3; i++) {
+        Publish((i == 1) ? SAMPLE_SENSOR_LID : SAMPLE_SENSOR_SHTC3, i);
+    }
+    CHECK_EQ(Stats(2).drops, 2);
+    CHECK_EQ(Stats(2).depth, SAMPLE_BUS_DEPTH);
+    CHECK_EQ(Stats(2).maxDepth, SAMPLE_BUS_DEPTH);
+
+    // Reading resumes at the oldest record still in the ring
+    CHECK(SampleBusRead(slow, &record));
+    CHECK_EQ(record.sequence, first + 3);
+    CHECK_EQ(record.channel[0], 3);
+    while (SampleBusRead(slow, &record)) {
+    }
+    CHECK_EQ(record.channel[0], SAMPLE_BUS_DEPTH + 2);
+    CHECK_EQ(Stats(2).depth, 0);
+    CHECK_EQ(Stats(2).received, SAMPLE_BUS_DEPTH);
+}
+
+static void TestTableFull(void)
+{
+    CHECK(SampleBusSubscribe("d", SAMPLE_SENSOR_ALL, NULL, 0) != NULL);
+    CHECK_EQ(SampleBusGetSubscriberCount(), SAMPLE_BUS_MAX_SUBSCRIBERS);
+    CHECK(SampleBusSubscribe("e", SAMPLE_SENSOR_ALL, NULL, 0) == NULL);
+}
+
+int main(void)
+{
+    RUN(TestMasks);
+    RUN(TestDrops);
+    RUN(TestTableFull);
+    CHECK_EQ(fakeCriticalNesting, 0);
+    return TEST_REPORT("sample_bus");
+}
@@ -0,0 +1,302 @@
+/**************************************************************************/ /**
+ * @file      test_schedule.c
+ * @brief     Host checks of Schedule/Schedule.c: date math, the deadline heap, dose updates, the RTC alarm service and
+ *            the flash copy kept across a reset
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "Schedule/Schedule.c"
+
+#include "fake.h"
+#include "test.h"
+
+/******************************************************************************
+ * Defines
+ ******************************************************************************/
+#define NOTIFY_BIT 0x4
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static StaticTask_t task;
+static Sample_Subscriber *doses;
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+static Schedule_Stats Stats(void)
+{
+    Schedule_Stats stats;
+
+    ScheduleGetStats(&stats);
+    return stats;
+}
+
+static int32_t Parse(const char *text)
+{
+    return ScheduleParse(text, strlen(text));
+}
+
+/// Moves the RTC to a local date and time
+static void SetRtc(uint32_t minute)
+{
+    rtc_calendar_get_time_defaults(&fakeRtcTime);
+    ScheduleMinuteToDate(minute, &fakeRtcTime.year, &fakeRtcTime.month, &fakeRtcTime.day, &fakeRtcTime.hour,
+                         &fakeRtcTime.minute);
+}
+
+/// Clears the RAM of the module, as a system reset would. The RTC and the flash row are left as they are
+static void Reset(void)
+{
+    memset(scheduleEntries, 0, sizeof(scheduleEntries));
+    memset(&scheduleStats, 0, sizeof(scheduleStats));
+    scheduleHeapSize = 0;
+    scheduleUtcOffsetMin = SCHEDULE_UTC_OFFSET_MIN;
+    scheduleMutex = NULL;
+}
+
+static void TestDateMath(void)
+{
+    uint16_t year;
+    uint8_t month, day, hour, minute;
+
+    CHECK_EQ(ScheduleDaysFromDate(2000, 1, 1), 0);
+    CHECK_EQ(ScheduleDaysFromDate(2000, 3, 1), 60);
+    CHECK_EQ(ScheduleDaysFromDate(2001, 1, 1), 366);
+    CHECK_EQ(ScheduleDaysFromDate(2024, 2, 29), 8825);
+    CHECK_EQ(ScheduleDaysFromDate(2025, 3, 1), 9191);
+
+    ScheduleMinuteToDate(8825 * SCHEDULE_MINUTES_PER_DAY + 8 * 60 + 30, &year, &month, &day, &hour, &minute);
+    CHECK_EQ(year, 2024);
+    CHECK_EQ(month, 2);
+    CHECK_EQ(day, 29);
+    CHECK_EQ(hour, 8);
+    CHECK_EQ(minute, 30);
+
+    // Every day of the century converts back to itself
+    int mismatches = 0;
+    for (uint32_t days = 0; days < ScheduleDaysFromDate(2099, 12, 31) + 1; days++) {
+        ScheduleMinuteToDate(days * SCHEDULE_MINUTES_PER_DAY + 23 * 60 + 59, &year, &month, &day, &hour, &minute);
+        if (ScheduleDaysFromDate(year, month, day) != days || hour != 23 || minute != 59) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+    CHECK_EQ(year, 2099);
+}
+
+static void TestNextDue(void)
+{
+    Schedule_Entry saturday = {INPUT_LID_1, 8, 0, 1 << 6};
+    Schedule_Entry sunday = {INPUT_LID_1, 8, 0, 1 << 0};
+    Schedule_Entry daily = {INPUT_LID_1, 8, 0, SCHEDULE_DAYS_DAILY};
+    Schedule_Entry never = {INPUT_LID_1, 8, 0, 0};
+
+    // 2000-01-01 was a Saturday
+    CHECK_EQ(ScheduleNextDue(&saturday, 0), 8 * 60);
+    CHECK_EQ(ScheduleNextDue(&sunday, 0), SCHEDULE_MINUTES_PER_DAY + 8 * 60);
+
+    // Strictly later: a dose at the given minute is due again next week, or tomorrow
+    CHECK_EQ(ScheduleNextDue(&saturday, 8 * 60), 7 * SCHEDULE_MINUTES_PER_DAY + 8 * 60);
+    CHECK_EQ(ScheduleNextDue(&daily, 8 * 60), SCHEDULE_MINUTES_PER_DAY + 8 * 60);
+    CHECK_EQ(ScheduleNextDue(&daily, 8 * 60 - 1), 8 * 60);
+    CHECK_EQ(ScheduleNextDue(&never, 0), UINT32_MAX);
+}
+
+static void TestHeap(void)
+{
+    static const uint32_t dues[] = {50, 10, 40, 30, 20, 60, 5, 10};
+    uint32_t last = 0;
+    bool ordered = true;
+
+    scheduleHeapSize = 0;
+    for (uint8_t i = 0; i < sizeof(dues) / sizeof(dues[0]); i++) {
+        ScheduleHeapPush(dues[i], i);
+    }
+    CHECK_EQ(scheduleHeapSize, 8);
+    CHECK_EQ(scheduleHeap[0].due, 5);
+    CHECK_EQ(scheduleHeap[0].slot, 6);
+
+    while (scheduleHeapSize > 0) {
+        if (scheduleHeap[0].due < last || dues[scheduleHeap[0].slot] != scheduleHeap[0].due) {
+            ordered = false;
+        }
+        last = scheduleHeap[0].due;
+        ScheduleHeapPop();
+    }
+    CHECK(ordered);
+    CHECK_EQ(last, 60);
+}
+
+static void TestSetAndParse(void)
+{
+    Schedule_Entry entry;
+
+    // Power-on: the RTC starts from the epoch and waits for the network time
+    CHECK_EQ(ScheduleInit(&task, NOTIFY_BIT), ERROR_NONE);
+    CHECK(!Stats().timeValid);
+    CHECK(!Stats().stored);
+    CHECK_EQ(Stats().utcOffsetMin, SCHEDULE_UTC_OFFSET_MIN);
+    CHECK_EQ(ScheduleGetMinute(), 0);
+    CHECK_EQ(fakeRtcTime.year, 2000);
+
+    // Slots are kept without a time, but nothing is armed
+    CHECK_EQ(Parse("0 1 08:30 7f"), ERROR_NONE);
+    ScheduleGet(0, &entry);
+    CHECK_EQ(entry.compartment, INPUT_LID_1);
+    CHECK_EQ(entry.hour, 8);
+    CHECK_EQ(entry.minute, 30);
+    CHECK_EQ(entry.days, SCHEDULE_DAYS_DAILY);
+    CHECK_EQ(Stats().pending, 0);
+    CHECK(Stats().stored);
+    CHECK_EQ(fakeNvmWrites, 1);
+
+    // A retained update sent again is not written again
+    CHECK_EQ(Parse("0 1 08:30 7f"), ERROR_NONE);
+    CHECK_EQ(fakeNvmWrites, 1);
+
+    CHECK_EQ(Parse("tz 900"), ERROR_INVALID_ARG);
+    CHECK_EQ(Parse("0 4 08:30 7f"), ERROR_INVALID_ARG);
+    CHECK_EQ(Parse("0 0 08:30 7f"), ERROR_INVALID_ARG);
+    CHECK_EQ(Parse("0 1 24:00 7f"), ERROR_INVALID_ARG);
+    CHECK_EQ(Parse("0 1 08:30 80"), ERROR_INVALID_ARG);
+    CHECK_EQ(Parse("12 1 08:30 7f"), ERROR_INVALID_ARG);
+    CHECK_EQ(Parse("0 1 0830 7f"), ERROR_BAD_FORMAT);
+    CHECK_EQ(Parse("0 1 08:30 7f                      "), ERROR_BAD_FORMAT);
+    CHECK_EQ(fakeNvmWrites, 1);
+}
+
+static void TestService(void)
+{
+    Sample_Record record;
+    uint32_t now;
+
+    // 2026-10-16 13:00 UTC is 08:00 local, a Friday
+    ScheduleSetTime(2000, 1, 1, 0, 0, 0);
+    CHECK_EQ(Stats().timeSets, 0);
+    ScheduleSetTime(2026, 10, 16, 13, 0, 12);
+    now = ScheduleGetMinute();
+    CHECK_EQ(fakeRtcTime.hour, 8);
+    CHECK_EQ(fakeRtcTime.second, 12);
+    CHECK_EQ((now / SCHEDULE_MINUTES_PER_DAY + SCHEDULE_EPOCH_WEEKDAY) % 7, 5);
+    CHECK(Stats().timeValid);
+    CHECK_EQ(Stats().timeSets, 1);
+    CHECK_EQ(Stats().pending, 1);
+    CHECK_EQ(Stats().nextMinute, now + 30);
+    CHECK_EQ(fakeRtcAlarm.mask, RTC_CALENDAR_ALARM_MASK_YEAR);
+    CHECK_EQ(fakeRtcAlarm.time.hour, 8);
+    CHECK_EQ(fakeRtcAlarm.time.minute, 30);
+
+    // Saturdays and Sundays at 20:00: the daily dose stays the nearest
+    CHECK_EQ(Parse("1 2 20:00 41"), ERROR_NONE);
+    CHECK_EQ(Stats().pending, 2);
+    CHECK_EQ(Stats().nextMinute, now + 30);
+
+    // The alarm only notifies; the task signals the dose
+    SetRtc(now + 30);
+    FakeRtcFireAlarm();
+    CHECK_EQ(FakeNotifyTake(&task), NOTIFY_BIT);
+    fakeBuzzerPlays = 0;
+    ScheduleService();
+    CHECK_EQ(Stats().fired, 1);
+    CHECK_EQ(Stats().late, 0);
+    CHECK_EQ(fakeBuzzerPlays, 1);
+    CHECK(fakeBuzzerLast == &buzzerPatternPill);
+    CHECK(strcmp(fakeConsoleLast, "dose due: box 1\r\n") == 0);
+    CHECK(SampleBusRead(doses, &record));
+    CHECK_EQ(record.channel[SAMPLE_DOSE_COMPARTMENT], INPUT_LID_1);
+    CHECK_EQ(record.channel[SAMPLE_DOSE_SLOT], 0);
+    CHECK_EQ(record.channel[SAMPLE_DOSE_LATE], 0);
+
+    // Saturday 20:00: the daily dose of the morning is late, the nearest is signalled first
+    uint32_t plays = fakeBuzzerPlays;
+    CHECK_EQ(Stats().nextMinute, now + SCHEDULE_MINUTES_PER_DAY + 30);
+    SetRtc(now + SCHEDULE_MINUTES_PER_DAY + 12 * 60);
+    ScheduleService();
+    CHECK_EQ(fakeBuzzerPlays, plays + 2);
+    CHECK_EQ(Stats().fired, 3);
+    CHECK_EQ(Stats().late, 1);
+    CHECK(SampleBusRead(doses, &record));
+    CHECK_EQ(record.channel[SAMPLE_DOSE_SLOT], 0);
+    CHECK_EQ(record.channel[SAMPLE_DOSE_LATE], 12 * 60 - 30);
+    CHECK(SampleBusRead(doses, &record));
+    CHECK_EQ(record.channel[SAMPLE_DOSE_SLOT], 1);
+    CHECK_EQ(record.channel[SAMPLE_DOSE_COMPARTMENT], INPUT_LID_2);
+    CHECK_EQ(record.channel[SAMPLE_DOSE_LATE], 0);
+    CHECK(strcmp(fakeConsoleLast, "dose due: box 2\r\n") == 0);
+    CHECK(!SampleBusRead(doses, &record));
+    CHECK_EQ(Stats().nextMinute, now + 2 * SCHEDULE_MINUTES_PER_DAY + 30);
+
+    // A time zone change moves the RTC along, and is stored
+    uint32_t writes = fakeNvmWrites;
+    uint8_t hour = fakeRtcTime.hour;
+    CHECK_EQ(Parse("tz -240"), ERROR_NONE);
+    CHECK_EQ(fakeRtcTime.hour, hour + 1);
+    CHECK_EQ(Stats().utcOffsetMin, -240);
+    CHECK_EQ(fakeNvmWrites, writes + 1);
+    CHECK(Stats().stored);
+}
+
+static void TestReset(void)
+{
+    Schedule_Entry entry;
+    Schedule_Stats before = Stats();
+    struct rtc_calendar_time time = fakeRtcTime;
+
+    // A reset leaves the RTC running: the schedule is armed again from flash, without the network time
+    Reset();
+    CHECK_EQ(ScheduleInit(&task, NOTIFY_BIT), ERROR_NONE);
+    CHECK(Stats().timeValid);
+    CHECK(Stats().stored);
+    CHECK_EQ(Stats().utcOffsetMin, -240);
+    CHECK_EQ(Stats().pending, 2);
+    CHECK_EQ(Stats().nextMinute, before.nextMinute);
+    CHECK_EQ(fakeRtcTime.hour, time.hour);
+    CHECK_EQ(fakeRtcTime.day, time.day);
+    ScheduleGet(1, &entry);
+    CHECK_EQ(entry.compartment, INPUT_LID_2);
+    CHECK_EQ(entry.days, 0x41);
+
+    // Freeing a slot disarms it
+    CHECK_EQ(Parse("1 2 00:00 0"), ERROR_NONE);
+    CHECK_EQ(Stats().pending, 1);
+
+    // A corrupt row is ignored, and a power-on restarts the RTC
+    Schedule_Store store;
+    memcpy(&store, (const void *)&scheduleRow.store, sizeof(store));
+    store.entries[0].hour ^= 0x01;
+    CHECK_EQ(nvm_write_buffer((uint32_t)&scheduleRow, (const uint8_t *)&store, sizeof(store)), STATUS_OK);
+    Reset();
+    fakeRtc.MODE2.CTRL.reg = 0;
+    CHECK_EQ(ScheduleInit(&task, NOTIFY_BIT), ERROR_NONE);
+    CHECK(!Stats().stored);
+    CHECK(!Stats().timeValid);
+    CHECK_EQ(Stats().pending, 0);
+    CHECK_EQ(Stats().utcOffsetMin, SCHEDULE_UTC_OFFSET_MIN);
+    CHECK_EQ(fakeRtcTime.year, 2000);
+    ScheduleGet(0, &entry);
+    CHECK_EQ(entry.days, 0);
+
+    // Without a time the service signals nothing
+    uint32_t plays = fakeBuzzerPlays;
+    ScheduleService();
+    CHECK_EQ(fakeBuzzerPlays, plays);
+}
+
+int main(void)
+{
+    doses = SampleBusSubscribe("doses", SAMPLE_SENSOR_MASK(SAMPLE_SENSOR_DOSE), NULL, 0);
+
+    RUN(TestDateMath);
+    RUN(TestNextDue);
+    RUN(TestHeap);
+    RUN(TestSetAndParse);
+    RUN(TestService);
+    RUN(TestReset);
+    CHECK_EQ(fakeCriticalNesting, 0);
+    return TEST_REPORT("schedule");
+}
@@ -0,0 +1,196 @@
+/**************************************************************************/ /**
+ * @file      test_shtc3.c
+ * @brief     Host checks of SHTC3/SHTC3.c: CRC, fixed point conversions and the wake / trigger / read / sleep cycle
+ *            on the I2C transaction engine
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "SHTC3/SHTC3.c"
+
+#include "fake.h"
+#include "test.h"
+
+/******************************************************************************
+ * Variables
+ ******************************************************************************/
+static uint16_t sensorTemperature = 0x6666;  ///< 25.0 C
+static uint16_t sensorHumidity = 0x8000;     ///< 50.0 %RH
+static bool sensorBadCrc = false;
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+/// Answers a result read as the sensor does: temperature word, CRC, humidity word, CRC
+static void Sensor(uint16_t address, uint8_t *data, uint16_t length)
+{
+    CHECK_EQ(address, SHTC3_ADDR);
+    CHECK_EQ(length, SHTC3_RESPONSE_SIZE);
+    data[0] = sensorTemperature >> 8;
+    data[1] = sensorTemperature & 0xFF;
+    data[2] = SHTC3_Crc8(&data[0], 2);
+    data[3] = sensorHumidity >> 8;
+    data[4] = sensorHumidity & 0xFF;
+    data[5] = SHTC3_Crc8(&data[3], 2) ^ (sensorBadCrc ? 0x01 : 0x00);
+}
+
+static bool IsCommand(uint8_t index, uint8_t cmd1, uint8_t cmd2)
+{
+    return !fakeI2cLog[index].read && fakeI2cLog[index].length == 2 && fakeI2cLog[index].data[0] == cmd1 &&
+           fakeI2cLog[index].data[1] == cmd2;
+}
+
+static SHTC3_Stats Stats(void)
+{
+    SHTC3_Stats stats;
+
+    SHTC3_GetStats(&stats);
+    return stats;
+}
+
+static void TestCrc(void)
+{
+    static const uint8_t datasheet[2] = {0xBE, 0xEF};
+    static const uint8_t zero[2] = {0x00, 0x00};
+
+    CHECK_EQ(SHTC3_Crc8(datasheet, 2), 0x92);
+    CHECK_EQ(SHTC3_Crc8(zero, 2), 0x81);
+    CHECK_EQ(SHTC3_Crc8(zero, 0), SHTC3_CRC_INIT);
+}
+
+static void TestConversion(void)
+{
+    // T = -45 + 175 * raw / 65536, RH = 100 * raw / 65536, in tenths and rounded
+    CHECK_EQ(SHTC3_ConvertTemperature(0x0000), -450);
+    CHECK_EQ(SHTC3_ConvertTemperature(0xFFFF), 1300);
+    CHECK_EQ(SHTC3_ConvertTemperature(0x6666), 250);
+    CHECK_EQ(SHTC3_ConvertTemperature(0x41D4), 0);
+    CHECK_EQ(SHTC3_ConvertHumidity(0x0000), 0);
+    CHECK_EQ(SHTC3_ConvertHumidity(0x8000), 500);
+    CHECK_EQ(SHTC3_ConvertHumidity(0xFFFF), 1000);
+}
+
+static void TestBlockingRead(void)
+{
+    SHTC3_Sample sample = {0};
+
+    fakeOnBlock = FakeI2cRun;
+    fakeI2cLogCount = 0;
+    CHECK_EQ(SHTC3_Init(), ERROR_NONE);
+    CHECK_EQ(fakeI2cLogCount, 2);
+    CHECK(IsCommand(0, SHTC3_WAKEUP_CMD1, SHTC3_WAKEUP_CMD2));
+    CHECK(IsCommand(1, SHTC3_SLEEP_CMD1, SHTC3_SLEEP_CMD2));
+
+    fakeI2cLogCount = 0;
+    TickType_t start = fakeTick;
+    CHECK_EQ(SHTC3_ReadTemperatureAndHumidity(&sample), ERROR_NONE);
+    CHECK_EQ(sample.temperature, 250);
+    CHECK_EQ(sample.humidity, 500);
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_SLEEP);
+    CHECK(fakeTick - start >= SHTC3_GetWakeupTicks() + SHTC3_GetMeasurementTicks());
+
+    // Wake, measure in normal mode, read, and the sleep command left on the bus
+    CHECK_EQ(fakeI2cLogCount, 4);
+    CHECK(IsCommand(0, SHTC3_WAKEUP_CMD1, SHTC3_WAKEUP_CMD2));
+    CHECK(IsCommand(1, SHT3_TH_NM_NCS_MEASURE_CMD1, SHT3_TH_NM_NCS_MEASURE_CMD2));
+    CHECK(fakeI2cLog[2].read);
+    CHECK(IsCommand(3, SHTC3_SLEEP_CMD1, SHTC3_SLEEP_CMD2));
+    CHECK_EQ(Stats().samples, 1);
+
+    // Low power mode: its own command and a 1 ms conversion. The sleep command ends before the next sample
+    FakeI2cRun();
+    SHTC3_SetPowerMode(SHTC3_POWER_LOW);
+    CHECK_EQ(SHTC3_GetMeasurementTicks(), 2);
+    fakeI2cLogCount = 0;
+    sensorTemperature = 0xFFFF;
+    CHECK_EQ(SHTC3_ReadTemperatureAndHumidity(&sample), ERROR_NONE);
+    CHECK(IsCommand(1, SHT3_TH_LPM_NCS_MEASURE_CMD1, SHT3_TH_LPM_NCS_MEASURE_CMD2));
+    CHECK_EQ(sample.temperature, 1300);
+    SHTC3_SetPowerMode(SHTC3_POWER_NORMAL);
+    sensorTemperature = 0x6666;
+
+    // A corrupted humidity word is dropped, and the sensor still goes back to sleep
+    FakeI2cRun();
+    sensorBadCrc = true;
+    sample.humidity = 0;
+    CHECK_EQ(SHTC3_ReadTemperatureAndHumidity(&sample), ERROR_INVALID_DATA);
+    CHECK_EQ(sample.humidity, 0);
+    CHECK_EQ(Stats().crcErrors, 1);
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_SLEEP);
+    sensorBadCrc = false;
+    FakeI2cRun();
+}
+
+static void TestSteps(void)
+{
+    SHTC3_Sample sample = {0};
+
+    // Driven by the executor: every step returns at once, ERROR_BUSY until the previous one can be followed up
+    fakeOnBlock = NULL;
+    CHECK_EQ(SHTC3_Trigger(), ERROR_NOT_READY);
+    CHECK_EQ(SHTC3_ReadMeasurement(&sample), ERROR_NOT_READY);
+    CHECK_EQ(SHTC3_Wake(), ERROR_NONE);
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_WAKING);
+    CHECK_EQ(SHTC3_Wake(), ERROR_BUSY);
+    CHECK_EQ(SHTC3_Trigger(), ERROR_BUSY);
+
+    FakeI2cRun();
+    CHECK_EQ(SHTC3_Trigger(), ERROR_BUSY);  // Still waking up
+    fakeTick += SHTC3_GetWakeupTicks();
+    CHECK_EQ(SHTC3_Trigger(), ERROR_NONE);
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_MEASURING);
+
+    FakeI2cRun();
+    fakeTick += SHTC3_GetMeasurementTicks() - 1;
+    CHECK_EQ(SHTC3_ReadMeasurement(&sample), ERROR_BUSY);
+    fakeTick += 1;
+    CHECK_EQ(SHTC3_ReadMeasurement(&sample), ERROR_BUSY);  // Read queued
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_READING);
+    FakeI2cRun();
+    CHECK_EQ(SHTC3_ReadMeasurement(&sample), ERROR_NONE);
+    CHECK_EQ(sample.temperature, 250);
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_SLEEP);
+    FakeI2cRun();
+}
+
+static void TestBusErrors(void)
+{
+    uint32_t busErrors = Stats().busErrors;
+
+    // The wake-up command is not acknowledged
+    fakeI2cNack = true;
+    CHECK_EQ(SHTC3_Wake(), ERROR_NONE);
+    FakeI2cRun();
+    fakeI2cNack = false;
+    fakeTick += SHTC3_GetWakeupTicks();
+    CHECK_EQ(SHTC3_Trigger(), ERROR_ABORTED);
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_SLEEP);
+    CHECK_EQ(Stats().busErrors, busErrors + 1);
+
+    // A transfer that never completes is cancelled once it is overdue
+    CHECK_EQ(SHTC3_Wake(), ERROR_NONE);
+    fakeTick += pdMS_TO_TICKS(WAIT_I2C_LINE_MS + WAIT_TIME) - 1;
+    CHECK_EQ(SHTC3_Trigger(), ERROR_BUSY);
+    fakeTick += 1;
+    CHECK_EQ(SHTC3_Trigger(), ERROR_TIMEOUT);
+    CHECK_EQ(SHTC3_GetState(), SHTC3_STATE_SLEEP);
+    CHECK_EQ(Stats().busErrors, busErrors + 2);
+    CHECK(!I2cIsBusy());
+}
+
+int main(void)
+{
+    fakeI2cResponder = Sensor;
+    CHECK_EQ(I2cInitializeDriver(), STATUS_OK);
+
+    RUN(TestCrc);
+    RUN(TestConversion);
+    RUN(TestBlockingRead);
+    RUN(TestSteps);
+    RUN(TestBusErrors);
+    CHECK_EQ(fakeCriticalNesting, 0);
+    return TEST_REPORT("shtc3");
+}
@@ -0,0 +1,220 @@
+/**************************************************************************/ /**
+ * @file      test_ssd1306.c
+ * @brief     Host checks of OLED/SSD1306.c: dirty column ranges, unaligned bitmap copies and the address windows and
+ *            data writes of a screen update
+ * @date      2026-10-16
+
+ ******************************************************************************/
+
+/******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "OLED/SSD1306.c"
+
+#include "fake.h"
+#include "test.h"
+
+/******************************************************************************
+ * Functions
+ ******************************************************************************/
+static SSD1306_Stats Stats(void)
+{
+    SSD1306_Stats stats;
+
+    SSD1306_GetStats(&stats);
+    return stats;
+}
+
+static bool AllClean(void)
+{
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        if (ssd1306DirtyFirst[page] != SSD1306_CLEAN) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Checks that a logged write is the address window of one update
+static void CheckWindow(uint8_t index, uint8_t first, uint8_t last, uint8_t page, uint8_t end)
+{
+    const uint8_t window[] = {0x00, SSD1306_SET_COLUMN_ADDRESS, first, last, SSD1306_SET_PAGE_ADDRESS, page, end};
+
+    CHECK_EQ(fakeI2cLog[index].address, SSD1306_I2C_ADDRESS);
+    CHECK_EQ(fakeI2cLog[index].length, sizeof(window));
+    CHECK(memcmp(fakeI2cLog[index].data, window, sizeof(window)) == 0);
+}
+
+/// Checks that a logged write is a data write of the given buffer bytes
+static void CheckData(uint8_t index, uint16_t offset, uint16_t count)
+{
+    CHECK_EQ(fakeI2cLog[index].length, count + 1);
+    CHECK_EQ(fakeI2cLog[index].data[0], 0x40);
+    CHECK(memcmp(&fakeI2cLog[index].data[1], &SSD1306_Buffer[offset], count) == 0);
+}
+
+static void TestInit(void)
+{
+    TickType_t start = fakeTick;
+
+    fakeI2cLogCount = 0;
+    CHECK_EQ(SSD1306_Init(), 1);
+    CHECK(fakeTick - start >= pdMS_TO_TICKS(SSD1306_CHARGE_PUMP_MS));
+
+    // The configuration is one command stream, then display on once the charge pump settled
+    CHECK_EQ(fakeI2cLogCount, 2);
+    CHECK_EQ(fakeI2cLog[0].length, sizeof(ssd1306InitCommands) + 1);
+    CHECK_EQ(fakeI2cLog[0].data[0], 0x00);
+    CHECK(memcmp(&fakeI2cLog[0].data[1], ssd1306InitCommands, sizeof(ssd1306InitCommands)) == 0);
+    CHECK_EQ(fakeI2cLog[1].length, 2);
+    CHECK_EQ(fakeI2cLog[1].data[1], SSD1306_DISPLAY_ON);
+
+    for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
+        CHECK_EQ(ssd1306DirtyFirst[page], 0);
+        CHECK_EQ(ssd1306DirtyLast[page], SSD1306_WIDTH - 1);
+    }
+}
+
+static void TestFullFrame(void)
+{
+    uint16_t sent = 0;
+
+    // The whole frame is one window and one 1024-byte write, in chunks of I2C_MAX_CHUNK_LEN with a control byte each
+    SSD1306_Buffer[0] = 0x5A;
+    SSD1306_Buffer[sizeof(SSD1306_Buffer) - 1] = 0xA5;
+    fakeI2cLogCount = 0;
+    SSD1306_UpdateScreen();
+    CHECK(AllClean());
+    CheckWindow(0, 0, SSD1306_WIDTH - 1, 0, SSD1306_PAGES - 1);
+    CHECK_EQ(fakeI2cLogCount, 1 + 5);
+    for (uint8_t i = 1; i < fakeI2cLogCount; i++) {
+        CHECK_EQ(fakeI2cLog[i].data[0], 0x40);
+        CHECK(fakeI2cLog[i].length <= I2C_MAX_CHUNK_LEN);
+        sent += fakeI2cLog[i].length - 1;
+    }
+    CHECK_EQ(sent, sizeof(SSD1306_Buffer));
+    CHECK_EQ(fakeI2cLog[1].data[1], 0x5A);
+    CHECK_EQ(fakeI2cLog[5].data[fakeI2cLog[5].length - 1], 0xA5);
+    CHECK_EQ(Stats().lastBytes, 1 + 6 + 1024 + 5);
+
+    // Nothing changed, nothing sent
+    fakeI2cLogCount = 0;
+    SSD1306_UpdateScreen();
+    CHECK_EQ(fakeI2cLogCount, 0);
+    CHECK_EQ(Stats().lastBytes, 0);
+    CHECK_EQ(Stats().updates, 2);
+    CHECK_EQ(Stats().totalBytes, 1036);
+}
+
+static void TestDirtyRanges(void)
+{
+    // Ranges only widen, per page
+    SSD1306_MarkDirty(10, 20, 2, 3);
+    SSD1306_MarkDirty(5, 8, 3, 3);
+    CHECK_EQ(ssd1306DirtyFirst[2], 10);
+    CHECK_EQ(ssd1306DirtyLast[2], 20);
+    CHECK_EQ(ssd1306DirtyFirst[3], 5);
+    CHECK_EQ(ssd1306DirtyLast[3], 20);
+    CHECK_EQ(ssd1306DirtyFirst[1], SSD1306_CLEAN);
+    CHECK_EQ(ssd1306DirtyFirst[4], SSD1306_CLEAN);
+
+    // A pixel that does not change is not sent
+    SSD1306_DrawPixel(100, 60, SSD1306_COLOR_BLACK);
+    CHECK_EQ(ssd1306DirtyFirst[7], SSD1306_CLEAN);
+    SSD1306_DrawPixel(40, 17, SSD1306_COLOR_WHITE);
+    CHECK_EQ(SSD1306_Buffer[2 * SSD1306_WIDTH + 40], 0x02);
+    CHECK_EQ(ssd1306DirtyLast[2], 40);
+
+    // One window and one write per dirty page
+    fakeI2cLogCount = 0;
+    SSD1306_UpdateScreen();
+    CHECK_EQ(fakeI2cLogCount, 4);
+    CheckWindow(0, 10, 40, 2, 2);
+    CheckData(1, 2 * SSD1306_WIDTH + 10, 31);
+    CheckWindow(2, 5, 20, 3, 3);
+    CheckData(3, 3 * SSD1306_WIDTH + 5, 16);
+    CHECK_EQ(Stats().lastBytes, (1 + 6 + 31 + 1) + (1 + 6 + 16 + 1));
+    CHECK(AllClean());
+}
+
+static void TestBlit(void)
+{
+    // 2 x 10 bitmap, page-major: column 0 is all set, column 1 only its top row
+    static const uint8_t bitmap[] = {0xFF, 0x01, 0x03, 0x00};
+    static const uint8_t nibble[] = {0x0F};
+
+    // Rows 8 to 10 and 23 of column 50 are outside the bitmap and must be kept
+    SSD1306_Buffer[1 * SSD1306_WIDTH + 50] = 0x07;
+    SSD1306_Buffer[2 * SSD1306_WIDTH + 50] = 0x80;
+    SSD1306_Buffer[2 * SSD1306_WIDTH + 51] = 0x20;
+
+    // Row 11 straddles pages 1 and 2
+    SSD1306_DrawBitmap(50, 11, 2, 10, bitmap, SSD1306_COLOR_WHITE);
+    CHECK_EQ(SSD1306_Buffer[1 * SSD1306_WIDTH + 50], 0xFF);
+    CHECK_EQ(SSD1306_Buffer[1 * SSD1306_WIDTH + 51], 0x08);
+    CHECK_EQ(SSD1306_Buffer[2 * SSD1306_WIDTH + 50], 0x9F);
+    CHECK_EQ(SSD1306_Buffer[2 * SSD1306_WIDTH + 51], 0x20);
+    CHECK_EQ(SSD1306_Buffer[1 * SSD1306_WIDTH + 52], 0x00);
+    CHECK_EQ(ssd1306DirtyFirst[1], 50);
+    CHECK_EQ(ssd1306DirtyLast[1], 51);
+    CHECK_EQ(ssd1306DirtyFirst[2], 50);
+    CHECK_EQ(ssd1306DirtyLast[2], 51);
+    CHECK_EQ(ssd1306DirtyFirst[3], SSD1306_CLEAN);
+    SSD1306_UpdateScreen();
+
+    // The same bitmap again changes nothing
+    SSD1306_DrawBitmap(50, 11, 2, 10, bitmap, SSD1306_COLOR_WHITE);
+    CHECK(AllClean());
+
+    // A black bitmap draws the complement, and so does a white one on an inverted screen
+    SSD1306_DrawBitmap(0, 56, 1, 8, nibble, SSD1306_COLOR_BLACK);
+    CHECK_EQ(SSD1306_Buffer[7 * SSD1306_WIDTH], 0xF0);
+    SSD1306.Inverted = 1;
+    SSD1306_DrawBitmap(1, 56, 1, 8, nibble, SSD1306_COLOR_WHITE);
+    CHECK_EQ(SSD1306_Buffer[7 * SSD1306_WIDTH + 1], 0xF0);
+    SSD1306.Inverted = 0;
+
+    // A bitmap that does not fit is not drawn
+    SSD1306_UpdateScreen();
+    SSD1306_DrawBitmap(127, 0, 2, 8, bitmap, SSD1306_COLOR_WHITE);
+    SSD1306_DrawBitmap(0, 60, 1, 8, nibble, SSD1306_COLOR_WHITE);
+    CHECK(AllClean());
+}
+
+static void TestText(void)
+{
+    uint8_t pages = (Font_7x10.FontHeight + 7) / 8;
+
+    SSD1306_Clear();
+    SSD1306_UpdateScreen();
+
+    SSD1306_GotoXY(0, 3);
+    CHECK_EQ(SSD1306_Putc('A', &Font_7x10, SSD1306_COLOR_WHITE), 'A');
+    CHECK_EQ(SSD1306.CurrentX, Font_7x10.FontWidth);
+
+    // The glyph lands three rows down, as the blit of its bitmap would put it
+    const uint8_t *glyph = &Font_7x10.data[('A' - ' ') * Font_7x10.FontWidth * pages];
+    CHECK_EQ(SSD1306_Buffer[3], (uint8_t)(glyph[3] << 3));
+    CHECK_EQ(ssd1306DirtyFirst[0], 0);
+    CHECK_EQ(ssd1306DirtyLast[0], Font_7x10.FontWidth - 1);
+    CHECK_EQ(ssd1306DirtyLast[1], Font_7x10.FontWidth - 1);
+    CHECK_EQ(ssd1306DirtyFirst[2], SSD1306_CLEAN);
+
+    CHECK_EQ(SSD1306_Putc('\n', &Font_7x10, SSD1306_COLOR_WHITE), 0);
+    SSD1306_GotoXY(SSD1306_WIDTH - Font_7x10.FontWidth, 0);
+    CHECK_EQ(SSD1306_Putc('A', &Font_7x10, SSD1306_COLOR_WHITE), 0);
+}
+
+int main(void)
+{
+    fakeOnBlock = FakeI2cRun;
+    CHECK_EQ(I2cInitializeDriver(), STATUS_OK);
+
+    RUN(TestInit);
+    RUN(TestFullFrame);
+    RUN(TestDirtyRanges);
+    RUN(TestBlit);
+    RUN(TestText);
+    CHECK_EQ(fakeCriticalNesting, 0);
+    return TEST_REPORT("ssd1306");
+}